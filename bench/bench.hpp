@@ -0,0 +1,42 @@
+/**
+ * @file bench.hpp
+ * @brief SAPPOROBDD 2.0 benchmark suite - workload registry
+ * @copyright MIT License
+ *
+ * Every workload is deterministic (fixed seeds, fixed parameters per scale)
+ * and returns a result string (a count or checksum), so runs of different
+ * library versions can be compared both for time and for correctness.
+ */
+
+#ifndef SBDD2_BENCH_HPP
+#define SBDD2_BENCH_HPP
+
+#include <sbdd2/sbdd2.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace sbdd2 {
+namespace bench {
+
+/// Problem size presets selected with --scale
+enum class Scale { SMALL, MEDIUM, LARGE };
+
+/// One benchmark workload
+struct Workload {
+    const char* name;         ///< Identifier used by --filter and in the JSON output
+    const char* param_name;   ///< Meaning of the integer parameter
+    int params[3];            ///< Parameter for SMALL, MEDIUM, LARGE
+    std::size_t table_size;   ///< Node table size of the manager for one run
+    /// Runs the workload on a fresh manager and returns its result
+    std::string (*run)(DDManager& mgr, int param);
+};
+
+/// All registered workloads, in output order
+const std::vector<Workload>& workloads();
+
+} // namespace bench
+} // namespace sbdd2
+
+#endif // SBDD2_BENCH_HPP
@@ -0,0 +1,289 @@
+/**
+ * @file micro_bench.cpp
+ * @brief SAPPOROBDD 2.0 benchmark suite - DDManager primitives
+ * @copyright MIT License
+ *
+ * Google Benchmark micro-suite for the unique table, the operation cache,
+ * reference counting and garbage collection. Built as sbdd2_micro_bench
+ * when the benchmark package is found.
+ *
+ * Nodes are synthetic chains (var i % 1000 + 1, 0-arc to the previous
+ * node, 1-arc to terminal 1), so every node is distinct and the table load
+ * is exactly the requested one. Tables are kept below the GC threshold.
+ */
+
+#include <sbdd2/sbdd2.hpp>
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <mutex>
+#include <random>
+#include <vector>
+
+namespace sbdd2 {
+namespace bench {
+
+// Access to the private table primitives of DDManager
+struct ManagerAccess {
+    static bddindex find_node(const DDManager& mgr, bddvar var, Arc arc0, Arc arc1) {
+        return mgr.find_node(var, arc0, arc1);
+    }
+    static void resize_table(DDManager& mgr) {
+        std::lock_guard<std::mutex> lock(mgr.table_mutex_);
+        mgr.resize_table();
+    }
+    static void mark_and_sweep(DDManager& mgr) {
+        std::lock_guard<std::mutex> lock(mgr.table_mutex_);
+        mgr.mark_and_sweep();
+    }
+};
+
+} // namespace bench
+} // namespace sbdd2
+
+using namespace sbdd2;
+using sbdd2::bench::ManagerAccess;
+
+namespace {
+
+constexpr std::size_t TABLE_SIZE = 1u << 20;
+// Upper bound on nodes per manager, below the 0.75 GC threshold
+constexpr std::size_t NODE_LIMIT = TABLE_SIZE * 7 / 10;
+
+struct NodeKey {
+    bddvar var;
+    Arc arc0;
+    Arc arc1;
+};
+
+bddvar chain_var(std::size_t i) {
+    return static_cast<bddvar>(i % 1000 + 1);
+}
+
+// Creates a chain of `count` nodes; returns their keys (and arcs if asked)
+std::vector<NodeKey> populate(DDManager& mgr, std::size_t count,
+                              std::vector<Arc>* arcs = nullptr) {
+    std::vector<NodeKey> keys;
+    keys.reserve(count);
+    Arc prev = ARC_TERMINAL_0;
+    for (std::size_t i = 0; i < count; ++i) {
+        NodeKey key = {chain_var(i), prev, ARC_TERMINAL_1};
+        prev = mgr.get_or_create_node_bdd(key.var, key.arc0, key.arc1);
+        keys.push_back(key);
+        if (arcs) arcs->push_back(prev);
+    }
+    return keys;
+}
+
+std::size_t nodes_at_load(benchmark::State& state) {
+    return static_cast<std::size_t>(TABLE_SIZE * state.range(0) / 100);
+}
+
+// ============== Unique table ==============
+
+void BM_GetOrCreateNew(benchmark::State& state) {
+    std::unique_ptr<DDManager> mgr(new DDManager(TABLE_SIZE));
+    Arc prev = ARC_TERMINAL_0;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        if (mgr->node_count() >= NODE_LIMIT) {
+            state.PauseTiming();
+            mgr.reset(new DDManager(TABLE_SIZE));
+            prev = ARC_TERMINAL_0;
+            state.ResumeTiming();
+        }
+        prev = mgr->get_or_create_node_bdd(chain_var(i++), prev, ARC_TERMINAL_1);
+        benchmark::DoNotOptimize(prev);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetOrCreateNew);
+
+// Every thread grows its own chain in one shared table
+DDManager* g_shared = nullptr;
+
+void BM_GetOrCreateNewMT(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        g_shared = new DDManager(TABLE_SIZE * 4);
+    }
+    Arc prev = ARC_TERMINAL_0;
+    std::size_t i = 0;
+    bddvar base = static_cast<bddvar>(1000 * state.thread_index());
+    for (auto _ : state) {
+        prev = g_shared->get_or_create_node_bdd(base + chain_var(i++), prev, ARC_TERMINAL_1);
+        benchmark::DoNotOptimize(prev);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        delete g_shared;
+        g_shared = nullptr;
+    }
+}
+// Fixed iterations keep 8 threads below the GC threshold of the shared table
+BENCHMARK(BM_GetOrCreateNewMT)->ThreadRange(1, 8)->Iterations(1 << 17)->UseRealTime();
+
+void BM_GetOrCreateExistingMT(benchmark::State& state) {
+    static std::vector<NodeKey> keys;
+    if (state.thread_index() == 0) {
+        g_shared = new DDManager(TABLE_SIZE);
+        keys = populate(*g_shared, TABLE_SIZE / 2);
+    }
+    std::mt19937 rng(state.thread_index());
+    std::uniform_int_distribution<std::size_t> pick(0, TABLE_SIZE / 2 - 1);
+    for (auto _ : state) {
+        const NodeKey& k = keys[pick(rng)];
+        benchmark::DoNotOptimize(g_shared->get_or_create_node_bdd(k.var, k.arc0, k.arc1));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        delete g_shared;
+        g_shared = nullptr;
+    }
+}
+BENCHMARK(BM_GetOrCreateExistingMT)->ThreadRange(1, 8)->UseRealTime();
+
+// find_node at a load factor of range(0) percent
+void BM_FindNodeHit(benchmark::State& state) {
+    DDManager mgr(TABLE_SIZE);
+    std::vector<NodeKey> keys = populate(mgr, nodes_at_load(state));
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<std::size_t> pick(0, keys.size() - 1);
+    for (auto _ : state) {
+        const NodeKey& k = keys[pick(rng)];
+        benchmark::DoNotOptimize(ManagerAccess::find_node(mgr, k.var, k.arc0, k.arc1));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindNodeHit)->Arg(10)->Arg(25)->Arg(50)->Arg(70);
+
+void BM_FindNodeMiss(benchmark::State& state) {
+    DDManager mgr(TABLE_SIZE);
+    std::vector<NodeKey> keys = populate(mgr, nodes_at_load(state));
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<std::size_t> pick(0, keys.size() - 1);
+    for (auto _ : state) {
+        // Chain variables stay below 1001, so this key is never present
+        const NodeKey& k = keys[pick(rng)];
+        benchmark::DoNotOptimize(ManagerAccess::find_node(mgr, k.var + 1000, k.arc0, k.arc1));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindNodeMiss)->Arg(10)->Arg(25)->Arg(50)->Arg(70);
+
+// Rehash into a doubled table at a load factor of range(0) percent
+void BM_ResizeTable(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<DDManager> mgr(new DDManager(TABLE_SIZE / 4));
+        populate(*mgr, TABLE_SIZE / 4 * state.range(0) / 100);
+        state.ResumeTiming();
+        ManagerAccess::resize_table(*mgr);
+        state.PauseTiming();
+        mgr.reset();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_ResizeTable)->Arg(25)->Arg(50)->Arg(70)->Unit(benchmark::kMillisecond);
+
+// ============== Garbage collection ==============
+
+// Mark and sweep with range(0) percent of the nodes reachable
+void BM_MarkAndSweep(benchmark::State& state) {
+    const std::size_t count = TABLE_SIZE / 2;
+    const std::size_t live = count * state.range(0) / 100;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::unique_ptr<DDManager> mgr(new DDManager(TABLE_SIZE));
+        std::vector<Arc> arcs;
+        populate(*mgr, count, &arcs);
+        // Only the live-th node stays referenced; the chain below it is marked
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i + 1 != live) mgr->dec_ref(arcs[i]);
+        }
+        state.ResumeTiming();
+        ManagerAccess::mark_and_sweep(*mgr);
+        state.PauseTiming();
+        mgr.reset();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_MarkAndSweep)->Arg(10)->Arg(50)->Arg(90)->Unit(benchmark::kMillisecond);
+
+// ============== Reference counting ==============
+
+void BM_IncDecRef(benchmark::State& state) {
+    static Arc top;
+    if (state.thread_index() == 0) {
+        g_shared = new DDManager(TABLE_SIZE);
+        std::vector<Arc> arcs;
+        populate(*g_shared, 1024, &arcs);
+        top = arcs.back();
+    }
+    for (auto _ : state) {
+        g_shared->inc_ref(top);
+        g_shared->dec_ref(top);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+    if (state.thread_index() == 0) {
+        delete g_shared;
+        g_shared = nullptr;
+    }
+}
+BENCHMARK(BM_IncDecRef)->ThreadRange(1, 8)->UseRealTime();
+
+// ============== Operation cache ==============
+
+void BM_CacheLookupHit(benchmark::State& state) {
+    static std::vector<Arc> arcs;
+    if (state.thread_index() == 0) {
+        g_shared = new DDManager(TABLE_SIZE);
+        arcs.clear();
+        populate(*g_shared, 4096, &arcs);
+        for (std::size_t i = 0; i + 1 < arcs.size(); ++i) {
+            g_shared->cache_insert(CacheOp::AND, arcs[i], arcs[i + 1], arcs[i]);
+        }
+    }
+    std::size_t i = state.thread_index();
+    Arc result;
+    for (auto _ : state) {
+        std::size_t j = i++ % (arcs.size() - 1);
+        benchmark::DoNotOptimize(g_shared->cache_lookup(CacheOp::AND, arcs[j], arcs[j + 1], result));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        delete g_shared;
+        g_shared = nullptr;
+    }
+}
+BENCHMARK(BM_CacheLookupHit)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_CacheLookupMiss(benchmark::State& state) {
+    DDManager mgr(TABLE_SIZE);
+    std::vector<NodeKey> keys = populate(mgr, 4096);
+    std::size_t i = 0;
+    Arc result;
+    for (auto _ : state) {
+        const NodeKey& k = keys[i++ % keys.size()];
+        benchmark::DoNotOptimize(mgr.cache_lookup(CacheOp::XOR, k.arc0, k.arc0, result));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CacheLookupMiss);
+
+void BM_CacheInsert(benchmark::State& state) {
+    DDManager mgr(TABLE_SIZE);
+    std::vector<NodeKey> keys = populate(mgr, 4096);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const NodeKey& k = keys[i % keys.size()];
+        const NodeKey& l = keys[(i * 7 + 1) % keys.size()];
+        mgr.cache_insert(CacheOp::OR, k.arc0, l.arc0, k.arc0);
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CacheInsert);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,251 @@
+/**
+ * @file sbdd2_bench.cpp
+ * @brief SAPPOROBDD 2.0 benchmark suite - runner
+ * @copyright MIT License
+ *
+ * Runs the registered workloads and writes one JSON document:
+ *
+ *   sbdd2_bench [--scale small|medium|large] [--filter NAME]
+ *               [--repeat K] [--output FILE] [--list]
+ *
+ * Each repetition runs on a fresh DDManager. Times are wall-clock
+ * milliseconds of the workload alone (manager construction excluded);
+ * node and cache statistics are taken from the last repetition.
+ * peak_rss_kb is the peak of the last repetition alone where the kernel can
+ * reset it (Linux), and 0 elsewhere.
+ */
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if !defined(__linux__) && (defined(__unix__) || defined(__APPLE__))
+#include <sys/resource.h>
+#endif
+
+#ifndef SBDD2_BENCH_VERSION
+#define SBDD2_BENCH_VERSION "unknown"
+#endif
+
+using namespace sbdd2;
+using namespace sbdd2::bench;
+
+namespace {
+
+// Resident set size in KiB: current and peak (0 if unavailable)
+void read_rss(long& rss_kb, long& peak_kb) {
+    rss_kb = 0;
+    peak_kb = 0;
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) rss_kb = std::atol(line.c_str() + 6);
+        if (line.compare(0, 6, "VmHWM:") == 0) peak_kb = std::atol(line.c_str() + 6);
+    }
+#elif defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+        peak_kb = usage.ru_maxrss / 1024;
+#else
+        peak_kb = usage.ru_maxrss;
+#endif
+        rss_kb = peak_kb;
+    }
+#endif
+}
+
+// Resets the peak resident set size, so that the next read_rss() reports
+// the peak since this call. Returns false where the peak cannot be reset.
+bool reset_peak_rss() {
+#if defined(__linux__)
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+    clear_refs.close();
+    return !clear_refs.fail();
+#else
+    return false;
+#endif
+}
+
+// Control characters may not appear raw in a JSON string
+std::string json_escape(const std::string& s) {
+    static const char hex[] = "0123456789abcdef";
+    std::string out;
+    for (char c : s) {
+        unsigned char u = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (u < 0x20) {
+            out += "\\u00";
+            out += hex[u >> 4];
+            out += hex[u & 0xf];
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+struct RunResult {
+    std::string result;
+    std::vector<double> times_ms;
+    std::size_t nodes;
+    std::size_t peak_nodes;
+    std::size_t cache_hits;
+    std::size_t cache_misses;
+    std::size_t memory_bytes;
+    std::size_t peak_memory_bytes;
+    long rss_kb;
+    long peak_rss_kb;
+};
+
+RunResult run_workload(const Workload& w, int param, int repeat) {
+    RunResult r;
+    for (int i = 0; i < repeat; ++i) {
+        bool peak_reset = reset_peak_rss();
+        DDManager mgr(w.table_size);
+        mgr.reset_stats();
+        auto start = std::chrono::steady_clock::now();
+        std::string result = w.run(mgr, param);
+        auto end = std::chrono::steady_clock::now();
+        r.times_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+
+        if (i > 0 && result != r.result) {
+            r.result = "nondeterministic";
+        } else if (i == 0) {
+            r.result = result;
+        }
+        r.nodes = mgr.node_count();
+        r.peak_nodes = mgr.peak_node_count();
+        r.cache_hits = mgr.cache_hit_count();
+        r.cache_misses = mgr.cache_miss_count();
+        r.memory_bytes = mgr.memory_usage().total();
+        r.peak_memory_bytes = mgr.peak_memory_usage();
+        read_rss(r.rss_kb, r.peak_rss_kb);
+        // Otherwise the peak covers every earlier workload too
+        if (!peak_reset) r.peak_rss_kb = 0;
+    }
+    return r;
+}
+
+void write_result(std::ostream& os, const Workload& w, int param, const RunResult& r) {
+    std::vector<double> sorted = r.times_ms;
+    std::sort(sorted.begin(), sorted.end());
+    double median = sorted[sorted.size() / 2];
+    std::size_t lookups = r.cache_hits + r.cache_misses;
+    double hit_rate = lookups ? static_cast<double>(r.cache_hits) / lookups : 0.0;
+
+    // Streamed rather than formatted into a fixed buffer: results such as
+    // exact counts can be arbitrarily long.
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "    {\"name\": \"" << w.name << "\", \"param\": {\"" << w.param_name
+        << "\": " << param << "}, \"result\": \"" << json_escape(r.result) << "\",\n"
+        << "     \"time_ms\": {\"min\": " << sorted.front() << ", \"median\": " << median
+        << ", \"max\": " << sorted.back() << ", \"repeat\": " << sorted.size() << "},\n"
+        << "     \"nodes\": " << r.nodes << ", \"peak_nodes\": " << r.peak_nodes
+        << ", \"table_size\": " << w.table_size << ",\n"
+        << "     \"cache_hits\": " << r.cache_hits << ", \"cache_misses\": " << r.cache_misses
+        << ", \"cache_hit_rate\": " << std::setprecision(4) << hit_rate << ",\n"
+        << "     \"memory_bytes\": " << r.memory_bytes
+        << ", \"peak_memory_bytes\": " << r.peak_memory_bytes << ",\n"
+        << "     \"rss_kb\": " << r.rss_kb << ", \"peak_rss_kb\": " << r.peak_rss_kb << "}";
+    os << out.str();
+}
+
+void print_usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options]\n"
+              << "  --scale small|medium|large  Problem sizes (default: small)\n"
+              << "  --filter NAME               Run workloads whose name contains NAME\n"
+              << "  --repeat K                  Repetitions per workload (default: 3)\n"
+              << "  --output FILE               Write JSON to FILE (default: stdout)\n"
+              << "  --list                      List workloads and exit\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Scale scale = Scale::SMALL;
+    std::string filter;
+    std::string output;
+    int repeat = 3;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--scale" && has_value) {
+            std::string s = argv[++i];
+            if (s == "small") scale = Scale::SMALL;
+            else if (s == "medium") scale = Scale::MEDIUM;
+            else if (s == "large") scale = Scale::LARGE;
+            else { print_usage(argv[0]); return 1; }
+        } else if (arg == "--filter" && has_value) {
+            filter = argv[++i];
+        } else if (arg == "--repeat" && has_value) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--output" && has_value) {
+            output = argv[++i];
+        } else if (arg == "--list") {
+            for (const Workload& w : workloads()) {
+                std::cout << w.name << " (" << w.param_name << ": "
+                          << w.params[0] << " / " << w.params[1] << " / " << w.params[2] << ")\n";
+            }
+            return 0;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    static const char* scale_names[] = {"small", "medium", "large"};
+    int scale_index = static_cast<int>(scale);
+
+    std::ostringstream json;
+    json << "{\n"
+         << "  \"schema\": 1,\n"
+         << "  \"library\": \"SAPPOROBDD2\",\n"
+         << "  \"version\": \"" << SBDD2_BENCH_VERSION << "\",\n"
+#ifdef NDEBUG
+         << "  \"assertions\": false,\n"
+#else
+         << "  \"assertions\": true,\n"
+#endif
+         << "  \"scale\": \"" << scale_names[scale_index] << "\",\n"
+         << "  \"results\": [\n";
+
+    bool first = true;
+    for (const Workload& w : workloads()) {
+        if (!filter.empty() && std::strstr(w.name, filter.c_str()) == nullptr) continue;
+        int param = w.params[scale_index];
+        std::cerr << "running " << w.name << " (" << w.param_name << "=" << param << ")\n";
+        RunResult r = run_workload(w, param, repeat);
+        if (!first) json << ",\n";
+        write_result(json, w, param, r);
+        first = false;
+    }
+    json << "\n  ]\n}\n";
+
+    if (output.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream out(output.c_str());
+        if (!out) {
+            std::cerr << "cannot open " << output << "\n";
+            return 1;
+        }
+        out << json.str();
+    }
+    return 0;
+}
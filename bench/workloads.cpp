@@ -0,0 +1,325 @@
+/**
+ * @file workloads.cpp
+ * @brief SAPPOROBDD 2.0 benchmark suite - workloads
+ * @copyright MIT License
+ *
+ * The N-Queens, tic-tac-toe (reduced to a flat board), Hamiltonian, CNF and relational-product
+ * workloads follow the programs in examples/ (after the BDD Benchmark suite
+ * by Steffan Sølvsten, MIT License), reduced to a single integer parameter
+ * and made deterministic.
+ */
+
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <sstream>
+
+namespace sbdd2 {
+namespace bench {
+
+static std::string format_double(double x) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.17g", x);
+    return buf;
+}
+
+static void declare_vars(DDManager& mgr, int n) {
+    for (int i = 0; i < n; ++i) mgr.new_var();
+}
+
+// ============== N-Queens (BDD) ==============
+
+// Number of placements of n non-attacking queens on an n x n board
+static std::string run_nqueens(DDManager& mgr, int n) {
+    declare_vars(mgr, n * n);
+    auto var = [n](int r, int c) { return static_cast<bddvar>(n * r + c + 1); };
+
+    BDD board = mgr.bdd_one();
+    for (int i = 0; i < n; ++i) {
+        BDD row = mgr.bdd_zero();
+        for (int j = 0; j < n; ++j) {
+            // Queen at (i, j) and none on a conflicting square
+            BDD s = mgr.var_bdd(var(i, j));
+            for (int r = 0; r < n; ++r) {
+                for (int c = 0; c < n; ++c) {
+                    if (r == i && c == j) continue;
+                    if (r == i || c == j || r - c == i - j || r + c == i + j) {
+                        s &= ~mgr.var_bdd(var(r, c));
+                    }
+                }
+            }
+            row |= s;
+        }
+        board &= row;
+    }
+    return format_double(board.card());
+}
+
+// ============== Tic-Tac-Toe (BDD) ==============
+
+// Number of final n x n positions (floor(n*n/2) crosses, the rest noughts)
+// with no row, column or diagonal that is entirely crosses or noughts
+static std::string run_tictactoe(DDManager& mgr, int n) {
+    int cells = n * n;
+    int crosses = cells / 2;
+    declare_vars(mgr, cells);
+    auto var = [n](int r, int c) { return static_cast<bddvar>(n * r + c + 1); };
+
+    // Exactly `crosses` of the variables are true (built bottom-up)
+    std::vector<BDD> dp(crosses + 1, mgr.bdd_zero());
+    dp[0] = mgr.bdd_one();
+    for (int v = 1; v <= cells; ++v) {
+        BDD x = mgr.var_bdd(static_cast<bddvar>(v));
+        std::vector<BDD> next(crosses + 1, mgr.bdd_zero());
+        for (int k = 0; k <= crosses; ++k) {
+            next[k] = (~x & dp[k]) | (k > 0 ? (x & dp[k - 1]) : mgr.bdd_zero());
+        }
+        dp.swap(next);
+    }
+    BDD result = dp[crosses];
+
+    std::vector<std::vector<bddvar>> lines;
+    for (int i = 0; i < n; ++i) {
+        std::vector<bddvar> row, col;
+        for (int j = 0; j < n; ++j) {
+            row.push_back(var(i, j));
+            col.push_back(var(j, i));
+        }
+        lines.push_back(row);
+        lines.push_back(col);
+    }
+    std::vector<bddvar> diag, anti;
+    for (int i = 0; i < n; ++i) {
+        diag.push_back(var(i, i));
+        anti.push_back(var(i, n - 1 - i));
+    }
+    lines.push_back(diag);
+    lines.push_back(anti);
+
+    for (const auto& line : lines) {
+        BDD all_x = mgr.bdd_one();
+        BDD all_o = mgr.bdd_one();
+        for (bddvar v : line) {
+            BDD x = mgr.var_bdd(v);
+            all_x &= x;
+            all_o &= ~x;
+        }
+        result &= ~all_x & ~all_o;
+    }
+    return format_double(result.card());
+}
+
+// ============== Grid 2-factors (BDD) ==============
+
+// Degree-2 edge subsets (2-factors) of the n x n grid graph that use both
+// edges at the top-left corner. Like examples/hamiltonian, there is no
+// single-cycle constraint, so for n >= 4 this also counts unions of cycles.
+static std::string run_two_factor(DDManager& mgr, int n) {
+    int horizontal = n * (n - 1);
+    declare_vars(mgr, 2 * horizontal);
+    auto h_edge = [n](int r, int c) { return static_cast<bddvar>(r * (n - 1) + c + 1); };
+    auto v_edge = [n, horizontal](int r, int c) {
+        return static_cast<bddvar>(horizontal + r * n + c + 1);
+    };
+
+    BDD result = mgr.var_bdd(h_edge(0, 0)) & mgr.var_bdd(v_edge(0, 0));
+    for (int r = 0; r < n; ++r) {
+        for (int c = 0; c < n; ++c) {
+            std::vector<BDD> edges;
+            if (c > 0) edges.push_back(mgr.var_bdd(h_edge(r, c - 1)));
+            if (c < n - 1) edges.push_back(mgr.var_bdd(h_edge(r, c)));
+            if (r > 0) edges.push_back(mgr.var_bdd(v_edge(r - 1, c)));
+            if (r < n - 1) edges.push_back(mgr.var_bdd(v_edge(r, c)));
+
+            // Exactly two incident edges
+            BDD degree2 = mgr.bdd_zero();
+            for (std::size_t a = 0; a < edges.size(); ++a) {
+                for (std::size_t b = a + 1; b < edges.size(); ++b) {
+                    BDD term = edges[a] & edges[b];
+                    for (std::size_t e = 0; e < edges.size(); ++e) {
+                        if (e != a && e != b) term &= ~edges[e];
+                    }
+                    degree2 |= term;
+                }
+            }
+            result &= degree2;
+        }
+    }
+    return format_double(result.card());
+}
+
+// ============== Random CNF (BDD) ==============
+
+// Models of a random 3-CNF with n variables and 2n clauses (seed 1)
+static std::string run_cnf(DDManager& mgr, int n) {
+    declare_vars(mgr, n);
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> pick(1, n);
+
+    BDD result = mgr.bdd_one();
+    for (int i = 0; i < 2 * n; ++i) {
+        std::set<int> vars;
+        while (vars.size() < 3) vars.insert(pick(rng));
+        BDD clause = mgr.bdd_zero();
+        for (int v : vars) {
+            BDD x = mgr.var_bdd(static_cast<bddvar>(v));
+            clause |= (rng() & 1) ? x : ~x;
+        }
+        result &= clause;
+    }
+    return format_double(result.card());
+}
+
+// ============== Relational product (BDD) ==============
+
+// Breadth-first reachability over n state bits, where a step flips exactly
+// one bit. Current bits are the even variables, next bits the odd ones.
+static std::string run_relprod(DDManager& mgr, int n) {
+    declare_vars(mgr, 2 * n);
+    auto cur = [](int i) { return static_cast<bddvar>(2 * i + 2); };
+    auto nxt = [](int i) { return static_cast<bddvar>(2 * i + 1); };
+
+    std::vector<bddvar> cur_vars, nxt_vars;
+    BDD eq = mgr.bdd_one();
+    for (int i = 0; i < n; ++i) {
+        cur_vars.push_back(cur(i));
+        nxt_vars.push_back(nxt(i));
+        eq &= ~(mgr.var_bdd(cur(i)) ^ mgr.var_bdd(nxt(i)));
+    }
+    BDD relation = mgr.bdd_zero();
+    for (int i = 0; i < n; ++i) {
+        BDD step = mgr.var_bdd(cur(i)) ^ mgr.var_bdd(nxt(i));
+        for (int j = 0; j < n; ++j) {
+            if (j != i) step &= ~(mgr.var_bdd(cur(j)) ^ mgr.var_bdd(nxt(j)));
+        }
+        relation |= step;
+    }
+
+    BDD reached = mgr.bdd_one();
+    for (int i = 0; i < n; ++i) reached &= ~mgr.var_bdd(cur(i));
+    BDD frontier = reached;
+    int steps = 0;
+    while (!frontier.is_zero()) {
+        BDD image = (frontier & relation).exist(cur_vars);
+        // Rename next to current through the identity relation
+        BDD image_cur = (image & eq).exist(nxt_vars);
+        frontier = image_cur - reached;
+        reached |= frontier;
+        ++steps;
+    }
+    // card() of a constant does not scale by the variable count, so count
+    // over all 2n variables; reached does not depend on the next bits
+    return format_double(reached.count(2 * n) / std::ldexp(1.0, n)) + "/" + std::to_string(steps);
+}
+
+// ============== Random apply (BDD) ==============
+
+// XOR/AND/OR folding of 16 random DNFs over n variables (seed 2)
+static std::string run_apply(DDManager& mgr, int n) {
+    declare_vars(mgr, n);
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<int> pick(1, n);
+
+    std::vector<BDD> fs;
+    for (int k = 0; k < 16; ++k) {
+        BDD f = mgr.bdd_zero();
+        for (int c = 0; c < n / 2; ++c) {
+            BDD cube = mgr.bdd_one();
+            for (int l = 0; l < 4; ++l) {
+                BDD x = mgr.var_bdd(static_cast<bddvar>(pick(rng)));
+                cube &= (rng() & 1) ? x : ~x;
+            }
+            f |= cube;
+        }
+        fs.push_back(f);
+    }
+
+    BDD acc = fs[0];
+    for (std::size_t k = 1; k < fs.size(); ++k) {
+        switch (k % 3) {
+        case 0: acc = acc ^ fs[k]; break;
+        case 1: acc = acc & (fs[k] | fs[k - 1]); break;
+        default: acc = acc | (fs[k] & ~fs[k - 1]); break;
+        }
+    }
+    return format_double(acc.card());
+}
+
+// ============== Builders (ZDD) ==============
+
+// Family algebra on combination families over n variables
+static std::string run_builders(DDManager& mgr, int n) {
+    declare_vars(mgr, n);
+    ZDD half = get_power_set_with_card(mgr, n, n / 2);
+    ZDD small = get_power_set_with_card(mgr, n, 2);
+    ZDD joined = half * small;
+    ZDD mixed = (joined - half) + (small & joined);
+    return format_double(half.card()) + "/" + format_double(mixed.card()) +
+           "/" + std::to_string(mixed.size());
+}
+
+// ============== Index (ZDD) ==============
+
+// Round trips between ranks and sets of the 5-subsets of n variables
+static std::string run_index(DDManager& mgr, int n) {
+    declare_vars(mgr, n);
+    ZDD family = get_power_set_with_card(mgr, n, 5);
+    family.build_index();
+    double total = family.indexed_count();
+
+    std::mt19937_64 rng(3);
+    std::uniform_int_distribution<std::int64_t> pick(0, static_cast<std::int64_t>(total) - 1);
+    std::uint64_t checksum = 0;
+    for (int i = 0; i < 20000; ++i) {
+        std::int64_t order = pick(rng);
+        std::set<bddvar> s = family.get_set(order);
+        if (family.order_of(s) != order) return "mismatch";
+        for (bddvar v : s) checksum = checksum * 31 + v;
+    }
+    return format_double(total) + "/" + std::to_string(checksum);
+}
+
+// ============== I/O (ZDD) ==============
+
+// Binary export/import round trips of a combination family, plus text export
+static std::string run_io(DDManager& mgr, int n) {
+    declare_vars(mgr, n);
+    ZDD family = get_power_set_with_card(mgr, n, n / 2) + get_power_set_with_card(mgr, n, 3);
+
+    std::size_t bytes = 0;
+    for (int round = 0; round < 4; ++round) {
+        std::stringstream ss;
+        if (!export_zdd(family, ss)) return "export-failed";
+        bytes += ss.str().size();
+        if (import_zdd(mgr, ss) != family) return "mismatch";
+
+        std::stringstream text;
+        ExportOptions topts;
+        topts.format = DDFileFormat::TEXT;
+        if (!export_zdd(family, text, topts)) return "export-failed";
+        bytes += text.str().size();
+    }
+    return std::to_string(bytes);
+}
+
+const std::vector<Workload>& workloads() {
+    static const std::vector<Workload> list = {
+        {"nqueens",     "n",       {6, 7, 8},       1u << 21, run_nqueens},
+        {"tictactoe",   "n",       {4, 5, 6},       1u << 21, run_tictactoe},
+        {"two_factor",  "n",       {4, 5, 6},       1u << 22, run_two_factor},
+        {"cnf",         "vars",    {24, 30, 36},    1u << 21, run_cnf},
+        {"relprod",     "bits",    {8, 12, 16},     1u << 20, run_relprod},
+        {"apply",       "vars",    {16, 20, 24},    1u << 23, run_apply},
+        {"builders",    "vars",    {64, 128, 256},  1u << 21, run_builders},
+        {"index",       "vars",    {20, 40, 80},    1u << 20, run_index},
+        {"io",          "vars",    {32, 96, 256},   1u << 21, run_io},
+    };
+    return list;
+}
+
+} // namespace bench
+} // namespace sbdd2
@@ -34,6 +34,7 @@ using namespace sbdd2;
 // Command line options
 static std::string cnf_file;
 static bool do_satcount = false;
+static std::string order_name = "none";
 
 ////////////////////////////////////////////////////////////////////////////////
 // CNF Data Structures
@@ -180,9 +181,10 @@ BDD cnf_to_bdd_balanced(DDManager& mgr, const CNF& cnf) {
 ////////////////////////////////////////////////////////////////////////////////
 
 void print_usage(const char* prog) {
-    std::cout << "Usage: " << prog << " -f <cnf_file> [-c]" << std::endl;
+    std::cout << "Usage: " << prog << " -f <cnf_file> [-c] [-o <order>]" << std::endl;
     std::cout << "  -f file   Path to DIMACS CNF file" << std::endl;
     std::cout << "  -c        Count satisfying assignments" << std::endl;
+    std::cout << "  -o order  Variable order: none (file order), dfs, bfs, force, mince" << std::endl;
     std::cout << std::endl;
     std::cout << "Solves CNF SAT problems using BDD." << std::endl;
     std::cout << "Based on bdd-benchmark (MIT License) by Steffan Soelvsten." << std::endl;
@@ -196,6 +198,8 @@ int main(int argc, char** argv) {
             cnf_file = argv[++i];
         } else if (arg == "-c") {
             do_satcount = true;
+        } else if (arg == "-o" && i + 1 < argc) {
+            order_name = argv[++i];
         } else if (arg == "-h" || arg == "--help") {
             print_usage(argv[0]);
             return 0;
@@ -230,10 +234,35 @@ int main(int argc, char** argv) {
     // Create DD Manager
     DDManager mgr;
 
-    // Create variables
-    std::cout << "Creating " << cnf.num_vars << " variables..." << std::endl;
-    for (int i = 0; i < cnf.num_vars; i++) {
-        mgr.new_var();
+    // Create variables, optionally in a static order computed from the clauses
+    std::cout << "Creating " << cnf.num_vars << " variables (order: " << order_name << ")..."
+              << std::endl;
+    bddvar n = static_cast<bddvar>(cnf.num_vars);
+    if (order_name == "none") {
+        for (int i = 0; i < cnf.num_vars; i++) {
+            mgr.new_var();
+        }
+    } else {
+        std::vector<std::vector<int>> literals;
+        for (const Clause& clause : cnf.clauses) {
+            literals.push_back(clause.literals);
+        }
+        ordering::Hypergraph edges = ordering::from_clauses(literals);
+        std::vector<bddvar> order;
+        if (order_name == "dfs") {
+            order = ordering::dfs(n, edges);
+        } else if (order_name == "bfs") {
+            order = ordering::bfs(n, edges);
+        } else if (order_name == "force") {
+            order = ordering::force(n, edges, ordering::dfs(n, edges));
+        } else if (order_name == "mince") {
+            order = ordering::mince(n, edges);
+        } else {
+            std::cerr << "Error: Unknown order: " << order_name << std::endl;
+            return 1;
+        }
+        std::cout << "  Total clause span: " << ordering::total_span(order, edges) << std::endl;
+        ordering::apply(mgr, order);
     }
 
     // Build BDD
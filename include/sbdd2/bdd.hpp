@@ -250,6 +250,20 @@ public:
      */
     BDD forall(const std::vector<bddvar>& vars) const;
 
+    /**
+     * @brief 論理積と存在量化（関係積）
+     * @param g 右オペランド
+     * @param vars 量化する変数のリスト
+     * @return ∃vars. (f ∧ g)
+     * @throws DDIncompatibleException マネージャーが異なる場合
+     * @throws DDArgumentException 無効な変数番号を含む場合
+     *
+     * f ∧ g を作らずに1回の走査で求める。量化する変数の上では
+     * 0-側の結果が真なら 1-側を計算しない。
+     * 結果は演算キャッシュに (f, g, 量化変数のキューブ) をキーとして記録される。
+     */
+    BDD and_exist(const BDD& g, const std::vector<bddvar>& vars) const;
+
     /// @}
 
     /**
@@ -260,6 +274,30 @@ public:
      */
     BDD restrict(bddvar v, bool value) const;
 
+    /**
+     * @brief キューブによる余因子
+     * @param cube リテラルの論理積（例: x1 & ~x3 & x4）
+     * @return cube の各リテラルを真にする値を代入した f
+     * @throws DDIncompatibleException マネージャーが異なる場合
+     * @throws DDArgumentException cube がキューブでない（偽を含む）場合
+     *
+     * restrict を1変数ずつ適用するのと同じ結果を1回の走査で求める。
+     * 結果は演算キャッシュに (f, cube) をキーとして記録される。
+     */
+    BDD cofactor(const BDD& cube) const;
+
+    /**
+     * @brief 一般化余因子 (constrain, Coudert–Madre)
+     * @param c 制約（ケア集合）
+     * @return c が真になる割当では f と一致するBDD
+     * @throws DDIncompatibleException マネージャーが異なる場合
+     *
+     * c のどちらかの余因子が偽になる変数では、もう一方の余因子へ進む。
+     * f ∧ c == f.constrain(c) ∧ c が成り立つ。c が偽なら偽を返す。
+     * 到達可能性解析のフロンティアの簡単化などに使う。
+     */
+    BDD constrain(const BDD& c) const;
+
     /**
      * @brief 合成演算
      * @param v 置換する変数
@@ -270,6 +308,81 @@ public:
      */
     BDD compose(bddvar v, const BDD& g) const;
 
+    /**
+     * @brief 変数の置換（名前替え）
+     * @param perm perm[v] が変数 v の置換先（perm[0] は使わない）
+     * @return 各 x_v を x_{perm[v]} に置き換えたBDD
+     * @throws DDArgumentException 置換先が無効な変数番号の場合
+     *
+     * perm.size() 以上の番号の変数は置き換えない。
+     * 置換が単射でない場合は、同じ変数に写る変数が同一視される。
+     * 変数順序を保つ置換なら、ノードを1つずつ付け替えるだけで済む。
+     */
+    BDD permute(const std::vector<bddvar>& perm) const;
+
+    /// @name 近似（ノード数の上限つき）
+    ///
+    /// いずれも元のBDDを1回走査して各辺の充足割合を数え、ノードテーブルを
+    /// 書き換えずに結果を組み立てる。結果のノード数は threshold 以下になる。
+    /// ノード数がすでに threshold 以下なら元のBDDを返す。
+    /// 否定辺の先のノードは肯定側と別の関数として近似する。
+    /// @{
+
+    /**
+     * @brief 下からの近似（再写像法）
+     * @param threshold 結果のノード数の上限
+     * @return f を含意し、ノード数が threshold 以下のBDD
+     *
+     * 失う充足割当の割合が小さい順に、辺を偽に置き換えるか、
+     * もう一方の子が真である辺を残す子に置き換える（再写像）。
+     * 参照数を追いながら置き換えるので、所要時間は O(n log n)（n は辺の数）。
+     */
+    BDD under_approx(std::size_t threshold) const;
+
+    /**
+     * @brief 上からの近似（再写像法）
+     * @param threshold 結果のノード数の上限
+     * @return f に含意され、ノード数が threshold 以下のBDD
+     * @see under_approx()
+     */
+    BDD over_approx(std::size_t threshold) const;
+
+    /**
+     * @brief 重い枝による部分集合
+     * @param threshold 結果のノード数の上限
+     * @return f を含意し、ノード数が threshold 以下のBDD
+     *
+     * 根から充足割当の多い子（重い枝）をたどり、途中のノードの軽い枝を偽に置き換える。
+     * 残りの部分グラフが収まる最も浅い位置で置き換えをやめる。
+     */
+    BDD subset_heavy_branch(std::size_t threshold) const;
+
+    /**
+     * @brief 重い枝による上位集合
+     * @param threshold 結果のノード数の上限
+     * @return ~((~f).subset_heavy_branch(threshold))
+     */
+    BDD superset_heavy_branch(std::size_t threshold) const;
+
+    /**
+     * @brief 短い路による部分集合
+     * @param threshold 結果のノード数の上限
+     * @return f を含意し、ノード数が threshold 以下のBDD
+     *
+     * 根から真の終端までの路のうち、ノード数が上限以下のものだけを残す。
+     * 上限は結果が threshold に収まる最大の値を選ぶ。
+     */
+    BDD subset_short_paths(std::size_t threshold) const;
+
+    /**
+     * @brief 短い路による上位集合
+     * @param threshold 結果のノード数の上限
+     * @return ~((~f).subset_short_paths(threshold))
+     */
+    BDD superset_short_paths(std::size_t threshold) const;
+
+    /// @}
+
     /// @name カウント演算
     /// @{
 
@@ -310,10 +423,12 @@ public:
     std::vector<int> one_sat() const;
 
     /**
-     * @brief ZDDへの変換
-     * @return 等価なZDD
+     * @brief ZDDへの変換（充足割当の集合族）
+     * @param universe 台集合とするレベル数。0なら全変数
+     * @return ZDD::from_bdd(*this, universe) と同じ
+     * @see ZDD::from_bdd(), ZDD::to_bdd()
      */
-    ZDD to_zdd() const;
+    ZDD to_zdd(bddvar universe = 0) const;
 
     /// @name デバッグ・出力
     /// @{
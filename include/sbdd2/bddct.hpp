@@ -19,6 +19,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <cstdio>
 
 namespace sbdd2 {
@@ -56,13 +57,11 @@ private:
     std::vector<bddcost> costs_;
     std::vector<std::string> labels_;
 
-    /** @brief キャッシュエントリ（コストマップ付き） */
-    struct CacheEntry {
-        std::uint64_t id;
-        CostMap* zmap;
-
-        CacheEntry() : id(~0ULL), zmap(nullptr) {}
-        ~CacheEntry() { delete zmap; }
+    /** @brief コスト制約付き抽出の結果（結果のアークと、同じ結果を与える上限の区間 [aw, rb)） */
+    struct CostLeResult {
+        Arc result;
+        bddcost aw;
+        bddcost rb;
     };
 
     /** @brief 簡易キャッシュエントリ（コスト値のみ） */
@@ -74,11 +73,16 @@ private:
         Cache0Entry() : id(~0ULL), bound(BDDCOST_NULL), op(255) {}
     };
 
-    std::vector<CacheEntry> cache_;
+    /** @brief 区間キャッシュ：ノードごとに aw の昇順で並べた互いに素な区間 */
+    std::unordered_map<std::uint64_t, std::vector<CostLeResult>> cache_;
     std::vector<Cache0Entry> cache0_;
     std::size_t cache_entries_;
     std::size_t cache0_entries_;
     std::size_t call_count_;
+    std::uint64_t gc_epoch_;
+
+    /** @brief キャッシュの使用量（DDManager::memory_usage() に計上） */
+    MemoryAccount memory_;
 
 public:
     /**
@@ -224,9 +228,11 @@ public:
      * @brief ZDD に対してコスト上限以下の部分集合のみを抽出する（詳細情報付き）
      * @param f 入力 ZDD
      * @param bound コスト上限値
-     * @param[out] actual_weight 実際の最小コスト
-     * @param[out] reduced_bound 削減後のコスト上限
+     * @param[out] actual_weight 結果に含まれる集合の最大コスト（結果が空なら -BDDCOST_NULL）
+     * @param[out] reduced_bound 除外された集合の最小コスト（除外がなければ BDDCOST_NULL）
      * @return コストが bound 以下の部分集合のみを含む ZDD
+     *
+     * actual_weight <= b < reduced_bound を満たす任意の上限 b に対して同じ結果となる。
      * @see ZDD
      */
     ZDD zdd_cost_le(const ZDD& f, bddcost bound, bddcost& actual_weight, bddcost& reduced_bound);
@@ -236,6 +242,8 @@ public:
      * @param f 入力 ZDD
      * @param bound コスト上限値
      * @return コストが bound 以下の部分集合のみを含む ZDD
+     *
+     * zdd_cost_le() とキャッシュを共有する。
      * @see ZDD
      */
     ZDD zdd_cost_le0(const ZDD& f, bddcost bound);
@@ -256,11 +264,15 @@ public:
 
     /**
      * @brief メインキャッシュをクリアする
+     *
+     * メインキャッシュは上限値の区間ごとに結果を保持し、呼び出しをまたいで共有される。
+     * 異なる上限での繰り返し呼び出しは、既に求めた区間に含まれる限り再計算されない。
+     * DDManager の GC 後は自動的に破棄される。
      */
     void cache_clear();
 
     /**
-     * @brief メインキャッシュのサイズを拡大する
+     * @brief メインキャッシュのバケット数を拡大する
      */
     void cache_enlarge();
 
@@ -287,11 +299,19 @@ public:
     std::string to_string() const;
 
 private:
+    // Arc-level kernels
+    Arc cost_le_arc(Arc f, bddcost bound, bddcost& aw, bddcost& rb);
+    bddcost min_cost_arc(Arc f);
+    bddcost max_cost_arc(Arc f);
+    bddcost extreme_cost_arc(Arc f, std::uint8_t op);
+
     // Cache helpers
-    ZDD cache_ref(const ZDD& f, bddcost bound, bddcost& aw, bddcost& rb);
-    void cache_ent(const ZDD& f, const ZDD& result, bddcost bound, bddcost cost);
+    void check_epoch();
+    bool cache_ref(Arc f, bddcost bound, CostLeResult& entry) const;
+    void cache_ent(Arc f, const CostLeResult& entry);
     bddcost cache0_ref(std::uint8_t op, std::uint64_t id) const;
     void cache0_ent(std::uint8_t op, std::uint64_t id, bddcost result);
+    void account_memory();
 };
 
 } // namespace sbdd2
@@ -0,0 +1,151 @@
+/**
+ * @file chain_zdd.hpp
+ * @brief 連鎖簡約ZDD (Chain-reduced ZDD) クラスの定義
+ * @copyright MIT License
+ *
+ * 連続したレベルのノードの連鎖を1つのノードにまとめた ZDD を実装します。
+ * 疎な集合族（各集合が少数の要素からなる族）でノード数を減らせます。
+ */
+
+// SAPPOROBDD 2.0 - Chain-reduced ZDD class
+// MIT License
+
+#ifndef SBDD2_CHAIN_ZDD_HPP
+#define SBDD2_CHAIN_ZDD_HPP
+
+#include "dd_base.hpp"
+
+namespace sbdd2 {
+
+// Forward declarations
+class ZDD;
+
+/**
+ * @brief 連鎖簡約ZDD (Chain-reduced ZDD) クラス
+ *
+ * レベル t から b（t > b）まで連続する ZDD ノードのうち、
+ * すべての 0-枝が同じノード lo を指し、各 1-枝が1つ下のレベルのノードを指すものを、
+ * 1つの連鎖ノード [t:b](lo, hi) で表します（Bryant の chain reduction）。
+ * lo が空集合族なら、1要素ずつ増える「1本道」の連鎖がそのまま1ノードになります。
+ *
+ * 連鎖ノードはノードテーブル上で2つのノードで表します。
+ * - 先頭: 変数 = レベル t の変数、0-arc = lo、1-arc = 末尾ノードへの否定枝
+ * - 末尾: 変数 = レベル b の変数、0-arc = lo、1-arc = hi（通常の ZDD ノード）
+ *
+ * ZDD のノードは否定枝を持たず、BDD のノードも 1-arc を否定しないので、
+ * 1-arc の否定ビットが連鎖ノードの目印になります（DDNode::is_chain_head()）。
+ * 長さ k の連鎖は k 個のノードの代わりに2個で済みます。
+ *
+ * DDBase のメソッドは連鎖ノードを扱えます。size() は格納しているノード数
+ * （連鎖1つにつき先頭と末尾の2個）を返し、support() は連鎖の途中の
+ * レベルの変数も含めます。連鎖ノードの先頭に対する DDNodeRef::child1() は
+ * 例外を送出し、io の ZDD 出力関数は連鎖ノードを含む ZDD を受け付けません。
+ *
+ * 表現は正準形なので、等価比較はルート辺の比較で行えます。
+ * 連鎖ノードは ChainZDD からのみ参照され、ZDD の演算に渡ることはありません。
+ * 相互の変換には ChainZDD(const ZDD&) と to_zdd() を使います。
+ *
+ * @see ZDD
+ */
+class ChainZDD : public DDBase {
+public:
+    /**
+     * @brief デフォルトコンストラクタ（無効なChainZDDを生成）
+     */
+    ChainZDD() : DDBase() {}
+
+    /**
+     * @brief マネージャとArcを指定するコンストラクタ（内部使用）
+     * @param mgr DDマネージャへのポインタ
+     * @param a ルート辺
+     */
+    ChainZDD(DDManager* mgr, Arc a) : DDBase(mgr, a) {}
+
+    /// @brief コピーコンストラクタ（デフォルト）
+    ChainZDD(const ChainZDD&) = default;
+    /// @brief ムーブコンストラクタ（デフォルト）
+    ChainZDD(ChainZDD&&) noexcept = default;
+    /// @brief コピー代入演算子（デフォルト）
+    ChainZDD& operator=(const ChainZDD&) = default;
+    /// @brief ムーブ代入演算子（デフォルト）
+    ChainZDD& operator=(ChainZDD&&) noexcept = default;
+
+    /**
+     * @brief ZDD から連鎖簡約ZDDを構築する
+     * @param f 変換元の ZDD
+     *
+     * ZDD のノードを1回ずつ走査し、連続する連鎖をまとめます。
+     */
+    explicit ChainZDD(const ZDD& f);
+
+    /**
+     * @brief 空集合族を作成
+     * @param mgr DDマネージャー
+     * @return 空集合族 ∅
+     */
+    static ChainZDD empty(DDManager& mgr);
+
+    /**
+     * @brief 単一集合族を作成
+     * @param mgr DDマネージャー
+     * @return 単一集合族 {∅}
+     */
+    static ChainZDD single(DDManager& mgr);
+
+    /**
+     * @brief ZDD に変換する
+     * @return 連鎖を展開した ZDD
+     */
+    ZDD to_zdd() const;
+
+    /// @name 集合族演算
+    ///
+    /// 連鎖ノード同士は、両者が共通に持つレベルの範囲を1ステップで処理します。
+    /// 結果は演算キャッシュに残ります。
+    /// @{
+
+    /**
+     * @brief 和集合
+     * @param other 右オペランド
+     * @return this ∪ other
+     * @throws DDIncompatibleException マネージャーが異なる場合
+     */
+    ChainZDD operator+(const ChainZDD& other) const;
+
+    /**
+     * @brief 共通集合
+     * @param other 右オペランド
+     * @return this ∩ other
+     * @throws DDIncompatibleException マネージャーが異なる場合
+     */
+    ChainZDD operator&(const ChainZDD& other) const;
+
+    /**
+     * @brief 差集合
+     * @param other 右オペランド
+     * @return this \ other
+     * @throws DDIncompatibleException マネージャーが異なる場合
+     */
+    ChainZDD operator-(const ChainZDD& other) const;
+
+    /// @brief 和集合の代入演算子
+    ChainZDD& operator+=(const ChainZDD& other) { return *this = *this + other; }
+    /// @brief 共通集合の代入演算子
+    ChainZDD& operator&=(const ChainZDD& other) { return *this = *this & other; }
+    /// @brief 差集合の代入演算子
+    ChainZDD& operator-=(const ChainZDD& other) { return *this = *this - other; }
+
+    /// @}
+
+    /**
+     * @brief 集合の個数を数える
+     * @return 集合族に含まれる集合の数
+     *
+     * 連鎖ノード [t:b](lo, hi) の集合数は (t - b + 1) * |lo| + |hi| で求めます。
+     */
+    double card() const;
+};
+
+} // namespace sbdd2
+
+#endif // SBDD2_CHAIN_ZDD_HPP
@@ -27,9 +27,12 @@ namespace sbdd2 {
 class BDD;
 class ZDD;
 class DDBase;
+class DDManager;
 class DDNodeRef;
 class MTBDDTerminalTableBase;
+class TraceRecorder;
 template<typename T> class MTBDDTerminalTable;
+namespace bench { struct ManagerAccess; }
 
 /**
  * @name デフォルトサイズ定数
@@ -50,8 +53,11 @@ enum class CacheOp : std::uint8_t {
     XOR = 2,        ///< 排他的論理和（BDD）
     DIFF = 3,       ///< 差（BDD: f & ~g, ZDD: f - g）
     ITE = 4,        ///< if-then-else（BDD）
-    RESTRICT = 5,   ///< 制限演算
+    RESTRICT = 5,   ///< 制限演算（キューブのBDDをキーとする）
     COMPOSE = 6,    ///< 合成演算
+    ONSET = 7,      ///< ZDD onset（変数集合のZDDをキーとする）
+    OFFSET = 8,     ///< ZDD offset（同上）
+    CHANGE = 9,     ///< ZDD change（同上）
     // ZDD specific
     PRODUCT = 10,   ///< 直積（ZDD）
     QUOTIENT = 11,  ///< 商（ZDD）
@@ -67,6 +73,12 @@ enum class CacheOp : std::uint8_t {
     SYM_SET = 20,       ///< ZDD対称集合
     CO_IMPLY_SET = 21,  ///< ZDD逆インプリケーション集合
     MEET = 22,          ///< ZDD Meet演算
+    MAXIMAL = 23,       ///< ZDD極大集合族
+    MINIMAL = 24,       ///< ZDD極小集合族
+    NONSUP = 25,        ///< ZDD非上位集合族
+    NONSUB = 26,        ///< ZDD非部分集合族
+    SHIFT = 27,         ///< ZDD変数番号シフト（射影付き）
+    UNION3 = 28,        ///< ZDD三項和集合（直積の内部演算）
     // MTBDD/MTZDD operations
     MTBDD_PLUS = 30,    ///< MTBDD加算
     MTBDD_MINUS = 31,   ///< MTBDD減算
@@ -74,6 +86,16 @@ enum class CacheOp : std::uint8_t {
     MTBDD_MIN = 33,     ///< MTBDD最小値
     MTBDD_MAX = 34,     ///< MTBDD最大値
     MTBDD_ITE = 35,     ///< MTBDD ITE演算
+    // Conversion
+    ZDD_TO_BDD = 36,    ///< ZDD→BDD変換（台集合の最上位レベルをキーとする）
+    BDD_TO_ZDD = 37,    ///< BDD→ZDD変換（同上）
+    // Chain-reduced ZDD
+    CHAIN_UNION = 38,       ///< ChainZDD 和集合（連鎖を切ったレベルをキーとする）
+    CHAIN_INTERSECT = 39,   ///< ChainZDD 積集合（同上）
+    CHAIN_DIFF = 40,        ///< ChainZDD 差集合（同上）
+    // Relational product
+    AND_EXIST = 41,     ///< 論理積と存在量化（量化変数のキューブを第3キーとする）
+    CONSTRAIN = 42,     ///< 一般化余因子 (constrain)
     // Custom
     CUSTOM = 255    ///< カスタム操作
 };
@@ -102,6 +124,120 @@ struct CacheEntry {
     }
 };
 
+/**
+ * @brief CacheOp の名前を取得
+ * @param op 操作タイプ
+ * @return "AND", "UNION" などの名前（未知の値なら "UNKNOWN"）
+ */
+const char* cache_op_name(CacheOp op);
+
+/**
+ * @brief 演算種別ごとのプロファイル
+ *
+ * DDManager::profile_report() の要素。
+ *
+ * @see DDManager::profile_report()
+ */
+struct OpProfile {
+    CacheOp op;                   ///< 操作タイプ
+    std::uint64_t calls;          ///< 再帰呼び出し数（終端で決まらない部分問題の数）
+    std::uint64_t cache_hits;     ///< そのうちキャッシュで解決した数
+    std::uint64_t nodes_created;  ///< 最外の呼び出しの間にそのスレッドが作ったノード数
+    double time_ms;               ///< 最外の呼び出しの経過時間の合計（ミリ秒）
+};
+
+/**
+ * @brief 演算種別ごとのプロファイルカウンタ（計測マクロ用の内部構造体）
+ *
+ * DDManager のレイアウトを SBDD2_ENABLE_PROFILING に依存させないため、
+ * 常に定義する。
+ *
+ * @see profile.hpp
+ */
+struct ProfileCounters {
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> cache_hits{0};
+    std::atomic<std::uint64_t> nodes_created{0};
+    std::atomic<std::uint64_t> time_ns{0};
+};
+
+/**
+ * @brief DDManager::memory_usage() の内訳（バイト数）
+ *
+ * 各構造体が確保している容量（capacity）に基づく値。ハッシュ表はバケット配列と
+ * 要素ごとのノード（要素＋次ポインタ）として見積もる。
+ */
+struct MemoryUsage {
+    std::size_t node_table;       ///< ノードテーブル（検索用のハッシュ索引を含む）
+    std::size_t cache;            ///< 演算キャッシュ
+    std::size_t unlinked_nodes;   ///< トップダウン構築用の未登録ノード
+    std::size_t avail;            ///< 空きスロットリスト
+    std::size_t variables;        ///< 変数とレベルの対応表
+    std::size_t mtbdd_terminals;  ///< MTBDD/MTZDD終端テーブル
+    std::size_t zdd_index;        ///< ZDDのインデックス（ZDDIndexData, ZDDExactIndexData）
+    std::size_t bddct_cache;      ///< BDDCTのキャッシュ
+
+    /// 合計バイト数
+    std::size_t total() const {
+        return node_table + cache + unlinked_nodes + avail + variables +
+               mtbdd_terminals + zdd_index + bddct_cache;
+    }
+};
+
+/**
+ * @brief マネージャーの外で確保され、マネージャーに計上される補助構造体の種別
+ */
+enum class AuxMemory : std::uint8_t {
+    ZDD_INDEX = 0,    ///< ZDDのインデックス
+    BDDCT_CACHE = 1   ///< BDDCTのキャッシュ
+};
+
+/**
+ * @brief 補助構造体の使用量をマネージャーに計上するハンドル
+ *
+ * 補助構造体のメンバとして持ち、サイズが変わったら update() を呼ぶ。
+ * 破棄時に計上分を取り消す。コピーは計上を引き継がない（コピー先は未計上から始まる）。
+ *
+ * @see DDManager::memory_usage()
+ */
+class MemoryAccount {
+public:
+    MemoryAccount() : manager_(nullptr), kind_(AuxMemory::ZDD_INDEX), bytes_(0) {}
+    MemoryAccount(const MemoryAccount&) : MemoryAccount() {}
+    MemoryAccount& operator=(const MemoryAccount&) { return *this; }
+    ~MemoryAccount() { release(); }
+
+    /**
+     * @brief 計上額を bytes に置き換える
+     * @param mgr 計上先のマネージャー（nullptrなら計上しない）
+     * @param kind 種別
+     * @param bytes 現在のバイト数
+     */
+    void update(DDManager* mgr, AuxMemory kind, std::size_t bytes);
+
+    /// 計上を取り消す
+    void release();
+
+    /// 現在の計上額
+    std::size_t bytes() const { return bytes_; }
+
+private:
+    DDManager* manager_;
+    AuxMemory kind_;
+    std::size_t bytes_;
+};
+
+/**
+ * @brief unordered_map / unordered_set の使用量の見積もり（内部用）
+ * @param table ハッシュ表
+ * @return バケット配列と要素ノード（要素＋次ポインタ）のバイト数
+ */
+template<typename HashTable>
+std::size_t hash_table_bytes(const HashTable& table) {
+    return table.bucket_count() * sizeof(void*) +
+           table.size() * (sizeof(typename HashTable::value_type) + sizeof(void*));
+}
+
 /**
  * @brief DDマネージャークラス
  *
@@ -109,7 +245,7 @@ struct CacheEntry {
  * 中心的なクラスです。
  *
  * 主な機能:
- * - ノードテーブル管理（内部ハッシュ法、二次探索）
+ * - ノードテーブル管理（ノードを移動しないブロック列と、1つのハッシュ索引）
  * - 変数の作成と管理
  * - 演算キャッシュ
  * - 参照カウントによるメモリ管理
@@ -164,6 +300,51 @@ public:
 
     /// @}
 
+    /// @name スナップショット
+    /// @{
+
+    /**
+     * @brief このマネージャーを土台とする子マネージャーを作る
+     * @param node_table_size 子が自分のノードのために持つテーブルのサイズ
+     * @param cache_size 子の演算キャッシュのサイズ
+     * @return 子マネージャー
+     *
+     * 子はこのマネージャーのノードテーブルをコピーせずに読み、新しいノードは
+     * 自分のテーブルにだけ作る。子を破棄すれば子の作ったノードはまとめて消え、
+     * 土台には何も残らない。変数とその順序は作成時点のものを引き継ぐ。
+     *
+     * 土台のDDは transfer() で子に渡す（ノードの複製は行わない）。
+     * 子同士は独立なので、複数の子を別々のスレッドで同時に使ってよい。
+     *
+     * 子が生存している間、このマネージャーは GC を行わず、GC で空いたスロットも再利用しない。
+     * テーブルの拡張は行うが、作成時点のテーブルの範囲外に作られたノードは子からは見えず、
+     * transfer() はそのようなDDを子にコピーする。また子の使用と並行してこのマネージャーを変更してはならず、
+     * 子より先に破棄・ムーブしてはならない。MTBDD/MTZDD の終端表は共有しない。
+     *
+     * @code{.cpp}
+     * ZDD base_family = ...;                     // mgr 上の大きなZDD
+     * std::unique_ptr<DDManager> child = mgr.fork(1 << 16);
+     * ZDD f = transfer(base_family, *child);     // O(1)
+     * ZDD g = f.onset(3) + f.offset(5);          // 新しいノードは child 側に作られる
+     * child.reset();                             // 破棄しても mgr は変わらない
+     * @endcode
+     *
+     * @see base_manager(), fork_count()
+     */
+    std::unique_ptr<DDManager> fork(std::size_t node_table_size = DEFAULT_NODE_TABLE_SIZE,
+                                    std::size_t cache_size = DEFAULT_CACHE_SIZE);
+
+    /// fork() の土台のマネージャー（fork() で作られていなければ nullptr）
+    DDManager* base_manager() const { return base_; }
+
+    /// 生存している子マネージャーの数
+    std::size_t fork_count() const { return forks_.load(); }
+
+    /// 土台のノードのうちこのマネージャーから読めるインデックスの上限（fork() 時点の土台のテーブル分）
+    std::size_t base_index_limit() const { return base_size_; }
+
+    /// @}
+
     /// @name 変数管理
     /// @{
 
@@ -211,6 +392,25 @@ public:
      */
     bddvar new_var_of_lev(bddvar lev);
 
+    /**
+     * @brief 複数の新しい変数を既存の変数より上のレベルにまとめて作成
+     * @param levs levs[i] が変数 m + 1 + i のレベル（m は作成前の変数の数）
+     * @return 作成された最初の変数番号（m + 1）
+     * @throw DDArgumentException levs が m+1..m+n の順列でない場合
+     *
+     * new_var_of_lev() を繰り返すとレベルのシフトに変数1つあたり O(n) かかるが、
+     * こちらは対応表を1回で作るので O(n) で済む。
+     *
+     * @code{.cpp}
+     * DDManager mgr;
+     * mgr.new_var();                 // 変数1, レベル1
+     * mgr.new_vars_of_levs({3, 2});  // 変数2はレベル3, 変数3はレベル2
+     * @endcode
+     *
+     * @see new_var_of_lev(), ordering::apply()
+     */
+    bddvar new_vars_of_levs(const std::vector<bddvar>& levs);
+
     /**
      * @brief 変数番号からレベルを取得
      * @param v 変数番号
@@ -428,9 +628,25 @@ public:
      * @param arc1 1枝アーク
      * @param reduced 既約フラグ
      * @return ノードへのアーク（既存または新規）
+     * @throws DDArgumentException 否定枝を渡した場合（ZDDは否定枝を持たない）
      */
     Arc get_or_create_node_zdd(bddvar var, Arc arc0, Arc arc1, bool reduced = true);
 
+    /**
+     * @brief ChainZDD の連鎖ノードの先頭を取得または作成
+     * @param var 連鎖の最上位レベルの変数番号
+     * @param lo 連鎖の 0-枝
+     * @param tail 連鎖の末尾ノード（否定しない）
+     * @return 先頭ノードへのアーク
+     *
+     * 先頭は 1-arc に tail への否定枝を持つノードとして格納される。
+     * ZDD・BDD のノードは 1-arc を否定しないので、DDNode::is_chain_head() で
+     * 通常のノードと区別できる。
+     *
+     * @see ChainZDD
+     */
+    Arc get_or_create_chain_head(bddvar var, Arc lo, Arc tail);
+
     /**
      * @brief MTBDDノードを取得または作成（BDD縮約規則）
      *
@@ -558,11 +774,56 @@ public:
     /// @name ガベージコレクション
     /// @{
 
-    /// 強制的にGCを実行
-    void gc();
+    /**
+     * @brief 強制的にGCを実行
+     * @return GCを実行したらtrue。fork() した子が生存している間と並列演算の区間内は
+     *         ノードを回収できないので、何もせずにfalseを返す
+     */
+    bool gc();
 
-    /// 必要に応じてGCを実行
-    void gc_if_needed();
+    /**
+     * @brief 充填率が閾値を超えていればGCを実行
+     * @return GCを実行したらtrue（閾値以下の場合と、gc() が実行できない場合はfalse）
+     */
+    bool gc_if_needed();
+
+    /**
+     * @brief GCの世代番号
+     * @return GCのたびに増加する値
+     *
+     * ノードが回収されるとアークは無効になるため、
+     * マネージャー外でアークを保持するキャッシュはこの値の変化で破棄を判定する。
+     */
+    std::uint64_t gc_epoch() const { return gc_epoch_; }
+
+    /// @}
+
+    /// @name 並列演算
+    /// @{
+
+    /**
+     * @brief ZDD直積を並列実行するサイズの下限を設定
+     * @param nodes 2つのオペランドの合計ノード数がこの値以上なら、上位レベルの
+     *              部分直積を別スレッドで実行する（0で無効、デフォルト）
+     *
+     * 並列実行中のタスクはノードテーブルと演算キャッシュを共有する。
+     * テーブルの拡張はノードを移動しないので、実行中に拡張が起きてもよい。
+     */
+    void set_parallel_cutoff(std::size_t nodes) { parallel_cutoff_ = nodes; }
+
+    /// ZDD直積を並列実行するサイズの下限（0なら無効）
+    std::size_t parallel_cutoff() const { return parallel_cutoff_; }
+
+    /**
+     * @brief 複数のタスクがノードテーブルを共有する区間の開始（内部API）
+     *
+     * タスクはロックなしでノードを読むため、区間内では見つかった既存ノードの
+     * 参照カウントを変更せず、GCも行わない。end_parallel() と対にして呼ぶ。入れ子にしてよい。
+     */
+    void begin_parallel() { ++parallel_ops_; }
+
+    /// 複数のタスクがノードテーブルを共有する区間の終了（内部API）
+    void end_parallel() { --parallel_ops_; }
 
     /// @}
 
@@ -578,6 +839,9 @@ public:
     /// テーブルサイズ
     std::size_t table_size() const { return table_size_; }
 
+    /// ノードインデックスの上限（fork() した子では土台のテーブル分を含む）
+    std::size_t node_index_limit() const { return base_size_ + table_size_; }
+
     /// キャッシュサイズ
     std::size_t cache_size() const { return cache_size_; }
 
@@ -587,6 +851,94 @@ public:
      */
     double load_factor() const;
 
+    /// 演算キャッシュのヒット数（reset_stats() 以降）
+    std::size_t cache_hit_count() const { return cache_hits_; }
+
+    /// 演算キャッシュのミス数（reset_stats() 以降）
+    std::size_t cache_miss_count() const { return cache_misses_; }
+
+    /// ノード数の最大値（reset_stats() 以降）
+    std::size_t peak_node_count() const { return peak_node_count_; }
+
+    /**
+     * @brief キャッシュのヒット・ミス数とピークノード数をリセット
+     *
+     * ピークノード数は現在のノード数から数え直す。
+     */
+    void reset_stats();
+
+    /**
+     * @brief メモリ使用量の内訳を取得
+     * @return 構造体ごとのバイト数
+     *
+     * ZDDのインデックスとBDDCTのキャッシュは、このマネージャーのノードを参照する
+     * オブジェクトが生存している間の分を含む。
+     *
+     * @see peak_memory_usage()
+     */
+    MemoryUsage memory_usage() const;
+
+    /**
+     * @brief メモリ使用量の最大値（MemoryUsage::total() の高水位）
+     * @return バイト数
+     *
+     * テーブル拡張時、未登録ノードや
+     * 補助構造体の増加時、および memory_usage() の呼び出し時に更新される。
+     */
+    std::size_t peak_memory_usage() const { return peak_memory_.load(); }
+
+    /**
+     * @brief 補助構造体の使用量を加減する（MemoryAccount 用の内部API）
+     * @param kind 種別
+     * @param delta 増減するバイト数
+     */
+    void account_aux_memory(AuxMemory kind, std::ptrdiff_t delta);
+
+    /**
+     * @brief 演算種別ごとのプロファイルを取得
+     * @return 呼び出しのあった演算のカウンタ（CacheOp の値の順）
+     *
+     * SBDD2_ENABLE_PROFILING を定義してビルドした場合に、bdd_apply, bdd_ite,
+     * ZDDの二項演算（和・積・差・直積・商）と MTBDD/MTZDD の apply が計測される。
+     * 定義しない場合は計測コードが消え、常に空のベクタを返す。
+     *
+     * nodes_created と time_ms は同じ演算の最外の呼び出しについてのみ数える。
+     * nodes_created はノードテーブルへの挿入時に、挿入したスレッドで実行中の
+     * 演算に加算するので、他のスレッドが同時に作ったノードは含まれない。
+     *
+     * @see profiling_enabled(), reset_profile()
+     */
+    std::vector<OpProfile> profile_report() const;
+
+    /// プロファイルカウンタをすべて0にする
+    void reset_profile();
+
+    /// ライブラリが SBDD2_ENABLE_PROFILING 付きでビルドされているか
+    static bool profiling_enabled();
+
+    /**
+     * @brief 操作タイプのカウンタ（計測マクロ用の内部API）
+     * @return ライブラリが計測なしでビルドされている場合は nullptr
+     */
+    ProfileCounters* profile_counters(CacheOp op) {
+        return profile_ ? &profile_[static_cast<std::size_t>(op)] : nullptr;
+    }
+
+    /**
+     * @brief 演算イベントの記録器を取り付ける
+     * @param recorder 記録器（nullptr で取り外す）。所有権は移らない
+     *
+     * 取り付けている間、BDD/ZDDの二項演算子、build_zdd/build_bdd、GC、
+     * ノードテーブルの拡張、import_* の開始と終了が記録される。
+     * 記録器はマネージャーから取り外すまで生存していなければならない。
+     *
+     * @see TraceRecorder
+     */
+    void set_trace_recorder(TraceRecorder* recorder) { trace_recorder_ = recorder; }
+
+    /// 取り付けられている記録器（なければ nullptr）
+    TraceRecorder* trace_recorder() const { return trace_recorder_.load(std::memory_order_relaxed); }
+
     /// @}
 
     /// @name キャッシュ操作
@@ -663,8 +1015,17 @@ public:
     /// @}
 
 private:
-    // Node table (internal hash with quadratic probing)
-    std::vector<DDNode> nodes_;
+    // Node table: nodes live in a chain of blocks so that growing never
+    // moves a node (node_at() readers need no lock). Block 0 has the initial
+    // size and block k >= 1 holds as many slots as all blocks before it.
+    // Slots are handed out in index order, or reused from avail_ after GC,
+    // and looked up through one open-addressing hash index over the table.
+    static constexpr int MAX_NODE_BLOCKS = 48;
+    std::unique_ptr<DDNode[]> node_blocks_[MAX_NODE_BLOCKS];
+    int node_block_count_;
+    int block0_shift_;                  // Block 0 has 1 << block0_shift_ slots
+    std::size_t next_slot_;             // Slots [0, next_slot_) have been handed out
+    std::vector<bddindex> hash_index_;  // Slot + 1 per bucket, 0 if empty
     std::size_t table_size_;
     std::size_t node_count_;      // Total nodes in table (including tombstones)
     std::size_t alive_count_;     // Nodes with refcount > 0
@@ -672,7 +1033,7 @@ private:
     // Unlinked nodes for top-down construction (TdZdd support)
     std::vector<DDNode> unlinked_nodes_;
 
-    // Avail list (indices of available slots)
+    // Avail list (slots freed by GC)
     std::vector<bddindex> avail_;
 
     // Operation cache
@@ -701,31 +1062,134 @@ private:
     double gc_threshold_;
     std::size_t gc_min_nodes_;
 
+    // Parallel ZDD join cutoff (0 = sequential)
+    std::size_t parallel_cutoff_;
+
+    // Incremented whenever nodes are swept
+    std::uint64_t gc_epoch_;
+
+    // Statistics (cache counters are updated under cache_mutex_)
+    mutable std::size_t cache_hits_;
+    mutable std::size_t cache_misses_;
+    std::size_t peak_node_count_;
+
+    // One entry per CacheOp value; null unless the library is built with
+    // SBDD2_ENABLE_PROFILING (the member exists either way to fix the layout)
+    std::unique_ptr<ProfileCounters[]> profile_;
+
+    // Bytes of auxiliary structures (per AuxMemory) and the high-water mark
+    std::atomic<std::size_t> aux_memory_[2];
+    mutable std::atomic<std::size_t> peak_memory_;
+
+    // Optional event recorder (not owned)
+    std::atomic<TraceRecorder*> trace_recorder_;
+
+    // fork(): indices below base_size_ live in base_'s table, ours are offset
+    DDManager* base_;
+    std::size_t base_size_;
+    std::atomic<std::size_t> forks_;
+
+    // Nesting depth of begin_parallel()
+    std::atomic<std::size_t> parallel_ops_;
+
+    // Take a reference on a node found by find_node (base nodes are not counted)
+    void ref_found(bddindex idx);
+
+    // Raise peak_memory_ to the current usage plus `transient` bytes
+    void note_memory(std::size_t transient = 0) const;
+
     // Internal hash function
     std::size_t hash_node(bddvar var, Arc arc0, Arc arc1) const;
 
+    // Slot of a local index (block, offset)
+    const DDNode& slot(std::size_t i) const;
+    DDNode& slot(std::size_t i);
+
     // Find or create node (internal)
     bddindex find_node(bddvar var, Arc arc0, Arc arc1) const;
     bddindex insert_node(bddvar var, Arc arc0, Arc arc1, bool reduced);
 
+    // Hash index maintenance
+    void index_insert(std::size_t slot_index);
+    void rebuild_index();
+
     // Resize table when needed
     void resize_table();
 
-    // GC helper
-    void mark_and_sweep();
+    // GC helper (false if GC is not allowed now)
+    bool mark_and_sweep();
     void mark_arc(Arc arc, std::vector<bool>& marked);
+
+    // Microbenchmarks (bench/micro_bench.cpp) drive the table primitives
+    friend struct bench::ManagerAccess;
 };
 
 /**
  * @brief デフォルトマネージャーを取得
- * @return グローバルなデフォルトDDManager
+ * @return 呼び出したスレッドに束縛されたDDManager、なければグローバルなDDManager
  *
- * @note シングルスレッド環境での簡易使用を想定
+ * ScopedManager で束縛されたマネージャーがあればそれを返す。
+ * なければプロセス全体で共有するマネージャーを返す（初回呼び出しで生成）。
+ * 生成は複数スレッドから同時に呼ばれても1回だけ行われる。
  *
- * @see DDManager
+ * @see ScopedManager, bound_manager()
  */
 DDManager& default_manager();
 
+/**
+ * @brief 呼び出したスレッドに束縛されたマネージャーを取得
+ * @return 束縛されたDDManager、なければ nullptr
+ */
+DDManager* bound_manager();
+
+/**
+ * @brief スコープの間、スレッドのデフォルトマネージャーを差し替える
+ *
+ * 生存している間、同じスレッドの default_manager() は束縛したマネージャーを返す。
+ * 入れ子にでき、破棄すると直前の束縛に戻る。束縛はスレッドごとなので、
+ * ワーカースレッドごとに独立したマネージャーを使える。
+ *
+ * @code{.cpp}
+ * // ワーカーごとに専用のマネージャーを作って束縛する
+ * pool.run([] {
+ *     ScopedManager scope(1 << 16);
+ *     DDManager& mgr = default_manager();  // scope.manager() と同じ
+ *     ...
+ * });
+ * @endcode
+ */
+class ScopedManager {
+public:
+    /**
+     * @brief 既存のマネージャーを束縛する
+     * @param mgr 束縛するマネージャー（所有権は移らない）
+     */
+    explicit ScopedManager(DDManager& mgr);
+
+    /**
+     * @brief 新しいマネージャーを作って束縛する
+     * @param node_table_size ノードテーブルサイズ
+     * @param cache_size キャッシュサイズ
+     *
+     * 作ったマネージャーはスコープの終わりに破棄される。
+     */
+    explicit ScopedManager(std::size_t node_table_size = DEFAULT_NODE_TABLE_SIZE,
+                           std::size_t cache_size = DEFAULT_CACHE_SIZE);
+
+    ~ScopedManager();
+
+    ScopedManager(const ScopedManager&) = delete;
+    ScopedManager& operator=(const ScopedManager&) = delete;
+
+    /// 束縛しているマネージャー
+    DDManager& manager() const { return *manager_; }
+
+private:
+    std::unique_ptr<DDManager> owned_;
+    DDManager* manager_;
+    DDManager* previous_;
+};
+
 } // namespace sbdd2
 
 #endif // SBDD2_DD_MANAGER_HPP
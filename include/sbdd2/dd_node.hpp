@@ -155,6 +155,20 @@ public:
         high_ = (high_ & ~(VAR_MASK << VAR_SHIFT)) | (static_cast<std::uint64_t>(v) << VAR_SHIFT);
     }
 
+    /**
+     * @brief ChainZDD の連鎖ノードの先頭かどうかを判定する
+     * @return 1-arc が否定枝であれば true
+     *
+     * BDD は正規形で 1-arc を否定せず、ZDD は否定枝を持たないので、
+     * 1-arc の否定ビットは連鎖ノードの先頭だけに現れる。
+     * 先頭の 1-arc は連鎖の末尾ノードを指し、論理的な 1-枝ではない。
+     *
+     * @see DDManager::get_or_create_chain_head()
+     */
+    bool is_chain_head() const {
+        return arc1().is_negated();
+    }
+
     /**
      * @brief 簡約済みかどうかを判定する
      * @return 簡約済みであれば true
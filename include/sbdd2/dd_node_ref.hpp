@@ -160,11 +160,15 @@ public:
     /**
      * @brief 論理的な1-child（否定辺を考慮）を取得する
      * @return 1-child への DDNodeRef
+     * @throws DDArgumentException ChainZDD の連鎖ノードの先頭の場合
      *
      * このノードへの辺に否定が付いている場合、子の否定フラグを反転します。
+     * 連鎖ノードの先頭の論理的な 1-child（1つ下のレベルから始まる連鎖）は
+     * ノードとして存在しないため、例外を送出します。
      *
      * @see raw_child1()
      * @see child0()
+     * @see DDNode::is_chain_head()
      */
     DDNodeRef child1() const;
 
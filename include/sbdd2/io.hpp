@@ -233,6 +233,8 @@ bool validate_bdd(const BDD& bdd);
  * @brief ZDDの整合性を検証する
  * @param zdd 検証するZDD
  * @return 整合性が正しければtrue、不正な場合はfalse
+ *
+ * 否定枝を含む場合（ChainZDD のルートから作った ZDD など）も false を返す。
  * @see validate_bdd
  */
 bool validate_zdd(const ZDD& zdd);
@@ -266,6 +268,7 @@ ZDD import_zdd_as_graphillion(DDManager& mgr, const std::string& filename, int r
  * @param os 出力ストリーム
  * @param root_level ルートレベル（-1で自動設定）
  * @see import_zdd_as_graphillion
+ * @throws DDArgumentException 否定枝を含む場合（ChainZDD の連鎖ノードは出力できない）
  */
 void export_zdd_as_graphillion(const ZDD& zdd, std::ostream& os, int root_level = -1);
 
@@ -275,6 +278,7 @@ void export_zdd_as_graphillion(const ZDD& zdd, std::ostream& os, int root_level
  * @param filename 出力ファイルパス
  * @param root_level ルートレベル（-1で自動設定）
  * @see import_zdd_as_graphillion
+ * @throws DDArgumentException 否定枝を含む場合（ChainZDD の連鎖ノードは出力できない）
  */
 void export_zdd_as_graphillion(const ZDD& zdd, const std::string& filename, int root_level = -1);
 
@@ -309,6 +313,7 @@ ZDD import_zdd_as_knuth(DDManager& mgr, const std::string& filename, bool is_hex
  * @param os 出力ストリーム
  * @param is_hex trueの場合、16進数形式で出力する
  * @see import_zdd_as_knuth
+ * @throws DDArgumentException 否定枝を含む場合（ChainZDD の連鎖ノードは出力できない）
  */
 void export_zdd_as_knuth(const ZDD& zdd, std::ostream& os, bool is_hex = false);
 
@@ -318,6 +323,7 @@ void export_zdd_as_knuth(const ZDD& zdd, std::ostream& os, bool is_hex = false);
  * @param filename 出力ファイルパス
  * @param is_hex trueの場合、16進数形式で出力する
  * @see import_zdd_as_knuth
+ * @throws DDArgumentException 否定枝を含む場合（ChainZDD の連鎖ノードは出力できない）
  */
 void export_zdd_as_knuth(const ZDD& zdd, const std::string& filename, bool is_hex = false);
 
@@ -393,6 +399,7 @@ void export_bdd_as_libbdd(const BDD& bdd, const std::string& filename);
  * @param zdd エクスポートするZDD
  * @param os 出力ストリーム
  * @see import_zdd_as_libbdd
+ * @throws DDArgumentException 否定枝を含む場合（ChainZDD の連鎖ノードは出力できない）
  */
 void export_zdd_as_libbdd(const ZDD& zdd, std::ostream& os);
 
@@ -401,6 +408,7 @@ void export_zdd_as_libbdd(const ZDD& zdd, std::ostream& os);
  * @param zdd エクスポートするZDD
  * @param filename 出力ファイルパス
  * @see import_zdd_as_libbdd
+ * @throws DDArgumentException 否定枝を含む場合（ChainZDD の連鎖ノードは出力できない）
  */
 void export_zdd_as_libbdd(const ZDD& zdd, const std::string& filename);
 
@@ -438,6 +446,7 @@ struct SvgExportOptions {
  * @param os 出力ストリーム
  * @param options SVGエクスポートオプション
  * @see SvgExportOptions
+ * @throws DDArgumentException 否定枝を含む場合（ChainZDD の連鎖ノードは出力できない）
  */
 void export_zdd_as_svg(const ZDD& zdd, std::ostream& os,
                        const SvgExportOptions& options = SvgExportOptions());
@@ -448,6 +457,7 @@ void export_zdd_as_svg(const ZDD& zdd, std::ostream& os,
  * @param filename 出力ファイルパス
  * @param options SVGエクスポートオプション
  * @see SvgExportOptions
+ * @throws DDArgumentException 否定枝を含む場合（ChainZDD の連鎖ノードは出力できない）
  */
 void export_zdd_as_svg(const ZDD& zdd, const std::string& filename,
                        const SvgExportOptions& options = SvgExportOptions());
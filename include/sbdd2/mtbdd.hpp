@@ -11,6 +11,7 @@
 #define SBDD2_MTBDD_HPP
 
 #include "mtdd_base.hpp"
+#include "profile.hpp"
 #include "bdd.hpp"
 #include <functional>
 
@@ -257,6 +258,7 @@ public:
         }
 
         MTBDDTerminalTable<T>& table = manager_->template get_or_create_terminal_table<T>();
+        SBDD2_PROFILE_SCOPE(manager_, cache_op);
         Arc result = apply_impl(manager_, table, arc_, other.arc_, op, cache_op, false);
         return MTBDD(manager_, result);
     }
@@ -384,7 +386,9 @@ private:
 
         // キャッシュを検索
         Arc result;
+        SBDD2_PROFILE_CALL(mgr, cache_op);
         if (cache_op != CacheOp::CUSTOM && mgr->cache_lookup(cache_op, f, g, result)) {
+            SBDD2_PROFILE_HIT(mgr, cache_op);
             return result;
         }
 
@@ -32,6 +32,9 @@ public:
 
     /// 登録済み終端値の数
     virtual std::size_t size() const = 0;
+
+    /// テーブルが使用しているバイト数（見積もり）
+    virtual std::size_t memory_usage() const = 0;
 };
 
 /**
@@ -114,6 +117,14 @@ public:
         return values_.size();
     }
 
+    /**
+     * @brief テーブルが使用しているバイト数（見積もり）
+     */
+    std::size_t memory_usage() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return values_.capacity() * sizeof(T) + hash_table_bytes(value_to_index_);
+    }
+
     /**
      * @brief ゼロ終端のインデックス
      *
@@ -11,6 +11,7 @@
 #define SBDD2_MTZDD_HPP
 
 #include "mtdd_base.hpp"
+#include "profile.hpp"
 #include "zdd.hpp"
 #include <functional>
 
@@ -265,6 +266,7 @@ public:
         }
 
         MTBDDTerminalTable<T>& table = manager_->template get_or_create_terminal_table<T>();
+        SBDD2_PROFILE_SCOPE(manager_, cache_op);
         Arc result = apply_impl(manager_, table, arc_, other.arc_, op, cache_op);
         return MTZDD(manager_, result);
     }
@@ -388,7 +390,9 @@ private:
 
         // キャッシュを検索
         Arc result;
+        SBDD2_PROFILE_CALL(mgr, cache_op);
         if (cache_op != CacheOp::CUSTOM && mgr->cache_lookup(cache_op, f, g, result)) {
+            SBDD2_PROFILE_HIT(mgr, cache_op);
             return result;
         }
 
@@ -0,0 +1,164 @@
+/**
+ * @file mvbdd_saturation.hpp
+ * @brief SAPPOROBDD 2.0 - MVBDD の飽和法による到達可能状態の計算
+ * @copyright MIT License
+ *
+ * 局所性で分割したイベントの集合を遷移関係とし、
+ * 多値変数の状態空間の到達可能状態を飽和法 (saturation, Ciardo ら) で求めます。
+ */
+
+#ifndef SBDD2_MVBDD_SATURATION_HPP
+#define SBDD2_MVBDD_SATURATION_HPP
+
+#include "mvbdd.hpp"
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace sbdd2 {
+
+/**
+ * @brief 多値変数の状態に対するイベント（局所的な遷移）
+ *
+ * イベントは、いくつかの MVDD 変数についての局所的な遷移 (from → to) の組で表します。
+ * add() で遷移を登録した変数をイベントが「触る」変数と呼びます。
+ * - 触る変数のすべてで、現在の値を from とする遷移があるときにイベントが発火できる。
+ * - 発火すると、触る変数はそれぞれ対応する to の値に変わり、それ以外の変数は変わらない。
+ *
+ * 同じ変数に複数の遷移を登録すると、そのどれでも発火できます（非決定的な遷移）。
+ * 触る変数の遷移は互いに独立です（Kronecker 積の形の遷移関係）。
+ *
+ * @code{.cpp}
+ * // 変数1 が 1 以上なら 1 減らし、変数2 を 1 増やす（k=3）
+ * MVEvent move;
+ * move.add(1, 1, 0).add(1, 2, 1);
+ * move.add(2, 0, 1).add(2, 1, 2);
+ * @endcode
+ *
+ * @see MVBDDSaturation
+ */
+class MVEvent {
+public:
+    /// 局所的な遷移 (from, to) のリスト
+    using LocalTransitions = std::vector<std::pair<int, int> >;
+
+    /**
+     * @brief 局所的な遷移を追加
+     * @param mv MVDD変数番号
+     * @param from 遷移前の値
+     * @param to 遷移後の値
+     * @return *this
+     */
+    MVEvent& add(bddvar mv, int from, int to) {
+        local_[mv].push_back(std::make_pair(from, to));
+        return *this;
+    }
+
+    /**
+     * @brief 変数ごとの局所的な遷移
+     * @return MVDD変数番号から遷移のリストへのマップ
+     */
+    const std::map<bddvar, LocalTransitions>& locals() const { return local_; }
+
+private:
+    std::map<bddvar, LocalTransitions> local_;
+};
+
+/**
+ * @brief 飽和法による MVBDD の到達可能状態の計算
+ *
+ * 状態は MVBDD の変数への値の割当、状態集合は MVBDD で表します。
+ * MVDD 変数を内部DD変数のレベル順に並べ、各イベントについて
+ * 触る変数のうち最も上のもの（Top）と最も下のもの（Bot）を求めておきます。
+ *
+ * 飽和法は MVBDD のノードを下から順に「飽和」させます。
+ * ある変数のノードは、子をすべて飽和させたあと、Top がその変数である
+ * イベントを不動点まで発火させて飽和させます。Top がより上のイベントは、
+ * 上のノードを飽和させるときに初めて扱います。
+ * 幅優先探索のように全体の像を繰り返し求めないため、
+ * 非同期的なシステムでは途中の MVBDD が小さく保たれます。
+ *
+ * 飽和させた結果と、イベントを発火させた結果は、MVDD 変数ごとのキャッシュに残し、
+ * 同じオブジェクトでの以後の計算で使い回します。
+ *
+ * @code{.cpp}
+ * DDManager mgr;
+ * MVBDD base = MVBDD::one(mgr, 3);
+ * for (int i = 0; i < 4; ++i) base.new_var();
+ * MVBDDSaturation sat(base, events);
+ * MVBDD reached = sat.reachable(init);
+ * @endcode
+ *
+ * @see MVEvent
+ * @see TransitionRelation
+ */
+class MVBDDSaturation {
+public:
+    /**
+     * @brief コンストラクタ
+     * @param base 変数マッピング情報を持つMVBDD
+     * @param events イベントのリスト
+     * @throws DDArgumentException base が無効な場合、イベントが無効な変数番号や
+     *         値域外の値を含む場合、MVDD 変数の内部DD変数のレベルが
+     *         他の MVDD 変数と入り組んでいる場合
+     */
+    MVBDDSaturation(const MVBDD& base, const std::vector<MVEvent>& events);
+
+    /**
+     * @brief 到達可能状態
+     * @param init 初期状態の集合
+     * @return init からイベントの列で到達できる状態の集合
+     * @throws DDArgumentException init が MVDD 変数以外の変数に依存する場合
+     */
+    MVBDD reachable(const MVBDD& init);
+
+    /**
+     * @brief 像（いずれかのイベントを1回発火させて到達できる状態）
+     * @param states 状態の集合
+     * @return 1ステップで到達できる状態の集合
+     * @throws DDArgumentException states が MVDD 変数以外の変数に依存する場合
+     */
+    MVBDD image(const MVBDD& states) const;
+
+    /**
+     * @brief キャッシュを消去する
+     */
+    void clear_cache();
+
+private:
+    /// キャッシュの項目（キーの BDD も保持して、ノードの再利用による誤りを防ぐ）
+    struct CacheEntry {
+        BDD key;
+        BDD value;
+    };
+    using LevelCache = std::unordered_map<std::uint64_t, CacheEntry>;
+
+    struct EventInfo {
+        std::size_t top;                                         ///< 触る変数の最上位レベル
+        std::size_t bot;                                         ///< 触る変数の最下位レベル
+        std::vector<const MVEvent::LocalTransitions*> local;    ///< レベルごとの遷移（触らなければ null）
+    };
+
+    MVBDD base_;
+    std::vector<MVEvent> events_;
+    std::vector<bddvar> level_var_;                   ///< レベル (1-indexed) → MVDD変数
+    std::vector<std::vector<BDD> > literals_;         ///< [レベル][値] のリテラル
+    std::vector<EventInfo> info_;
+    std::vector<std::vector<std::size_t> > by_top_;   ///< レベルごとの Top がそのレベルのイベント
+    std::vector<LevelCache> saturate_cache_;          ///< レベルごとの飽和の結果
+    std::vector<LevelCache> fire_cache_;              ///< [イベント * (レベル数 + 1) + レベル]
+
+    void check_states(const MVBDD& states) const;
+    BDD child(const BDD& f, std::size_t lev, int value) const;
+    BDD build(std::size_t lev, const std::vector<BDD>& children) const;
+    BDD saturate(std::size_t lev, const BDD& f);
+    BDD saturate_node(std::size_t lev, std::vector<BDD>& children);
+    BDD fire(std::size_t lev, const BDD& f, std::size_t e);
+    BDD fire_once(std::size_t lev, const BDD& f, std::size_t e,
+                  std::vector<std::unordered_map<std::uint64_t, BDD> >& memo) const;
+};
+
+} // namespace sbdd2
+
+#endif // SBDD2_MVBDD_SATURATION_HPP
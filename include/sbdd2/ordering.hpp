@@ -0,0 +1,137 @@
+/**
+ * @file ordering.hpp
+ * @brief SAPPOROBDD 2.0 - 静的な変数順序のヒューリスティック
+ * @copyright MIT License
+ *
+ * CNF の節や回路のゲートを超辺（ハイパーエッジ）とみなし、
+ * BDD を作る前に変数順序を決めるヒューリスティックを提供する。
+ * 同じ超辺に現れる変数を近いレベルに置くほど、BDD は小さくなりやすい。
+ */
+
+#ifndef SBDD2_ORDERING_HPP
+#define SBDD2_ORDERING_HPP
+
+#include "types.hpp"
+#include <vector>
+
+namespace sbdd2 {
+
+class DDManager;
+
+/**
+ * @brief 静的な変数順序のヒューリスティック
+ *
+ * 変数は 1 から n までの番号で表し、超辺は変数番号のリストで表す。
+ * CNF なら各節の変数、回路なら各ゲートの出力と入力の変数が1つの超辺になる。
+ *
+ * 各関数は変数順序を、根に近い変数から順に並べた 1..n の順列 order として返す。
+ * order[0] が最上位（根）、order[n-1] が最下位のレベルに置かれる変数である。
+ * apply() で、この順序どおりのレベルに変数を作成できる。
+ *
+ * @code{.cpp}
+ * std::vector<std::vector<int> > clauses = ...;   // DIMACS の節
+ * ordering::Hypergraph h = ordering::from_clauses(clauses);
+ * std::vector<bddvar> order = ordering::force(n, h, ordering::dfs(n, h));
+ *
+ * DDManager mgr;
+ * ordering::apply(mgr, order);   // 変数 1..n を order のレベルに作成
+ * @endcode
+ */
+namespace ordering {
+
+/// 超辺のリスト（各超辺は変数番号のリスト）
+using Hypergraph = std::vector<std::vector<bddvar> >;
+
+/**
+ * @brief CNF の節から超辺を作る
+ * @param clauses 節のリスト（DIMACS と同じく、正負のリテラル番号）
+ * @return 各節の変数（重複を除く）を超辺とした Hypergraph
+ * @throws DDArgumentException リテラル 0 を含む場合
+ */
+Hypergraph from_clauses(const std::vector<std::vector<int> >& clauses);
+
+/**
+ * @brief 深さ優先探索による順序
+ * @param n 変数の数
+ * @param edges 超辺のリスト
+ * @return 変数順序（根に近い順）
+ * @throws DDArgumentException 超辺が 1..n 以外の変数番号を含む場合
+ *
+ * 超辺を与えられた順に見て、まだ訪れていない変数から深さ優先探索を始める。
+ * 各変数からは、その変数を含む超辺を与えられた順にたどる。
+ * 回路ならゲートを出力側から並べておくと、出力から入力へたどる順序になる。
+ * どの超辺にも現れない変数は最後に番号順に置く。
+ */
+std::vector<bddvar> dfs(bddvar n, const Hypergraph& edges);
+
+/**
+ * @brief 幅優先探索による順序
+ * @param n 変数の数
+ * @param edges 超辺のリスト
+ * @return 変数順序（根に近い順）
+ * @throws DDArgumentException 超辺が 1..n 以外の変数番号を含む場合
+ * @see dfs()
+ */
+std::vector<bddvar> bfs(bddvar n, const Hypergraph& edges);
+
+/**
+ * @brief FORCE（Aloul–Markov–Sakallah）による順序
+ * @param n 変数の数
+ * @param edges 超辺のリスト
+ * @param initial 初期順序（空なら 1, 2, ..., n）
+ * @param max_iterations 反復回数の上限
+ * @return 変数順序（根に近い順）
+ * @throws DDArgumentException 超辺が 1..n 以外の変数番号を含む場合、
+ *         initial が 1..n の順列でない場合
+ *
+ * 各超辺の重心（含む変数の位置の平均）を求め、各変数をその変数を含む超辺の
+ * 重心の平均の位置へ動かす操作を繰り返す。超辺の幅の合計 (total_span())
+ * が減らなくなったら止め、それまでで最良の順序を返す。
+ * 局所的な改善なので、dfs() などの結果を初期順序にするとよい。
+ */
+std::vector<bddvar> force(bddvar n, const Hypergraph& edges,
+                          const std::vector<bddvar>& initial = std::vector<bddvar>(),
+                          int max_iterations = 100);
+
+/**
+ * @brief MINCE 風の再帰的二分割による順序
+ * @param n 変数の数
+ * @param edges 超辺のリスト
+ * @param passes 各二分割での改善パス（Fiduccia–Mattheyses）の回数の上限
+ * @return 変数順序（根に近い順）
+ * @throws DDArgumentException 超辺が 1..n 以外の変数番号を含む場合
+ *
+ * 変数の集合を、ほぼ同じ大きさの2つに分けて切られる超辺を減らすことを
+ * 再帰的に繰り返し、分割の順に変数を並べる。
+ * 初期分割には dfs() の順序を使い、Fiduccia–Mattheyses 法の移動で改善する。
+ * MINCE の hMETIS による分割を、この簡単な改善法で置き換えたものである。
+ */
+std::vector<bddvar> mince(bddvar n, const Hypergraph& edges, int passes = 2);
+
+/**
+ * @brief 超辺の幅の合計
+ * @param order 変数順序
+ * @param edges 超辺のリスト
+ * @return 各超辺について、含む変数の位置の最大値と最小値の差を足したもの
+ *
+ * 値が小さいほど、同じ超辺の変数が近くに置かれている。
+ */
+std::size_t total_span(const std::vector<bddvar>& order, const Hypergraph& edges);
+
+/**
+ * @brief 変数順序に従って変数を作成する
+ * @param mgr DDマネージャー
+ * @param order 変数順序（根に近い順、1..n の順列）
+ * @throws DDArgumentException order が 1..n の順列でない場合
+ *
+ * mgr に n 個の変数を追加する。追加前の変数の数を m とすると、
+ * order の変数 v は変数番号 m + v となり、既存の変数より上で order の順に並ぶ。
+ * DDManager::new_vars_of_levs() でまとめて作成するので O(n) で済む。
+ */
+void apply(DDManager& mgr, const std::vector<bddvar>& order);
+
+} // namespace ordering
+
+} // namespace sbdd2
+
+#endif // SBDD2_ORDERING_HPP
@@ -0,0 +1,120 @@
+/**
+ * @file profile.hpp
+ * @brief SAPPOROBDD 2.0 - 演算カーネルの計測マクロ
+ * @author SAPPOROBDD Team
+ * @copyright MIT License
+ *
+ * SBDD2_ENABLE_PROFILING を定義してビルドしたときだけ、演算カーネルに
+ * 呼び出し数・キャッシュヒット数・作成ノード数・経過時間の計測を埋め込む。
+ * 定義しない場合、マクロは空になり計測コストはない。
+ * DDManager のレイアウトはこの定義に依存しないので、定義の有無が異なる
+ * 翻訳単位を混ぜてもよい（計測されるのはライブラリが定義付きでビルドされ、
+ * かつマクロを展開した翻訳単位でも定義されていた演算だけ）。
+ * 結果は DDManager::profile_report() で取得する。
+ */
+
+#ifndef SBDD2_PROFILE_HPP
+#define SBDD2_PROFILE_HPP
+
+#include "dd_manager.hpp"
+
+#ifdef SBDD2_ENABLE_PROFILING
+#include <chrono>
+#endif
+
+namespace sbdd2 {
+
+#ifdef SBDD2_ENABLE_PROFILING
+
+/**
+ * @brief 演算の最外の呼び出しの時間と作成ノード数を計測するスコープ
+ *
+ * 同じ操作タイプのスコープが（同じスレッドで）入れ子になった場合は、
+ * 最外のスコープだけが記録するので二重に数えない。
+ * 作成ノード数は DDManager がノードを挿入するたびに note_node_created() で
+ * 数えるので、他のスレッドが作ったノードは含まない。
+ */
+class ProfileScope {
+public:
+    ProfileScope(DDManager* mgr, CacheOp op)
+        : mgr_(mgr), op_(op), outer_(depth(op)++ == 0), nodes_(0), prev_(nullptr) {
+        if (outer_) {
+            prev_ = top();
+            top() = this;
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ProfileScope() {
+        --depth(op_);
+        if (!outer_) return;
+        top() = prev_;
+        ProfileCounters* c = mgr_->profile_counters(op_);
+        if (!c) return;
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        c->time_ns.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+            std::memory_order_relaxed);
+        c->nodes_created.fetch_add(nodes_, std::memory_order_relaxed);
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    /// mgr にノードが1つ挿入されたことを、このスレッドで実行中の演算に数える
+    static void note_node_created(const DDManager* mgr) {
+        for (ProfileScope* s = top(); s; s = s->prev_) {
+            if (s->mgr_ == mgr) ++s->nodes_;
+        }
+    }
+
+private:
+    static unsigned& depth(CacheOp op) {
+        static thread_local unsigned depths[256];
+        return depths[static_cast<std::size_t>(op)];
+    }
+
+    // Innermost outer scope of this thread; scopes are strictly nested
+    static ProfileScope*& top() {
+        static thread_local ProfileScope* scope = nullptr;
+        return scope;
+    }
+
+    DDManager* mgr_;
+    CacheOp op_;
+    bool outer_;
+    std::uint64_t nodes_;
+    ProfileScope* prev_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+/// 計測マクロ用: ライブラリが計測なしでビルドされていれば何もしない
+inline void profile_count(DDManager* mgr, CacheOp op, bool hit) {
+    ProfileCounters* c = mgr->profile_counters(op);
+    if (!c) return;
+    (hit ? c->cache_hits : c->calls).fetch_add(1, std::memory_order_relaxed);
+}
+
+/// 演算の入口で使う。スコープを抜けるまでの時間と作成ノード数を記録する
+#define SBDD2_PROFILE_SCOPE(mgr, op) \
+    ::sbdd2::ProfileScope sbdd2_profile_scope_((mgr), (op))
+
+/// 終端で決まらない部分問題を1つ数える
+#define SBDD2_PROFILE_CALL(mgr, op) \
+    ::sbdd2::profile_count((mgr), (op), false)
+
+/// キャッシュで解決した部分問題を1つ数える
+#define SBDD2_PROFILE_HIT(mgr, op) \
+    ::sbdd2::profile_count((mgr), (op), true)
+
+#else
+
+#define SBDD2_PROFILE_SCOPE(mgr, op) ((void)0)
+#define SBDD2_PROFILE_CALL(mgr, op) ((void)0)
+#define SBDD2_PROFILE_HIT(mgr, op) ((void)0)
+
+#endif // SBDD2_ENABLE_PROFILING
+
+} // namespace sbdd2
+
+#endif // SBDD2_PROFILE_HPP
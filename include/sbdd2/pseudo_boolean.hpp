@@ -0,0 +1,120 @@
+/**
+ * @file pseudo_boolean.hpp
+ * @brief SAPPOROBDD 2.0 - 擬似ブール制約・濃度制約の BDD/ZDD への変換
+ * @copyright MIT License
+ *
+ * 線形の擬似ブール制約 Σ w_i x_i ≤ K などを表す BDD/ZDD を、
+ * 論理演算の繰り返しやフィルタを使わずに直接構築する。
+ */
+
+#ifndef SBDD2_PSEUDO_BOOLEAN_HPP
+#define SBDD2_PSEUDO_BOOLEAN_HPP
+
+#include "bdd.hpp"
+#include "zdd.hpp"
+#include <vector>
+
+namespace sbdd2 {
+
+/**
+ * @brief 擬似ブール制約の関係
+ */
+enum class PBRelation {
+    LE,  ///< Σ w_i x_i ≤ K
+    GE,  ///< Σ w_i x_i ≥ K
+    EQ   ///< Σ w_i x_i = K
+};
+
+/**
+ * @brief 擬似ブール制約を表す BDD を構築する
+ * @param mgr DDマネージャー
+ * @param vars 変数のリスト
+ * @param weights 各変数の重み（vars[i] の重みが weights[i]、負でもよい）
+ * @param rel 関係
+ * @param bound 右辺の定数 K
+ * @return 制約を満たす割当の集合を表す BDD（vars 以外の変数には依存しない）
+ * @throws DDArgumentException vars と weights の長さが異なる場合、
+ *         無効な変数番号や重複した変数を含む場合
+ *
+ * 区間メモ化法（Abío ら）で構築する。変数を根に近い順に並べ、
+ * 下側の変数だけの部分制約 Σ_{j≥i} w_j x_j ≤ K' について、同じ BDD になる K' の区間を
+ * BDD ノードとともに記録しておき、区間に入る K' が再び現れたら探索せずに使い回す。
+ * 区間は子の区間から求まるので、構築の手間は結果のノード数にほぼ比例する。
+ * 結果は変数順序に対して既約なので、その順序で最小の BDD になる。
+ *
+ * GE は重みと K の符号を反転した LE、EQ は LE と GE の論理積として求める。
+ * すべての重みが 1 の LE / EQ は at_most_k_bdd() / exactly_k_bdd() で求める。
+ *
+ * @see pb_zdd(), weight_le()
+ */
+BDD pb_bdd(DDManager& mgr, const std::vector<bddvar>& vars,
+           const std::vector<long long>& weights, PBRelation rel, long long bound);
+
+/**
+ * @brief 擬似ブール制約を表す ZDD を構築する
+ * @param mgr DDマネージャー
+ * @param vars 変数のリスト（台集合）
+ * @param weights 各変数の重み（vars[i] の重みが weights[i]、負でもよい）
+ * @param rel 関係
+ * @param bound 右辺の定数 K
+ * @return vars の部分集合のうち、重みの合計が制約を満たすものの族
+ * @throws DDArgumentException vars と weights の長さが異なる場合、
+ *         無効な変数番号や重複した変数を含む場合
+ *
+ * pb_bdd() と同じ区間メモ化法で構築する。
+ * get_power_set(mgr, vars) に weight_le() などを適用した結果と同じ族を、
+ * べき集合を作らずに求める。
+ *
+ * @see pb_bdd()
+ */
+ZDD pb_zdd(DDManager& mgr, const std::vector<bddvar>& vars,
+           const std::vector<long long>& weights, PBRelation rel, long long bound);
+
+/**
+ * @brief 真になる変数が k 個以下であることを表す BDD
+ * @param mgr DDマネージャー
+ * @param vars 変数のリスト
+ * @param k 個数の上限
+ * @return x_1 + ... + x_n ≤ k を表す BDD
+ * @throws DDArgumentException 無効な変数番号や重複した変数を含む場合
+ *
+ * 各レベルで残りの個数ごとにノードを1つずつ作る。所要時間は O(n k)。
+ */
+BDD at_most_k_bdd(DDManager& mgr, const std::vector<bddvar>& vars, int k);
+
+/**
+ * @brief 真になる変数がちょうど k 個であることを表す BDD
+ * @param mgr DDマネージャー
+ * @param vars 変数のリスト
+ * @param k 個数
+ * @return x_1 + ... + x_n = k を表す BDD
+ * @throws DDArgumentException 無効な変数番号や重複した変数を含む場合
+ * @see at_most_k_bdd()
+ */
+BDD exactly_k_bdd(DDManager& mgr, const std::vector<bddvar>& vars, int k);
+
+/**
+ * @brief 要素数が k 以下の部分集合の族
+ * @param mgr DDマネージャー
+ * @param vars 変数のリスト（台集合）
+ * @param k 要素数の上限
+ * @return vars の部分集合のうち要素数が k 以下のものの族
+ * @throws DDArgumentException 無効な変数番号や重複した変数を含む場合
+ * @see at_most_k_bdd()
+ */
+ZDD at_most_k_zdd(DDManager& mgr, const std::vector<bddvar>& vars, int k);
+
+/**
+ * @brief 要素数がちょうど k の部分集合の族
+ * @param mgr DDマネージャー
+ * @param vars 変数のリスト（台集合）
+ * @param k 要素数
+ * @return vars の部分集合のうち要素数が k のものの族
+ * @throws DDArgumentException 無効な変数番号や重複した変数を含む場合
+ * @see get_power_set_with_card()
+ */
+ZDD exactly_k_zdd(DDManager& mgr, const std::vector<bddvar>& vars, int k);
+
+} // namespace sbdd2
+
+#endif // SBDD2_PSEUDO_BOOLEAN_HPP
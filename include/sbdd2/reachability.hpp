@@ -0,0 +1,133 @@
+/**
+ * @file reachability.hpp
+ * @brief 分割された遷移関係と到達可能状態の計算
+ * @copyright MIT License
+ *
+ * 論理積に分割された遷移関係を保持し、早期量化の順序（スケジュール）に従って
+ * 像・逆像を求めます。到達可能状態はフロンティアを使った不動点計算で求めます。
+ */
+
+// SAPPOROBDD 2.0 - Partitioned transition relation and reachability
+// MIT License
+
+#ifndef SBDD2_REACHABILITY_HPP
+#define SBDD2_REACHABILITY_HPP
+
+#include "bdd.hpp"
+#include <vector>
+
+namespace sbdd2 {
+
+/**
+ * @brief 論理積に分割された遷移関係
+ *
+ * 遷移関係 T(x, w, y) = T_1 ∧ T_2 ∧ ... ∧ T_k を分割のまま保持します
+ * （x: 現状態変数、y: 次状態変数、w: 入力などその他の変数）。
+ * 単一の T を作ると大きくなりすぎる場合でも、像の計算を
+ * 量化しながらの論理積 (BDD::and_exist) の列に分解できます。
+ *
+ * 構築時に1回だけ次を行い、以後の像・逆像の計算で使い回します。
+ * - 各分割のサポートから、IWLS95 と同様の貪欲法で分割の順序を決める。
+ *   まだ後の分割に現れる変数が少なく、そこで量化を終えられる変数の多いものを先にします。
+ * - その順序で隣り合う分割を、積のノード数が cluster_limit 以下である限りまとめる（クラスタ化）。
+ * - 像と逆像それぞれについて、クラスタの順序と、各変数を最後に使うクラスタの直後で
+ *   量化するスケジュール（変数の生存区間）を求める。
+ *
+ * @code{.cpp}
+ * TransitionRelation tr(parts, cur, next);
+ * BDD reached = tr.reachable(init);
+ * BDD bad_pre = tr.backward_reachable(bad);
+ * @endcode
+ *
+ * @see BDD::and_exist()
+ * @see BDD::constrain()
+ */
+class TransitionRelation {
+public:
+    /**
+     * @brief コンストラクタ
+     * @param parts 遷移関係の分割（論理積で遷移関係になる）
+     * @param current_vars 現状態変数
+     * @param next_vars 次状態変数（current_vars[i] に対応する次状態が next_vars[i]）
+     * @param cluster_limit クラスタのノード数の上限（0 ならクラスタ化しない）
+     * @throws DDArgumentException parts が空の場合、変数列の長さが異なる場合、
+     *         無効な変数番号を含む場合、現状態変数と次状態変数が重なる場合
+     * @throws DDIncompatibleException parts のマネージャーが異なる場合
+     */
+    TransitionRelation(const std::vector<BDD>& parts,
+                       const std::vector<bddvar>& current_vars,
+                       const std::vector<bddvar>& next_vars,
+                       std::size_t cluster_limit = 5000);
+
+    /**
+     * @brief 像（1ステップで遷移できる状態）
+     * @param states 現状態変数上の状態集合 S(x)
+     * @return (∃x, w. S(x) ∧ T(x, w, y)) の y を x に置き換えたもの
+     * @throws DDIncompatibleException マネージャーが異なる場合
+     */
+    BDD image(const BDD& states) const;
+
+    /**
+     * @brief 逆像（1ステップで states に遷移できる状態）
+     * @param states 現状態変数上の状態集合 S(x)
+     * @return ∃y, w. T(x, w, y) ∧ S(y)
+     * @throws DDIncompatibleException マネージャーが異なる場合
+     */
+    BDD preimage(const BDD& states) const;
+
+    /**
+     * @brief 前向きの到達可能状態
+     * @param init 初期状態の集合
+     * @param max_steps 像を求める回数の上限（0 なら不動点まで）
+     * @return init から到達できる状態の集合
+     *
+     * 直前のステップで新しく到達した状態（フロンティア）だけの像を求めます。
+     * 像を求める前に、到達済みでフロンティアでない状態をドントケアとして
+     * フロンティアを BDD::constrain() で簡単化し、小さいほうを使います。
+     */
+    BDD reachable(const BDD& init, std::size_t max_steps = 0) const;
+
+    /**
+     * @brief 後ろ向きの到達可能状態
+     * @param target 目標状態の集合
+     * @param max_steps 逆像を求める回数の上限（0 なら不動点まで）
+     * @return target に到達できる状態の集合
+     * @see reachable()
+     */
+    BDD backward_reachable(const BDD& target, std::size_t max_steps = 0) const;
+
+    /**
+     * @brief クラスタ化後の遷移関係
+     * @return クラスタのリスト（構築時の分割をまとめたもの）
+     */
+    const std::vector<BDD>& clusters() const { return clusters_; }
+
+    /**
+     * @brief クラスタの数
+     * @return クラスタの数
+     */
+    std::size_t cluster_count() const { return clusters_.size(); }
+
+private:
+    /// 一方向の量化スケジュール
+    struct Schedule {
+        std::vector<std::size_t> order;              ///< クラスタを掛ける順序
+        std::vector<std::vector<bddvar> > quantify;  ///< order[i] を掛けるときに量化する変数
+    };
+
+    DDManager* manager_;
+    std::vector<bddvar> current_vars_;
+    std::vector<bddvar> next_vars_;
+    std::vector<BDD> clusters_;
+    Schedule image_schedule_;
+    Schedule preimage_schedule_;
+    std::vector<bddvar> to_current_;  ///< 次状態変数を現状態変数に写す置換
+    std::vector<bddvar> to_next_;     ///< 現状態変数を次状態変数に写す置換
+
+    BDD apply_schedule(const Schedule& schedule, const BDD& states) const;
+    BDD fixpoint(const BDD& init, std::size_t max_steps, bool forward) const;
+};
+
+} // namespace sbdd2
+
+#endif // SBDD2_REACHABILITY_HPP
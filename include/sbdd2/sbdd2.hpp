@@ -23,15 +23,19 @@
 #include "exception.hpp"
 #include "dd_node.hpp"
 #include "dd_manager.hpp"
+#include "profile.hpp"
+#include "trace.hpp"
 #include "dd_node_ref.hpp"
 #include "dd_base.hpp"
 #include "bdd.hpp"
 #include "zdd.hpp"
+#include "shifted_zdd.hpp"
 
 // Extended DD types
 #include "unreduced_bdd.hpp"
 #include "unreduced_zdd.hpp"
 #include "qdd.hpp"
+#include "chain_zdd.hpp"
 
 // Multi-Terminal DD types
 #include "mtdd_base.hpp"
@@ -42,6 +46,7 @@
 #include "mvdd_base.hpp"
 #include "mvzdd.hpp"
 #include "mvbdd.hpp"
+#include "mvbdd_saturation.hpp"
 
 // Derived classes
 #include "pidd.hpp"
@@ -51,9 +56,16 @@
 
 // Helper functions
 #include "zdd_helper.hpp"
+#include "pseudo_boolean.hpp"
+#include "itemset_mining.hpp"
+#include "reachability.hpp"
 
 // I/O
 #include "io.hpp"
+#include "transfer.hpp"
+
+// Variable ordering
+#include "ordering.hpp"
 
 namespace sbdd2 {
 
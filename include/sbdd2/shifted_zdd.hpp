@@ -0,0 +1,288 @@
+/**
+ * @file shifted_zdd.hpp
+ * @brief SAPPOROBDD 2.0 - 変数番号シフトの遅延ビュー
+ * @author SAPPOROBDD Team
+ * @copyright MIT License
+ *
+ * ZDDの変数番号シフトを、ノードを作らずに (根, オフセット) の組として保持する
+ * ビュークラスを提供する。シフトの合成は O(1) で、ノードの実体化は必要になった時点で
+ * 一度だけ行う。
+ */
+
+#ifndef SBDD2_SHIFTED_ZDD_HPP
+#define SBDD2_SHIFTED_ZDD_HPP
+
+#include "zdd.hpp"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+namespace sbdd2 {
+
+/**
+ * @brief 変数番号をシフトしたZDDの遅延ビュー
+ *
+ * 基底のZDD F、オフセット offset、射影境界 floor の組で集合族
+ * { {v + offset | v ∈ S, v > floor} | S ∈ F } を表す。
+ * ZDD::operator<< / operator>> はシフトのたびに全ノードを作り直すが、
+ * ShiftedZDD のシフトは offset と floor を書き換えるだけで、一意テーブルにノードを追加しない。
+ *
+ * floor 以下の変数をFが含まない場合（純粋な番号の付け替え）、card() や enumerate() などの
+ * 問い合わせは基底のZDDに対して直接行われる。オフセットの等しいビュー同士の集合演算も
+ * 基底のZDD上で行い、結果を同じオフセットのビューとして返す。オフセットが異なる場合は
+ * 両方の基底をオフセットの差を考慮しながら同時にたどり、小さい方のオフセットのビューとして
+ * 結果を構築する（結果にそのまま入る部分木だけをシフトする）。等価判定もノードを作らずに行う。
+ * 上記に当てはまらない場合は materialize() でZDDを実体化してから計算する。
+ *
+ * @code{.cpp}
+ * ZDD f = ...;
+ * ShiftedZDD a(f);
+ * ShiftedZDD b = a << 10;       // O(1)、ノードは作られない
+ * ShiftedZDD c = a * b;         // f と (f << 10) の直積、f << 10 は作らない
+ * ZDD g = c.materialize();      // 通常のZDDとして取り出す
+ * @endcode
+ *
+ * @see ZDD::operator<<, ZDD::operator>>, zdd_shift
+ */
+class ShiftedZDD {
+public:
+    /// @name コンストラクタ
+    /// @{
+
+    /**
+     * @brief デフォルトコンストラクタ（無効なビュー）
+     */
+    ShiftedZDD() : offset_(0), floor_(0), min_var_(0) {}
+
+    /**
+     * @brief ZDDからシフト量0のビューを作る
+     * @param base 基底のZDD
+     */
+    explicit ShiftedZDD(const ZDD& base) : base_(base), offset_(0), floor_(0), min_var_(0) {}
+
+    /**
+     * @brief オフセットと射影境界を指定してビューを作る
+     * @param base 基底のZDD
+     * @param offset 変数番号に加える量
+     * @param floor この番号以下の変数を射影で取り除く
+     * @throws DDArgumentException floor + offset < 0 の場合
+     *
+     * floor が0でなければ、基底のZDDのサポートを一度だけ走査する。
+     */
+    ShiftedZDD(const ZDD& base, int offset, bddvar floor);
+
+    /// @}
+
+    /// @name アクセサ
+    /// @{
+
+    /**
+     * @brief 基底のZDD
+     * @return シフト前のZDD
+     */
+    const ZDD& base() const { return base_; }
+
+    /**
+     * @brief 変数番号に加える量
+     * @return オフセット
+     */
+    int offset() const { return offset_; }
+
+    /**
+     * @brief 射影境界
+     * @return 基底のZDDでこの番号以下の変数は取り除かれる
+     */
+    bddvar floor() const { return floor_; }
+
+    /**
+     * @brief マネージャーを取得
+     * @return DDマネージャーへのポインタ
+     */
+    DDManager* manager() const { return base_.manager(); }
+
+    /**
+     * @brief 射影が何も取り除かないか（純粋な番号の付け替えか）
+     * @return 基底のZDDがfloor以下の変数を含まなければtrue
+     *
+     * O(1)。基底のZDDの最小の変数番号は、floor が0でなくなったときに一度だけ求めて保持する。
+     */
+    bool is_relabeling() const;
+
+    /// @}
+
+    /// @name シフト演算子
+    /// @{
+
+    /**
+     * @brief 左シフト（O(1)）
+     * @param s シフト量（0以下なら何もしない）
+     * @return 変数番号をsだけ増加させたビュー
+     */
+    ShiftedZDD operator<<(int s) const;
+
+    /**
+     * @brief 右シフト（射影が初めて生じるときだけ基底のZDDのサポートを走査し、それ以外は O(1)）
+     * @param s シフト量（0以下なら何もしない）
+     * @return 変数番号をsだけ減少させたビュー（番号が1未満になる変数は射影で取り除く）
+     */
+    ShiftedZDD operator>>(int s) const;
+
+    /**
+     * @brief 左シフト代入
+     * @param s シフト量
+     * @return *this
+     */
+    ShiftedZDD& operator<<=(int s);
+
+    /**
+     * @brief 右シフト代入
+     * @param s シフト量
+     * @return *this
+     */
+    ShiftedZDD& operator>>=(int s);
+
+    /// @}
+
+    /// @name 実体化
+    /// @{
+
+    /**
+     * @brief ビューが表す集合族をZDDとして構築
+     * @return zdd_shift(base(), offset(), floor()) と同じZDD
+     *
+     * オフセット0かつ射影なしの場合はノードを作らずに基底のZDDを返す。
+     */
+    ZDD materialize() const;
+
+    /// @}
+
+    /// @name 問い合わせ
+    /// @{
+
+    /**
+     * @brief 空集合族かどうか（O(1)）
+     * @return 空集合族ならtrue
+     */
+    bool is_zero() const { return base_.is_zero(); }
+
+    /**
+     * @brief 空集合のみからなる集合族かどうか
+     * @return {∅} ならtrue
+     */
+    bool is_one() const;
+
+    /**
+     * @brief 最上位変数の番号
+     * @return シフト後の最上位変数（終端なら0）
+     */
+    bddvar top() const;
+
+    /**
+     * @brief 集合族に含まれる集合の数
+     * @return |F|
+     */
+    double card() const;
+
+    /**
+     * @brief 集合族に含まれる集合の数（cardの別名）
+     * @return |F|
+     */
+    double count() const { return card(); }
+
+#if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
+    /**
+     * @brief 集合族に含まれる集合の数（厳密計算）
+     * @return |F| を文字列で返す
+     */
+    std::string exact_count() const;
+#endif
+
+    /**
+     * @brief 全集合を列挙
+     * @return シフト後の変数番号で表した全ての集合
+     */
+    std::vector<std::vector<bddvar>> enumerate() const;
+
+    /**
+     * @brief 1つの集合を取得
+     * @return シフト後の変数番号で表した任意の1つの集合
+     */
+    std::vector<bddvar> one_set() const;
+
+    /**
+     * @brief 全集合のリテラル数の合計
+     * @return Σ|S|
+     */
+    std::uint64_t lit() const;
+
+    /**
+     * @brief 最大集合のサイズ
+     * @return max|S|
+     */
+    std::uint64_t len() const;
+
+    /// @}
+
+    /// @name 集合演算
+    /// @{
+
+    /**
+     * @brief 和集合
+     * @param other 右オペランド
+     * @return 和集合のビュー
+     * @throws DDIncompatibleException マネージャーが異なる場合
+     */
+    ShiftedZDD operator+(const ShiftedZDD& other) const;
+
+    /**
+     * @brief 差集合
+     * @param other 右オペランド
+     * @return 差集合のビュー
+     * @throws DDIncompatibleException マネージャーが異なる場合
+     */
+    ShiftedZDD operator-(const ShiftedZDD& other) const;
+
+    /**
+     * @brief 積集合
+     * @param other 右オペランド
+     * @return 積集合のビュー
+     * @throws DDIncompatibleException マネージャーが異なる場合
+     */
+    ShiftedZDD operator&(const ShiftedZDD& other) const;
+
+    /**
+     * @brief 直積（Join）
+     * @param other 右オペランド
+     * @return 直積のビュー
+     * @throws DDIncompatibleException マネージャーが異なる場合
+     */
+    ShiftedZDD operator*(const ShiftedZDD& other) const;
+
+    /**
+     * @brief 集合族として等しいか
+     * @param other 比較対象
+     * @return 同じ集合族を表していればtrue
+     */
+    bool operator==(const ShiftedZDD& other) const;
+
+    /**
+     * @brief 集合族として異なるか
+     * @param other 比較対象
+     * @return 異なる集合族を表していればtrue
+     */
+    bool operator!=(const ShiftedZDD& other) const { return !(*this == other); }
+
+    /// @}
+
+private:
+    ShiftedZDD combine(const ShiftedZDD& other, CacheOp op) const;
+
+    ZDD base_;
+    int offset_;
+    bddvar floor_;
+    bddvar min_var_;  ///< 基底のZDDの最小の変数番号（変数がなければ0）。floor_ が0のときは未計算
+};
+
+} // namespace sbdd2
+
+#endif // SBDD2_SHIFTED_ZDD_HPP
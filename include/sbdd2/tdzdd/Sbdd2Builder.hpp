@@ -28,6 +28,7 @@
 #include "../unreduced_bdd.hpp"
 #include "../mvzdd.hpp"
 #include "../mvbdd.hpp"
+#include "../trace.hpp"
 
 namespace sbdd2 {
 namespace tdzdd {
@@ -287,6 +288,7 @@ UnreducedZDD build_unreduced_zdd(DDManager& mgr, SPEC& spec, int offset = 0) {
  */
 template<typename SPEC>
 ZDD build_zdd(DDManager& mgr, SPEC& spec, int offset = 0) {
+    TraceScope trace(&mgr, "build_zdd", "build");
     UnreducedZDD unreduced = build_unreduced_zdd(mgr, spec, offset);
     return unreduced.reduce();
 }
@@ -459,6 +461,7 @@ UnreducedBDD build_unreduced_bdd(DDManager& mgr, SPEC& spec, int offset = 0) {
  */
 template<typename SPEC>
 BDD build_bdd(DDManager& mgr, SPEC& spec, int offset = 0) {
+    TraceScope trace(&mgr, "build_bdd", "build");
     UnreducedBDD unreduced = build_unreduced_bdd(mgr, spec, offset);
     return unreduced.reduce();
 }
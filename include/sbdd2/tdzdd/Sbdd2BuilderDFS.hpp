@@ -21,6 +21,7 @@
 #include "../dd_manager.hpp"
 #include "../zdd.hpp"
 #include "../bdd.hpp"
+#include "../trace.hpp"
 
 namespace sbdd2 {
 namespace tdzdd {
@@ -319,6 +320,7 @@ Arc dfs_build_bdd_impl(DDManager& mgr, SPEC& spec, int rootLevel, int level,
  */
 template<typename SPEC>
 ZDD build_zdd_dfs(DDManager& mgr, SPEC& spec) {
+    TraceScope trace(&mgr, "build_zdd_dfs", "build");
     int const datasize = spec.datasize();
 
     // ルート状態を取得
@@ -368,6 +370,7 @@ ZDD build_zdd_dfs(DDManager& mgr, SPEC& spec) {
  */
 template<typename SPEC>
 BDD build_bdd_dfs(DDManager& mgr, SPEC& spec) {
+    TraceScope trace(&mgr, "build_bdd_dfs", "build");
     int const datasize = spec.datasize();
 
     // ルート状態を取得
@@ -0,0 +1,157 @@
+/**
+ * @file trace.hpp
+ * @brief SAPPOROBDD 2.0 - 演算のタイムライン記録
+ * @author SAPPOROBDD Team
+ * @copyright MIT License
+ *
+ * トップレベルの演算（BDD/ZDDの二項演算、build_zdd、GC、テーブル拡張、インポート）の
+ * 開始・終了時刻、ノード数、スレッドを記録し、Chrome trace 形式の JSON として出力する。
+ * 出力は chrome://tracing や Perfetto でそのまま開ける。
+ */
+
+#ifndef SBDD2_TRACE_HPP
+#define SBDD2_TRACE_HPP
+
+#include "dd_manager.hpp"
+#include <chrono>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sbdd2 {
+
+/**
+ * @brief 演算イベントの記録器
+ *
+ * DDManager::set_trace_recorder() でマネージャーに取り付けると、そのマネージャーの
+ * トップレベル演算が1つずつイベントとして記録される。取り付けていない場合の
+ * コストはポインタ1つの確認だけである。
+ *
+ * 記録は複数スレッドから行ってよい。イベント数が max_events に達した後の
+ * イベントは捨てられ、dropped_count() で数えられる。
+ *
+ * @code{.cpp}
+ * TraceRecorder recorder;
+ * mgr.set_trace_recorder(&recorder);
+ * BDD f = x1 & x2;              // "BDD::and" が記録される
+ * mgr.set_trace_recorder(nullptr);
+ * recorder.write_chrome_trace("trace.json");
+ * @endcode
+ *
+ * @see DDManager::set_trace_recorder()
+ */
+class TraceRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// 記録された1つのイベント
+    struct Event {
+        const char* name;          ///< 演算名（静的文字列）
+        const char* category;      ///< 分類（"bdd", "zdd", "gc", "io", "build"）
+        Clock::time_point start;   ///< 開始時刻
+        Clock::time_point end;     ///< 終了時刻
+        std::size_t nodes_before;  ///< 開始時のノード数
+        std::size_t nodes_after;   ///< 終了時のノード数
+        unsigned thread;           ///< スレッド番号（記録器内で初出順に1から）
+    };
+
+    /**
+     * @brief コンストラクタ
+     * @param max_events 保持するイベント数の上限
+     */
+    explicit TraceRecorder(std::size_t max_events = 1 << 20);
+
+    /**
+     * @brief イベントを1つ記録する
+     * @param name 演算名（記録器より長く生存する文字列）
+     * @param category 分類（同上）
+     * @param start 開始時刻
+     * @param end 終了時刻
+     * @param nodes_before 開始時のノード数
+     * @param nodes_after 終了時のノード数
+     */
+    void record(const char* name, const char* category,
+                Clock::time_point start, Clock::time_point end,
+                std::size_t nodes_before, std::size_t nodes_after);
+
+    /// 記録済みイベントのコピー（記録順）
+    std::vector<Event> events() const;
+
+    /// 記録済みイベント数
+    std::size_t event_count() const;
+
+    /// 上限を超えて捨てたイベント数
+    std::size_t dropped_count() const;
+
+    /// イベントを捨てて時刻の原点をリセットする
+    void clear();
+
+    /**
+     * @brief Chrome trace 形式で出力
+     * @param os 出力ストリーム
+     *
+     * 各イベントは "ph":"X"（完了イベント）で、時刻は記録器の生成（または clear()）
+     * からのマイクロ秒、args にノード数の前後を持つ。
+     */
+    void write_chrome_trace(std::ostream& os) const;
+
+    /**
+     * @brief Chrome trace 形式でファイルに出力
+     * @param filename 出力ファイル名
+     * @return 成功すればtrue
+     */
+    bool write_chrome_trace(const std::string& filename) const;
+
+private:
+    unsigned thread_number(std::thread::id id);
+
+    std::size_t max_events_;
+    std::size_t dropped_;
+    Clock::time_point origin_;
+    std::vector<Event> events_;
+    std::vector<std::thread::id> threads_;
+    mutable std::mutex mutex_;
+};
+
+/**
+ * @brief スコープの開始から終了までを1イベントとして記録する（内部用）
+ *
+ * マネージャーに記録器が取り付けられていなければ何もしない。
+ */
+class TraceScope {
+public:
+    TraceScope(const DDManager* mgr, const char* name, const char* category)
+        : recorder_(mgr ? mgr->trace_recorder() : nullptr) {
+        if (recorder_) {
+            mgr_ = mgr;
+            name_ = name;
+            category_ = category;
+            nodes_ = mgr->node_count();
+            start_ = TraceRecorder::Clock::now();
+        }
+    }
+
+    ~TraceScope() {
+        if (recorder_) {
+            recorder_->record(name_, category_, start_, TraceRecorder::Clock::now(),
+                              nodes_, mgr_->node_count());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    TraceRecorder* recorder_;
+    const DDManager* mgr_;
+    const char* name_;
+    const char* category_;
+    std::size_t nodes_;
+    TraceRecorder::Clock::time_point start_;
+};
+
+} // namespace sbdd2
+
+#endif // SBDD2_TRACE_HPP
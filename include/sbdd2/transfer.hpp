@@ -0,0 +1,73 @@
+/**
+ * @file transfer.hpp
+ * @brief SAPPOROBDD 2.0 - マネージャー間のBDD/ZDDの転送
+ * @author SAPPOROBDD Team
+ * @copyright MIT License
+ *
+ * あるDDManagerのBDD/ZDDを、ストリームを経由せずに別のDDManagerへ複製する。
+ * スレッドごとのマネージャー（ScopedManager）で計算した結果を1つに集める用途を想定している。
+ */
+
+#ifndef SBDD2_TRANSFER_HPP
+#define SBDD2_TRANSFER_HPP
+
+#include "bdd.hpp"
+#include "zdd.hpp"
+#include <vector>
+
+namespace sbdd2 {
+
+/**
+ * @brief BDDを別のマネージャーへ転送する
+ * @param f 転送するBDD
+ * @param dst 転送先のマネージャー
+ * @param parallel trueなら同じレベルのノードを複数スレッドで作る
+ * @return dst 上の同じ論理関数を表すBDD
+ *
+ * 変数は番号で対応させる。dst の変数が足りない場合は new_var() で追加する。
+ * 両マネージャーで変数の順序が（f に現れる範囲で）一致していれば、ノードを
+ * レベルの低い順に1つずつ複製する。一致しない場合は dst 上で ite を使って組み立て直す。
+ * dst が f のマネージャーを DDManager::fork() して作られた場合は複製せず、そのまま参照する。
+ *
+ * @see transfer(const std::vector<BDD>&, DDManager&, bool)
+ */
+BDD transfer(const BDD& f, DDManager& dst, bool parallel = false);
+
+/**
+ * @brief ZDDを別のマネージャーへ転送する
+ * @param f 転送するZDD
+ * @param dst 転送先のマネージャー
+ * @param parallel trueなら同じレベルのノードを複数スレッドで作る
+ * @return dst 上の同じ集合族を表すZDD
+ *
+ * 変数の扱いは BDD 版と同じ。順序が一致しない場合は dst 上で
+ * 和と change を使って組み立て直す。
+ */
+ZDD transfer(const ZDD& f, DDManager& dst, bool parallel = false);
+
+/**
+ * @brief 複数のBDDをまとめて転送する
+ * @param fs 転送するBDD（すべて同じマネージャーに属すること）
+ * @param dst 転送先のマネージャー
+ * @param parallel trueなら同じレベルのノードを複数スレッドで作る
+ * @return fs と同じ順の転送結果
+ * @throws DDIncompatibleException fs が異なるマネージャーのBDDを含む場合
+ *
+ * 根の間で共有されているノードは1回だけ複製する。
+ * 無効なBDDは無効なBDDのまま返す。
+ */
+std::vector<BDD> transfer(const std::vector<BDD>& fs, DDManager& dst, bool parallel = false);
+
+/**
+ * @brief 複数のZDDをまとめて転送する
+ * @param fs 転送するZDD（すべて同じマネージャーに属すること）
+ * @param dst 転送先のマネージャー
+ * @param parallel trueなら同じレベルのノードを複数スレッドで作る
+ * @return fs と同じ順の転送結果
+ * @throws DDIncompatibleException fs が異なるマネージャーのZDDを含む場合
+ */
+std::vector<ZDD> transfer(const std::vector<ZDD>& fs, DDManager& dst, bool parallel = false);
+
+} // namespace sbdd2
+
+#endif // SBDD2_TRANSFER_HPP
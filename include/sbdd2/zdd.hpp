@@ -199,6 +199,20 @@ public:
      */
     static ZDD singleton(DDManager& mgr, bddvar v);
 
+    /**
+     * @brief BDDから変換（充足割当の集合族）
+     * @param f 変換するBDD
+     * @param universe 台集合とするレベル数（レベル 1..universe の変数）。0なら全変数
+     * @return f を真にする割当の、1の変数の集合からなる集合族
+     * @throws DDArgumentException universe が変数数を超える場合、
+     *         または f が台集合の外の変数に依存する場合
+     *
+     * BDDで飛ばされたレベルは「どちらでもよい」としてZDDのノードを補う。
+     *
+     * @see to_bdd()
+     */
+    static ZDD from_bdd(const BDD& f, bddvar universe = 0);
+
     /// @}
 
     /// @name 集合族演算
@@ -232,6 +246,33 @@ public:
      */
     ZDD change(bddvar v) const;
 
+    /**
+     * @brief 複数要素の onset 演算
+     * @param vars 要素番号（順序・重複は問わない）
+     * @return {S \ vars | S ∈ F, vars ⊆ S}
+     * @throws DDArgumentException 範囲外の変数番号を含む場合
+     *
+     * onset を1つずつ適用するのと同じ結果を1回の走査で求める。
+     * 単一要素版と同じく結果は演算キャッシュに (F, vars) をキーとして記録される。
+     */
+    ZDD onset(const std::vector<bddvar>& vars) const;
+
+    /**
+     * @brief 複数要素の offset 演算
+     * @param vars 要素番号
+     * @return {S | S ∈ F, vars ∩ S = ∅}
+     * @throws DDArgumentException 範囲外の変数番号を含む場合
+     */
+    ZDD offset(const std::vector<bddvar>& vars) const;
+
+    /**
+     * @brief 複数要素の change 演算
+     * @param vars 要素番号
+     * @return {S △ vars | S ∈ F}
+     * @throws DDArgumentException 範囲外の変数番号を含む場合
+     */
+    ZDD change(const std::vector<bddvar>& vars) const;
+
     /// @}
 
     /// @name 子ノードアクセス
@@ -349,6 +390,52 @@ public:
     std::string exact_count() const;
 #endif
 
+    /**
+     * @brief 要素数ごとの集合の数
+     * @param parallel true なら同じレベルのノードを複数のスレッドで処理する
+     * @return result[c] が要素数 c の集合の数である配列
+     *         （長さは最大の要素数 + 1、空の族なら空の配列）
+     *
+     * 各ノードについて、下の族の要素数ごとの集合の数を下から1回の走査で求める。
+     * get_power_set_with_card() との積を要素数ごとに card() で数えるより速い。
+     * 子の配列は、親をすべて処理したところで解放する。
+     */
+    std::vector<double> size_histogram(bool parallel = false) const;
+
+#if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
+    /**
+     * @brief 要素数ごとの集合の数（厳密計算）
+     * @param parallel true なら同じレベルのノードを複数のスレッドで処理する
+     * @return 各要素を文字列で表した size_histogram() と同じ配列
+     *
+     * @note この機能はGMPがインストールされている場合のみ利用可能です
+     */
+    std::vector<std::string> exact_size_histogram(bool parallel = false) const;
+#endif
+
+    /**
+     * @brief 各要素を含む集合の数
+     * @param parallel true なら同じレベルのノードを複数のスレッドで処理する
+     * @return result[v] が変数 v を含む集合の数である長さ var_count() + 1 の配列
+     *         （result[0] は 0）
+     *
+     * 各ノードの下の集合の数と根からの経路数を求めておき、
+     * 変数 v のノードごとに「経路数 × 1枝側の集合の数」を足し合わせる。
+     * 変数ごとに onset(v).card() を求めるのと異なり、ZDD の走査は変数の数によらない。
+     */
+    std::vector<double> element_frequencies(bool parallel = false) const;
+
+#if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
+    /**
+     * @brief 各要素を含む集合の数（厳密計算）
+     * @param parallel true なら同じレベルのノードを複数のスレッドで処理する
+     * @return 各要素を文字列で表した element_frequencies() と同じ配列
+     *
+     * @note この機能はGMPがインストールされている場合のみ利用可能です
+     */
+    std::vector<std::string> exact_element_frequencies(bool parallel = false) const;
+#endif
+
     /// @}
 
     /// @name 列挙演算
@@ -373,10 +460,18 @@ public:
     /// @}
 
     /**
-     * @brief BDDへの変換
-     * @return 等価なBDD
+     * @brief BDDへの変換（特性関数）
+     * @param universe 台集合とするレベル数（レベル 1..universe の変数）。0なら全変数
+     * @return 台集合上の割当のうち、1の変数の集合がこの集合族に属するものを真とするBDD
+     * @throws DDArgumentException universe が変数数を超える場合、
+     *         または台集合の外の変数を含む場合
+     *
+     * ZDDで飛ばされたレベルは「要素を含まない」としてBDDのノードを補う。
+     * レベルごとに1回の走査で求め、結果は演算キャッシュに残る。
+     *
+     * @see from_bdd(), BDD::to_zdd()
      */
-    BDD to_bdd() const;
+    BDD to_bdd(bddvar universe = 0) const;
 
     /// @name デバッグ・出力
     /// @{
@@ -432,6 +527,32 @@ public:
      */
     ZDD always() const;
 
+    /**
+     * @brief 極大集合族
+     * @return 自身の他の集合の真部分集合にならない集合のみを残した族
+     */
+    ZDD maximal() const;
+
+    /**
+     * @brief 極小集合族
+     * @return 自身の他の集合を真部分集合として含まない集合のみを残した族
+     */
+    ZDD minimal() const;
+
+    /**
+     * @brief 非上位集合族（Knuth の nonsupersets）
+     * @param g 比較対象のZDD
+     * @return gのどの集合も部分集合として含まない集合のみを残す
+     */
+    ZDD nonsup(const ZDD& g) const;
+
+    /**
+     * @brief 非部分集合族（Knuth の nonsubsets）
+     * @param g 比較対象のZDD
+     * @return gのどの集合の部分集合にもならない集合のみを残す
+     */
+    ZDD nonsub(const ZDD& g) const;
+
     /// @}
 
     /// @name カウント・サイズ演算
@@ -933,6 +1054,19 @@ inline ZDD operator*(ZDD&& a, const ZDD& b) { return a *= b; }
  */
 ZDD zdd_meet(const ZDD& f, const ZDD& g);
 
+/**
+ * @brief 射影付き変数番号シフト
+ * @param f 対象のZDD
+ * @param offset 変数番号に加える量（負も可）
+ * @param floor この番号以下の変数を射影で取り除く（0なら除去なし）
+ * @return floor以下の変数を各集合から取り除き、残りの変数vをv+offsetに置き換えた集合族
+ * @throws DDArgumentException floor + offset < 0 の場合（番号が1未満になる変数が残る）
+ *
+ * f << s は zdd_shift(f, s, 0)、f >> s は zdd_shift(f, -s, s) と等しい。
+ * 結果は演算キャッシュでメモ化される。ShiftedZDD::materialize() もこの関数を使う。
+ */
+ZDD zdd_shift(const ZDD& f, int offset, bddvar floor = 0);
+
 /// @}
 
 } // namespace sbdd2
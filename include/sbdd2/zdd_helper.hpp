@@ -12,6 +12,7 @@
 
 #include "zdd.hpp"
 #include "dd_manager.hpp"
+#include "pseudo_boolean.hpp"
 #include <vector>
 #include <set>
 #include <random>
@@ -64,57 +65,23 @@ inline ZDD get_power_set(DDManager& mgr, int n) {
  * @brief 指定濃度のべき集合を生成する
  *
  * 指定された変数集合から、要素数がちょうどkの部分集合のみを表すZDDを
- * 動的計画法で構築する。
+ * exactly_k_zdd() で、レベルごとに残りの要素数に対応するノードを作って構築する。
  *
  * @tparam Container 変数を格納するコンテナ型（begin/endをサポートする型）
  * @param mgr DDマネージャー
  * @param variables 変数のコンテナ
  * @param k 濃度（部分集合の要素数）
  * @return 濃度がちょうどkの部分集合を含むZDD
- * @see get_power_set
+ * @throws DDArgumentException 無効な変数番号や重複した変数を含む場合
+ * @see get_power_set, exactly_k_zdd
  */
 template<typename Container>
 ZDD get_power_set_with_card(DDManager& mgr, const Container& variables, int k) {
-    std::vector<bddvar> vars(variables.begin(), variables.end());
-    int n = static_cast<int>(vars.size());
-
-    if (k < 0 || k > n) {
-        return ZDD::empty(mgr);
-    }
-    if (k == 0) {
-        return ZDD::single(mgr);  // Only empty set
-    }
-    if (k == n) {
-        // Only full set
-        ZDD result = ZDD::single(mgr);
-        for (bddvar v : vars) {
-            result = result.change(v);
-        }
-        return result;
-    }
-
-    // Dynamic programming approach
-    // dp[i][j] = ZDD of subsets of vars[0..i-1] with exactly j elements
-    std::vector<ZDD> prev(k + 1, ZDD::empty(mgr));
-    std::vector<ZDD> curr(k + 1, ZDD::empty(mgr));
-
-    prev[0] = ZDD::single(mgr);
-
-    for (int i = 0; i < n; ++i) {
-        bddvar v = vars[i];
-        for (int j = 0; j <= k; ++j) {
-            curr[j] = prev[j];  // Don't include v
-            if (j > 0) {
-                curr[j] = curr[j] + prev[j - 1].change(v);  // Include v
-            }
-        }
-        std::swap(prev, curr);
-        for (int j = 0; j <= k; ++j) {
-            curr[j] = ZDD::empty(mgr);
-        }
+    std::vector<bddvar> vars;
+    for (const auto& v : variables) {
+        vars.push_back(static_cast<bddvar>(v));
     }
-
-    return prev[k];
+    return exactly_k_zdd(mgr, vars, k);
 }
 
 /**
@@ -12,6 +12,7 @@
 #define SBDD2_ZDD_INDEX_HPP
 
 #include "types.hpp"
+#include "dd_manager.hpp"
 #include <vector>
 #include <unordered_map>
 #include <cstdint>
@@ -88,6 +89,9 @@ struct ZDDIndexData {
     /// @brief 最低レベル（終端に最も近い非終端レベル）
     int min_level;
 
+    /// @brief DDManager::memory_usage() への計上
+    MemoryAccount memory;
+
     /**
      * @brief デフォルトコンストラクタ
      *
@@ -123,6 +127,9 @@ struct ZDDExactIndexData {
     /// @brief 最低レベル（終端に最も近い非終端レベル）
     int min_level;
 
+    /// @brief DDManager::memory_usage() への計上
+    MemoryAccount memory;
+
     /**
      * @brief デフォルトコンストラクタ
      *
@@ -3,6 +3,8 @@
 
 #include "sbdd2/bdd.hpp"
 #include "sbdd2/zdd.hpp"
+#include "sbdd2/profile.hpp"
+#include "sbdd2/trace.hpp"
 #include <iostream>
 #include <sstream>
 #include <stack>
@@ -86,9 +88,27 @@ BDD BDD::operator~() const {
     return BDD(manager_, arc_.negated());
 }
 
-// Internal apply function
-static Arc bdd_apply(DDManager* mgr, CacheOp op, Arc f, Arc g) {
-    // Terminal cases
+// Split arc a on top_var into its effective cofactors
+static void bdd_split(DDManager* mgr, Arc a, bddvar top_var, Arc& a0, Arc& a1) {
+    if (a.is_constant()) {
+        a0 = a1 = a;
+        return;
+    }
+    const DDNode& node = mgr->node_at(a.index());
+    if (node.var() != top_var) {
+        a0 = a1 = a;
+        return;
+    }
+    a0 = node.arc0();
+    a1 = node.arc1();
+    if (a.is_negated()) {
+        a0 = a0.negated();
+        a1 = a1.negated();
+    }
+}
+
+// Terminal cases of bdd_apply (returns true if result is determined)
+static bool bdd_apply_terminal(CacheOp op, Arc f, Arc g, Arc& result) {
     bool f_term = f.is_constant();
     bool g_term = g.is_constant();
     bool f_val = f_term ? (f.terminal_value() != f.is_negated()) : false;
@@ -96,90 +116,116 @@ static Arc bdd_apply(DDManager* mgr, CacheOp op, Arc f, Arc g) {
 
     switch (op) {
     case CacheOp::AND:
-        if (f_term && !f_val) return ARC_TERMINAL_0;
-        if (g_term && !g_val) return ARC_TERMINAL_0;
-        if (f_term && f_val) return g;
-        if (g_term && g_val) return f;
-        if (f == g) return f;
-        if (f.data == (g.data ^ 1)) return ARC_TERMINAL_0;  // f & ~f = 0
+        if (f_term && !f_val) { result = ARC_TERMINAL_0; return true; }
+        if (g_term && !g_val) { result = ARC_TERMINAL_0; return true; }
+        if (f_term && f_val) { result = g; return true; }
+        if (g_term && g_val) { result = f; return true; }
+        if (f == g) { result = f; return true; }
+        if (f.data == (g.data ^ 1)) { result = ARC_TERMINAL_0; return true; }  // f & ~f = 0
         break;
 
     case CacheOp::OR:
-        if (f_term && f_val) return ARC_TERMINAL_1;
-        if (g_term && g_val) return ARC_TERMINAL_1;
-        if (f_term && !f_val) return g;
-        if (g_term && !g_val) return f;
-        if (f == g) return f;
-        if (f.data == (g.data ^ 1)) return ARC_TERMINAL_1;  // f | ~f = 1
+        if (f_term && f_val) { result = ARC_TERMINAL_1; return true; }
+        if (g_term && g_val) { result = ARC_TERMINAL_1; return true; }
+        if (f_term && !f_val) { result = g; return true; }
+        if (g_term && !g_val) { result = f; return true; }
+        if (f == g) { result = f; return true; }
+        if (f.data == (g.data ^ 1)) { result = ARC_TERMINAL_1; return true; }  // f | ~f = 1
         break;
 
     case CacheOp::XOR:
-        if (f_term && !f_val) return g;
-        if (g_term && !g_val) return f;
-        if (f_term && f_val) return Arc(g.data ^ 1);
-        if (g_term && g_val) return Arc(f.data ^ 1);
-        if (f == g) return ARC_TERMINAL_0;
-        if (f.data == (g.data ^ 1)) return ARC_TERMINAL_1;
+        if (f_term && !f_val) { result = g; return true; }
+        if (g_term && !g_val) { result = f; return true; }
+        if (f_term && f_val) { result = Arc(g.data ^ 1); return true; }
+        if (g_term && g_val) { result = Arc(f.data ^ 1); return true; }
+        if (f == g) { result = ARC_TERMINAL_0; return true; }
+        if (f.data == (g.data ^ 1)) { result = ARC_TERMINAL_1; return true; }
         break;
 
     case CacheOp::DIFF:  // f & ~g
-        if (f_term && !f_val) return ARC_TERMINAL_0;
-        if (g_term && g_val) return ARC_TERMINAL_0;
-        if (g_term && !g_val) return f;
-        if (f == g) return ARC_TERMINAL_0;
+        if (f_term && !f_val) { result = ARC_TERMINAL_0; return true; }
+        if (g_term && g_val) { result = ARC_TERMINAL_0; return true; }
+        if (g_term && !g_val) { result = f; return true; }
+        if (f == g) { result = ARC_TERMINAL_0; return true; }
         break;
 
     default:
         break;
     }
+    return false;
+}
 
-    // Check cache
-    Arc result;
-    if (mgr->cache_lookup(op, f, g, result)) {
-        return result;
-    }
-
-    // Recursive case
+// Explicit-stack frame of bdd_apply.
+// sub[i] holds the operand pair of the i-th pending subproblem; stage
+// counts how many of them have been issued.
+struct BDDApplyFrame {
+    Arc f, g;
+    Arc sub[2][2];
+    bddvar var;
+    int stage;
+};
+
+static void bdd_apply_push(DDManager* mgr, std::vector<BDDApplyFrame>& stack, Arc f, Arc g) {
     bddvar f_var = f.is_constant() ? BDDVAR_MAX : mgr->node_at(f.index()).var();
     bddvar g_var = g.is_constant() ? BDDVAR_MAX : mgr->node_at(g.index()).var();
-    bddvar top_var = mgr->var_of_top_lev(f_var, g_var);
 
-    Arc f0, f1, g0, g1;
+    BDDApplyFrame frame;
+    frame.f = f;
+    frame.g = g;
+    frame.var = mgr->var_of_top_lev(f_var, g_var);
+    frame.stage = 0;
+    bdd_split(mgr, f, frame.var, frame.sub[0][0], frame.sub[1][0]);
+    bdd_split(mgr, g, frame.var, frame.sub[0][1], frame.sub[1][1]);
+    stack.push_back(frame);
+}
 
-    if (f.is_constant()) {
-        f0 = f1 = f;
-    } else if (f_var == top_var) {
-        const DDNode& node = mgr->node_at(f.index());
-        f0 = node.arc0();
-        f1 = node.arc1();
-        if (f.is_negated()) {
-            f0 = f0.negated();
-            f1 = f1.negated();
-        }
-    } else {
-        f0 = f1 = f;
+// Internal apply function (iterative, safe at any depth)
+static Arc bdd_apply(DDManager* mgr, CacheOp op, Arc f, Arc g) {
+    Arc result;
+    if (bdd_apply_terminal(op, f, g, result)) return result;
+    SBDD2_PROFILE_SCOPE(mgr, op);
+    SBDD2_PROFILE_CALL(mgr, op);
+    if (mgr->cache_lookup(op, f, g, result)) {
+        SBDD2_PROFILE_HIT(mgr, op);
+        return result;
     }
 
-    if (g.is_constant()) {
-        g0 = g1 = g;
-    } else if (g_var == top_var) {
-        const DDNode& node = mgr->node_at(g.index());
-        g0 = node.arc0();
-        g1 = node.arc1();
-        if (g.is_negated()) {
-            g0 = g0.negated();
-            g1 = g1.negated();
+    std::vector<BDDApplyFrame> stack;
+    std::vector<Arc> results;
+    bdd_apply_push(mgr, stack, f, g);
+
+    while (!stack.empty()) {
+        BDDApplyFrame& frame = stack.back();
+        if (frame.stage < 2) {
+            Arc sf = frame.sub[frame.stage][0];
+            Arc sg = frame.sub[frame.stage][1];
+            ++frame.stage;
+            // Resolve terminal and cached subproblems without pushing a frame
+            if (bdd_apply_terminal(op, sf, sg, result)) {
+                results.push_back(result);
+                continue;
+            }
+            SBDD2_PROFILE_CALL(mgr, op);
+            if (mgr->cache_lookup(op, sf, sg, result)) {
+                SBDD2_PROFILE_HIT(mgr, op);
+                results.push_back(result);
+            } else {
+                bdd_apply_push(mgr, stack, sf, sg);
+            }
+            continue;
         }
-    } else {
-        g0 = g1 = g;
-    }
 
-    Arc r0 = bdd_apply(mgr, op, f0, g0);
-    Arc r1 = bdd_apply(mgr, op, f1, g1);
+        Arc r1 = results.back();
+        results.pop_back();
+        Arc r0 = results.back();
+        results.pop_back();
 
-    result = mgr->get_or_create_node_bdd(top_var, r0, r1, true);
-    mgr->cache_insert(op, f, g, result);
-    return result;
+        result = mgr->get_or_create_node_bdd(frame.var, r0, r1, true);
+        mgr->cache_insert(op, frame.f, frame.g, result);
+        results.push_back(result);
+        stack.pop_back();
+    }
+    return results.back();
 }
 
 // Boolean operations
@@ -187,6 +233,7 @@ BDD BDD::operator&(const BDD& other) const {
     if (!manager_ || !other.manager_ || manager_ != other.manager_) {
         throw DDIncompatibleException("BDD managers do not match");
     }
+    TraceScope trace(manager_, "BDD::and", "bdd");
     Arc result = bdd_apply(manager_, CacheOp::AND, arc_, other.arc_);
     return BDD(manager_, result);
 }
@@ -195,6 +242,7 @@ BDD BDD::operator|(const BDD& other) const {
     if (!manager_ || !other.manager_ || manager_ != other.manager_) {
         throw DDIncompatibleException("BDD managers do not match");
     }
+    TraceScope trace(manager_, "BDD::or", "bdd");
     Arc result = bdd_apply(manager_, CacheOp::OR, arc_, other.arc_);
     return BDD(manager_, result);
 }
@@ -203,6 +251,7 @@ BDD BDD::operator^(const BDD& other) const {
     if (!manager_ || !other.manager_ || manager_ != other.manager_) {
         throw DDIncompatibleException("BDD managers do not match");
     }
+    TraceScope trace(manager_, "BDD::xor", "bdd");
     Arc result = bdd_apply(manager_, CacheOp::XOR, arc_, other.arc_);
     return BDD(manager_, result);
 }
@@ -211,6 +260,7 @@ BDD BDD::operator-(const BDD& other) const {
     if (!manager_ || !other.manager_ || manager_ != other.manager_) {
         throw DDIncompatibleException("BDD managers do not match");
     }
+    TraceScope trace(manager_, "BDD::diff", "bdd");
     Arc result = bdd_apply(manager_, CacheOp::DIFF, arc_, other.arc_);
     return BDD(manager_, result);
 }
@@ -236,65 +286,103 @@ BDD& BDD::operator-=(const BDD& other) {
     return *this;
 }
 
-// ITE operation
-static Arc bdd_ite(DDManager* mgr, Arc f, Arc t, Arc e) {
-    // Terminal cases
+// Terminal cases of bdd_ite (returns true if result is determined)
+static bool bdd_ite_terminal(Arc f, Arc t, Arc e, Arc& result) {
     if (f.is_constant()) {
         bool f_val = f.terminal_value() != f.is_negated();
-        return f_val ? t : e;
+        result = f_val ? t : e;
+        return true;
+    }
+    if (t == e) {
+        result = t;
+        return true;
     }
-    if (t == e) return t;
     if (t.is_constant() && e.is_constant()) {
         bool t_val = t.terminal_value() != t.is_negated();
         bool e_val = e.terminal_value() != e.is_negated();
-        if (t_val && !e_val) return f;
-        if (!t_val && e_val) return f.negated();
+        if (t_val && !e_val) {
+            result = f;
+            return true;
+        }
+        if (!t_val && e_val) {
+            result = f.negated();
+            return true;
+        }
     }
+    return false;
+}
 
-    // Check cache
-    Arc result;
-    if (mgr->cache_lookup3(CacheOp::ITE, f, t, e, result)) {
-        return result;
-    }
+// Explicit-stack frame of bdd_ite
+struct BDDIteFrame {
+    Arc f, t, e;
+    Arc sub[2][3];
+    bddvar var;
+    int stage;
+};
 
-    // Get top variable
+static void bdd_ite_push(DDManager* mgr, std::vector<BDDIteFrame>& stack, Arc f, Arc t, Arc e) {
     bddvar f_var = mgr->node_at(f.index()).var();
     bddvar t_var = t.is_constant() ? BDDVAR_MAX : mgr->node_at(t.index()).var();
     bddvar e_var = e.is_constant() ? BDDVAR_MAX : mgr->node_at(e.index()).var();
-    bddvar top_var = mgr->var_of_top_lev(f_var, mgr->var_of_top_lev(t_var, e_var));
 
-    // Split
-    Arc f0, f1, t0, t1, e0, e1;
+    BDDIteFrame frame;
+    frame.f = f;
+    frame.t = t;
+    frame.e = e;
+    frame.var = mgr->var_of_top_lev(f_var, mgr->var_of_top_lev(t_var, e_var));
+    frame.stage = 0;
+    bdd_split(mgr, f, frame.var, frame.sub[0][0], frame.sub[1][0]);
+    bdd_split(mgr, t, frame.var, frame.sub[0][1], frame.sub[1][1]);
+    bdd_split(mgr, e, frame.var, frame.sub[0][2], frame.sub[1][2]);
+    stack.push_back(frame);
+}
 
-    auto split = [mgr, top_var](Arc a, Arc& a0, Arc& a1) {
-        if (a.is_constant()) {
-            a0 = a1 = a;
-        } else {
-            bddvar v = mgr->node_at(a.index()).var();
-            if (v == top_var) {
-                const DDNode& node = mgr->node_at(a.index());
-                a0 = node.arc0();
-                a1 = node.arc1();
-                if (a.is_negated()) {
-                    a0 = a0.negated();
-                    a1 = a1.negated();
-                }
+// ITE operation (iterative, safe at any depth)
+static Arc bdd_ite(DDManager* mgr, Arc f, Arc t, Arc e) {
+    Arc result;
+    if (bdd_ite_terminal(f, t, e, result)) return result;
+    SBDD2_PROFILE_SCOPE(mgr, CacheOp::ITE);
+    SBDD2_PROFILE_CALL(mgr, CacheOp::ITE);
+    if (mgr->cache_lookup3(CacheOp::ITE, f, t, e, result)) {
+        SBDD2_PROFILE_HIT(mgr, CacheOp::ITE);
+        return result;
+    }
+
+    std::vector<BDDIteFrame> stack;
+    std::vector<Arc> results;
+    bdd_ite_push(mgr, stack, f, t, e);
+
+    while (!stack.empty()) {
+        BDDIteFrame& frame = stack.back();
+        if (frame.stage < 2) {
+            const Arc* sub = frame.sub[frame.stage];
+            Arc sf = sub[0], st = sub[1], se = sub[2];
+            ++frame.stage;
+            if (bdd_ite_terminal(sf, st, se, result)) {
+                results.push_back(result);
+                continue;
+            }
+            SBDD2_PROFILE_CALL(mgr, CacheOp::ITE);
+            if (mgr->cache_lookup3(CacheOp::ITE, sf, st, se, result)) {
+                SBDD2_PROFILE_HIT(mgr, CacheOp::ITE);
+                results.push_back(result);
             } else {
-                a0 = a1 = a;
+                bdd_ite_push(mgr, stack, sf, st, se);
             }
+            continue;
         }
-    };
-
-    split(f, f0, f1);
-    split(t, t0, t1);
-    split(e, e0, e1);
 
-    Arc r0 = bdd_ite(mgr, f0, t0, e0);
-    Arc r1 = bdd_ite(mgr, f1, t1, e1);
+        Arc r1 = results.back();
+        results.pop_back();
+        Arc r0 = results.back();
+        results.pop_back();
 
-    result = mgr->get_or_create_node_bdd(top_var, r0, r1, true);
-    mgr->cache_insert3(CacheOp::ITE, f, t, e, result);
-    return result;
+        result = mgr->get_or_create_node_bdd(frame.var, r0, r1, true);
+        mgr->cache_insert3(CacheOp::ITE, frame.f, frame.t, frame.e, result);
+        results.push_back(result);
+        stack.pop_back();
+    }
+    return results.back();
 }
 
 BDD BDD::ite(const BDD& t, const BDD& e) const {
@@ -308,31 +396,122 @@ BDD BDD::ite(const BDD& t, const BDD& e) const {
     return BDD(manager_, result);
 }
 
-// Restrict
-static Arc bdd_restrict(DDManager* mgr, Arc f, bddvar v, bool value) {
-    if (f.is_constant()) return f;
+// Explicit-stack frame shared by the single-operand kernels
+// (restrict, compose): f is the operand, sub[] its two cofactors.
+struct BDDUnaryFrame {
+    Arc f;
+    Arc sub[2];
+    bddvar var;
+    int stage;
+};
+
+static void bdd_unary_push(DDManager* mgr, std::vector<BDDUnaryFrame>& stack, Arc f) {
+    BDDUnaryFrame frame;
+    frame.f = f;
+    frame.var = mgr->node_at(f.index()).var();
+    frame.stage = 0;
+    bdd_split(mgr, f, frame.var, frame.sub[0], frame.sub[1]);
+    stack.push_back(frame);
+}
 
-    bddvar f_var = mgr->node_at(f.index()).var();
-    bddvar v_lev = mgr->lev_of_var(v);
-    bddvar f_lev = mgr->lev_of_var(f_var);
-    if (f_lev < v_lev) return f;  // f_var is below v in DD (smaller level = further from root)
+// Cofactor by a cube (a conjunction of literals, given as a BDD arc). The
+// single-variable restrict is the cube of one literal, so both share the
+// cache entry format (RESTRICT, f, cube).
+static bool bdd_cube_is_zero(Arc a) {
+    return a.is_constant() && a.terminal_value() == a.is_negated();
+}
 
-    const DDNode& node = mgr->node_at(f.index());
-    Arc f0 = node.arc0();
-    Arc f1 = node.arc1();
-    if (f.is_negated()) {
-        f0 = f0.negated();
-        f1 = f1.negated();
+// Explicit-stack frame of bdd_cofactor: f is split at var, c stays the same
+struct BDDCofactorFrame {
+    Arc f, c;
+    Arc sub[2];
+    bddvar var;
+    int stage;
+};
+
+// Terminal, cached and tail cases of bdd_cofactor. Advances (f, c) past cube
+// literals that resolve without a new node; returns true if the result is
+// determined, false if f's top variable is above every literal of c.
+static bool bdd_cofactor_shortcut(DDManager* mgr, Arc& f, Arc& c, Arc& result) {
+    while (true) {
+        if (f.is_constant() || c.is_constant()) {
+            result = f;
+            return true;
+        }
+        if (mgr->cache_lookup(CacheOp::RESTRICT, f, c, result)) return true;
+
+        bddvar c_var = mgr->node_at(c.index()).var();
+        bddvar f_var = mgr->node_at(f.index()).var();
+        bddvar c_lev = mgr->lev_of_var(c_var);
+        bddvar f_lev = mgr->lev_of_var(f_var);
+        if (f_lev > c_lev) return false;
+
+        Arc c0, c1;
+        bdd_split(mgr, c, c_var, c0, c1);
+        bool positive = bdd_cube_is_zero(c0);
+        if (f_lev == c_lev) {
+            Arc f0, f1;
+            bdd_split(mgr, f, f_var, f0, f1);
+            f = positive ? f1 : f0;
+        }
+        // Otherwise f does not depend on the literal's variable
+        c = positive ? c1 : c0;
     }
+}
 
-    if (f_var == v) {
-        return value ? f1 : f0;
+// Cofactor (iterative, safe at any depth)
+static Arc bdd_cofactor(DDManager* mgr, Arc f, Arc c) {
+    Arc result;
+    if (bdd_cofactor_shortcut(mgr, f, c, result)) return result;
+
+    auto push = [mgr](std::vector<BDDCofactorFrame>& stack, Arc a, Arc cube) {
+        BDDCofactorFrame frame;
+        frame.f = a;
+        frame.c = cube;
+        frame.var = mgr->node_at(a.index()).var();
+        frame.stage = 0;
+        bdd_split(mgr, a, frame.var, frame.sub[0], frame.sub[1]);
+        stack.push_back(frame);
+    };
+
+    std::vector<BDDCofactorFrame> stack;
+    std::vector<Arc> results;
+    push(stack, f, c);
+
+    while (!stack.empty()) {
+        BDDCofactorFrame& frame = stack.back();
+        if (frame.stage < 2) {
+            Arc sf = frame.sub[frame.stage];
+            Arc sc = frame.c;
+            ++frame.stage;
+            if (bdd_cofactor_shortcut(mgr, sf, sc, result)) {
+                results.push_back(result);
+            } else {
+                push(stack, sf, sc);
+            }
+            continue;
+        }
+
+        // f_lev > c_lev (f_var is above the cube, larger level = closer to root)
+        Arc r1 = results.back();
+        results.pop_back();
+        Arc r0 = results.back();
+        results.pop_back();
+
+        result = mgr->get_or_create_node_bdd(frame.var, r0, r1, true);
+        mgr->cache_insert(CacheOp::RESTRICT, frame.f, frame.c, result);
+        results.push_back(result);
+        stack.pop_back();
     }
+    return results.back();
+}
 
-    // f_lev > v_lev (f_var is above v in DD, larger level = closer to root)
-    Arc r0 = bdd_restrict(mgr, f0, v, value);
-    Arc r1 = bdd_restrict(mgr, f1, v, value);
-    return mgr->get_or_create_node_bdd(f_var, r0, r1, true);
+static Arc bdd_restrict(DDManager* mgr, Arc f, bddvar v, bool value) {
+    if (v == 0 || v > mgr->var_count()) {
+        throw DDArgumentException("Invalid variable number");
+    }
+    Arc literal = mgr->get_or_create_node_bdd(v, ARC_TERMINAL_0, ARC_TERMINAL_1, true);
+    return bdd_cofactor(mgr, f, value ? literal : literal.negated());
 }
 
 BDD BDD::restrict(bddvar v, bool value) const {
@@ -341,6 +520,140 @@ BDD BDD::restrict(bddvar v, bool value) const {
     return BDD(manager_, result);
 }
 
+BDD BDD::cofactor(const BDD& cube) const {
+    if (!manager_ || !cube.manager_ || manager_ != cube.manager_) {
+        throw DDIncompatibleException("BDD managers do not match");
+    }
+    // Each node of a cube has exactly one child that is constant 0
+    Arc c = cube.arc_;
+    if (bdd_cube_is_zero(c)) {
+        throw DDArgumentException("cofactor: cube must not be false");
+    }
+    while (!c.is_constant()) {
+        Arc c0, c1;
+        bdd_split(manager_, c, manager_->node_at(c.index()).var(), c0, c1);
+        if (bdd_cube_is_zero(c0)) {
+            c = c1;
+        } else if (bdd_cube_is_zero(c1)) {
+            c = c0;
+        } else {
+            throw DDArgumentException("cofactor: argument is not a cube");
+        }
+    }
+    Arc result = bdd_cofactor(manager_, arc_, cube.arc_);
+    return BDD(manager_, result);
+}
+
+// Explicit-stack frame of bdd_constrain
+struct BDDConstrainFrame {
+    Arc f, c;
+    Arc sub[2][2];
+    bddvar var;
+    int stage;
+};
+
+// Terminal, cached and tail cases of bdd_constrain. Follows the cofactor of c
+// that is not false while the other one is; returns true if the result is
+// determined, false if both cofactors of c at the top variable are satisfiable.
+static bool bdd_constrain_shortcut(DDManager* mgr, Arc& f, Arc& c, Arc& result) {
+    while (true) {
+        if (bdd_cube_is_zero(c)) {
+            result = ARC_TERMINAL_0;
+            return true;
+        }
+        if (f.is_constant() || c.is_constant()) {
+            result = f;
+            return true;
+        }
+        if (f == c) {
+            result = ARC_TERMINAL_1;
+            return true;
+        }
+        if (f.data == (c.data ^ 1)) {
+            result = ARC_TERMINAL_0;
+            return true;
+        }
+        SBDD2_PROFILE_CALL(mgr, CacheOp::CONSTRAIN);
+        if (mgr->cache_lookup(CacheOp::CONSTRAIN, f, c, result)) {
+            SBDD2_PROFILE_HIT(mgr, CacheOp::CONSTRAIN);
+            return true;
+        }
+
+        bddvar var = mgr->var_of_top_lev(mgr->node_at(f.index()).var(),
+                                         mgr->node_at(c.index()).var());
+        Arc f0, f1, c0, c1;
+        bdd_split(mgr, f, var, f0, f1);
+        bdd_split(mgr, c, var, c0, c1);
+        if (bdd_cube_is_zero(c0)) {
+            f = f1;
+            c = c1;
+        } else if (bdd_cube_is_zero(c1)) {
+            f = f0;
+            c = c0;
+        } else {
+            return false;
+        }
+    }
+}
+
+// Constrain (iterative, safe at any depth)
+static Arc bdd_constrain(DDManager* mgr, Arc f, Arc c) {
+    Arc result;
+    SBDD2_PROFILE_SCOPE(mgr, CacheOp::CONSTRAIN);
+    if (bdd_constrain_shortcut(mgr, f, c, result)) return result;
+
+    auto push = [mgr](std::vector<BDDConstrainFrame>& stack, Arc a, Arc care) {
+        BDDConstrainFrame frame;
+        frame.f = a;
+        frame.c = care;
+        frame.var = mgr->var_of_top_lev(mgr->node_at(a.index()).var(),
+                                        mgr->node_at(care.index()).var());
+        frame.stage = 0;
+        bdd_split(mgr, a, frame.var, frame.sub[0][0], frame.sub[1][0]);
+        bdd_split(mgr, care, frame.var, frame.sub[0][1], frame.sub[1][1]);
+        stack.push_back(frame);
+    };
+
+    std::vector<BDDConstrainFrame> stack;
+    std::vector<Arc> results;
+    push(stack, f, c);
+
+    while (!stack.empty()) {
+        BDDConstrainFrame& frame = stack.back();
+        if (frame.stage < 2) {
+            Arc sf = frame.sub[frame.stage][0];
+            Arc sc = frame.sub[frame.stage][1];
+            ++frame.stage;
+            if (bdd_constrain_shortcut(mgr, sf, sc, result)) {
+                results.push_back(result);
+            } else {
+                push(stack, sf, sc);
+            }
+            continue;
+        }
+
+        Arc r1 = results.back();
+        results.pop_back();
+        Arc r0 = results.back();
+        results.pop_back();
+
+        result = mgr->get_or_create_node_bdd(frame.var, r0, r1, true);
+        mgr->cache_insert(CacheOp::CONSTRAIN, frame.f, frame.c, result);
+        results.push_back(result);
+        stack.pop_back();
+    }
+    return results.back();
+}
+
+BDD BDD::constrain(const BDD& c) const {
+    if (!manager_ || !c.manager_ || manager_ != c.manager_) {
+        throw DDIncompatibleException("BDD managers do not match");
+    }
+    TraceScope trace(manager_, "BDD::constrain", "bdd");
+    Arc result = bdd_constrain(manager_, arc_, c.arc_);
+    return BDD(manager_, result);
+}
+
 // Quantification
 BDD BDD::exist(bddvar v) const {
     return at0(v) | at1(v);
@@ -366,39 +679,219 @@ BDD BDD::forall(const std::vector<bddvar>& vars) const {
     return result;
 }
 
-// Compose
-static Arc bdd_compose(DDManager* mgr, Arc f, bddvar v, Arc g) {
-    if (f.is_constant()) return f;
+// Relational product: exists cube. (f & g), where cube is the positive cube
+// of the quantified variables.
+static bool bdd_is_one(Arc a) {
+    return a.is_constant() && a.terminal_value() != a.is_negated();
+}
 
+// Explicit-stack frame of bdd_and_exist
+struct BDDAndExistFrame {
+    Arc f, g, c;
+    Arc sub[2][2];
+    Arc sub_c;
+    bddvar var;
+    bool quantify;
+    int stage;
+};
+
+// Terminal and cached cases of bdd_and_exist. Normalizes (f, g), drops cube
+// variables above both operands and returns true if the result is determined.
+static bool bdd_and_exist_shortcut(DDManager* mgr, Arc& f, Arc& g, Arc& c, Arc& result) {
+    if (bdd_cube_is_zero(f) || bdd_cube_is_zero(g) || f.data == (g.data ^ 1)) {
+        result = ARC_TERMINAL_0;
+        return true;
+    }
+    if (bdd_is_one(f) || f == g) f = ARC_TERMINAL_1;
+    if (bdd_is_one(g)) g = ARC_TERMINAL_1;
+    // A constant goes first (node arcs 0 and 1 sort below the terminals),
+    // otherwise order by arc so that each pair has one cache key
+    if (f.is_constant() != g.is_constant() ? g.is_constant() : f.data > g.data) {
+        std::swap(f, g);
+    }
+    if (g.is_constant()) {
+        result = ARC_TERMINAL_1;
+        return true;
+    }
+    // Only f can be constant now
+    bddvar f_var = f.is_constant() ? 0 : mgr->node_at(f.index()).var();
+    bddvar top_lev = mgr->lev_of_var(mgr->var_of_top_lev(f_var, mgr->node_at(g.index()).var()));
+    while (!c.is_constant()) {
+        const DDNode& node = mgr->node_at(c.index());
+        if (mgr->lev_of_var(node.var()) <= top_lev) break;
+        c = node.arc1();
+    }
+    if (c.is_constant()) {
+        result = bdd_apply(mgr, CacheOp::AND, f, g);
+        return true;
+    }
+    SBDD2_PROFILE_CALL(mgr, CacheOp::AND_EXIST);
+    if (mgr->cache_lookup3(CacheOp::AND_EXIST, f, g, c, result)) {
+        SBDD2_PROFILE_HIT(mgr, CacheOp::AND_EXIST);
+        return true;
+    }
+    return false;
+}
+
+// (f, g, c) as normalized by bdd_and_exist_shortcut: g and c are not constant
+static void bdd_and_exist_push(DDManager* mgr, std::vector<BDDAndExistFrame>& stack,
+                               Arc f, Arc g, Arc c) {
+    bddvar f_var = f.is_constant() ? 0 : mgr->node_at(f.index()).var();
+    const DDNode& c_node = mgr->node_at(c.index());
+
+    BDDAndExistFrame frame;
+    frame.f = f;
+    frame.g = g;
+    frame.c = c;
+    frame.var = mgr->var_of_top_lev(f_var, mgr->node_at(g.index()).var());
+    frame.quantify = (c_node.var() == frame.var);
+    frame.sub_c = frame.quantify ? c_node.arc1() : c;
+    frame.stage = 0;
+    bdd_split(mgr, f, frame.var, frame.sub[0][0], frame.sub[1][0]);
+    bdd_split(mgr, g, frame.var, frame.sub[0][1], frame.sub[1][1]);
+    stack.push_back(frame);
+}
+
+// AND-EXIST (iterative, safe at any depth)
+static Arc bdd_and_exist(DDManager* mgr, Arc f, Arc g, Arc c) {
     Arc result;
-    if (mgr->cache_lookup3(CacheOp::COMPOSE, f, Arc(v), g, result)) {
-        return result;
+    SBDD2_PROFILE_SCOPE(mgr, CacheOp::AND_EXIST);
+    if (bdd_and_exist_shortcut(mgr, f, g, c, result)) return result;
+
+    std::vector<BDDAndExistFrame> stack;
+    std::vector<Arc> results;
+    bdd_and_exist_push(mgr, stack, f, g, c);
+
+    while (!stack.empty()) {
+        BDDAndExistFrame& frame = stack.back();
+        if (frame.stage == 1 && frame.quantify && bdd_is_one(results.back())) {
+            // exists x. (h0 | h1) is already true
+            results.push_back(ARC_TERMINAL_1);
+            frame.stage = 2;
+        }
+        if (frame.stage < 2) {
+            Arc sf = frame.sub[frame.stage][0];
+            Arc sg = frame.sub[frame.stage][1];
+            Arc sc = frame.sub_c;
+            ++frame.stage;
+            if (bdd_and_exist_shortcut(mgr, sf, sg, sc, result)) {
+                results.push_back(result);
+            } else {
+                bdd_and_exist_push(mgr, stack, sf, sg, sc);
+            }
+            continue;
+        }
+
+        Arc r1 = results.back();
+        results.pop_back();
+        Arc r0 = results.back();
+        results.pop_back();
+
+        if (frame.quantify) {
+            result = bdd_apply(mgr, CacheOp::OR, r0, r1);
+        } else {
+            result = mgr->get_or_create_node_bdd(frame.var, r0, r1, true);
+        }
+        mgr->cache_insert3(CacheOp::AND_EXIST, frame.f, frame.g, frame.c, result);
+        results.push_back(result);
+        stack.pop_back();
     }
+    return results.back();
+}
 
-    bddvar f_var = mgr->node_at(f.index()).var();
-    bddvar v_lev = mgr->lev_of_var(v);
-    bddvar f_lev = mgr->lev_of_var(f_var);
-    if (f_lev < v_lev) return f;  // f_var is below v in DD (smaller level = further from root)
+BDD BDD::and_exist(const BDD& g, const std::vector<bddvar>& vars) const {
+    if (!manager_ || !g.manager_ || manager_ != g.manager_) {
+        throw DDIncompatibleException("BDD managers do not match");
+    }
+    TraceScope trace(manager_, "BDD::and_exist", "bdd");
+    // Build the positive cube bottom-up
+    std::vector<bddvar> levs;
+    levs.reserve(vars.size());
+    for (bddvar v : vars) {
+        if (v == 0 || v > manager_->var_count()) {
+            throw DDArgumentException("Invalid variable number");
+        }
+        levs.push_back(manager_->lev_of_var(v));
+    }
+    std::sort(levs.begin(), levs.end());
+    levs.erase(std::unique(levs.begin(), levs.end()), levs.end());
+    Arc cube = ARC_TERMINAL_1;
+    for (bddvar lev : levs) {
+        cube = manager_->get_or_create_node_bdd(manager_->var_of_lev(lev),
+                                                ARC_TERMINAL_0, cube, true);
+    }
+    BDD cube_bdd(manager_, cube);  // keep the cube alive during the call
+    Arc result = bdd_and_exist(manager_, arc_, g.arc_, cube);
+    return BDD(manager_, result);
+}
 
-    const DDNode& node = mgr->node_at(f.index());
-    Arc f0 = node.arc0();
-    Arc f1 = node.arc1();
-    if (f.is_negated()) {
-        f0 = f0.negated();
-        f1 = f1.negated();
+// Terminal and cached cases of bdd_compose (returns true if result is determined)
+static bool bdd_compose_shortcut(DDManager* mgr, Arc f, bddvar v, bddvar v_lev,
+                                 Arc g, Arc& result) {
+    if (f.is_constant()) {
+        result = f;
+        return true;
+    }
+    if (mgr->cache_lookup3(CacheOp::COMPOSE, f, Arc(v), g, result)) {
+        return true;
     }
 
+    const DDNode& node = mgr->node_at(f.index());
+    bddvar f_var = node.var();
+    if (mgr->lev_of_var(f_var) < v_lev) {
+        // f_var is below v in DD (smaller level = further from root)
+        result = f;
+        return true;
+    }
     if (f_var == v) {
+        Arc f0 = node.arc0();
+        Arc f1 = node.arc1();
+        if (f.is_negated()) {
+            f0 = f0.negated();
+            f1 = f1.negated();
+        }
         result = bdd_ite(mgr, g, f1, f0);
-    } else {
-        // f_lev > v_lev (f_var is above v, larger level = closer to root)
-        Arc r0 = bdd_compose(mgr, f0, v, g);
-        Arc r1 = bdd_compose(mgr, f1, v, g);
-        result = mgr->get_or_create_node_bdd(f_var, r0, r1, true);
+        mgr->cache_insert3(CacheOp::COMPOSE, f, Arc(v), g, result);
+        return true;
     }
+    return false;
+}
 
-    mgr->cache_insert3(CacheOp::COMPOSE, f, Arc(v), g, result);
-    return result;
+// Compose (iterative, safe at any depth)
+static Arc bdd_compose(DDManager* mgr, Arc f, bddvar v, Arc g) {
+    bddvar v_lev = mgr->lev_of_var(v);
+    Arc result;
+    if (bdd_compose_shortcut(mgr, f, v, v_lev, g, result)) return result;
+
+    std::vector<BDDUnaryFrame> stack;
+    std::vector<Arc> results;
+    bdd_unary_push(mgr, stack, f);
+
+    while (!stack.empty()) {
+        BDDUnaryFrame& frame = stack.back();
+        if (frame.stage < 2) {
+            Arc sf = frame.sub[frame.stage];
+            ++frame.stage;
+            if (bdd_compose_shortcut(mgr, sf, v, v_lev, g, result)) {
+                results.push_back(result);
+            } else {
+                bdd_unary_push(mgr, stack, sf);
+            }
+            continue;
+        }
+
+        // f_lev > v_lev (f_var is above v, larger level = closer to root)
+        Arc r1 = results.back();
+        results.pop_back();
+        Arc r0 = results.back();
+        results.pop_back();
+
+        result = mgr->get_or_create_node_bdd(frame.var, r0, r1, true);
+        mgr->cache_insert3(CacheOp::COMPOSE, frame.f, Arc(v), g, result);
+        results.push_back(result);
+        stack.pop_back();
+    }
+    return results.back();
 }
 
 BDD BDD::compose(bddvar v, const BDD& g) const {
@@ -409,110 +902,151 @@ BDD BDD::compose(bddvar v, const BDD& g) const {
     return BDD(manager_, result);
 }
 
-// Counting
-double BDD::card() const {
-    if (!manager_) return 0.0;
-    if (arc_.is_constant()) {
-        bool val = arc_.terminal_value() != arc_.is_negated();
-        return val ? 1.0 : 0.0;
+// Variable renaming. The nodes are rebuilt bottom-up (by level), each as
+// ite(x_{perm[v]}, hi, lo); results are memoized per node index, the
+// negation bit of an arc is applied afterwards.
+BDD BDD::permute(const std::vector<bddvar>& perm) const {
+    if (!manager_) return BDD();
+    bddvar n = manager_->var_count();
+    for (std::size_t v = 1; v < perm.size() && v <= n; ++v) {
+        if (perm[v] == 0 || perm[v] > n) {
+            throw DDArgumentException("permute: invalid target variable");
+        }
     }
-
-    // Count with memoization
-    // SAPPOROBDD convention: larger level = closer to root
-    // Iterate from top level down to level 1
-    bddvar top_lev = manager_->top_lev();
-    std::unordered_map<std::uint64_t, double> memo;
-
-    std::function<double(Arc, bddvar)> count_rec = [&](Arc a, bddvar level) -> double {
-        if (a.is_constant()) {
-            bool val = a.terminal_value() != a.is_negated();
-            return val ? std::pow(2.0, level) : 0.0;
+    if (arc_.is_constant()) return *this;
+    TraceScope trace(manager_, "BDD::permute", "bdd");
+
+    std::vector<bddindex> nodes;
+    std::unordered_set<bddindex> visited;
+    std::vector<bddindex> todo(1, arc_.index());
+    visited.insert(arc_.index());
+    while (!todo.empty()) {
+        bddindex idx = todo.back();
+        todo.pop_back();
+        nodes.push_back(idx);
+        const DDNode& node = manager_->node_at(idx);
+        Arc children[2] = {node.arc0(), node.arc1()};
+        for (Arc child : children) {
+            if (!child.is_constant() && visited.insert(child.index()).second) {
+                todo.push_back(child.index());
+            }
         }
-
-        std::uint64_t key = (a.data << 20) | level;
-        auto it = memo.find(key);
-        if (it != memo.end()) return it->second;
-
-        const DDNode& node = manager_->node_at(a.index());
+    }
+    DDManager* mgr = manager_;
+    std::sort(nodes.begin(), nodes.end(), [mgr](bddindex a, bddindex b) {
+        return mgr->lev_of_var(mgr->node_at(a).var()) < mgr->lev_of_var(mgr->node_at(b).var());
+    });
+
+    // BDD handles keep the intermediate results alive
+    std::unordered_map<bddindex, BDD> memo;
+    auto mapped = [&memo](Arc a) -> Arc {
+        if (a.is_constant()) return a;
+        Arc r = memo[a.index()].arc();
+        return a.is_negated() ? r.negated() : r;
+    };
+    for (bddindex idx : nodes) {
+        const DDNode& node = mgr->node_at(idx);
         bddvar v = node.var();
-        bddvar v_lev = manager_->lev_of_var(v);
-
-        // Account for skipped variables
-        double skip_factor = std::pow(2.0, level - v_lev);
+        bddvar target = (v < perm.size()) ? perm[v] : v;
+        Arc lo = mapped(node.arc0());
+        Arc hi = mapped(node.arc1());
+        Arc x = mgr->get_or_create_node_bdd(target, ARC_TERMINAL_0, ARC_TERMINAL_1, true);
+        memo[idx] = BDD(mgr, bdd_ite(mgr, x, hi, lo));
+    }
+    return BDD(mgr, mapped(arc_));
+}
 
-        Arc a0 = node.arc0();
-        Arc a1 = node.arc1();
+// Counting helper: number of satisfying assignments of the function at
+// root over levels 1..lev(root). Post-order traversal with an explicit
+// stack so that deep BDDs do not overflow the call stack. Memoized per arc
+// (including the negation bit).
+template <typename T, typename Pow2>
+static T bdd_count_below(DDManager* mgr, Arc root, Pow2 pow2) {
+    auto lev_of = [mgr](Arc a) -> bddvar {
+        return a.is_constant() ? 0 : mgr->lev_of_var(mgr->node_at(a.index()).var());
+    };
+    auto children = [mgr](Arc a, Arc& a0, Arc& a1) {
+        const DDNode& node = mgr->node_at(a.index());
+        a0 = node.arc0();
+        a1 = node.arc1();
         if (a.is_negated()) {
             a0 = a0.negated();
             a1 = a1.negated();
         }
+    };
 
-        double c0 = count_rec(a0, v_lev - 1);
-        double c1 = count_rec(a1, v_lev - 1);
-        double result = skip_factor * (c0 + c1);
+    std::unordered_map<std::uint64_t, T> memo;
+    std::vector<std::pair<Arc, bool>> stack;
+    stack.emplace_back(root, false);
+
+    while (!stack.empty()) {
+        Arc a = stack.back().first;
+        bool expanded = stack.back().second;
+        stack.pop_back();
+        if (memo.count(a.data)) continue;
+
+        Arc a0, a1;
+        children(a, a0, a1);
+        if (!expanded) {
+            stack.emplace_back(a, true);
+            if (!a1.is_constant() && !memo.count(a1.data)) stack.emplace_back(a1, false);
+            if (!a0.is_constant() && !memo.count(a0.data)) stack.emplace_back(a0, false);
+            continue;
+        }
 
-        memo[key] = result;
-        return result;
-    };
+        // Account for skipped variables between this node and each child
+        bddvar a_lev = lev_of(a);
+        T result(0);
+        for (Arc c : {a0, a1}) {
+            if (c.is_constant()) {
+                if (c.terminal_value() != c.is_negated()) {
+                    result += pow2(a_lev - 1);
+                }
+            } else {
+                result += memo[c.data] * pow2(a_lev - 1 - lev_of(c));
+            }
+        }
+        memo.emplace(a.data, result);
+    }
+    return memo[root.data];
+}
 
-    return count_rec(arc_, top_lev);
+static double bdd_pow2(bddvar n) {
+    return std::pow(2.0, n);
 }
 
-double BDD::count(bddvar max_var) const {
+// Counting
+double BDD::card() const {
     if (!manager_) return 0.0;
     if (arc_.is_constant()) {
         bool val = arc_.terminal_value() != arc_.is_negated();
-        return val ? std::pow(2.0, max_var) : 0.0;
+        return val ? 1.0 : 0.0;
     }
 
-    std::unordered_map<std::uint64_t, double> memo;
-
-    // Iterate from max_var (root, highest level) down to 1 (lowest level)
     // SAPPOROBDD convention: larger level = closer to root
-    std::function<double(Arc, bddvar)> count_rec = [&](Arc a, bddvar level) -> double {
-        if (level == 0) {
-            bool val = a.is_constant() ?
-                       (a.terminal_value() != a.is_negated()) : true;
-            return val ? 1.0 : 0.0;
-        }
-
-        if (a.is_constant()) {
-            bool val = a.terminal_value() != a.is_negated();
-            return val ? std::pow(2.0, level) : 0.0;
-        }
-
-        std::uint64_t key = (a.data << 20) | level;
-        auto it = memo.find(key);
-        if (it != memo.end()) return it->second;
-
-        const DDNode& node = manager_->node_at(a.index());
-        bddvar v = node.var();
-        bddvar v_lev = manager_->lev_of_var(v);
-
-        if (v_lev < level) {
-            // Current level's variable is skipped, both branches are the same
-            double c = count_rec(a, level - 1);
-            double result = 2.0 * c;
-            memo[key] = result;
-            return result;
-        }
-
-        Arc a0 = node.arc0();
-        Arc a1 = node.arc1();
-        if (a.is_negated()) {
-            a0 = a0.negated();
-            a1 = a1.negated();
-        }
-
-        double c0 = count_rec(a0, v_lev - 1);
-        double c1 = count_rec(a1, v_lev - 1);
-        double result = c0 + c1;
+    // Variables above the root (up to top_lev) are free
+    bddvar top_lev = manager_->top_lev();
+    bddvar root_lev = manager_->lev_of_var(manager_->node_at(arc_.index()).var());
+    double below = bdd_count_below<double>(manager_, arc_, bdd_pow2);
+    return std::pow(2.0, top_lev - root_lev) * below;
+}
 
-        memo[key] = result;
-        return result;
-    };
+double BDD::count(bddvar max_var) const {
+    if (!manager_) return 0.0;
+    if (arc_.is_constant()) {
+        bool val = arc_.terminal_value() != arc_.is_negated();
+        return val ? std::pow(2.0, max_var) : 0.0;
+    }
+    if (max_var == 0) return 1.0;
 
-    return count_rec(arc_, max_var);
+    // Levels from max_var (root, highest level) down to 1 (lowest level)
+    // SAPPOROBDD convention: larger level = closer to root
+    bddvar root_lev = manager_->lev_of_var(manager_->node_at(arc_.index()).var());
+    double below = bdd_count_below<double>(manager_, arc_, bdd_pow2);
+    if (root_lev < max_var) {
+        below *= std::pow(2.0, max_var - root_lev);
+    }
+    return below;
 }
 
 #if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
@@ -524,50 +1058,21 @@ std::string BDD::exact_count() const {
         return val ? "1" : "0";
     }
 
-    // Count with memoization using levels
     // SAPPOROBDD convention: larger level = closer to root
     bddvar top_lev = manager_->top_lev();
-    std::unordered_map<std::uint64_t, exact_int_t> memo;
-
-    std::function<exact_int_t(Arc, bddvar)> count_rec = [&](Arc a, bddvar level) -> exact_int_t {
-        if (a.is_constant()) {
-            bool val = a.terminal_value() != a.is_negated();
-            if (!val) return exact_int_t(0);
-            // 2^level for remaining variables below this level
-            return exact_int_pow2(level);
-        }
-
-        std::uint64_t key = (a.data << 20) | level;
-        auto it = memo.find(key);
-        if (it != memo.end()) return it->second;
-
-        const DDNode& node = manager_->node_at(a.index());
-        bddvar v = node.var();
-        bddvar v_lev = manager_->lev_of_var(v);
-
-        Arc a0 = node.arc0();
-        Arc a1 = node.arc1();
-        if (a.is_negated()) {
-            a0 = a0.negated();
-            a1 = a1.negated();
-        }
-
-        // Account for skipped variables: 2^(level - v_lev) for levels above this node
-        exact_int_t skip_factor = exact_int_pow2(level - v_lev);
-
-        exact_int_t c0 = count_rec(a0, v_lev - 1);
-        exact_int_t c1 = count_rec(a1, v_lev - 1);
-        exact_int_t result = skip_factor * (c0 + c1);
-
-        memo[key] = result;
-        return result;
-    };
-
-    return exact_int_to_str(count_rec(arc_, top_lev));
+    bddvar root_lev = manager_->lev_of_var(manager_->node_at(arc_.index()).var());
+    exact_int_t below = bdd_count_below<exact_int_t>(
+        manager_, arc_, [](bddvar n) { return exact_int_pow2(n); });
+    return exact_int_to_str(exact_int_pow2(top_lev - root_lev) * below);
 }
 #endif
 
 // Satisfying assignment
+// Convert to ZDD (kernel shared with ZDD::to_bdd in zdd.cpp)
+ZDD BDD::to_zdd(bddvar universe) const {
+    return ZDD::from_bdd(*this, universe);
+}
+
 std::vector<int> BDD::one_sat() const {
     if (!manager_) return {};
 
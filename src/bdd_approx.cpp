@@ -0,0 +1,379 @@
+// SAPPOROBDD 2.0 - Size-bounded BDD approximation
+// MIT License
+
+#include "sbdd2/bdd.hpp"
+#include "sbdd2/trace.hpp"
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace sbdd2 {
+
+namespace {
+
+constexpr std::size_t NONE = static_cast<std::size_t>(-1);
+
+// The arcs reachable from a root, with polarity: a node reached both plainly
+// and through a complement edge appears twice, since the two functions are
+// approximated separately. Arcs are numbered parents first (by level).
+struct ArcGraph {
+    std::vector<Arc> arc;
+    std::vector<bddvar> var;
+    std::vector<Arc> child_arc[2];       // with polarity applied
+    std::vector<std::size_t> child[2];   // dense id, NONE for constants
+    std::vector<double> density;         // fraction of satisfying assignments
+};
+
+bool const_value(Arc a) {
+    return a.terminal_value() != a.is_negated();
+}
+
+// One counting pass: collect the arcs and their densities
+ArcGraph build_graph(DDManager* mgr, Arc root) {
+    ArcGraph g;
+    std::unordered_map<std::uint64_t, std::size_t> id;
+    std::vector<bddvar> level;
+    std::vector<Arc> stack(1, root);
+    while (!stack.empty()) {
+        Arc a = stack.back();
+        stack.pop_back();
+        if (a.is_constant() || !id.emplace(a.data, 0).second) continue;
+        const DDNode& node = mgr->node_at(a.index());
+        Arc c0 = a.is_negated() ? node.arc0().negated() : node.arc0();
+        Arc c1 = a.is_negated() ? node.arc1().negated() : node.arc1();
+        g.arc.push_back(a);
+        level.push_back(mgr->lev_of_var(node.var()));
+        stack.push_back(c0);
+        stack.push_back(c1);
+    }
+
+    std::vector<std::size_t> order(g.arc.size());
+    for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+        return level[x] != level[y] ? level[x] > level[y] : g.arc[x].data < g.arc[y].data;
+    });
+    std::vector<Arc> sorted(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        sorted[i] = g.arc[order[i]];
+        id[sorted[i].data] = i;
+    }
+    g.arc.swap(sorted);
+
+    std::size_t n = g.arc.size();
+    g.var.resize(n);
+    g.density.resize(n);
+    for (int b = 0; b < 2; ++b) {
+        g.child_arc[b].resize(n);
+        g.child[b].resize(n);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        Arc a = g.arc[i];
+        const DDNode& node = mgr->node_at(a.index());
+        g.var[i] = node.var();
+        for (int b = 0; b < 2; ++b) {
+            Arc c = b ? node.arc1() : node.arc0();
+            if (a.is_negated()) c = c.negated();
+            g.child_arc[b][i] = c;
+            g.child[b][i] = c.is_constant() ? NONE : id[c.data];
+        }
+    }
+    for (std::size_t i = n; i-- > 0;) {
+        double p = 0.0;
+        for (int b = 0; b < 2; ++b) {
+            std::size_t c = g.child[b][i];
+            p += c == NONE ? (const_value(g.child_arc[b][i]) ? 1.0 : 0.0) : g.density[c];
+        }
+        g.density[i] = p / 2.0;
+    }
+    return g;
+}
+
+double child_density(const ArcGraph& g, std::size_t i, int b) {
+    std::size_t c = g.child[b][i];
+    return c == NONE ? (const_value(g.child_arc[b][i]) ? 1.0 : 0.0) : g.density[c];
+}
+
+// What the rebuilt function of an arc is. Every choice is at most the
+// original function, so the result under-approximates the root.
+enum class Keep : std::uint8_t {
+    BOTH,    // node(var, child0, child1)
+    ZERO,    // false
+    ONLY0,   // node(var, child0, false)
+    ONLY1,   // node(var, false, child1)
+    REMAP0,  // child0 (valid when child1 is true)
+    REMAP1   // child1 (valid when child0 is true)
+};
+
+// Rebuild the arcs reachable from the root under the given choices
+Arc rebuild(DDManager* mgr, const ArcGraph& g, const std::vector<Keep>& keep) {
+    std::size_t n = g.arc.size();
+    std::vector<bool> reached(n, false);
+    reached[0] = true;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!reached[i]) continue;
+        for (int b = 0; b < 2; ++b) {
+            bool used = keep[i] == Keep::BOTH ||
+                        (b == 0 && (keep[i] == Keep::ONLY0 || keep[i] == Keep::REMAP0)) ||
+                        (b == 1 && (keep[i] == Keep::ONLY1 || keep[i] == Keep::REMAP1));
+            if (used && g.child[b][i] != NONE) reached[g.child[b][i]] = true;
+        }
+    }
+
+    std::vector<Arc> result(n, ARC_TERMINAL_0);
+    auto value = [&](std::size_t i, int b) {
+        std::size_t c = g.child[b][i];
+        return c == NONE ? g.child_arc[b][i] : result[c];
+    };
+    for (std::size_t i = n; i-- > 0;) {
+        if (!reached[i]) continue;
+        switch (keep[i]) {
+        case Keep::BOTH:
+            result[i] = mgr->get_or_create_node_bdd(g.var[i], value(i, 0), value(i, 1), true);
+            break;
+        case Keep::ZERO:
+            result[i] = ARC_TERMINAL_0;
+            break;
+        case Keep::ONLY0:
+            result[i] = mgr->get_or_create_node_bdd(g.var[i], value(i, 0), ARC_TERMINAL_0, true);
+            break;
+        case Keep::ONLY1:
+            result[i] = mgr->get_or_create_node_bdd(g.var[i], ARC_TERMINAL_0, value(i, 1), true);
+            break;
+        case Keep::REMAP0:
+            result[i] = value(i, 0);
+            break;
+        case Keep::REMAP1:
+            result[i] = value(i, 1);
+            break;
+        }
+    }
+    return result[0];
+}
+
+// Keep only the first `depth` arcs of path, each with the child that
+// leads to the next one; the arc at `depth` keeps its whole subgraph.
+void keep_path(const std::vector<std::size_t>& path, std::size_t depth,
+               const std::vector<int>& step, std::vector<Keep>& keep) {
+    for (std::size_t j = 0; j < depth; ++j) {
+        keep[path[j]] = step[j] ? Keep::ONLY1 : Keep::ONLY0;
+    }
+}
+
+Arc heavy_branch(DDManager* mgr, Arc root, std::size_t threshold) {
+    ArcGraph g = build_graph(mgr, root);
+    std::size_t n = g.arc.size();
+
+    // Follow the child with more satisfying assignments
+    std::vector<std::size_t> path;
+    std::vector<int> step;
+    for (std::size_t i = 0; i != NONE;) {
+        int heavy = child_density(g, i, 1) >= child_density(g, i, 0) ? 1 : 0;
+        path.push_back(i);
+        step.push_back(heavy);
+        i = g.child[heavy][i];
+    }
+
+    // Node counts of the subgraphs below each path arc, deepest first. Each
+    // subgraph contains the next one, so one sweep over the graph suffices.
+    std::vector<bool> seen_arc(n, false);
+    std::unordered_set<bddindex> seen_node;
+    std::vector<std::size_t> size(path.size());
+    std::vector<std::size_t> stack;
+    for (std::size_t k = path.size(); k-- > 0;) {
+        stack.push_back(path[k]);
+        while (!stack.empty()) {
+            std::size_t i = stack.back();
+            stack.pop_back();
+            if (seen_arc[i]) continue;
+            seen_arc[i] = true;
+            seen_node.insert(g.arc[i].index());
+            for (int b = 0; b < 2; ++b) {
+                if (g.child[b][i] != NONE) stack.push_back(g.child[b][i]);
+            }
+        }
+        size[k] = seen_node.size();
+    }
+
+    // Cut the light branches above the shallowest path arc that fits
+    std::vector<Keep> keep(n, Keep::BOTH);
+    for (std::size_t k = 0; k < path.size(); ++k) {
+        if (k + size[k] <= threshold) {
+            keep_path(path, k, step, keep);
+            return rebuild(mgr, g, keep);
+        }
+    }
+    if (path.size() > threshold) return ARC_TERMINAL_0;
+    keep_path(path, path.size(), step, keep);
+    return rebuild(mgr, g, keep);
+}
+
+Arc short_paths(DDManager* mgr, Arc root, std::size_t threshold) {
+    ArcGraph g = build_graph(mgr, root);
+    std::size_t n = g.arc.size();
+    const std::size_t INF = std::numeric_limits<std::size_t>::max() / 2;
+
+    // Nodes on the shortest path from each arc down to true, and from the
+    // root down to each arc
+    std::vector<std::size_t> below(n), above(n, INF);
+    for (std::size_t i = n; i-- > 0;) {
+        std::size_t best = INF;
+        for (int b = 0; b < 2; ++b) {
+            std::size_t c = g.child[b][i];
+            std::size_t d = c == NONE ? (const_value(g.child_arc[b][i]) ? 0 : INF) : below[c];
+            best = std::min(best, d);
+        }
+        below[i] = best == INF ? INF : best + 1;
+    }
+    above[0] = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (int b = 0; b < 2; ++b) {
+            std::size_t c = g.child[b][i];
+            if (c != NONE) above[c] = std::min(above[c], above[i] + 1);
+        }
+    }
+
+    // Longest path length whose arcs still fit: each kept arc yields at most
+    // one node of the result
+    std::vector<std::size_t> total(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        total[i] = below[i] == INF ? INF : above[i] + below[i];
+    }
+    std::vector<std::size_t> sorted(total);
+    std::sort(sorted.begin(), sorted.end());
+    std::size_t limit = INF - 1;
+    if (threshold < n && sorted[threshold] != INF) {
+        limit = sorted[threshold] - 1;
+    }
+
+    std::vector<Keep> keep(n, Keep::BOTH);
+    if (limit < below[0]) {
+        // Not even all shortest paths fit: keep one of them
+        if (below[0] > threshold) return ARC_TERMINAL_0;
+        for (std::size_t i = 0; i != NONE;) {
+            std::size_t c0 = g.child[0][i];
+            std::size_t d0 = c0 == NONE ? (const_value(g.child_arc[0][i]) ? 0 : INF) : below[c0];
+            int b = d0 + 1 == below[i] ? 0 : 1;
+            keep[i] = b ? Keep::ONLY1 : Keep::ONLY0;
+            i = g.child[b][i];
+        }
+        return rebuild(mgr, g, keep);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (total[i] > limit) keep[i] = Keep::ZERO;
+    }
+    return rebuild(mgr, g, keep);
+}
+
+// Greedy replacement of arcs by false, or by a child when the other child is
+// true, in order of the fraction of assignments lost. Reference counts on the
+// arc graph track which arcs stay reachable, so the loop ends as soon as the
+// live arc count is within the threshold.
+Arc remap_under(DDManager* mgr, Arc root, std::size_t threshold) {
+    ArcGraph g = build_graph(mgr, root);
+    std::size_t n = g.arc.size();
+
+    std::vector<std::size_t> refs(n, 0);
+    std::vector<double> reach(n, 0.0);
+    refs[0] = 1;
+    reach[0] = 1.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (int b = 0; b < 2; ++b) {
+            std::size_t c = g.child[b][i];
+            if (c == NONE) continue;
+            ++refs[c];
+            reach[c] += reach[i] / 2.0;
+        }
+    }
+
+    std::vector<Keep> choice(n, Keep::ZERO);
+    std::vector<double> loss(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        loss[i] = reach[i] * g.density[i];
+        for (int b = 0; b < 2; ++b) {
+            Arc other = g.child_arc[1 - b][i];
+            if (other.is_constant() && const_value(other)) {
+                double remap_loss = reach[i] * (g.density[i] - child_density(g, i, b));
+                if (remap_loss < loss[i]) {
+                    loss[i] = remap_loss;
+                    choice[i] = b ? Keep::REMAP1 : Keep::REMAP0;
+                }
+            }
+        }
+    }
+    std::vector<std::size_t> order(n);
+    for (std::size_t i = 0; i < n; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t x, std::size_t y) {
+        return loss[x] < loss[y];
+    });
+
+    std::vector<Keep> keep(n, Keep::BOTH);
+    std::vector<bool> dead(n, false);
+    std::size_t live = n;
+    std::vector<std::size_t> release;
+    auto drop = [&](std::size_t c) {
+        if (c != NONE && --refs[c] == 0) release.push_back(c);
+    };
+    for (std::size_t k = 0; k < n && live > threshold; ++k) {
+        std::size_t i = order[k];
+        if (dead[i]) continue;
+        keep[i] = choice[i];
+        dead[i] = true;
+        --live;
+        if (choice[i] == Keep::ZERO) {
+            drop(g.child[0][i]);
+            drop(g.child[1][i]);
+        } else {
+            // The parents of i now point to the kept child
+            std::size_t c = g.child[choice[i] == Keep::REMAP1 ? 1 : 0][i];
+            if (c != NONE) refs[c] += refs[i] - 1;
+        }
+        while (!release.empty()) {
+            std::size_t d = release.back();
+            release.pop_back();
+            if (dead[d]) continue;
+            dead[d] = true;
+            --live;
+            drop(g.child[0][d]);
+            drop(g.child[1][d]);
+        }
+    }
+    return rebuild(mgr, g, keep);
+}
+
+} // namespace
+
+BDD BDD::under_approx(std::size_t threshold) const {
+    if (!manager_ || size() <= threshold) return *this;
+    TraceScope trace(manager_, "BDD::under_approx", "bdd");
+    return BDD(manager_, remap_under(manager_, arc_, threshold));
+}
+
+BDD BDD::over_approx(std::size_t threshold) const {
+    if (!manager_) return *this;
+    return ~(~*this).under_approx(threshold);
+}
+
+BDD BDD::subset_heavy_branch(std::size_t threshold) const {
+    if (!manager_ || size() <= threshold) return *this;
+    TraceScope trace(manager_, "BDD::subset_heavy_branch", "bdd");
+    return BDD(manager_, heavy_branch(manager_, arc_, threshold));
+}
+
+BDD BDD::superset_heavy_branch(std::size_t threshold) const {
+    if (!manager_) return *this;
+    return ~(~*this).subset_heavy_branch(threshold);
+}
+
+BDD BDD::subset_short_paths(std::size_t threshold) const {
+    if (!manager_ || size() <= threshold) return *this;
+    TraceScope trace(manager_, "BDD::subset_short_paths", "bdd");
+    return BDD(manager_, short_paths(manager_, arc_, threshold));
+}
+
+BDD BDD::superset_short_paths(std::size_t threshold) const {
+    if (!manager_) return *this;
+    return ~(~*this).subset_short_paths(threshold);
+}
+
+} // namespace sbdd2
@@ -8,6 +8,7 @@
 #include <cstdlib>
 #include <ctime>
 #include <functional>
+#include <algorithm>
 
 namespace sbdd2 {
 
@@ -18,6 +19,7 @@ BDDCT::BDDCT()
     , cache_entries_(0)
     , cache0_entries_(0)
     , call_count_(0)
+    , gc_epoch_(0)
 {
 }
 
@@ -27,13 +29,12 @@ BDDCT::BDDCT(DDManager& mgr)
     , cache_entries_(0)
     , cache0_entries_(0)
     , call_count_(0)
+    , gc_epoch_(0)
 {
 }
 
 // Destructor
-BDDCT::~BDDCT() {
-    // CacheEntry destructor handles cleanup
-}
+BDDCT::~BDDCT() = default;
 
 // Move constructor
 BDDCT::BDDCT(BDDCT&& other) noexcept
@@ -46,9 +47,12 @@ BDDCT::BDDCT(BDDCT&& other) noexcept
     , cache_entries_(other.cache_entries_)
     , cache0_entries_(other.cache0_entries_)
     , call_count_(other.call_count_)
+    , gc_epoch_(other.gc_epoch_)
 {
     other.manager_ = nullptr;
     other.n_vars_ = 0;
+    other.account_memory();
+    account_memory();
 }
 
 // Move assignment
@@ -63,9 +67,12 @@ BDDCT& BDDCT::operator=(BDDCT&& other) noexcept {
         cache_entries_ = other.cache_entries_;
         cache0_entries_ = other.cache0_entries_;
         call_count_ = other.call_count_;
+        gc_epoch_ = other.gc_epoch_;
 
         other.manager_ = nullptr;
         other.n_vars_ = 0;
+        other.account_memory();
+        account_memory();
     }
     return *this;
 }
@@ -82,9 +89,12 @@ bool BDDCT::alloc(int n_vars, bddcost default_cost) {
         labels_[i] = "v" + std::to_string(i);
     }
 
-    // Initialize caches
-    cache_.resize(1024);
+    // Initialize caches (entries of a previous table are stale)
+    cache_clear();
+    cache_.reserve(1024);
     cache0_.resize(1024);
+    cache0_clear();
+    account_memory();
 
     return true;
 }
@@ -140,6 +150,9 @@ bddcost BDDCT::cost_of_level(int level) const {
 bool BDDCT::set_cost(int var_index, bddcost cost) {
     if (var_index < 0 || var_index > n_vars_) return false;
     costs_[var_index] = cost;
+    // Cached costs and filtered families depend on the table
+    cache_clear();
+    cache0_clear();
     return true;
 }
 
@@ -171,17 +184,13 @@ bool BDDCT::set_label_of_level(int level, const std::string& label) {
 
 // Cache management
 void BDDCT::cache_clear() {
-    for (auto& entry : cache_) {
-        entry.id = ~0ULL;
-        delete entry.zmap;
-        entry.zmap = nullptr;
-    }
+    cache_.clear();
     cache_entries_ = 0;
 }
 
 void BDDCT::cache_enlarge() {
-    std::size_t new_size = cache_.size() * 2;
-    cache_.resize(new_size);
+    cache_.reserve(std::max<std::size_t>(1024, cache_.bucket_count() * 2));
+    account_memory();
 }
 
 void BDDCT::cache0_clear() {
@@ -196,9 +205,21 @@ void BDDCT::cache0_clear() {
 void BDDCT::cache0_enlarge() {
     std::size_t new_size = cache0_.size() * 2;
     cache0_.resize(new_size);
+    account_memory();
 }
 
 // Cost-bounded operations
+
+// Saturating addition: the ±BDDCOST_NULL sentinels of an empty interval
+// side stay put when the cost of a variable is added
+static bddcost cost_add(bddcost x, bddcost c) {
+    if (x == BDDCOST_NULL || x == -BDDCOST_NULL) return x;
+    long long r = static_cast<long long>(x) + c;
+    if (r >= BDDCOST_NULL) return BDDCOST_NULL - 1;
+    if (r <= -BDDCOST_NULL) return -BDDCOST_NULL + 1;
+    return static_cast<bddcost>(r);
+}
+
 ZDD BDDCT::zdd_cost_le(const ZDD& f, bddcost bound) {
     bddcost aw, rb;
     return zdd_cost_le(f, bound, aw, rb);
@@ -207,189 +228,248 @@ ZDD BDDCT::zdd_cost_le(const ZDD& f, bddcost bound) {
 ZDD BDDCT::zdd_cost_le(const ZDD& f, bddcost bound,
                         bddcost& actual_weight, bddcost& reduced_bound) {
     if (!manager_ || !f.manager()) return ZDD();
-
-    call_count_++;
-
-    if (f.is_zero()) {
-        actual_weight = 0;
-        reduced_bound = bound;
-        return ZDD::empty(*manager_);
-    }
-
-    if (f.is_one()) {
-        actual_weight = 0;
-        reduced_bound = bound;
-        return (bound >= 0) ? ZDD::single(*manager_) : ZDD::empty(*manager_);
-    }
-
-    // Check cache
-    ZDD cached = cache_ref(f, bound, actual_weight, reduced_bound);
-    if (cached.is_valid()) {
-        return cached;
-    }
-
-    bddvar top = f.top();
-    bddcost c = cost(static_cast<int>(top));
-
-    ZDD f0 = f.offset(top);
-    ZDD f1 = f.onset(top);
-
-    // Process low branch (element not selected)
-    bddcost aw0, rb0;
-    ZDD z0 = zdd_cost_le(f0, bound, aw0, rb0);
-
-    // Process high branch (element selected, add cost)
-    bddcost aw1, rb1;
-    ZDD z1;
-    if (bound >= c) {
-        z1 = zdd_cost_le(f1, bound - c, aw1, rb1);
-        aw1 += c;
-    } else {
-        z1 = ZDD::empty(*manager_);
-        aw1 = 0;
-        rb1 = bound;
-    }
-
-    // Combine results
-    ZDD result;
-    if (z1.is_zero()) {
-        result = z0;
-        actual_weight = aw0;
-        reduced_bound = rb0;
-    } else {
-        // Create node with top variable
-        Arc arc = manager_->get_or_create_node_zdd(top, z0.arc(), z1.arc(), true);
-        result = ZDD(manager_, arc);
-        actual_weight = std::max(aw0, aw1);
-        reduced_bound = std::min(rb0, rb1 + c);
-    }
-
-    // Store in cache
-    cache_ent(f, result, bound, actual_weight);
-
-    return result;
+    check_epoch();
+    Arc result = cost_le_arc(f.arc(), bound, actual_weight, reduced_bound);
+    account_memory();
+    return ZDD(manager_, result);
 }
 
 ZDD BDDCT::zdd_cost_le0(const ZDD& f, bddcost bound) {
-    // Simple version without weight tracking
     if (!manager_ || !f.manager()) return ZDD();
-
-    if (f.is_zero()) return ZDD::empty(*manager_);
-    if (f.is_one()) return (bound >= 0) ? ZDD::single(*manager_) : ZDD::empty(*manager_);
-
-    bddvar top = f.top();
-    bddcost c = cost(static_cast<int>(top));
-
-    ZDD f0 = f.offset(top);
-    ZDD f1 = f.onset(top);
-
-    ZDD z0 = zdd_cost_le0(f0, bound);
-    ZDD z1 = (bound >= c) ? zdd_cost_le0(f1, bound - c) : ZDD::empty(*manager_);
-
-    if (z1.is_zero()) {
-        return z0;
+    check_epoch();
+    bddcost aw, rb;
+    Arc result = cost_le_arc(f.arc(), bound, aw, rb);
+    account_memory();
+    return ZDD(manager_, result);
+}
+
+// Frame of the explicit-stack cost kernels: the node f, its branches and
+// the cost of its variable; stage counts the branches already queued
+struct CostFrame {
+    Arc f;
+    Arc sub[2];
+    bddvar var;
+    bddcost c;
+    bddcost bound;
+    std::uint8_t stage;
+};
+
+// Sets of f with cost <= bound. Besides the result, reports the interval
+// [aw, rb) of bounds that give the same result: aw is the largest cost
+// kept and rb the smallest cost dropped. Whole subfamilies are decided by
+// their (memoized) min and max cost without descending into them.
+Arc BDDCT::cost_le_arc(Arc f, bddcost bound, bddcost& aw, bddcost& rb) {
+    auto resolve = [this](Arc a, bddcost b, CostLeResult& r) -> bool {
+        call_count_++;
+        if (a == ARC_TERMINAL_0) {
+            r.result = ARC_TERMINAL_0;
+            r.aw = -BDDCOST_NULL;
+            r.rb = BDDCOST_NULL;
+            return true;
+        }
+        bddcost lo = min_cost_arc(a);
+        if (b < lo) {
+            r.result = ARC_TERMINAL_0;
+            r.aw = -BDDCOST_NULL;
+            r.rb = lo;
+            return true;
+        }
+        bddcost hi = max_cost_arc(a);
+        if (b >= hi) {
+            r.result = a;
+            r.aw = hi;
+            r.rb = BDDCOST_NULL;
+            return true;
+        }
+        return cache_ref(a, b, r);
+    };
+    // Both terminals are decided by resolve, so a is a node here
+    auto push = [this](std::vector<CostFrame>& stack, Arc a, bddcost b) {
+        const DDNode& node = manager_->node_at(a.index());
+        CostFrame frame;
+        frame.f = a;
+        frame.sub[0] = node.arc0();
+        frame.sub[1] = node.arc1();
+        frame.var = node.var();
+        frame.c = cost(static_cast<int>(frame.var));
+        frame.bound = b;
+        frame.stage = 0;
+        stack.push_back(frame);
+    };
+
+    CostLeResult entry;
+    if (!resolve(f, bound, entry)) {
+        std::vector<CostFrame> stack;
+        std::vector<CostLeResult> results;
+        push(stack, f, bound);
+
+        while (!stack.empty()) {
+            CostFrame& frame = stack.back();
+            if (frame.stage < 2) {
+                // The 1-branch sees the bound less the cost of the variable
+                bddcost b = frame.stage == 0 ? frame.bound : frame.bound - frame.c;
+                Arc sf = frame.sub[frame.stage];
+                ++frame.stage;
+                if (resolve(sf, b, entry)) {
+                    results.push_back(entry);
+                } else {
+                    push(stack, sf, b);
+                }
+                continue;
+            }
+
+            CostLeResult r1 = results.back();
+            results.pop_back();
+            CostLeResult r0 = results.back();
+            results.pop_back();
+
+            entry.result = manager_->get_or_create_node_zdd(frame.var, r0.result, r1.result, true);
+            entry.aw = std::max(r0.aw, cost_add(r1.aw, frame.c));
+            entry.rb = std::min(r0.rb, cost_add(r1.rb, frame.c));
+            cache_ent(frame.f, entry);
+            results.push_back(entry);
+            stack.pop_back();
+        }
+        entry = results.back();
     }
 
-    Arc arc = manager_->get_or_create_node_zdd(top, z0.arc(), z1.arc(), true);
-    return ZDD(manager_, arc);
+    aw = entry.aw;
+    rb = entry.rb;
+    return entry.result;
 }
 
 // Cost computation
 bddcost BDDCT::min_cost(const ZDD& f) {
     if (!manager_ || !f.manager()) return BDDCOST_NULL;
-    if (f.is_zero()) return BDDCOST_NULL;
-    if (f.is_one()) return 0;
-
-    // Check cache
-    bddcost cached = cache0_ref(0, f.id());
-    if (cached != BDDCOST_NULL) return cached;
-
-    bddvar top = f.top();
-    bddcost c = cost(static_cast<int>(top));
-
-    ZDD f0 = f.offset(top);
-    ZDD f1 = f.onset(top);
-
-    bddcost min0 = min_cost(f0);
-    bddcost min1 = min_cost(f1);
-    if (min1 != BDDCOST_NULL) min1 += c;
-
-    bddcost result;
-    if (min0 == BDDCOST_NULL) {
-        result = min1;
-    } else if (min1 == BDDCOST_NULL) {
-        result = min0;
-    } else {
-        result = std::min(min0, min1);
-    }
-
-    cache0_ent(0, f.id(), result);
-    return result;
+    check_epoch();
+    return min_cost_arc(f.arc());
 }
 
 bddcost BDDCT::max_cost(const ZDD& f) {
     if (!manager_ || !f.manager()) return BDDCOST_NULL;
-    if (f.is_zero()) return BDDCOST_NULL;
-    if (f.is_one()) return 0;
-
-    bddcost cached = cache0_ref(1, f.id());
-    if (cached != BDDCOST_NULL) return cached;
+    check_epoch();
+    return max_cost_arc(f.arc());
+}
 
-    bddvar top = f.top();
-    bddcost c = cost(static_cast<int>(top));
+bddcost BDDCT::min_cost_arc(Arc f) {
+    return extreme_cost_arc(f, 0);
+}
 
-    ZDD f0 = f.offset(top);
-    ZDD f1 = f.onset(top);
+bddcost BDDCT::max_cost_arc(Arc f) {
+    return extreme_cost_arc(f, 1);
+}
 
-    bddcost max0 = max_cost(f0);
-    bddcost max1 = max_cost(f1);
-    if (max1 != BDDCOST_NULL) max1 += c;
+// Minimum (op 0) or maximum (op 1) cost of a set in f, BDDCOST_NULL if f
+// is empty. The cache0 op code is the same as the kernel's.
+bddcost BDDCT::extreme_cost_arc(Arc f, std::uint8_t op) {
+    auto resolve = [this, op](Arc a, bddcost& r) -> bool {
+        if (a == ARC_TERMINAL_0) {
+            r = BDDCOST_NULL;
+            return true;
+        }
+        if (a == ARC_TERMINAL_1) {
+            r = 0;
+            return true;
+        }
+        r = cache0_ref(op, a.data);
+        return r != BDDCOST_NULL;
+    };
+    auto push = [this](std::vector<CostFrame>& stack, Arc a) {
+        const DDNode& node = manager_->node_at(a.index());
+        CostFrame frame;
+        frame.f = a;
+        frame.sub[0] = node.arc0();
+        frame.sub[1] = node.arc1();
+        frame.var = node.var();
+        frame.c = cost(static_cast<int>(frame.var));
+        frame.stage = 0;
+        stack.push_back(frame);
+    };
 
     bddcost result;
-    if (max0 == BDDCOST_NULL) {
-        result = max1;
-    } else if (max1 == BDDCOST_NULL) {
-        result = max0;
-    } else {
-        result = std::max(max0, max1);
-    }
+    if (resolve(f, result)) return result;
+
+    std::vector<CostFrame> stack;
+    std::vector<bddcost> results;
+    push(stack, f);
+
+    while (!stack.empty()) {
+        CostFrame& frame = stack.back();
+        if (frame.stage < 2) {
+            Arc sf = frame.sub[frame.stage];
+            ++frame.stage;
+            if (resolve(sf, result)) {
+                results.push_back(result);
+            } else {
+                push(stack, sf);
+            }
+            continue;
+        }
 
-    cache0_ent(1, f.id(), result);
-    return result;
+        bddcost r1 = results.back();
+        results.pop_back();
+        bddcost r0 = results.back();
+        results.pop_back();
+
+        // The 1-branch of a ZDD node is never empty
+        result = cost_add(r1, frame.c);
+        if (r0 != BDDCOST_NULL) {
+            result = (op == 0) ? std::min(r0, result) : std::max(r0, result);
+        }
+        cache0_ent(op, frame.f.data, result);
+        results.push_back(result);
+        stack.pop_back();
+    }
+    return results.back();
 }
 
 // Cache helpers
-ZDD BDDCT::cache_ref(const ZDD& f, bddcost bound, bddcost& aw, bddcost& rb) {
-    std::size_t idx = (f.id() * 31 + bound) % cache_.size();
-    const CacheEntry& entry = cache_[idx];
-
-    if (entry.id == f.id() && entry.zmap) {
-        auto it = entry.zmap->find(bound);
-        if (it != entry.zmap->end()) {
-            aw = 0;  // Simplified
-            rb = bound;
-            return it->second;
-        }
+
+// Reports the cache footprint to the manager (released when manager_ is null)
+void BDDCT::account_memory() {
+    std::size_t bytes = 0;
+    if (manager_) {
+        bytes = hash_table_bytes(cache_) + cache_entries_ * sizeof(CostLeResult) +
+                cache0_.capacity() * sizeof(Cache0Entry);
     }
+    memory_.update(manager_, AuxMemory::BDDCT_CACHE, bytes);
+}
 
-    return ZDD();  // Invalid - cache miss
+// Cached arcs and costs are keyed by node index, which a GC invalidates
+void BDDCT::check_epoch() {
+    if (manager_->gc_epoch() != gc_epoch_) {
+        cache_clear();
+        cache0_clear();
+        gc_epoch_ = manager_->gc_epoch();
+    }
 }
 
-void BDDCT::cache_ent(const ZDD& f, const ZDD& result, bddcost bound, bddcost cost) {
-    std::size_t idx = (f.id() * 31 + bound) % cache_.size();
-    CacheEntry& entry = cache_[idx];
+// Interval lookup: the entry with the largest aw <= bound, if bound < rb
+bool BDDCT::cache_ref(Arc f, bddcost bound, CostLeResult& entry) const {
+    auto it = cache_.find(f.data);
+    if (it == cache_.end()) return false;
+    const std::vector<CostLeResult>& intervals = it->second;
 
-    if (entry.id != f.id()) {
-        delete entry.zmap;
-        entry.zmap = new CostMap();
-        entry.id = f.id();
-    }
+    auto pos = std::upper_bound(intervals.begin(), intervals.end(), bound,
+        [](bddcost b, const CostLeResult& e) { return b < e.aw; });
+    if (pos == intervals.begin()) return false;
+    --pos;
+    if (bound >= pos->rb) return false;
+    entry = *pos;
+    return true;
+}
 
-    (*entry.zmap)[bound] = result;
+void BDDCT::cache_ent(Arc f, const CostLeResult& entry) {
+    std::vector<CostLeResult>& intervals = cache_[f.data];
+    // Intervals of distinct results are disjoint, so ordering by aw suffices
+    auto pos = std::upper_bound(intervals.begin(), intervals.end(), entry.aw,
+        [](bddcost aw, const CostLeResult& e) { return aw < e.aw; });
+    intervals.insert(pos, entry);
     cache_entries_++;
 }
 
 bddcost BDDCT::cache0_ref(std::uint8_t op, std::uint64_t id) const {
+    if (cache0_.empty()) return BDDCOST_NULL;
     std::size_t idx = (id * 31 + op) % cache0_.size();
     const Cache0Entry& entry = cache0_[idx];
 
@@ -401,6 +481,7 @@ bddcost BDDCT::cache0_ref(std::uint8_t op, std::uint64_t id) const {
 }
 
 void BDDCT::cache0_ent(std::uint8_t op, std::uint64_t id, bddcost result) {
+    if (cache0_.empty()) return;
     std::size_t idx = (id * 31 + op) % cache0_.size();
     Cache0Entry& entry = cache0_[idx];
 
@@ -0,0 +1,409 @@
+// SAPPOROBDD 2.0 - Chain-reduced ZDD implementation
+// MIT License
+
+#include "sbdd2/chain_zdd.hpp"
+#include "sbdd2/zdd.hpp"
+#include "sbdd2/trace.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace sbdd2 {
+
+// Decoded chain node: levels top..bottom all have 0-edge lo; the 1-edge of
+// each level leads to the next lower level, and that of bottom to hi. A plain
+// node is the chain with top == bottom. Terminals have top == bottom == 0.
+struct ChainNode {
+    bddvar top, bottom;
+    Arc lo, hi;
+};
+
+static ChainNode chain_of(DDManager* mgr, Arc f) {
+    ChainNode c;
+    if (f.is_constant()) {
+        c.top = c.bottom = 0;
+        c.lo = c.hi = f;
+        return c;
+    }
+    const DDNode& node = mgr->node_at(f.index());
+    c.top = mgr->lev_of_var(node.var());
+    c.lo = node.arc0();
+    Arc a1 = node.arc1();
+    if (node.is_chain_head()) {
+        // Chain head: the negated 1-arc points to the bottom node
+        const DDNode& tail = mgr->node_at(a1.index());
+        c.bottom = mgr->lev_of_var(tail.var());
+        c.hi = tail.arc1();
+    } else {
+        c.bottom = c.top;
+        c.hi = a1;
+    }
+    return c;
+}
+
+static bddvar chain_top(DDManager* mgr, Arc f) {
+    return f.is_constant() ? 0 : mgr->lev_of_var(mgr->node_at(f.index()).var());
+}
+
+// Canonical node for the chain [top:bottom](lo, hi). Applies zero-suppression
+// at the bottom and absorbs hi when it continues the chain one level down.
+static Arc chain_make(DDManager* mgr, bddvar top, bddvar bottom, Arc lo, Arc hi) {
+    while (hi == ARC_TERMINAL_0) {
+        if (bottom == top) return lo;
+        // The bottom level vanishes; the level above now has 1-edge lo
+        hi = lo;
+        ++bottom;
+    }
+    if (!hi.is_constant()) {
+        ChainNode h = chain_of(mgr, hi);
+        if (h.top + 1 == bottom && h.lo == lo) {
+            bottom = h.bottom;
+            hi = h.hi;
+        }
+    }
+    Arc tail = mgr->get_or_create_node_zdd(mgr->var_of_lev(bottom), lo, hi, true);
+    if (top == bottom) return tail;
+    return mgr->get_or_create_chain_head(mgr->var_of_lev(top), lo, tail);
+}
+
+// An operand of the binary kernels: f read from level lev downwards, i.e. the
+// chain of f cut to [lev:bottom]. Only the root chain of f can be cut.
+struct ChainView {
+    Arc f;
+    bddvar lev;
+};
+
+static ChainView chain_view(DDManager* mgr, Arc f) {
+    ChainView v;
+    v.f = f;
+    v.lev = chain_top(mgr, f);
+    return v;
+}
+
+static Arc chain_materialize(DDManager* mgr, const ChainView& v) {
+    if (v.f.is_constant()) return v.f;
+    ChainNode c = chain_of(mgr, v.f);
+    if (v.lev == c.top) return v.f;
+    return chain_make(mgr, v.lev, c.bottom, c.lo, c.hi);
+}
+
+// What the 1-edge at level lev of the chain c leads to
+static ChainView chain_next(DDManager* mgr, Arc f, const ChainNode& c, bddvar lev) {
+    if (lev == c.bottom) return chain_view(mgr, c.hi);
+    ChainView v;
+    v.f = f;
+    v.lev = lev - 1;
+    return v;
+}
+
+enum class ChainOp { UNION, INTERSECT, DIFF };
+
+static CacheOp chain_cache_op(ChainOp op) {
+    switch (op) {
+    case ChainOp::UNION: return CacheOp::CHAIN_UNION;
+    case ChainOp::INTERSECT: return CacheOp::CHAIN_INTERSECT;
+    case ChainOp::DIFF: break;
+    }
+    return CacheOp::CHAIN_DIFF;
+}
+
+// The cache key holds one level: the common cut level, or 0 for two uncut
+// operands at different levels. Other pairs do O(1) work before reaching a
+// cacheable pair, so they are not cached.
+static bool chain_cacheable(DDManager* mgr, const ChainView& f, const ChainView& g,
+                            Arc& level_key) {
+    level_key = Arc(f.lev == g.lev ? static_cast<std::uint64_t>(f.lev) : 0);
+    return f.lev == g.lev ||
+           (f.lev == chain_top(mgr, f.f) && g.lev == chain_top(mgr, g.f));
+}
+
+// Explicit-stack frame of chain_apply. The nsub operand pairs sub_f/sub_g
+// give r0 (and r1); the result is chain_make(top, bottom, r0, r1), with
+// r1 = hi if nsub == 1, or just r0 if top == 0.
+struct ChainApplyFrame {
+    ChainView f, g;
+    ChainView sub_f[2];
+    ChainView sub_g[2];
+    int nsub;
+    bddvar top, bottom;
+    Arc hi;
+    int stage;
+};
+
+// Terminal and cached cases of chain_apply (returns true if the result is
+// determined). Orders the operands of the commutative operations.
+static bool chain_apply_shortcut(DDManager* mgr, ChainOp op, ChainView& f, ChainView& g,
+                                 Arc& result) {
+    bool same = f.f == g.f && f.lev == g.lev;
+    switch (op) {
+    case ChainOp::UNION:
+        if (f.f == ARC_TERMINAL_0 || same) { result = chain_materialize(mgr, g); return true; }
+        if (g.f == ARC_TERMINAL_0) { result = chain_materialize(mgr, f); return true; }
+        if (g.f.data < f.f.data || (g.f == f.f && g.lev < f.lev)) std::swap(f, g);
+        break;
+    case ChainOp::INTERSECT:
+        if (f.f == ARC_TERMINAL_0 || g.f == ARC_TERMINAL_0) { result = ARC_TERMINAL_0; return true; }
+        if (same) { result = chain_materialize(mgr, f); return true; }
+        if (g.f.data < f.f.data || (g.f == f.f && g.lev < f.lev)) std::swap(f, g);
+        break;
+    case ChainOp::DIFF:
+        if (f.f == ARC_TERMINAL_0 || same) { result = ARC_TERMINAL_0; return true; }
+        if (g.f == ARC_TERMINAL_0) { result = chain_materialize(mgr, f); return true; }
+        break;
+    }
+    Arc level_key;
+    return chain_cacheable(mgr, f, g, level_key) &&
+           mgr->cache_lookup3(chain_cache_op(op), f.f, g.f, level_key, result);
+}
+
+static void chain_apply_push(DDManager* mgr, ChainOp op, std::vector<ChainApplyFrame>& stack,
+                             const ChainView& f, const ChainView& g) {
+    ChainApplyFrame frame;
+    frame.f = f;
+    frame.g = g;
+    frame.top = frame.bottom = 0;
+    frame.stage = 0;
+    if (f.lev == g.lev) {
+        // Both chains cover [lev:m]; every level of that range combines the
+        // same 0-children, so the whole range is one step
+        ChainNode cf = chain_of(mgr, f.f);
+        ChainNode cg = chain_of(mgr, g.f);
+        bddvar m = std::max(cf.bottom, cg.bottom);
+        frame.sub_f[0] = chain_view(mgr, cf.lo);
+        frame.sub_g[0] = chain_view(mgr, cg.lo);
+        frame.sub_f[1] = chain_next(mgr, f.f, cf, m);
+        frame.sub_g[1] = chain_next(mgr, g.f, cg, m);
+        frame.nsub = 2;
+        frame.top = f.lev;
+        frame.bottom = m;
+    } else {
+        // One operand has no set with the top variables of the other
+        bool f_higher = f.lev > g.lev;
+        const ChainView& hv = f_higher ? f : g;
+        const ChainView& lv = f_higher ? g : f;
+        ChainNode ch = chain_of(mgr, hv.f);
+        ChainView h0 = chain_view(mgr, ch.lo);
+        frame.nsub = 1;
+        if (op == ChainOp::INTERSECT) {
+            frame.sub_f[0] = h0;
+            frame.sub_g[0] = lv;
+        } else if (op == ChainOp::DIFF && !f_higher) {
+            frame.sub_f[0] = f;
+            frame.sub_g[0] = h0;
+        } else {
+            // Union, or difference with f higher: the top level of hv keeps
+            // its 1-child and combines its 0-child with lv. chain_make joins
+            // it back to the rest of the chain if the 0-child is unchanged.
+            frame.sub_f[0] = f_higher ? h0 : lv;
+            frame.sub_g[0] = f_higher ? lv : h0;
+            frame.hi = chain_materialize(mgr, chain_next(mgr, hv.f, ch, hv.lev));
+            frame.top = frame.bottom = hv.lev;
+        }
+    }
+    stack.push_back(frame);
+}
+
+// Iterative, safe at any chain length
+static Arc chain_apply(DDManager* mgr, ChainOp op, ChainView f, ChainView g) {
+    Arc result;
+    if (chain_apply_shortcut(mgr, op, f, g, result)) return result;
+
+    std::vector<ChainApplyFrame> stack;
+    std::vector<Arc> results;
+    chain_apply_push(mgr, op, stack, f, g);
+
+    while (!stack.empty()) {
+        ChainApplyFrame& frame = stack.back();
+        if (frame.stage < frame.nsub) {
+            ChainView sf = frame.sub_f[frame.stage];
+            ChainView sg = frame.sub_g[frame.stage];
+            ++frame.stage;
+            if (chain_apply_shortcut(mgr, op, sf, sg, result)) {
+                results.push_back(result);
+            } else {
+                chain_apply_push(mgr, op, stack, sf, sg);
+            }
+            continue;
+        }
+
+        Arc r1 = frame.hi;
+        if (frame.nsub == 2) {
+            r1 = results.back();
+            results.pop_back();
+        }
+        Arc r0 = results.back();
+        results.pop_back();
+        result = frame.top == 0 ? r0 : chain_make(mgr, frame.top, frame.bottom, r0, r1);
+
+        Arc level_key;
+        if (chain_cacheable(mgr, frame.f, frame.g, level_key)) {
+            mgr->cache_insert3(chain_cache_op(op), frame.f.f, frame.g.f, level_key, result);
+        }
+        results.push_back(result);
+        stack.pop_back();
+    }
+    return results.back();
+}
+
+// Memoized post-order walk on an explicit stack, so that long chains do not
+// overflow the call stack. leaf(t) is the result of a terminal, children(f,
+// sub) sets the two children of a node and combine(f, r0, r1) its result.
+template <typename T, typename Leaf, typename Children, typename Combine>
+static T chain_walk(Arc root, std::unordered_map<std::uint64_t, T>& memo,
+                    Leaf leaf, Children children, Combine combine) {
+    struct Frame {
+        Arc f;
+        Arc sub[2];
+        int stage;
+    };
+    auto known = [&](Arc f, T& r) -> bool {
+        if (f.is_constant()) {
+            r = leaf(f);
+            return true;
+        }
+        auto it = memo.find(f.data);
+        if (it == memo.end()) return false;
+        r = it->second;
+        return true;
+    };
+    auto push = [&](std::vector<Frame>& stack, Arc f) {
+        Frame frame;
+        frame.f = f;
+        frame.stage = 0;
+        children(f, frame.sub);
+        stack.push_back(frame);
+    };
+
+    T result;
+    if (known(root, result)) return result;
+
+    std::vector<Frame> stack;
+    std::vector<T> results;
+    push(stack, root);
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        if (frame.stage < 2) {
+            Arc sub = frame.sub[frame.stage++];
+            if (known(sub, result)) {
+                results.push_back(result);
+            } else {
+                push(stack, sub);
+            }
+            continue;
+        }
+
+        T r1 = results.back();
+        results.pop_back();
+        T r0 = results.back();
+        results.pop_back();
+        result = combine(frame.f, r0, r1);
+        memo[frame.f.data] = result;
+        results.push_back(result);
+        stack.pop_back();
+    }
+    return results.back();
+}
+
+static Arc chain_from_zdd(DDManager* mgr, Arc f, std::unordered_map<std::uint64_t, Arc>& memo) {
+    return chain_walk(f, memo,
+        [](Arc t) { return t; },
+        [mgr](Arc a, Arc (&sub)[2]) {
+            const DDNode& node = mgr->node_at(a.index());
+            sub[0] = node.arc0();
+            sub[1] = node.arc1();
+        },
+        [mgr](Arc a, Arc lo, Arc hi) -> Arc {
+            bddvar lev = mgr->lev_of_var(mgr->node_at(a.index()).var());
+            return chain_make(mgr, lev, lev, lo, hi);
+        });
+}
+
+static Arc chain_to_zdd(DDManager* mgr, Arc f, std::unordered_map<std::uint64_t, Arc>& memo) {
+    return chain_walk(f, memo,
+        [](Arc t) { return t; },
+        [mgr](Arc a, Arc (&sub)[2]) {
+            ChainNode c = chain_of(mgr, a);
+            sub[0] = c.lo;
+            sub[1] = c.hi;
+        },
+        [mgr](Arc a, Arc lo, Arc hi) -> Arc {
+            ChainNode c = chain_of(mgr, a);
+            Arc result = hi;
+            for (bddvar lev = c.bottom; lev <= c.top; ++lev) {
+                result = mgr->get_or_create_node_zdd(mgr->var_of_lev(lev), lo, result, true);
+            }
+            return result;
+        });
+}
+
+static double chain_card(DDManager* mgr, Arc f, std::unordered_map<std::uint64_t, double>& memo) {
+    return chain_walk(f, memo,
+        [](Arc t) { return t == ARC_TERMINAL_1 ? 1.0 : 0.0; },
+        [mgr](Arc a, Arc (&sub)[2]) {
+            ChainNode c = chain_of(mgr, a);
+            sub[0] = c.lo;
+            sub[1] = c.hi;
+        },
+        [mgr](Arc a, double lo, double hi) -> double {
+            ChainNode c = chain_of(mgr, a);
+            return static_cast<double>(c.top - c.bottom + 1) * lo + hi;
+        });
+}
+
+ChainZDD::ChainZDD(const ZDD& f) : DDBase() {
+    if (!f.manager()) return;
+    std::unordered_map<std::uint64_t, Arc> memo;
+    *this = ChainZDD(f.manager(), chain_from_zdd(f.manager(), f.arc(), memo));
+}
+
+ChainZDD ChainZDD::empty(DDManager& mgr) {
+    return ChainZDD(&mgr, ARC_TERMINAL_0);
+}
+
+ChainZDD ChainZDD::single(DDManager& mgr) {
+    return ChainZDD(&mgr, ARC_TERMINAL_1);
+}
+
+ZDD ChainZDD::to_zdd() const {
+    if (!manager_) return ZDD();
+    std::unordered_map<std::uint64_t, Arc> memo;
+    return ZDD(manager_, chain_to_zdd(manager_, arc_, memo));
+}
+
+ChainZDD ChainZDD::operator+(const ChainZDD& other) const {
+    if (!manager_ || !other.manager_ || manager_ != other.manager_) {
+        throw DDIncompatibleException("ChainZDD managers do not match");
+    }
+    TraceScope trace(manager_, "ChainZDD::union", "zdd");
+    Arc result = chain_apply(manager_, ChainOp::UNION, chain_view(manager_, arc_),
+                             chain_view(manager_, other.arc_));
+    return ChainZDD(manager_, result);
+}
+
+ChainZDD ChainZDD::operator&(const ChainZDD& other) const {
+    if (!manager_ || !other.manager_ || manager_ != other.manager_) {
+        throw DDIncompatibleException("ChainZDD managers do not match");
+    }
+    TraceScope trace(manager_, "ChainZDD::intersect", "zdd");
+    Arc result = chain_apply(manager_, ChainOp::INTERSECT, chain_view(manager_, arc_),
+                             chain_view(manager_, other.arc_));
+    return ChainZDD(manager_, result);
+}
+
+ChainZDD ChainZDD::operator-(const ChainZDD& other) const {
+    if (!manager_ || !other.manager_ || manager_ != other.manager_) {
+        throw DDIncompatibleException("ChainZDD managers do not match");
+    }
+    TraceScope trace(manager_, "ChainZDD::diff", "zdd");
+    Arc result = chain_apply(manager_, ChainOp::DIFF, chain_view(manager_, arc_),
+                             chain_view(manager_, other.arc_));
+    return ChainZDD(manager_, result);
+}
+
+double ChainZDD::card() const {
+    if (!manager_) return 0.0;
+    std::unordered_map<std::uint64_t, double> memo;
+    return chain_card(manager_, arc_, memo);
+}
+
+} // namespace sbdd2
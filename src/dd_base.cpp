@@ -66,6 +66,14 @@ std::vector<bddvar> DDBase::support() const {
 
         const DDNode& node = manager_->node_at(idx);
         vars.insert(node.var());
+        if (node.is_chain_head()) {
+            // A ChainZDD chain also covers the levels between head and tail
+            bddvar top = manager_->lev_of_var(node.var());
+            bddvar bottom = manager_->lev_of_var(manager_->node_at(node.arc1().index()).var());
+            for (bddvar lev = bottom + 1; lev < top; ++lev) {
+                vars.insert(manager_->var_of_lev(lev));
+            }
+        }
         stack.push(node.arc0());
         stack.push(node.arc1());
     }
@@ -5,6 +5,8 @@
 #include "sbdd2/mtdd_base.hpp"  // For MTBDDTerminalTableBase complete type
 #include "sbdd2/bdd.hpp"
 #include "sbdd2/zdd.hpp"
+#include "sbdd2/trace.hpp"
+#include "sbdd2/profile.hpp"
 #include <algorithm>
 #include <cmath>
 
@@ -19,7 +21,28 @@ DDManager::DDManager(std::size_t node_table_size, std::size_t cache_size)
     , var_count_(0)
     , gc_threshold_(0.75)
     , gc_min_nodes_(1000)
+    , parallel_cutoff_(0)
+    , gc_epoch_(0)
+    , cache_hits_(0)
+    , cache_misses_(0)
+    , peak_node_count_(0)
+#ifdef SBDD2_ENABLE_PROFILING
+    , profile_(new ProfileCounters[256])
+#else
+    , profile_()
+#endif
+    , peak_memory_(0)
+    , trace_recorder_(nullptr)
+    , base_(nullptr)
+    , base_size_(0)
+    , forks_(0)
+    , parallel_ops_(0)
 {
+    node_block_count_ = 0;
+    next_slot_ = 0;
+    aux_memory_[0] = 0;
+    aux_memory_[1] = 0;
+
     // Ensure table size is power of 2
     table_size_ = 1;
     while (table_size_ < node_table_size) {
@@ -33,20 +56,30 @@ DDManager::DDManager(std::size_t node_table_size, std::size_t cache_size)
     }
 
     // Allocate tables
-    nodes_.resize(table_size_);
+    block0_shift_ = 0;
+    while ((std::size_t(1) << block0_shift_) < table_size_) ++block0_shift_;
+    node_blocks_[0].reset(new DDNode[table_size_]);
+    node_block_count_ = 1;
+    hash_index_.assign(table_size_, 0);
     cache_.resize(cache_size_);
 
     // Initialize level mappings (index 0 is unused, 1-indexed)
     var_to_level_.push_back(0);  // placeholder for index 0
     level_to_var_.push_back(0);  // placeholder for index 0
+    note_memory();
 }
 
 // Destructor
-DDManager::~DDManager() = default;
+DDManager::~DDManager() {
+    if (base_) --base_->forks_;
+}
 
 // Move constructor
 DDManager::DDManager(DDManager&& other) noexcept
-    : nodes_(std::move(other.nodes_))
+    : node_block_count_(other.node_block_count_)
+    , block0_shift_(other.block0_shift_)
+    , next_slot_(other.next_slot_)
+    , hash_index_(std::move(other.hash_index_))
     , table_size_(other.table_size_)
     , node_count_(other.node_count_)
     , alive_count_(other.alive_count_)
@@ -60,18 +93,45 @@ DDManager::DDManager(DDManager&& other) noexcept
     , mtbdd_tables_(std::move(other.mtbdd_tables_))
     , gc_threshold_(other.gc_threshold_)
     , gc_min_nodes_(other.gc_min_nodes_)
+    , parallel_cutoff_(other.parallel_cutoff_)
+    , gc_epoch_(other.gc_epoch_)
+    , cache_hits_(other.cache_hits_)
+    , cache_misses_(other.cache_misses_)
+    , peak_node_count_(other.peak_node_count_)
+    , profile_(std::move(other.profile_))
+    , peak_memory_(other.peak_memory_.load())
+    , trace_recorder_(other.trace_recorder_.load())
+    , base_(other.base_)
+    , base_size_(other.base_size_)
+    , forks_(other.forks_.load())
+    , parallel_ops_(other.parallel_ops_.load())
 {
+    for (int b = 0; b < MAX_NODE_BLOCKS; ++b) {
+        node_blocks_[b] = std::move(other.node_blocks_[b]);
+    }
+    aux_memory_[0] = other.aux_memory_[0].load();
+    aux_memory_[1] = other.aux_memory_[1].load();
+    other.node_block_count_ = 0;
+    other.next_slot_ = 0;
     other.table_size_ = 0;
     other.node_count_ = 0;
     other.alive_count_ = 0;
     other.cache_size_ = 0;
     other.var_count_ = 0;
+    other.base_ = nullptr;
+    other.base_size_ = 0;
 }
 
 // Move assignment
 DDManager& DDManager::operator=(DDManager&& other) noexcept {
     if (this != &other) {
-        nodes_ = std::move(other.nodes_);
+        for (int b = 0; b < MAX_NODE_BLOCKS; ++b) {
+            node_blocks_[b] = std::move(other.node_blocks_[b]);
+        }
+        node_block_count_ = other.node_block_count_;
+        block0_shift_ = other.block0_shift_;
+        next_slot_ = other.next_slot_;
+        hash_index_ = std::move(other.hash_index_);
         table_size_ = other.table_size_;
         node_count_ = other.node_count_;
         alive_count_ = other.alive_count_;
@@ -85,12 +145,31 @@ DDManager& DDManager::operator=(DDManager&& other) noexcept {
         mtbdd_tables_ = std::move(other.mtbdd_tables_);
         gc_threshold_ = other.gc_threshold_;
         gc_min_nodes_ = other.gc_min_nodes_;
-
+        parallel_cutoff_ = other.parallel_cutoff_;
+        gc_epoch_ = other.gc_epoch_;
+        cache_hits_ = other.cache_hits_;
+        cache_misses_ = other.cache_misses_;
+        peak_node_count_ = other.peak_node_count_;
+        profile_ = std::move(other.profile_);
+        aux_memory_[0] = other.aux_memory_[0].load();
+        aux_memory_[1] = other.aux_memory_[1].load();
+        peak_memory_ = other.peak_memory_.load();
+        trace_recorder_ = other.trace_recorder_.load();
+        if (base_) --base_->forks_;
+        base_ = other.base_;
+        base_size_ = other.base_size_;
+        forks_ = other.forks_.load();
+        parallel_ops_ = other.parallel_ops_.load();
+
+        other.node_block_count_ = 0;
+        other.next_slot_ = 0;
         other.table_size_ = 0;
         other.node_count_ = 0;
         other.alive_count_ = 0;
         other.cache_size_ = 0;
         other.var_count_ = 0;
+        other.base_ = nullptr;
+        other.base_size_ = 0;
     }
     return *this;
 }
@@ -129,6 +208,26 @@ bddvar DDManager::new_var_of_lev(bddvar lev) {
     return v;
 }
 
+bddvar DDManager::new_vars_of_levs(const std::vector<bddvar>& levs) {
+    bddvar m = var_count_;
+    bddvar n = static_cast<bddvar>(levs.size());
+    std::vector<bool> seen(n, false);
+    for (bddvar lev : levs) {
+        if (lev <= m || lev > m + n || seen[lev - m - 1]) {
+            throw DDArgumentException("new_vars_of_levs: levels must be a permutation of the new levels");
+        }
+        seen[lev - m - 1] = true;
+    }
+    var_to_level_.resize(m + n + 1);
+    level_to_var_.resize(m + n + 1);
+    for (bddvar i = 0; i < n; ++i) {
+        var_to_level_[m + 1 + i] = levs[i];
+        level_to_var_[levs[i]] = m + 1 + i;
+    }
+    var_count_ = m + n;
+    return m + 1;
+}
+
 bddvar DDManager::lev_of_var(bddvar v) const {
     if (v == 0 || v > var_count_) {
         throw std::out_of_range("lev_of_var: Invalid variable number");
@@ -156,95 +255,139 @@ std::size_t DDManager::hash_node(bddvar var, Arc arc0, Arc arc1) const {
     return hash;
 }
 
+// Node slots: block 0 covers [0, 2^shift), block b >= 1 covers
+// [2^(shift+b-1), 2^(shift+b))
+static inline int block_of(std::size_t i, int shift) {
+    std::size_t q = i >> shift;
+    if (q == 0) return 0;
+#if defined(__GNUC__)
+    return 64 - __builtin_clzll(q);
+#else
+    int b = 0;
+    for (; q != 0; q >>= 1) ++b;
+    return b;
+#endif
+}
+
+static inline std::size_t block_start(int b, int shift) {
+    return b == 0 ? 0 : std::size_t(1) << (shift + b - 1);
+}
+
+const DDNode& DDManager::slot(std::size_t i) const {
+    int b = block_of(i, block0_shift_);
+    return node_blocks_[b][i - block_start(b, block0_shift_)];
+}
+
+DDNode& DDManager::slot(std::size_t i) {
+    int b = block_of(i, block0_shift_);
+    return node_blocks_[b][i - block_start(b, block0_shift_)];
+}
+
 // Find existing node (returns BDDINDEX_MAX if not found)
 bddindex DDManager::find_node(bddvar var, Arc arc0, Arc arc1) const {
-    std::size_t hash = hash_node(var, arc0, arc1);
-    std::size_t mask = table_size_ - 1;
-
-    for (std::size_t i = 0; i < table_size_; ++i) {
-        // Quadratic probing: hash + i^2
-        std::size_t idx = (hash + i * i) & mask;
-        const DDNode& node = nodes_[idx];
+    // A node whose children are all in the base may already exist there
+    if (base_ && (arc0.is_constant() || arc0.index() < base_size_)
+              && (arc1.is_constant() || arc1.index() < base_size_)) {
+        // The base may have grown since the fork; nodes past base_size_
+        // share our index range and are not visible here
+        bddindex idx = base_->find_node(var, arc0, arc1);
+        if (idx < base_size_) return idx;
+    }
 
-        if (node.is_empty()) {
-            return BDDINDEX_MAX;
-        }
-        if (!node.is_tombstone() && node.equals(arc0, arc1, var)) {
-            return static_cast<bddindex>(idx);
+    std::size_t mask = hash_index_.size() - 1;
+    std::size_t pos = hash_node(var, arc0, arc1) & mask;
+    // Triangular probing visits every bucket of a power-of-two index
+    for (std::size_t i = 1; i <= hash_index_.size(); ++i) {
+        bddindex entry = hash_index_[pos];
+        if (entry == 0) break;
+        if (slot(entry - 1).equals(arc0, arc1, var)) {
+            return static_cast<bddindex>(entry - 1 + base_size_);
         }
+        pos = (pos + i) & mask;
     }
     return BDDINDEX_MAX;
 }
 
-// Insert node (returns index)
+void DDManager::index_insert(std::size_t slot_index) {
+    const DDNode& node = slot(slot_index);
+    std::size_t mask = hash_index_.size() - 1;
+    std::size_t pos = hash_node(node.var(), node.arc0(), node.arc1()) & mask;
+    for (std::size_t i = 1; hash_index_[pos] != 0; ++i) {
+        pos = (pos + i) & mask;
+    }
+    hash_index_[pos] = static_cast<bddindex>(slot_index + 1);
+}
+
+void DDManager::rebuild_index() {
+    hash_index_.assign(table_size_, 0);
+    for (std::size_t i = 0; i < next_slot_; ++i) {
+        const DDNode& node = slot(i);
+        if (!node.is_empty() && !node.is_tombstone()) index_insert(i);
+    }
+}
+
+// Insert a node that find_node did not find (returns index)
 bddindex DDManager::insert_node(bddvar var, Arc arc0, Arc arc1, bool reduced) {
-    std::size_t hash = hash_node(var, arc0, arc1);
-    std::size_t mask = table_size_ - 1;
-    bddindex tombstone_idx = BDDINDEX_MAX;
-
-    for (std::size_t i = 0; i < table_size_; ++i) {
-        std::size_t idx = (hash + i * i) & mask;
-        DDNode& node = nodes_[idx];
-
-        if (node.is_empty()) {
-            // Use first tombstone if found, otherwise use empty slot
-            if (tombstone_idx != BDDINDEX_MAX) {
-                idx = tombstone_idx;
-            }
-            nodes_[idx] = DDNode(arc0, arc1, var, reduced, 1);
-            ++node_count_;
-            ++alive_count_;
-            return static_cast<bddindex>(idx);
-        }
-        if (node.is_tombstone() && tombstone_idx == BDDINDEX_MAX) {
-            tombstone_idx = idx;
-        }
-        if (!node.is_tombstone() && node.equals(arc0, arc1, var)) {
-            // Node already exists
-            node.inc_refcount();
-            if (node.refcount() == 1) {
-                ++alive_count_;
-            }
-            return static_cast<bddindex>(idx);
+    std::size_t i;
+    // While forks read the table, slots are only appended, so a node below
+    // a fork's base_size_ never has a child above it
+    if (!avail_.empty() && forks_ == 0) {
+        i = static_cast<std::size_t>(avail_.back());
+        avail_.pop_back();
+    } else {
+        if (next_slot_ == table_size_) resize_table();
+        if (next_slot_ == table_size_) {
+            throw DDMemoryException("Node table is full");
         }
+        i = next_slot_++;
     }
 
-    // Table is full - should not happen with proper load management
-    throw DDMemoryException("Node table is full");
+    slot(i) = DDNode(arc0, arc1, var, reduced, 1);
+    index_insert(i);
+    ++node_count_;
+    ++alive_count_;
+    if (node_count_ > peak_node_count_) peak_node_count_ = node_count_;
+#ifdef SBDD2_ENABLE_PROFILING
+    ProfileScope::note_node_created(this);
+#endif
+    return static_cast<bddindex>(i + base_size_);
+}
+
+// A negated terminal is stored as the opposite terminal
+static Arc plain_terminal(Arc a) {
+    return (a.is_constant() && a.is_negated()) ? Arc::terminal(!a.terminal_value()) : a;
 }
 
 // Get or create BDD node
 Arc DDManager::get_or_create_node_bdd(bddvar var, Arc arc0, Arc arc1, bool reduced) {
+    arc0 = plain_terminal(arc0);
+    arc1 = plain_terminal(arc1);
+
     // BDD reduction rule: if both arcs point to same location, return that arc
     // But we need to handle negation edges
     if (arc0.data == arc1.data) {
         return arc0;
     }
 
-    // Normalize: ensure 1-arc is not negated (use negation on entire result)
-    bool result_negated = false;
-    if (arc1.is_negated()) {
-        arc0 = arc0.negated();
-        arc1 = arc1.negated();
-        result_negated = true;
+    // Normalize: ensure 1-arc is neither negated nor terminal 0 (use negation
+    // on entire result), so each function has exactly one representation
+    bool result_negated = arc1.is_constant() ? !arc1.terminal_value() : arc1.is_negated();
+    if (result_negated) {
+        arc0 = plain_terminal(arc0.negated());
+        arc1 = plain_terminal(arc1.negated());
     }
 
     std::lock_guard<std::mutex> lock(table_mutex_);
 
-    // Check load factor
+    // Grow only: running kernels hold arcs without references, so GC
+    // waits for gc() / gc_if_needed()
     if (load_factor() > gc_threshold_) {
-        gc();
-        if (load_factor() > gc_threshold_) {
-            resize_table();
-        }
+        resize_table();
     }
 
     bddindex idx = find_node(var, arc0, arc1);
     if (idx != BDDINDEX_MAX) {
-        nodes_[idx].inc_refcount();
-        if (nodes_[idx].refcount() == 1) {
-            ++alive_count_;
-        }
+        ref_found(idx);
         Arc result = Arc::node(idx, false);
         return result_negated ? result.negated() : result;
     }
@@ -256,6 +399,10 @@ Arc DDManager::get_or_create_node_bdd(bddvar var, Arc arc0, Arc arc1, bool reduc
 
 // Get or create ZDD node
 Arc DDManager::get_or_create_node_zdd(bddvar var, Arc arc0, Arc arc1, bool reduced) {
+    // A negated 1-arc would read as a ChainZDD chain head
+    if (arc0.is_negated() || arc1.is_negated()) {
+        throw DDArgumentException("ZDD nodes cannot have negated arcs");
+    }
     // ZDD reduction rule: if 1-arc points to terminal 0, return 0-arc
     if (arc1 == ARC_TERMINAL_0) {
         return arc0;
@@ -264,18 +411,12 @@ Arc DDManager::get_or_create_node_zdd(bddvar var, Arc arc0, Arc arc1, bool reduc
     std::lock_guard<std::mutex> lock(table_mutex_);
 
     if (load_factor() > gc_threshold_) {
-        gc();
-        if (load_factor() > gc_threshold_) {
-            resize_table();
-        }
+        resize_table();
     }
 
     bddindex idx = find_node(var, arc0, arc1);
     if (idx != BDDINDEX_MAX) {
-        nodes_[idx].inc_refcount();
-        if (nodes_[idx].refcount() == 1) {
-            ++alive_count_;
-        }
+        ref_found(idx);
         return Arc::node(idx, false);
     }
 
@@ -283,6 +424,29 @@ Arc DDManager::get_or_create_node_zdd(bddvar var, Arc arc0, Arc arc1, bool reduc
     return Arc::node(idx, false);
 }
 
+// Chain head: the negated 1-arc to the tail is the tag
+Arc DDManager::get_or_create_chain_head(bddvar var, Arc lo, Arc tail) {
+    if (tail.is_constant() || tail.is_negated() || lo.is_negated()) {
+        throw DDArgumentException("Invalid chain head");
+    }
+    Arc arc1 = tail.negated();
+
+    std::lock_guard<std::mutex> lock(table_mutex_);
+
+    if (load_factor() > gc_threshold_) {
+        resize_table();
+    }
+
+    bddindex idx = find_node(var, lo, arc1);
+    if (idx != BDDINDEX_MAX) {
+        ref_found(idx);
+        return Arc::node(idx, false);
+    }
+
+    idx = insert_node(var, lo, arc1, true);
+    return Arc::node(idx, false);
+}
+
 // Get or create MTBDD node (BDD reduction rule, no negation edges)
 Arc DDManager::get_or_create_node_mtbdd(bddvar var, Arc arc0, Arc arc1) {
     // MTBDD reduction rule: if both arcs are the same, return that arc
@@ -295,18 +459,12 @@ Arc DDManager::get_or_create_node_mtbdd(bddvar var, Arc arc0, Arc arc1) {
     std::lock_guard<std::mutex> lock(table_mutex_);
 
     if (load_factor() > gc_threshold_) {
-        gc();
-        if (load_factor() > gc_threshold_) {
-            resize_table();
-        }
+        resize_table();
     }
 
     bddindex idx = find_node(var, arc0, arc1);
     if (idx != BDDINDEX_MAX) {
-        nodes_[idx].inc_refcount();
-        if (nodes_[idx].refcount() == 1) {
-            ++alive_count_;
-        }
+        ref_found(idx);
         return Arc::node(idx, false);
     }
 
@@ -331,18 +489,12 @@ Arc DDManager::get_or_create_node_mtzdd(bddvar var, Arc arc0, Arc arc1, bddindex
     std::lock_guard<std::mutex> lock(table_mutex_);
 
     if (load_factor() > gc_threshold_) {
-        gc();
-        if (load_factor() > gc_threshold_) {
-            resize_table();
-        }
+        resize_table();
     }
 
     bddindex idx = find_node(var, arc0, arc1);
     if (idx != BDDINDEX_MAX) {
-        nodes_[idx].inc_refcount();
-        if (nodes_[idx].refcount() == 1) {
-            ++alive_count_;
-        }
+        ref_found(idx);
         return Arc::node(idx, false);
     }
 
@@ -355,14 +507,18 @@ bddindex DDManager::create_placeholder_zdd(bddvar var) {
     // Create a placeholder node in unlinked_nodes_
     // Children are set to terminal 0 initially (will be set later)
     DDNode node(ARC_TERMINAL_0, ARC_TERMINAL_0, var, false, 0);
+    std::size_t capacity = unlinked_nodes_.capacity();
     unlinked_nodes_.push_back(node);
+    if (unlinked_nodes_.capacity() != capacity) note_memory();
     return static_cast<bddindex>(unlinked_nodes_.size() - 1);
 }
 
 bddindex DDManager::create_placeholder_bdd(bddvar var) {
     // Same as ZDD version
     DDNode node(ARC_TERMINAL_0, ARC_TERMINAL_0, var, false, 0);
+    std::size_t capacity = unlinked_nodes_.capacity();
     unlinked_nodes_.push_back(node);
+    if (unlinked_nodes_.capacity() != capacity) note_memory();
     return static_cast<bddindex>(unlinked_nodes_.size() - 1);
 }
 
@@ -383,19 +539,13 @@ Arc DDManager::finalize_node_zdd(bddindex placeholder_idx, Arc arc0, Arc arc1, b
     std::lock_guard<std::mutex> lock(table_mutex_);
 
     if (load_factor() > gc_threshold_) {
-        gc();
-        if (load_factor() > gc_threshold_) {
-            resize_table();
-        }
+        resize_table();
     }
 
     // Check if this node already exists
     bddindex idx = find_node(var, arc0, arc1);
     if (idx != BDDINDEX_MAX) {
-        nodes_[idx].inc_refcount();
-        if (nodes_[idx].refcount() == 1) {
-            ++alive_count_;
-        }
+        ref_found(idx);
         return Arc::node(idx, false);
     }
 
@@ -412,34 +562,30 @@ Arc DDManager::finalize_node_bdd(bddindex placeholder_idx, Arc arc0, Arc arc1, b
     DDNode& placeholder = unlinked_nodes_[placeholder_idx];
     bddvar var = placeholder.var();
 
+    arc0 = plain_terminal(arc0);
+    arc1 = plain_terminal(arc1);
+
     // BDD reduction rule: if both arcs point to same location, return that arc
     if (!reduced && arc0.data == arc1.data) {
         return arc0;
     }
 
-    // Normalize: ensure 1-arc is not negated
-    bool result_negated = false;
-    if (arc1.is_negated()) {
-        arc0 = arc0.negated();
-        arc1 = arc1.negated();
-        result_negated = true;
+    // Normalize as in get_or_create_node_bdd
+    bool result_negated = arc1.is_constant() ? !arc1.terminal_value() : arc1.is_negated();
+    if (result_negated) {
+        arc0 = plain_terminal(arc0.negated());
+        arc1 = plain_terminal(arc1.negated());
     }
 
     std::lock_guard<std::mutex> lock(table_mutex_);
 
     if (load_factor() > gc_threshold_) {
-        gc();
-        if (load_factor() > gc_threshold_) {
-            resize_table();
-        }
+        resize_table();
     }
 
     bddindex idx = find_node(var, arc0, arc1);
     if (idx != BDDINDEX_MAX) {
-        nodes_[idx].inc_refcount();
-        if (nodes_[idx].refcount() == 1) {
-            ++alive_count_;
-        }
+        ref_found(idx);
         Arc result = Arc::node(idx, false);
         return result_negated ? result.negated() : result;
     }
@@ -453,10 +599,13 @@ Arc DDManager::finalize_node_bdd(bddindex placeholder_idx, Arc arc0, Arc arc1, b
 void DDManager::inc_ref(Arc arc) {
     if (arc.is_constant()) return;
 
-    std::lock_guard<std::mutex> lock(table_mutex_);
     bddindex idx = arc.index();
+    if (idx < base_size_) return;  // owned by the base manager
+    idx -= base_size_;
+
+    std::lock_guard<std::mutex> lock(table_mutex_);
     if (idx < table_size_) {
-        DDNode& node = nodes_[idx];
+        DDNode& node = slot(idx);
         if (node.refcount() == 0) {
             ++alive_count_;
         }
@@ -467,10 +616,13 @@ void DDManager::inc_ref(Arc arc) {
 void DDManager::dec_ref(Arc arc) {
     if (arc.is_constant()) return;
 
-    std::lock_guard<std::mutex> lock(table_mutex_);
     bddindex idx = arc.index();
+    if (idx < base_size_) return;  // owned by the base manager
+    idx -= base_size_;
+
+    std::lock_guard<std::mutex> lock(table_mutex_);
     if (idx < table_size_) {
-        DDNode& node = nodes_[idx];
+        DDNode& node = slot(idx);
         if (node.dec_refcount()) {
             --alive_count_;
             // Don't delete immediately - GC will clean up
@@ -478,13 +630,194 @@ void DDManager::dec_ref(Arc arc) {
     }
 }
 
+void DDManager::ref_found(bddindex idx) {
+    // Tasks of a parallel section read nodes without the lock
+    if (idx < base_size_ || parallel_ops_ > 0) return;
+    DDNode& node = slot(idx - base_size_);
+    node.inc_refcount();
+    if (node.refcount() == 1) {
+        ++alive_count_;
+    }
+}
+
 // Node access
 const DDNode& DDManager::node_at(bddindex index) const {
-    return nodes_[index];
+    if (index < base_size_) return base_->node_at(index);
+    return slot(index - base_size_);
 }
 
 DDNode& DDManager::node_at(bddindex index) {
-    return nodes_[index];
+    if (index < base_size_) return base_->node_at(index);
+    return slot(index - base_size_);
+}
+
+// Snapshots
+std::unique_ptr<DDManager> DDManager::fork(std::size_t node_table_size, std::size_t cache_size) {
+    std::unique_ptr<DDManager> child(new DDManager(node_table_size, cache_size));
+    {
+        std::lock_guard<std::mutex> lock(table_mutex_);
+        child->var_count_ = var_count_.load();
+        child->var_to_level_ = var_to_level_;
+        child->level_to_var_ = level_to_var_;
+        child->base_ = this;
+        child->base_size_ = base_size_ + table_size_;
+        ++forks_;
+    }
+    child->gc_threshold_ = gc_threshold_;
+    child->gc_min_nodes_ = gc_min_nodes_;
+    child->parallel_cutoff_ = parallel_cutoff_;
+    return child;
+}
+
+// Statistics
+void DDManager::reset_stats() {
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        cache_hits_ = 0;
+        cache_misses_ = 0;
+    }
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    peak_node_count_ = node_count_;
+}
+
+// Memory accounting
+MemoryUsage DDManager::memory_usage() const {
+    MemoryUsage usage;
+    usage.node_table = table_size_ * sizeof(DDNode) + hash_index_.capacity() * sizeof(bddindex);
+    usage.cache = cache_.capacity() * sizeof(CacheEntry);
+    usage.unlinked_nodes = unlinked_nodes_.capacity() * sizeof(DDNode);
+    usage.avail = avail_.capacity() * sizeof(bddindex);
+    usage.variables = (var_to_level_.capacity() + level_to_var_.capacity()) * sizeof(bddvar);
+    usage.mtbdd_terminals = hash_table_bytes(mtbdd_tables_);
+    {
+        std::lock_guard<std::mutex> lock(mtbdd_tables_mutex_);
+        for (const auto& entry : mtbdd_tables_) {
+            usage.mtbdd_terminals += entry.second->memory_usage();
+        }
+    }
+    usage.zdd_index = aux_memory_[static_cast<int>(AuxMemory::ZDD_INDEX)].load();
+    usage.bddct_cache = aux_memory_[static_cast<int>(AuxMemory::BDDCT_CACHE)].load();
+
+    std::size_t total = usage.total();
+    std::size_t peak = peak_memory_.load();
+    while (total > peak && !peak_memory_.compare_exchange_weak(peak, total)) {
+    }
+    return usage;
+}
+
+void DDManager::note_memory(std::size_t transient) const {
+    std::size_t total = memory_usage().total() + transient;
+    std::size_t peak = peak_memory_.load();
+    while (total > peak && !peak_memory_.compare_exchange_weak(peak, total)) {
+    }
+}
+
+void DDManager::account_aux_memory(AuxMemory kind, std::ptrdiff_t delta) {
+    aux_memory_[static_cast<int>(kind)] += static_cast<std::size_t>(delta);
+    if (delta > 0) note_memory();
+}
+
+void MemoryAccount::update(DDManager* mgr, AuxMemory kind, std::size_t bytes) {
+    if (manager_ != mgr || kind_ != kind) {
+        release();
+        manager_ = mgr;
+        kind_ = kind;
+    }
+    if (!manager_) return;
+    manager_->account_aux_memory(kind_, static_cast<std::ptrdiff_t>(bytes) -
+                                        static_cast<std::ptrdiff_t>(bytes_));
+    bytes_ = bytes;
+}
+
+void MemoryAccount::release() {
+    if (manager_ && bytes_ > 0) {
+        manager_->account_aux_memory(kind_, -static_cast<std::ptrdiff_t>(bytes_));
+    }
+    bytes_ = 0;
+}
+
+// Per-operation profile
+bool DDManager::profiling_enabled() {
+#ifdef SBDD2_ENABLE_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::vector<OpProfile> DDManager::profile_report() const {
+    std::vector<OpProfile> report;
+    if (!profile_) return report;
+    for (std::size_t i = 0; i < 256; ++i) {
+        const ProfileCounters& c = profile_[i];
+        OpProfile p;
+        p.op = static_cast<CacheOp>(i);
+        p.calls = c.calls.load(std::memory_order_relaxed);
+        p.cache_hits = c.cache_hits.load(std::memory_order_relaxed);
+        p.nodes_created = c.nodes_created.load(std::memory_order_relaxed);
+        p.time_ms = c.time_ns.load(std::memory_order_relaxed) / 1e6;
+        if (p.calls > 0 || p.time_ms > 0) report.push_back(p);
+    }
+    return report;
+}
+
+void DDManager::reset_profile() {
+    if (!profile_) return;
+    for (std::size_t i = 0; i < 256; ++i) {
+        profile_[i].calls = 0;
+        profile_[i].cache_hits = 0;
+        profile_[i].nodes_created = 0;
+        profile_[i].time_ns = 0;
+    }
+}
+
+const char* cache_op_name(CacheOp op) {
+    switch (op) {
+    case CacheOp::AND: return "AND";
+    case CacheOp::OR: return "OR";
+    case CacheOp::XOR: return "XOR";
+    case CacheOp::DIFF: return "DIFF";
+    case CacheOp::ITE: return "ITE";
+    case CacheOp::RESTRICT: return "RESTRICT";
+    case CacheOp::COMPOSE: return "COMPOSE";
+    case CacheOp::ONSET: return "ONSET";
+    case CacheOp::OFFSET: return "OFFSET";
+    case CacheOp::CHANGE: return "CHANGE";
+    case CacheOp::PRODUCT: return "PRODUCT";
+    case CacheOp::QUOTIENT: return "QUOTIENT";
+    case CacheOp::REMAINDER: return "REMAINDER";
+    case CacheOp::UNION: return "UNION";
+    case CacheOp::INTERSECT: return "INTERSECT";
+    case CacheOp::RESTRICT_ZDD: return "RESTRICT_ZDD";
+    case CacheOp::PERMIT_ZDD: return "PERMIT_ZDD";
+    case CacheOp::PERMIT_SYM: return "PERMIT_SYM";
+    case CacheOp::ALWAYS: return "ALWAYS";
+    case CacheOp::SYM_CHK: return "SYM_CHK";
+    case CacheOp::SYM_SET: return "SYM_SET";
+    case CacheOp::CO_IMPLY_SET: return "CO_IMPLY_SET";
+    case CacheOp::MEET: return "MEET";
+    case CacheOp::MAXIMAL: return "MAXIMAL";
+    case CacheOp::MINIMAL: return "MINIMAL";
+    case CacheOp::NONSUP: return "NONSUP";
+    case CacheOp::NONSUB: return "NONSUB";
+    case CacheOp::SHIFT: return "SHIFT";
+    case CacheOp::UNION3: return "UNION3";
+    case CacheOp::MTBDD_PLUS: return "MTBDD_PLUS";
+    case CacheOp::MTBDD_MINUS: return "MTBDD_MINUS";
+    case CacheOp::MTBDD_TIMES: return "MTBDD_TIMES";
+    case CacheOp::MTBDD_MIN: return "MTBDD_MIN";
+    case CacheOp::MTBDD_MAX: return "MTBDD_MAX";
+    case CacheOp::MTBDD_ITE: return "MTBDD_ITE";
+    case CacheOp::ZDD_TO_BDD: return "ZDD_TO_BDD";
+    case CacheOp::BDD_TO_ZDD: return "BDD_TO_ZDD";
+    case CacheOp::CHAIN_UNION: return "CHAIN_UNION";
+    case CacheOp::CHAIN_INTERSECT: return "CHAIN_INTERSECT";
+    case CacheOp::CHAIN_DIFF: return "CHAIN_DIFF";
+    case CacheOp::AND_EXIST: return "AND_EXIST";
+    case CacheOp::CONSTRAIN: return "CONSTRAIN";
+    case CacheOp::CUSTOM: return "CUSTOM";
+    }
+    return "UNKNOWN";
 }
 
 // Load factor
@@ -493,78 +826,82 @@ double DDManager::load_factor() const {
 }
 
 // Garbage collection
-void DDManager::gc() {
+bool DDManager::gc() {
     std::lock_guard<std::mutex> lock(table_mutex_);
-    mark_and_sweep();
+    return mark_and_sweep();
 }
 
-void DDManager::gc_if_needed() {
+bool DDManager::gc_if_needed() {
     if (load_factor() > gc_threshold_ && node_count_ > gc_min_nodes_) {
-        gc();
+        return gc();
     }
+    return false;
 }
 
-void DDManager::mark_and_sweep() {
+bool DDManager::mark_and_sweep() {
+    // Forks and parallel tasks read our table without holding references
+    if (forks_ > 0 || parallel_ops_ > 0) return false;
+    TraceScope trace(this, "gc", "gc");
     // Mark all nodes that are reachable from alive nodes
-    std::vector<bool> marked(table_size_, false);
+    std::vector<bool> marked(next_slot_, false);
 
     // Mark all alive nodes and their descendants
-    for (std::size_t i = 0; i < table_size_; ++i) {
-        const DDNode& node = nodes_[i];
+    for (std::size_t i = 0; i < next_slot_; ++i) {
+        const DDNode& node = slot(i);
         if (!node.is_empty() && !node.is_tombstone() && node.refcount() > 0) {
-            mark_arc(Arc::node(i, false), marked);
+            mark_arc(Arc::node(i + base_size_, false), marked);
         }
     }
 
-    // Sweep: mark dead nodes as tombstones
+    // Sweep: mark dead nodes as tombstones and hand their slots out again
     std::size_t swept = 0;
-    for (std::size_t i = 0; i < table_size_; ++i) {
-        DDNode& node = nodes_[i];
+    for (std::size_t i = 0; i < next_slot_; ++i) {
+        DDNode& node = slot(i);
         if (!node.is_empty() && !node.is_tombstone() && !marked[i]) {
             node.mark_tombstone();
+            avail_.push_back(static_cast<bddindex>(i));
             ++swept;
         }
     }
 
     node_count_ -= swept;
+    if (swept > 0) rebuild_index();
+    ++gc_epoch_;
     cache_clear();
+    return true;
 }
 
 void DDManager::mark_arc(Arc arc, std::vector<bool>& marked) {
-    if (arc.is_constant()) return;
-
-    bddindex idx = arc.index();
-    if (idx >= table_size_ || marked[idx]) return;
-
-    marked[idx] = true;
-    const DDNode& node = nodes_[idx];
-    mark_arc(node.arc0(), marked);
-    mark_arc(node.arc1(), marked);
+    // Explicit stack so that deep DDs do not overflow the call stack
+    std::vector<Arc> stack;
+    stack.push_back(arc);
+    while (!stack.empty()) {
+        Arc a = stack.back();
+        stack.pop_back();
+        if (a.is_constant()) continue;
+
+        bddindex idx = a.index();
+        if (idx < base_size_) continue;  // base nodes are not ours to sweep
+        idx -= base_size_;
+        if (idx >= next_slot_ || marked[idx]) continue;
+
+        marked[idx] = true;
+        const DDNode& node = slot(idx);
+        stack.push_back(node.arc1());
+        stack.push_back(node.arc0());
+    }
 }
 
-// Resize table
+// Resize table: add a block as large as the whole table and rehash the
+// index (nodes keep their slots)
 void DDManager::resize_table() {
-    std::size_t new_size = table_size_ * 2;
-    std::vector<DDNode> new_nodes(new_size);
-
-    // Rehash all nodes
-    std::size_t mask = new_size - 1;
-    for (std::size_t i = 0; i < table_size_; ++i) {
-        const DDNode& node = nodes_[i];
-        if (node.is_empty() || node.is_tombstone()) continue;
-
-        std::size_t hash = hash_node(node.var(), node.arc0(), node.arc1());
-        for (std::size_t j = 0; j < new_size; ++j) {
-            std::size_t idx = (hash + j * j) & mask;
-            if (new_nodes[idx].is_empty()) {
-                new_nodes[idx] = node;
-                break;
-            }
-        }
-    }
-
-    nodes_ = std::move(new_nodes);
-    table_size_ = new_size;
+    if (node_block_count_ == MAX_NODE_BLOCKS) return;
+    TraceScope trace(this, "resize_table", "gc");
+    node_blocks_[node_block_count_].reset(new DDNode[table_size_]);
+    ++node_block_count_;
+    table_size_ *= 2;
+    rebuild_index();
+    note_memory();
 }
 
 // Cache operations
@@ -579,8 +916,10 @@ bool DDManager::cache_lookup(CacheOp op, Arc f, Arc g, Arc& result) const {
     const CacheEntry& entry = cache_[idx];
     if (entry.key1 == key1 && entry.key2 == key2) {
         result = Arc(entry.result);
+        ++cache_hits_;
         return true;
     }
+    ++cache_misses_;
     return false;
 }
 
@@ -595,8 +934,10 @@ bool DDManager::cache_lookup3(CacheOp op, Arc f, Arc g, Arc h, Arc& result) cons
     const CacheEntry& entry = cache_[idx];
     if (entry.key1 == key1 && entry.key2 == key2) {
         result = Arc(entry.result);
+        ++cache_hits_;
         return true;
     }
+    ++cache_misses_;
     return false;
 }
 
@@ -667,14 +1008,38 @@ ZDD DDManager::var_zdd(bddvar v) {
     return ZDD(this, arc);
 }
 
-// Global default manager
-static DDManager* g_default_manager = nullptr;
+// Manager bound to the calling thread by ScopedManager
+static thread_local DDManager* t_bound_manager = nullptr;
 
 DDManager& default_manager() {
-    if (!g_default_manager) {
-        g_default_manager = new DDManager();
-    }
-    return *g_default_manager;
+    if (t_bound_manager) return *t_bound_manager;
+    // Initialization of a function-local static is thread-safe in C++11.
+    // Intentionally leaked so DDs destroyed during static teardown stay valid.
+    static DDManager* global_manager = new DDManager();
+    return *global_manager;
+}
+
+DDManager* bound_manager() {
+    return t_bound_manager;
+}
+
+ScopedManager::ScopedManager(DDManager& mgr)
+    : manager_(&mgr)
+    , previous_(t_bound_manager)
+{
+    t_bound_manager = manager_;
+}
+
+ScopedManager::ScopedManager(std::size_t node_table_size, std::size_t cache_size)
+    : owned_(new DDManager(node_table_size, cache_size))
+    , manager_(owned_.get())
+    , previous_(t_bound_manager)
+{
+    t_bound_manager = manager_;
+}
+
+ScopedManager::~ScopedManager() {
+    t_bound_manager = previous_;
 }
 
 } // namespace sbdd2
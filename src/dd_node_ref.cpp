@@ -75,6 +75,9 @@ DDNodeRef DDNodeRef::child1() const {
     const DDNode* node = node_ptr();
     if (!node) return DDNodeRef();
 
+    if (node->is_chain_head()) {
+        throw DDArgumentException("child1: a chain head has no 1-child node");
+    }
     Arc child_arc = node->arc1();
     // If this reference is negated, negate the child
     if (arc_.is_negated()) {
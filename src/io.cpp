@@ -2,6 +2,7 @@
 // MIT License
 
 #include "sbdd2/io.hpp"
+#include "sbdd2/trace.hpp"
 #include <cstring>
 #include <sstream>
 #include <unordered_map>
@@ -13,6 +14,31 @@
 
 namespace sbdd2 {
 
+// ZDD arcs are never negated; a negated arc means the root is a ChainZDD
+// (whose chain heads carry a negated 1-arc) and cannot be read as a ZDD
+static bool is_plain_zdd(const ZDD& zdd) {
+    DDManager* mgr = zdd.manager();
+    std::unordered_set<bddindex> visited;
+    std::stack<Arc> stack;
+    stack.push(zdd.arc());
+    while (!stack.empty()) {
+        Arc a = stack.top();
+        stack.pop();
+        if (a.is_negated()) return false;
+        if (a.is_constant() || !visited.insert(a.index()).second) continue;
+        const DDNode& node = mgr->node_at(a.index());
+        stack.push(node.arc0());
+        stack.push(node.arc1());
+    }
+    return true;
+}
+
+static void require_plain_zdd(const ZDD& zdd) {
+    if (!is_plain_zdd(zdd)) {
+        throw DDArgumentException("ZDD has negated arcs (ChainZDD nodes cannot be exported)");
+    }
+}
+
 // Detect format from filename extension
 DDFileFormat detect_format(const std::string& filename) {
     std::size_t dot = filename.rfind('.');
@@ -86,8 +112,13 @@ static bool export_dd_binary(const DD& dd, std::ostream& os, std::uint8_t type)
         stack.push(node.arc1());
     }
 
-    // Sort by index for deterministic output
-    std::sort(nodes.begin(), nodes.end());
+    // Children before parents (import resolves arcs in file order);
+    // ties broken by index for deterministic output
+    std::sort(nodes.begin(), nodes.end(), [mgr](bddindex a, bddindex b) {
+        bddvar la = mgr->lev_of_var(mgr->node_at(a).var());
+        bddvar lb = mgr->lev_of_var(mgr->node_at(b).var());
+        return la != lb ? la < lb : a < b;
+    });
 
     // Create index mapping
     std::unordered_map<bddindex, std::uint64_t> index_map;
@@ -177,22 +208,30 @@ static DD import_dd_binary(DDManager& mgr, std::istream& is, std::uint8_t expect
 
         if (!is.good()) return DD();
 
-        // Remap arcs
+        // Remap arcs; a child must appear earlier in the file
+        bool valid = true;
         auto remap = [&](std::uint64_t data) -> Arc {
+            if (expected_type == DD_TYPE_ZDD && (data & 1) != 0) {
+                // ZDD arcs are never negated
+                valid = false;
+                return ARC_TERMINAL_0;
+            }
             if ((data & 2) != 0) {
                 // Constant
                 return Arc(data);
             }
             bddindex idx = data >> 2;
-            if (idx > 0 && idx <= arc_map.size()) {
+            if (idx > 0 && idx <= i) {
                 Arc base = arc_map[idx];
                 return (data & 1) ? base.negated() : base;
             }
-            return Arc(data);
+            valid = false;
+            return ARC_TERMINAL_0;
         };
 
         Arc low = remap(low_data);
         Arc high = remap(high_data);
+        if (!valid) return DD();
 
         // Create node
         Arc arc;
@@ -209,11 +248,14 @@ static DD import_dd_binary(DDManager& mgr, std::istream& is, std::uint8_t expect
     is.read(reinterpret_cast<char*>(&root_data), 8);
 
     Arc root;
+    if (expected_type == DD_TYPE_ZDD && (root_data & 1) != 0) {
+        return DD();
+    }
     if ((root_data & 2) != 0) {
         root = Arc(root_data);
     } else {
         bddindex idx = root_data >> 2;
-        if (idx > 0 && idx <= arc_map.size()) {
+        if (idx > 0 && idx < arc_map.size()) {
             root = arc_map[idx];
             if (root_data & 1) root = root.negated();
         }
@@ -374,6 +416,7 @@ std::string to_dot(const BDD& bdd, const std::string& name) {
 
 std::string to_dot(const ZDD& zdd, const std::string& name) {
     if (!zdd.manager()) return "";
+    require_plain_zdd(zdd);
 
     DDManager* mgr = zdd.manager();
     std::ostringstream os;
@@ -470,6 +513,7 @@ BDD import_bdd(DDManager& mgr, const std::string& filename,
 }
 
 BDD import_bdd(DDManager& mgr, std::istream& is, const ImportOptions& options) {
+    TraceScope trace(&mgr, "import_bdd", "io");
     return import_dd_binary<BDD>(mgr, is, DD_TYPE_BDD);
 }
 
@@ -481,6 +525,7 @@ bool export_zdd(const ZDD& zdd, const std::string& filename,
 }
 
 bool export_zdd(const ZDD& zdd, std::ostream& os, const ExportOptions& options) {
+    if (zdd.manager() && !is_plain_zdd(zdd)) return false;
     DDFileFormat fmt = options.format;
 
     switch (fmt) {
@@ -504,6 +549,7 @@ ZDD import_zdd(DDManager& mgr, const std::string& filename,
 }
 
 ZDD import_zdd(DDManager& mgr, std::istream& is, const ImportOptions& options) {
+    TraceScope trace(&mgr, "import_zdd", "io");
     return import_dd_binary<ZDD>(mgr, is, DD_TYPE_ZDD);
 }
 
@@ -522,8 +568,7 @@ bool validate_bdd(const BDD& bdd) {
 bool validate_zdd(const ZDD& zdd) {
     if (!zdd.manager()) return false;
     try {
-        zdd.size();
-        return true;
+        return is_plain_zdd(zdd);
     } catch (...) {
         return false;
     }
@@ -534,6 +579,7 @@ bool validate_zdd(const ZDD& zdd) {
 // Nodes are 1-indexed, 0 is terminal-0, -1 is terminal-1
 
 ZDD import_zdd_as_graphillion(DDManager& mgr, std::istream& is, int root_level) {
+    TraceScope trace(&mgr, "import_zdd_as_graphillion", "io");
     std::string line;
     std::vector<std::tuple<int, int, int>> nodes;  // (lo, hi) pairs indexed by node_id
     int max_node_id = 0;
@@ -614,6 +660,7 @@ ZDD import_zdd_as_graphillion(DDManager& mgr, const std::string& filename, int r
 
 void export_zdd_as_graphillion(const ZDD& zdd, std::ostream& os, int root_level) {
     if (!zdd.manager()) return;
+    require_plain_zdd(zdd);
 
     DDManager* mgr = zdd.manager();
 
@@ -688,6 +735,7 @@ void export_zdd_as_graphillion(const ZDD& zdd, const std::string& filename, int
 // Format similar to Knuth's TAOCP BDD format
 
 ZDD import_zdd_as_knuth(DDManager& mgr, std::istream& is, bool is_hex, int root_level) {
+    TraceScope trace(&mgr, "import_zdd_as_knuth", "io");
     std::string line;
     std::vector<std::tuple<bddvar, int, int>> nodes;  // (var, lo, hi)
     int node_count = 0;
@@ -745,6 +793,7 @@ ZDD import_zdd_as_knuth(DDManager& mgr, const std::string& filename, bool is_hex
 
 void export_zdd_as_knuth(const ZDD& zdd, std::ostream& os, bool is_hex) {
     if (!zdd.manager()) return;
+    require_plain_zdd(zdd);
 
     DDManager* mgr = zdd.manager();
 
@@ -899,6 +948,7 @@ namespace {
 
 // Import BDD from lib_bdd format
 BDD import_bdd_as_libbdd(DDManager& mgr, std::istream& is) {
+    TraceScope trace(&mgr, "import_bdd_as_libbdd", "io");
     std::vector<LibBddNode> nodes;
 
     // Read all nodes
@@ -982,6 +1032,7 @@ BDD import_bdd_as_libbdd(DDManager& mgr, const std::string& filename) {
 
 // Import ZDD from lib_bdd format
 ZDD import_zdd_as_libbdd(DDManager& mgr, std::istream& is) {
+    TraceScope trace(&mgr, "import_zdd_as_libbdd", "io");
     std::vector<LibBddNode> nodes;
 
     // Read all nodes
@@ -1149,6 +1200,7 @@ void export_bdd_as_libbdd(const BDD& bdd, const std::string& filename) {
 // Export ZDD to lib_bdd format
 void export_zdd_as_libbdd(const ZDD& zdd, std::ostream& os) {
     if (!zdd.manager()) return;
+    require_plain_zdd(zdd);
 
     DDManager* mgr = zdd.manager();
 
@@ -1224,6 +1276,7 @@ void export_zdd_as_libbdd(const ZDD& zdd, const std::string& filename) {
 
 void export_zdd_as_svg(const ZDD& zdd, std::ostream& os, const SvgExportOptions& options) {
     if (!zdd.manager()) return;
+    require_plain_zdd(zdd);
 
     DDManager* mgr = zdd.manager();
 
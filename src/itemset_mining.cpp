@@ -0,0 +1,318 @@
+// SAPPOROBDD 2.0 - Frequent and closed itemset mining into ZDD
+// MIT License
+
+#include "sbdd2/itemset_mining.hpp"
+#include "sbdd2/trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+namespace sbdd2 {
+
+namespace {
+
+// Items are renumbered to positions 0, 1, ... in root-first level order, so
+// an itemset extended with increasing positions is built from the top of the
+// ZDD downwards. Recursion goes one item deeper per call, so its depth is
+// bounded by the longest transaction.
+
+using TidList = std::vector<std::uint32_t>;
+
+// Recursion results keyed by (first position to consider, occurrence list)
+struct MemoKey {
+    std::uint32_t from;
+    TidList occ;
+
+    bool operator==(const MemoKey& other) const {
+        return from == other.from && occ == other.occ;
+    }
+};
+
+struct MemoKeyHash {
+    std::size_t operator()(const MemoKey& key) const {
+        std::uint64_t h = key.from * 0x9E3779B97F4A7C15ULL;
+        for (std::uint32_t t : key.occ) {
+            h ^= t + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        }
+        return static_cast<std::size_t>(h);
+    }
+};
+
+using Memo = std::unordered_map<MemoKey, ZDD, MemoKeyHash>;
+
+// Transactions containing the item at position pos
+struct Bucket {
+    std::uint32_t pos;
+    TidList occ;
+};
+
+class ItemsetMiner {
+public:
+    ItemsetMiner(DDManager& mgr, const std::vector<Transaction>& transactions,
+                 std::size_t min_support);
+
+    ZDD frequent(bool parallel);
+    ZDD closed(bool parallel);
+
+private:
+    DDManager& mgr_;
+    std::uint64_t min_support_;
+    std::vector<bddvar> var_;                          // position -> variable
+    std::vector<std::vector<std::uint32_t> > items_;   // sorted positions per transaction
+    std::vector<std::uint64_t> weight_;                // multiplicity per transaction
+    TidList all_;
+
+    std::uint64_t support(const TidList& occ) const;
+    std::vector<Bucket> deliver(const TidList& occ, std::uint32_t from) const;
+    std::vector<std::uint32_t> closure(const TidList& occ) const;
+    ZDD node(std::uint32_t pos, const ZDD& lo, const ZDD& hi) const;
+    ZDD frequent_rec(const TidList& occ, std::uint32_t from, Memo& memo) const;
+    ZDD closed_rec(const std::vector<std::uint32_t>& q, const TidList& occ,
+                   std::uint32_t from, bool parallel) const;
+    ZDD closed_chain(const std::vector<std::uint32_t>& q, std::uint32_t from,
+                     const std::vector<std::pair<std::uint32_t, ZDD> >& children) const;
+};
+
+ItemsetMiner::ItemsetMiner(DDManager& mgr, const std::vector<Transaction>& transactions,
+                           std::size_t min_support)
+    : mgr_(mgr), min_support_(min_support) {
+    if (min_support == 0) {
+        throw DDArgumentException("min_support must be at least 1");
+    }
+
+    // Global supports; only frequent items are kept
+    std::map<bddvar, std::uint64_t> count;
+    std::vector<Transaction> cleaned;
+    cleaned.reserve(transactions.size());
+    for (const Transaction& t : transactions) {
+        Transaction items(t);
+        std::sort(items.begin(), items.end());
+        items.erase(std::unique(items.begin(), items.end()), items.end());
+        for (bddvar v : items) {
+            if (v == 0 || v > mgr.var_count()) {
+                throw DDArgumentException("Invalid variable number");
+            }
+            ++count[v];
+        }
+        cleaned.push_back(std::move(items));
+    }
+    for (const auto& entry : count) {
+        if (entry.second >= min_support_) var_.push_back(entry.first);
+    }
+    std::sort(var_.begin(), var_.end(), [&mgr](bddvar a, bddvar b) {
+        return mgr.lev_of_var(a) > mgr.lev_of_var(b);
+    });
+    std::unordered_map<bddvar, std::uint32_t> pos;
+    for (std::size_t i = 0; i < var_.size(); ++i) {
+        pos[var_[i]] = static_cast<std::uint32_t>(i);
+    }
+
+    // Database reduction: identical transactions become one with a weight
+    std::map<std::vector<std::uint32_t>, std::uint64_t> merged;
+    for (const Transaction& t : cleaned) {
+        std::vector<std::uint32_t> p;
+        for (bddvar v : t) {
+            auto it = pos.find(v);
+            if (it != pos.end()) p.push_back(it->second);
+        }
+        std::sort(p.begin(), p.end());
+        ++merged[p];
+    }
+    for (auto& entry : merged) {
+        all_.push_back(static_cast<std::uint32_t>(items_.size()));
+        items_.push_back(entry.first);
+        weight_.push_back(entry.second);
+    }
+}
+
+std::uint64_t ItemsetMiner::support(const TidList& occ) const {
+    std::uint64_t s = 0;
+    for (std::uint32_t t : occ) s += weight_[t];
+    return s;
+}
+
+// Occurrence deliver: the transactions of occ grouped by each item at a
+// position >= from, in increasing position order
+std::vector<Bucket> ItemsetMiner::deliver(const TidList& occ, std::uint32_t from) const {
+    std::vector<std::uint32_t> slot(var_.size() - std::min<std::size_t>(from, var_.size()), 0);
+    for (std::uint32_t t : occ) {
+        const std::vector<std::uint32_t>& items = items_[t];
+        for (auto it = std::lower_bound(items.begin(), items.end(), from); it != items.end(); ++it) {
+            ++slot[*it - from];
+        }
+    }
+    std::vector<Bucket> buckets;
+    for (std::size_t i = 0; i < slot.size(); ++i) {
+        if (slot[i] == 0) continue;
+        buckets.push_back(Bucket{static_cast<std::uint32_t>(from + i), TidList()});
+        buckets.back().occ.reserve(slot[i]);
+        slot[i] = static_cast<std::uint32_t>(buckets.size() - 1);
+    }
+    for (std::uint32_t t : occ) {
+        const std::vector<std::uint32_t>& items = items_[t];
+        for (auto it = std::lower_bound(items.begin(), items.end(), from); it != items.end(); ++it) {
+            buckets[slot[*it - from]].occ.push_back(t);
+        }
+    }
+    return buckets;
+}
+
+// Items shared by every transaction of occ
+std::vector<std::uint32_t> ItemsetMiner::closure(const TidList& occ) const {
+    std::vector<std::uint32_t> result = items_[occ.front()];
+    std::vector<std::uint32_t> next;
+    for (std::size_t i = 1; i < occ.size() && !result.empty(); ++i) {
+        const std::vector<std::uint32_t>& items = items_[occ[i]];
+        next.clear();
+        std::set_intersection(result.begin(), result.end(), items.begin(), items.end(),
+                              std::back_inserter(next));
+        result.swap(next);
+    }
+    return result;
+}
+
+ZDD ItemsetMiner::node(std::uint32_t pos, const ZDD& lo, const ZDD& hi) const {
+    return ZDD(&mgr_, mgr_.get_or_create_node_zdd(var_[pos], lo.arc(), hi.arc(), true));
+}
+
+// Runs fn(0), ..., fn(count - 1), spread over the cores if parallel
+void run_tasks(std::size_t count, bool parallel, const std::function<void(std::size_t)>& fn) {
+    unsigned cores = parallel ? std::max(1u, std::thread::hardware_concurrency()) : 1;
+    std::size_t workers = std::min<std::size_t>(cores, count);
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < count; ++i) fn(i);
+        return;
+    }
+    std::atomic<std::size_t> next(0);
+    auto work = [&]() {
+        for (std::size_t i = next++; i < count; i = next++) fn(i);
+    };
+    std::vector<std::future<void> > tasks;
+    for (std::size_t w = 1; w < workers; ++w) {
+        tasks.push_back(std::async(std::launch::async, work));
+    }
+    work();
+    for (auto& t : tasks) t.get();
+}
+
+// ============== Frequent itemsets ==============
+
+// Family of S over positions >= from such that P + S is frequent, where occ
+// is the occurrence list of P (itself frequent). Sets whose smallest item is
+// p are p + frequent_rec(occ(P + p), p + 1), so the family is a chain of
+// nodes over the frequent items, built from the bottom.
+ZDD ItemsetMiner::frequent_rec(const TidList& occ, std::uint32_t from, Memo& memo) const {
+    MemoKey key{from, occ};
+    auto it = memo.find(key);
+    if (it != memo.end()) return it->second;
+
+    std::vector<Bucket> buckets = deliver(occ, from);
+    ZDD result = ZDD::single(mgr_);
+    for (std::size_t k = buckets.size(); k-- > 0;) {
+        if (support(buckets[k].occ) < min_support_) continue;
+        ZDD hi = frequent_rec(buckets[k].occ, buckets[k].pos + 1, memo);
+        result = node(buckets[k].pos, result, hi);
+    }
+    memo.emplace(std::move(key), result);
+    return result;
+}
+
+ZDD ItemsetMiner::frequent(bool parallel) {
+    if (support(all_) < min_support_) return ZDD::empty(mgr_);
+
+    // Partition by the first (root-most) item; each task keeps its own memo
+    std::vector<Bucket> buckets = deliver(all_, 0);
+    std::vector<ZDD> hi(buckets.size());
+    run_tasks(buckets.size(), parallel, [&](std::size_t k) {
+        Memo memo;
+        hi[k] = frequent_rec(buckets[k].occ, buckets[k].pos + 1, memo);
+    });
+    ZDD result = ZDD::single(mgr_);
+    for (std::size_t k = buckets.size(); k-- > 0;) {
+        result = node(buckets[k].pos, result, hi[k]);
+    }
+    return result;
+}
+
+// ============== Closed itemsets ==============
+
+// For a closed set Q reached by adding the item at position from - 1 (or
+// the closure of the empty set, with from == 0): the family of C restricted
+// to positions >= from, over the closed sets C in the ppc-extension subtree
+// of Q. Every such C contains Q, and the sets of the child added at p have
+// no item in [from, p) outside Q.
+ZDD ItemsetMiner::closed_rec(const std::vector<std::uint32_t>& q, const TidList& occ,
+                             std::uint32_t from, bool parallel) const {
+    std::vector<Bucket> buckets = deliver(occ, from);
+    std::vector<ZDD> subtree(buckets.size());
+    std::vector<char> accepted(buckets.size(), 0);
+    run_tasks(buckets.size(), parallel, [&](std::size_t k) {
+        const Bucket& b = buckets[k];
+        if (std::binary_search(q.begin(), q.end(), b.pos)) return;
+        if (support(b.occ) < min_support_) return;
+        // Prefix preserving: the closure adds nothing before p
+        std::vector<std::uint32_t> c = closure(b.occ);
+        for (std::uint32_t x : c) {
+            if (x >= b.pos) break;
+            if (!std::binary_search(q.begin(), q.end(), x)) return;
+        }
+        subtree[k] = closed_rec(c, b.occ, b.pos + 1, false);
+        accepted[k] = 1;
+    });
+    std::vector<std::pair<std::uint32_t, ZDD> > children;
+    for (std::size_t k = 0; k < buckets.size(); ++k) {
+        if (accepted[k]) children.push_back(std::make_pair(buckets[k].pos, subtree[k]));
+    }
+    return closed_chain(q, from, children);
+}
+
+// Items of Q are in every set (0-arc to the empty family); a child at p
+// adds a branch whose 1-arc holds the child's subtree
+ZDD ItemsetMiner::closed_chain(const std::vector<std::uint32_t>& q, std::uint32_t from,
+                               const std::vector<std::pair<std::uint32_t, ZDD> >& children) const {
+    ZDD result = ZDD::single(mgr_);
+    auto qi = q.end();
+    auto ci = children.end();
+    auto q_begin = std::lower_bound(q.begin(), q.end(), from);
+    while (qi != q_begin || ci != children.begin()) {
+        bool take_q = ci == children.begin() ||
+                      (qi != q_begin && *(qi - 1) > (ci - 1)->first);
+        if (take_q) {
+            --qi;
+            result = node(*qi, ZDD::empty(mgr_), result);
+        } else {
+            --ci;
+            result = node(ci->first, result, ci->second);
+        }
+    }
+    return result;
+}
+
+ZDD ItemsetMiner::closed(bool parallel) {
+    if (support(all_) < min_support_) return ZDD::empty(mgr_);
+    // The tasks are the children of the closure of the empty set, i.e. they
+    // are partitioned by the first item added
+    return closed_rec(closure(all_), all_, 0, parallel);
+}
+
+} // namespace
+
+ZDD mine_frequent(DDManager& mgr, const std::vector<Transaction>& transactions,
+                  std::size_t min_support, bool parallel) {
+    TraceScope trace(&mgr, "mine_frequent", "zdd");
+    ItemsetMiner miner(mgr, transactions, min_support);
+    return miner.frequent(parallel);
+}
+
+ZDD mine_closed(DDManager& mgr, const std::vector<Transaction>& transactions,
+                std::size_t min_support, bool parallel) {
+    TraceScope trace(&mgr, "mine_closed", "zdd");
+    ItemsetMiner miner(mgr, transactions, min_support);
+    return miner.closed(parallel);
+}
+
+} // namespace sbdd2
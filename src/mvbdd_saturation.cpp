@@ -0,0 +1,234 @@
+// SAPPOROBDD 2.0 - Saturation-based reachability for MVBDD
+// MIT License
+
+#include "sbdd2/mvbdd_saturation.hpp"
+#include "sbdd2/trace.hpp"
+#include <algorithm>
+
+namespace sbdd2 {
+
+// Levels are numbered 1..L from the bottom MVDD variable upwards; level 0 is
+// the terminal level. The recursion of saturate/fire goes down one MVDD
+// level per call, so its depth is bounded by twice the number of MVDD
+// variables, not by the number of nodes.
+
+MVBDDSaturation::MVBDDSaturation(const MVBDD& base, const std::vector<MVEvent>& events)
+    : base_(base), events_(events) {
+    if (!base.is_valid()) {
+        throw DDArgumentException("Base MVBDD is not valid");
+    }
+    DDManager* mgr = base.manager();
+    bddvar n = base.mvdd_var_count();
+    int k = base.k();
+
+    // Order the MVDD variables by the levels of their DD variables
+    std::vector<std::pair<bddvar, bddvar> > ranges(n + 1);  // (min, max) level
+    level_var_.assign(1, 0);
+    for (bddvar mv = 1; mv <= n; ++mv) {
+        bddvar lo = BDDVAR_MAX, hi = 0;
+        for (bddvar dv : base.dd_vars_of(mv)) {
+            lo = std::min(lo, mgr->lev_of_var(dv));
+            hi = std::max(hi, mgr->lev_of_var(dv));
+        }
+        ranges[mv] = std::make_pair(lo, hi);
+        level_var_.push_back(mv);
+    }
+    std::sort(level_var_.begin() + 1, level_var_.end(), [&ranges](bddvar a, bddvar b) {
+        return ranges[a].first < ranges[b].first;
+    });
+    std::vector<std::size_t> level_of(n + 1, 0);
+    for (std::size_t lev = 1; lev <= n; ++lev) {
+        bddvar mv = level_var_[lev];
+        level_of[mv] = lev;
+        if (lev > 1 && ranges[level_var_[lev - 1]].second > ranges[mv].first) {
+            throw DDArgumentException("MVBDDSaturation: DD variables of MVDD variables interleave");
+        }
+    }
+
+    literals_.assign(n + 1, std::vector<BDD>());
+    for (std::size_t lev = 1; lev <= n; ++lev) {
+        for (int v = 0; v < k; ++v) {
+            literals_[lev].push_back(MVBDD::single(base, level_var_[lev], v).to_bdd());
+        }
+    }
+
+    by_top_.assign(n + 1, std::vector<std::size_t>());
+    info_.resize(events_.size());
+    for (std::size_t e = 0; e < events_.size(); ++e) {
+        EventInfo& info = info_[e];
+        info.top = 0;
+        info.bot = n + 1;
+        info.local.assign(n + 1, nullptr);
+        for (const auto& entry : events_[e].locals()) {
+            bddvar mv = entry.first;
+            if (mv == 0 || mv > n) {
+                throw DDArgumentException("Invalid MVDD variable number");
+            }
+            for (const auto& t : entry.second) {
+                if (t.first < 0 || t.first >= k || t.second < 0 || t.second >= k) {
+                    throw DDArgumentException("Value out of range");
+                }
+            }
+            std::size_t lev = level_of[mv];
+            info.local[lev] = &entry.second;
+            info.top = std::max(info.top, lev);
+            info.bot = std::min(info.bot, lev);
+        }
+        // An event touching no variable never changes the state
+        if (info.top > 0) by_top_[info.top].push_back(e);
+    }
+
+    saturate_cache_.assign(n + 1, LevelCache());
+    fire_cache_.assign(events_.size() * (n + 1), LevelCache());
+}
+
+void MVBDDSaturation::check_states(const MVBDD& states) const {
+    if (!states.is_valid() || states.manager() != base_.manager()) {
+        throw DDIncompatibleException("MVBDD managers do not match");
+    }
+    if (states.k() != base_.k()) {
+        throw DDArgumentException("MVBDD k values must match");
+    }
+    for (bddvar dv : states.to_bdd().support()) {
+        if (base_.mvdd_var_of(dv) == 0) {
+            throw DDArgumentException("MVBDDSaturation: states depend on a non-MVDD variable");
+        }
+    }
+}
+
+BDD MVBDDSaturation::child(const BDD& f, std::size_t lev, int value) const {
+    return f.cofactor(literals_[lev][value]);
+}
+
+// Same encoding as MVBDD::ite
+BDD MVBDDSaturation::build(std::size_t lev, const std::vector<BDD>& children) const {
+    DDManager& mgr = *base_.manager();
+    const auto& dd_vars = base_.dd_vars_of(level_var_[lev]);
+    BDD result = children[0];
+    for (int i = base_.k() - 2; i >= 0; --i) {
+        result = BDD::var(mgr, dd_vars[i]).ite(children[i + 1], result);
+    }
+    return result;
+}
+
+// Saturate f (a set over levels <= lev): the result is closed under every
+// event whose top level is at most lev.
+BDD MVBDDSaturation::saturate(std::size_t lev, const BDD& f) {
+    if (lev == 0 || f.is_zero()) return f;
+    LevelCache& cache = saturate_cache_[lev];
+    auto it = cache.find(f.arc().data);
+    if (it != cache.end()) return it->second.value;
+
+    std::vector<BDD> children;
+    children.reserve(base_.k());
+    for (int v = 0; v < base_.k(); ++v) {
+        children.push_back(saturate(lev - 1, child(f, lev, v)));
+    }
+    BDD result = saturate_node(lev, children);
+    cache[f.arc().data] = CacheEntry{f, result};
+    cache[result.arc().data] = CacheEntry{result, result};
+    return result;
+}
+
+// Fire the events with top level lev on a node whose children are already
+// saturated, until nothing changes. A union of saturated sets is saturated,
+// so the children stay saturated throughout.
+BDD MVBDDSaturation::saturate_node(std::size_t lev, std::vector<BDD>& children) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (std::size_t e : by_top_[lev]) {
+            for (const auto& t : *info_[e].local[lev]) {
+                if (children[t.first].is_zero()) continue;
+                BDD fired = fire(lev - 1, children[t.first], e);
+                BDD merged = children[t.second] | fired;
+                if (merged != children[t.second]) {
+                    children[t.second] = merged;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return build(lev, children);
+}
+
+// States reached from the saturated set f (over levels <= lev) by firing
+// event e on the levels <= lev, saturated again.
+BDD MVBDDSaturation::fire(std::size_t lev, const BDD& f, std::size_t e) {
+    const EventInfo& info = info_[e];
+    if (f.is_zero() || lev < info.bot) return f;
+    LevelCache& cache = fire_cache_[e * level_var_.size() + lev];
+    auto it = cache.find(f.arc().data);
+    if (it != cache.end()) return it->second.value;
+
+    int k = base_.k();
+    std::vector<BDD> children(k, BDD::zero(*base_.manager()));
+    const MVEvent::LocalTransitions* local = info.local[lev];
+    if (local) {
+        for (const auto& t : *local) {
+            BDD c = child(f, lev, t.first);
+            if (c.is_zero()) continue;
+            children[t.second] |= fire(lev - 1, c, e);
+        }
+    } else {
+        for (int v = 0; v < k; ++v) {
+            children[v] = fire(lev - 1, child(f, lev, v), e);
+        }
+    }
+    BDD result = saturate_node(lev, children);
+    cache[f.arc().data] = CacheEntry{f, result};
+    return result;
+}
+
+MVBDD MVBDDSaturation::reachable(const MVBDD& init) {
+    check_states(init);
+    TraceScope trace(base_.manager(), "MVBDDSaturation::reachable", "mvbdd");
+    BDD result = saturate(level_var_.size() - 1, init.to_bdd());
+    return MVBDD::from_bdd(init, result);
+}
+
+// Image of one event without saturation, memoized per call
+BDD MVBDDSaturation::fire_once(std::size_t lev, const BDD& f, std::size_t e,
+                               std::vector<std::unordered_map<std::uint64_t, BDD> >& memo) const {
+    const EventInfo& info = info_[e];
+    if (f.is_zero() || lev < info.bot) return f;
+    auto it = memo[lev].find(f.arc().data);
+    if (it != memo[lev].end()) return it->second;
+
+    int k = base_.k();
+    std::vector<BDD> children(k, BDD::zero(*base_.manager()));
+    const MVEvent::LocalTransitions* local = info.local[lev];
+    if (local) {
+        for (const auto& t : *local) {
+            BDD c = child(f, lev, t.first);
+            if (c.is_zero()) continue;
+            children[t.second] |= fire_once(lev - 1, c, e, memo);
+        }
+    } else {
+        for (int v = 0; v < k; ++v) {
+            children[v] = fire_once(lev - 1, child(f, lev, v), e, memo);
+        }
+    }
+    BDD result = build(lev, children);
+    memo[lev][f.arc().data] = result;
+    return result;
+}
+
+MVBDD MVBDDSaturation::image(const MVBDD& states) const {
+    check_states(states);
+    TraceScope trace(base_.manager(), "MVBDDSaturation::image", "mvbdd");
+    BDD result = BDD::zero(*base_.manager());
+    for (std::size_t e = 0; e < events_.size(); ++e) {
+        if (info_[e].top == 0) continue;
+        std::vector<std::unordered_map<std::uint64_t, BDD> > memo(level_var_.size());
+        result |= fire_once(level_var_.size() - 1, states.to_bdd(), e, memo);
+    }
+    return MVBDD::from_bdd(states, result);
+}
+
+void MVBDDSaturation::clear_cache() {
+    for (LevelCache& cache : saturate_cache_) cache.clear();
+    for (LevelCache& cache : fire_cache_) cache.clear();
+}
+
+} // namespace sbdd2
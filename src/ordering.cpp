@@ -0,0 +1,353 @@
+// SAPPOROBDD 2.0 - Static variable-ordering heuristics
+// MIT License
+
+#include "sbdd2/ordering.hpp"
+#include "sbdd2/dd_manager.hpp"
+#include "sbdd2/exception.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <set>
+#include <unordered_set>
+#include <utility>
+
+namespace sbdd2 {
+namespace ordering {
+
+namespace {
+
+// Edges incident to each variable (index 0 unused)
+std::vector<std::vector<std::size_t> > incidence(bddvar n, const Hypergraph& edges) {
+    std::vector<std::vector<std::size_t> > inc(n + 1);
+    for (std::size_t e = 0; e < edges.size(); ++e) {
+        for (bddvar v : edges[e]) {
+            if (v == 0 || v > n) {
+                throw DDArgumentException("ordering: variable out of range");
+            }
+            inc[v].push_back(e);
+        }
+    }
+    return inc;
+}
+
+void check_permutation(bddvar n, const std::vector<bddvar>& order) {
+    if (order.size() != n) {
+        throw DDArgumentException("ordering: order must be a permutation of 1..n");
+    }
+    std::vector<bool> seen(n + 1, false);
+    for (bddvar v : order) {
+        if (v == 0 || v > n || seen[v]) {
+            throw DDArgumentException("ordering: order must be a permutation of 1..n");
+        }
+        seen[v] = true;
+    }
+}
+
+// Graph traversal shared by dfs and bfs: start from the first unvisited
+// variable of each edge in the given order, follow incident edges in order.
+std::vector<bddvar> traverse(bddvar n, const Hypergraph& edges, bool depth_first) {
+    std::vector<std::vector<std::size_t> > inc = incidence(n, edges);
+    std::vector<bool> visited(n + 1, false);
+    std::vector<bddvar> order;
+    order.reserve(n);
+
+    auto visit_from = [&](bddvar root) {
+        visited[root] = true;
+        order.push_back(root);
+        if (depth_first) {
+            // (variable, next incident edge, next member of that edge)
+            struct Frame { bddvar v; std::size_t edge; std::size_t member; };
+            std::vector<Frame> stack(1, Frame{root, 0, 0});
+            while (!stack.empty()) {
+                Frame& f = stack.back();
+                if (f.edge == inc[f.v].size()) {
+                    stack.pop_back();
+                    continue;
+                }
+                const std::vector<bddvar>& e = edges[inc[f.v][f.edge]];
+                if (f.member == e.size()) {
+                    ++f.edge;
+                    f.member = 0;
+                    continue;
+                }
+                bddvar u = e[f.member++];
+                if (!visited[u]) {
+                    visited[u] = true;
+                    order.push_back(u);
+                    stack.push_back(Frame{u, 0, 0});
+                }
+            }
+        } else {
+            std::deque<bddvar> queue(1, root);
+            while (!queue.empty()) {
+                bddvar v = queue.front();
+                queue.pop_front();
+                for (std::size_t e : inc[v]) {
+                    for (bddvar u : edges[e]) {
+                        if (!visited[u]) {
+                            visited[u] = true;
+                            order.push_back(u);
+                            queue.push_back(u);
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    for (const std::vector<bddvar>& e : edges) {
+        for (bddvar v : e) {
+            if (!visited[v]) visit_from(v);
+        }
+    }
+    for (bddvar v = 1; v <= n; ++v) {
+        if (!visited[v]) {
+            visited[v] = true;
+            order.push_back(v);
+        }
+    }
+    return order;
+}
+
+// One balanced bisection of vars (given in their initial order) with
+// Fiduccia-Mattheyses refinement on the induced sub-hypergraph. Returns the
+// side (0 = first half) of each position of vars.
+std::vector<int> bisect(const std::vector<bddvar>& vars, const Hypergraph& edges,
+                        const std::vector<std::vector<std::size_t> >& inc,
+                        std::vector<std::size_t>& local, int passes) {
+    std::size_t m = vars.size();
+    for (std::size_t i = 0; i < m; ++i) local[vars[i]] = i;
+
+    // Induced edges: members by local index, only edges with two or more members
+    std::vector<std::vector<std::size_t> > sub_edges;
+    std::vector<std::vector<std::size_t> > sub_inc(m);
+    std::unordered_set<std::size_t> seen_edges;
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t e : inc[vars[i]]) {
+            if (seen_edges.insert(e).second) {
+                std::vector<std::size_t> members;
+                for (bddvar u : edges[e]) {
+                    if (local[u] < m && vars[local[u]] == u) members.push_back(local[u]);
+                }
+                std::sort(members.begin(), members.end());
+                members.erase(std::unique(members.begin(), members.end()), members.end());
+                if (members.size() < 2) continue;
+                for (std::size_t j : members) sub_inc[j].push_back(sub_edges.size());
+                sub_edges.push_back(members);
+            }
+        }
+    }
+
+    std::vector<int> side(m);
+    for (std::size_t i = 0; i < m; ++i) side[i] = (2 * i < m) ? 0 : 1;
+    std::vector<std::size_t> count[2];
+    count[0].assign(sub_edges.size(), 0);
+    count[1].assign(sub_edges.size(), 0);
+    for (std::size_t e = 0; e < sub_edges.size(); ++e) {
+        for (std::size_t j : sub_edges[e]) ++count[side[j]][e];
+    }
+    auto gain = [&](std::size_t j) {
+        int g = 0, s = side[j];
+        for (std::size_t e : sub_inc[j]) {
+            if (count[s][e] == 1 && count[1 - s][e] > 0) ++g;
+            if (count[1 - s][e] == 0 && count[s][e] > 1) --g;
+        }
+        return g;
+    };
+    // Either side may hold between lo and hi variables
+    std::size_t slack = std::max<std::size_t>(1, m / 10);
+    // Both sides stay non-empty
+    std::size_t lo = m / 2 > slack ? m / 2 - slack : 1;
+    std::size_t hi = (m + 1) / 2 + slack;
+    std::size_t size[2] = {(m + 1) / 2, m / 2};
+
+    for (int pass = 0; pass < passes; ++pass) {
+        std::vector<int> g(m);
+        std::set<std::pair<int, std::size_t> > free;
+        for (std::size_t j = 0; j < m; ++j) {
+            g[j] = gain(j);
+            free.insert(std::make_pair(g[j], j));
+        }
+        std::vector<std::size_t> moves;
+        int total = 0, best_total = 0;
+        std::size_t best_len = 0;
+        while (true) {
+            // Highest gain move that keeps the balance
+            std::size_t pick = m;
+            for (auto it = free.rbegin(); it != free.rend(); ++it) {
+                int s = side[it->second];
+                if (size[s] - 1 >= lo && size[1 - s] + 1 <= hi) {
+                    pick = it->second;
+                    break;
+                }
+            }
+            if (pick == m) break;
+            free.erase(std::make_pair(g[pick], pick));
+            total += g[pick];
+            int s = side[pick];
+            for (std::size_t e : sub_inc[pick]) {
+                --count[s][e];
+                ++count[1 - s][e];
+            }
+            side[pick] = 1 - s;
+            --size[s];
+            ++size[1 - s];
+            moves.push_back(pick);
+            if (total > best_total) {
+                best_total = total;
+                best_len = moves.size();
+            }
+            // Update the gains of the free neighbours
+            for (std::size_t e : sub_inc[pick]) {
+                for (std::size_t j : sub_edges[e]) {
+                    auto it = free.find(std::make_pair(g[j], j));
+                    if (it == free.end()) continue;
+                    free.erase(it);
+                    g[j] = gain(j);
+                    free.insert(std::make_pair(g[j], j));
+                }
+            }
+        }
+        // Undo the moves after the best prefix
+        for (std::size_t i = moves.size(); i > best_len; --i) {
+            std::size_t j = moves[i - 1];
+            int s = side[j];
+            for (std::size_t e : sub_inc[j]) {
+                --count[s][e];
+                ++count[1 - s][e];
+            }
+            side[j] = 1 - s;
+            --size[s];
+            ++size[1 - s];
+        }
+        if (best_total <= 0) break;
+    }
+    return side;
+}
+
+} // namespace
+
+Hypergraph from_clauses(const std::vector<std::vector<int> >& clauses) {
+    Hypergraph edges;
+    edges.reserve(clauses.size());
+    for (const std::vector<int>& clause : clauses) {
+        std::vector<bddvar> e;
+        for (int lit : clause) {
+            if (lit == 0) {
+                throw DDArgumentException("from_clauses: literal 0 is not allowed");
+            }
+            bddvar v = static_cast<bddvar>(std::abs(lit));
+            if (std::find(e.begin(), e.end(), v) == e.end()) e.push_back(v);
+        }
+        edges.push_back(e);
+    }
+    return edges;
+}
+
+std::vector<bddvar> dfs(bddvar n, const Hypergraph& edges) {
+    return traverse(n, edges, true);
+}
+
+std::vector<bddvar> bfs(bddvar n, const Hypergraph& edges) {
+    return traverse(n, edges, false);
+}
+
+std::vector<bddvar> force(bddvar n, const Hypergraph& edges,
+                          const std::vector<bddvar>& initial, int max_iterations) {
+    std::vector<std::vector<std::size_t> > inc = incidence(n, edges);
+    std::vector<bddvar> order = initial;
+    if (order.empty()) {
+        for (bddvar v = 1; v <= n; ++v) order.push_back(v);
+    }
+    check_permutation(n, order);
+
+    std::vector<bddvar> best = order;
+    std::size_t best_span = total_span(order, edges);
+    std::vector<double> pos(n + 1), cog(edges.size()), target(n + 1);
+    for (int it = 0; it < max_iterations; ++it) {
+        for (std::size_t i = 0; i < n; ++i) pos[order[i]] = static_cast<double>(i);
+        for (std::size_t e = 0; e < edges.size(); ++e) {
+            double sum = 0.0;
+            for (bddvar v : edges[e]) sum += pos[v];
+            cog[e] = edges[e].empty() ? 0.0 : sum / edges[e].size();
+        }
+        for (bddvar v = 1; v <= n; ++v) {
+            double sum = 0.0;
+            std::size_t k = 0;
+            for (std::size_t e : inc[v]) {
+                if (edges[e].empty()) continue;
+                sum += cog[e];
+                ++k;
+            }
+            target[v] = k == 0 ? pos[v] : sum / k;
+        }
+        std::stable_sort(order.begin(), order.end(), [&target](bddvar a, bddvar b) {
+            return target[a] < target[b];
+        });
+        std::size_t span = total_span(order, edges);
+        if (span >= best_span) break;
+        best_span = span;
+        best = order;
+    }
+    return best;
+}
+
+std::vector<bddvar> mince(bddvar n, const Hypergraph& edges, int passes) {
+    std::vector<std::vector<std::size_t> > inc = incidence(n, edges);
+    std::vector<bddvar> order = dfs(n, edges);
+    std::vector<std::size_t> local(n + 1, static_cast<std::size_t>(-1));
+
+    // Refine [begin, end) of order in place, largest ranges first
+    std::vector<std::pair<std::size_t, std::size_t> > ranges(1, std::make_pair(0, order.size()));
+    while (!ranges.empty()) {
+        std::size_t begin = ranges.back().first, end = ranges.back().second;
+        ranges.pop_back();
+        if (end - begin <= 2) continue;
+        std::vector<bddvar> vars(order.begin() + begin, order.begin() + end);
+        std::vector<int> side = bisect(vars, edges, inc, local, passes);
+        std::size_t mid = begin;
+        for (std::size_t i = 0; i < vars.size(); ++i) {
+            if (side[i] == 0) order[mid++] = vars[i];
+        }
+        std::size_t j = mid;
+        for (std::size_t i = 0; i < vars.size(); ++i) {
+            if (side[i] == 1) order[j++] = vars[i];
+        }
+        for (bddvar v : vars) local[v] = static_cast<std::size_t>(-1);
+        ranges.push_back(std::make_pair(mid, end));
+        ranges.push_back(std::make_pair(begin, mid));
+    }
+    return order;
+}
+
+std::size_t total_span(const std::vector<bddvar>& order, const Hypergraph& edges) {
+    bddvar max_var = 0;
+    for (bddvar v : order) max_var = std::max(max_var, v);
+    std::vector<std::size_t> pos(max_var + 1, 0);
+    for (std::size_t i = 0; i < order.size(); ++i) pos[order[i]] = i;
+    std::size_t span = 0;
+    for (const std::vector<bddvar>& e : edges) {
+        if (e.empty()) continue;
+        std::size_t lo = static_cast<std::size_t>(-1), hi = 0;
+        for (bddvar v : e) {
+            std::size_t p = v <= max_var ? pos[v] : 0;
+            lo = std::min(lo, p);
+            hi = std::max(hi, p);
+        }
+        span += hi - lo;
+    }
+    return span;
+}
+
+void apply(DDManager& mgr, const std::vector<bddvar>& order) {
+    bddvar n = static_cast<bddvar>(order.size());
+    check_permutation(n, order);
+    bddvar offset = mgr.var_count();
+    // order[0] goes to the top level
+    std::vector<bddvar> levs(n);
+    for (bddvar i = 0; i < n; ++i) levs[order[i] - 1] = offset + n - i;
+    mgr.new_vars_of_levs(levs);
+}
+
+} // namespace ordering
+} // namespace sbdd2
@@ -0,0 +1,248 @@
+// SAPPOROBDD 2.0 - Pseudo-Boolean and cardinality constraints to BDD/ZDD
+// MIT License
+
+#include "sbdd2/pseudo_boolean.hpp"
+#include "sbdd2/trace.hpp"
+#include <algorithm>
+#include <limits>
+#include <map>
+
+namespace sbdd2 {
+
+namespace {
+
+const long long PB_NEG_INF = std::numeric_limits<long long>::min();
+const long long PB_POS_INF = std::numeric_limits<long long>::max();
+
+// a + b, where PB_NEG_INF / PB_POS_INF stand for -inf / +inf and finite
+// results are clamped to the finite range
+long long sat_add(long long a, long long b) {
+    if (a == PB_NEG_INF || a == PB_POS_INF) return a;
+    if (b > 0 && a > PB_POS_INF - 1 - b) return PB_POS_INF - 1;
+    if (b < 0 && a < PB_NEG_INF + 1 - b) return PB_NEG_INF + 1;
+    return a + b;
+}
+
+// Variables sorted root-first, with their weights
+struct PBTerms {
+    std::vector<bddvar> vars;
+    std::vector<long long> weights;
+};
+
+PBTerms sort_terms(DDManager& mgr, const std::vector<bddvar>& vars,
+                   const std::vector<long long>& weights) {
+    if (vars.size() != weights.size()) {
+        throw DDArgumentException("vars and weights must have the same length");
+    }
+    std::vector<std::pair<bddvar, std::size_t> > order;
+    order.reserve(vars.size());
+    for (std::size_t i = 0; i < vars.size(); ++i) {
+        if (vars[i] == 0 || vars[i] > mgr.var_count()) {
+            throw DDArgumentException("Invalid variable number");
+        }
+        order.push_back(std::make_pair(mgr.lev_of_var(vars[i]), i));
+    }
+    std::sort(order.begin(), order.end(),
+              [](const std::pair<bddvar, std::size_t>& a,
+                 const std::pair<bddvar, std::size_t>& b) { return a.first > b.first; });
+    PBTerms terms;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        if (i > 0 && order[i].first == order[i - 1].first) {
+            throw DDArgumentException("Duplicate variable");
+        }
+        terms.vars.push_back(vars[order[i].second]);
+        terms.weights.push_back(weights[order[i].second]);
+    }
+    return terms;
+}
+
+// The function f_i(K) = [sum_{j>=i} w_j x_j <= K] is monotone in K, so the
+// set of K giving the same node is an interval [lo, hi]. Each position keeps
+// the intervals found so far, keyed by lo.
+struct PBInterval {
+    long long lo;
+    long long hi;
+    Arc node;
+};
+
+struct PBFrame {
+    std::size_t i;
+    long long bound;
+    int stage;
+};
+
+Arc pb_le_arc(DDManager& mgr, const PBTerms& terms, long long bound, bool zdd) {
+    std::size_t n = terms.vars.size();
+
+    // Range of the suffix sums: below min_sum[i] nothing fits, from
+    // max_sum[i] on everything does
+    std::vector<long long> min_sum(n + 1, 0), max_sum(n + 1, 0);
+    for (std::size_t i = n; i-- > 0;) {
+        long long w = terms.weights[i];
+        min_sum[i] = sat_add(min_sum[i + 1], std::min(w, 0LL));
+        max_sum[i] = sat_add(max_sum[i + 1], std::max(w, 0LL));
+    }
+    // What "everything fits" means below position i: the constant true for
+    // a BDD, the power set of the remaining variables for a ZDD
+    std::vector<Arc> full(n + 1, ARC_TERMINAL_1);
+    if (zdd) {
+        for (std::size_t i = n; i-- > 0;) {
+            full[i] = mgr.get_or_create_node_zdd(terms.vars[i], full[i + 1], full[i + 1], true);
+        }
+    }
+
+    std::vector<std::map<long long, PBInterval> > memo(n + 1);
+    std::vector<PBFrame> stack;
+    std::vector<PBInterval> results;
+    stack.push_back(PBFrame{0, bound, 0});
+
+    while (!stack.empty()) {
+        PBFrame& frame = stack.back();
+        std::size_t i = frame.i;
+        long long k = frame.bound;
+
+        if (frame.stage == 0) {
+            if (k < min_sum[i]) {
+                stack.pop_back();
+                results.push_back(PBInterval{PB_NEG_INF, min_sum[i] - 1, ARC_TERMINAL_0});
+                continue;
+            }
+            if (k >= max_sum[i]) {
+                stack.pop_back();
+                results.push_back(PBInterval{max_sum[i], PB_POS_INF, full[i]});
+                continue;
+            }
+            auto it = memo[i].upper_bound(k);
+            if (it != memo[i].begin()) {
+                --it;
+                if (k <= it->second.hi) {
+                    PBInterval hit = it->second;
+                    stack.pop_back();
+                    results.push_back(hit);
+                    continue;
+                }
+            }
+            frame.stage = 1;
+            stack.push_back(PBFrame{i + 1, k, 0});
+            continue;
+        }
+        if (frame.stage == 1) {
+            frame.stage = 2;
+            stack.push_back(PBFrame{i + 1, sat_add(k, -terms.weights[i]), 0});
+            continue;
+        }
+
+        PBInterval r1 = results.back();
+        results.pop_back();
+        PBInterval r0 = results.back();
+        results.pop_back();
+
+        // f_i(K) = x ? f_{i+1}(K - w) : f_{i+1}(K)
+        long long w = terms.weights[i];
+        PBInterval r;
+        r.lo = std::max(r0.lo, sat_add(r1.lo, w));
+        r.hi = std::min(r0.hi, sat_add(r1.hi, w));
+        bddvar var = terms.vars[i];
+        r.node = zdd ? mgr.get_or_create_node_zdd(var, r0.node, r1.node, true)
+                     : mgr.get_or_create_node_bdd(var, r0.node, r1.node, true);
+        memo[i][r.lo] = r;
+        stack.pop_back();
+        results.push_back(r);
+    }
+    return results.back().node;
+}
+
+bool unit_weights(const std::vector<long long>& weights) {
+    for (long long w : weights) {
+        if (w != 1) return false;
+    }
+    return true;
+}
+
+// Cardinality constraints, built layer by layer from the bottom.
+// layer[j] is the node for "at most j" (or "exactly j") of the variables
+// below the current one.
+Arc card_arc(DDManager& mgr, const std::vector<bddvar>& vars, int k,
+             bool exact, bool zdd) {
+    std::vector<bddvar> sorted = sort_terms(mgr, vars, std::vector<long long>(vars.size(), 1)).vars;
+    int n = static_cast<int>(vars.size());
+    if (k < 0 || (exact && k > n)) return ARC_TERMINAL_0;
+    if (!exact && k >= n) {
+        if (!zdd) return ARC_TERMINAL_1;
+        k = n;
+    }
+
+    std::vector<Arc> layer(k + 1);
+    for (int j = 0; j <= k; ++j) {
+        layer[j] = (exact && j > 0) ? ARC_TERMINAL_0 : ARC_TERMINAL_1;
+    }
+    std::vector<Arc> next(k + 1);
+    for (int i = n - 1; i >= 0; --i) {
+        // i variables lie above, so at least k - i of the count is left
+        for (int j = std::max(0, k - i); j <= k; ++j) {
+            Arc a1 = (j > 0) ? layer[j - 1] : ARC_TERMINAL_0;
+            next[j] = zdd ? mgr.get_or_create_node_zdd(sorted[i], layer[j], a1, true)
+                          : mgr.get_or_create_node_bdd(sorted[i], layer[j], a1, true);
+        }
+        layer.swap(next);
+    }
+    return layer[k];
+}
+
+} // namespace
+
+BDD pb_bdd(DDManager& mgr, const std::vector<bddvar>& vars,
+           const std::vector<long long>& weights, PBRelation rel, long long bound) {
+    TraceScope trace(&mgr, "pb_bdd", "bdd");
+    PBTerms terms = sort_terms(mgr, vars, weights);
+    if (unit_weights(weights) && rel != PBRelation::GE) {
+        int k = static_cast<int>(std::max(-1LL, std::min<long long>(bound, vars.size() + 1)));
+        return rel == PBRelation::LE ? at_most_k_bdd(mgr, vars, k) : exactly_k_bdd(mgr, vars, k);
+    }
+    if (rel == PBRelation::LE) {
+        return BDD(&mgr, pb_le_arc(mgr, terms, bound, false));
+    }
+    PBTerms neg = terms;
+    for (long long& w : neg.weights) w = -w;
+    BDD ge(&mgr, pb_le_arc(mgr, neg, bound == PB_NEG_INF ? PB_POS_INF : -bound, false));
+    if (rel == PBRelation::GE) return ge;
+    BDD le(&mgr, pb_le_arc(mgr, terms, bound, false));
+    return le & ge;
+}
+
+ZDD pb_zdd(DDManager& mgr, const std::vector<bddvar>& vars,
+           const std::vector<long long>& weights, PBRelation rel, long long bound) {
+    TraceScope trace(&mgr, "pb_zdd", "zdd");
+    PBTerms terms = sort_terms(mgr, vars, weights);
+    if (unit_weights(weights) && rel != PBRelation::GE) {
+        int k = static_cast<int>(std::max(-1LL, std::min<long long>(bound, vars.size() + 1)));
+        return rel == PBRelation::LE ? at_most_k_zdd(mgr, vars, k) : exactly_k_zdd(mgr, vars, k);
+    }
+    if (rel == PBRelation::LE) {
+        return ZDD(&mgr, pb_le_arc(mgr, terms, bound, true));
+    }
+    PBTerms neg = terms;
+    for (long long& w : neg.weights) w = -w;
+    ZDD ge(&mgr, pb_le_arc(mgr, neg, bound == PB_NEG_INF ? PB_POS_INF : -bound, true));
+    if (rel == PBRelation::GE) return ge;
+    ZDD le(&mgr, pb_le_arc(mgr, terms, bound, true));
+    return le & ge;
+}
+
+BDD at_most_k_bdd(DDManager& mgr, const std::vector<bddvar>& vars, int k) {
+    return BDD(&mgr, card_arc(mgr, vars, k, false, false));
+}
+
+BDD exactly_k_bdd(DDManager& mgr, const std::vector<bddvar>& vars, int k) {
+    return BDD(&mgr, card_arc(mgr, vars, k, true, false));
+}
+
+ZDD at_most_k_zdd(DDManager& mgr, const std::vector<bddvar>& vars, int k) {
+    return ZDD(&mgr, card_arc(mgr, vars, k, false, true));
+}
+
+ZDD exactly_k_zdd(DDManager& mgr, const std::vector<bddvar>& vars, int k) {
+    return ZDD(&mgr, card_arc(mgr, vars, k, true, true));
+}
+
+} // namespace sbdd2
@@ -0,0 +1,212 @@
+// SAPPOROBDD 2.0 - Partitioned transition relation and reachability
+// MIT License
+
+#include "sbdd2/reachability.hpp"
+#include "sbdd2/trace.hpp"
+#include <algorithm>
+
+namespace sbdd2 {
+
+namespace {
+
+// Greedy ordering of the parts by variable lifetime (after IWLS95). At each
+// step pick the part whose quantifiable variables mostly die there (appear in
+// no other remaining part); break ties by the number of variables it brings
+// into the product for the first time, then by position.
+std::vector<std::size_t> lifetime_order(const std::vector<std::vector<bddvar> >& supports,
+                                        const std::vector<bool>& quantifiable) {
+    std::vector<std::size_t> occurrences(quantifiable.size(), 0);
+    for (const auto& s : supports) {
+        for (bddvar v : s) ++occurrences[v];
+    }
+    std::vector<bool> introduced(quantifiable.size(), false);
+    std::vector<bool> used(supports.size(), false);
+    std::vector<std::size_t> order;
+    order.reserve(supports.size());
+
+    while (order.size() < supports.size()) {
+        std::size_t best = supports.size();
+        double best_score = -1.0;
+        std::size_t best_new = 0;
+        for (std::size_t j = 0; j < supports.size(); ++j) {
+            if (used[j]) continue;
+            std::size_t q = 0, dead = 0, fresh = 0;
+            for (bddvar v : supports[j]) {
+                if (quantifiable[v]) {
+                    ++q;
+                    if (occurrences[v] == 1) ++dead;
+                }
+                if (!introduced[v]) ++fresh;
+            }
+            double score = q == 0 ? 0.0 : static_cast<double>(dead) / q;
+            if (score > best_score || (score == best_score && fresh < best_new)) {
+                best = j;
+                best_score = score;
+                best_new = fresh;
+            }
+        }
+        used[best] = true;
+        order.push_back(best);
+        for (bddvar v : supports[best]) {
+            --occurrences[v];
+            introduced[v] = true;
+        }
+    }
+    return order;
+}
+
+// Quantify each quantifiable variable right after the last cluster (in the
+// given order) that depends on it. Variables in no cluster at all go with
+// the first one.
+void schedule_quantification(const std::vector<std::vector<bddvar> >& supports,
+                             const std::vector<std::size_t>& order,
+                             const std::vector<bool>& quantifiable,
+                             std::vector<std::vector<bddvar> >& quantify) {
+    std::vector<std::size_t> last(quantifiable.size(), 0);
+    std::vector<bool> seen(quantifiable.size(), false);
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        for (bddvar v : supports[order[i]]) {
+            last[v] = i;
+            seen[v] = true;
+        }
+    }
+    quantify.assign(order.size(), std::vector<bddvar>());
+    for (bddvar v = 1; v < quantifiable.size(); ++v) {
+        if (quantifiable[v]) quantify[seen[v] ? last[v] : 0].push_back(v);
+    }
+}
+
+} // namespace
+
+TransitionRelation::TransitionRelation(const std::vector<BDD>& parts,
+                                       const std::vector<bddvar>& current_vars,
+                                       const std::vector<bddvar>& next_vars,
+                                       std::size_t cluster_limit)
+    : manager_(nullptr), current_vars_(current_vars), next_vars_(next_vars) {
+    if (parts.empty()) {
+        throw DDArgumentException("TransitionRelation: no parts given");
+    }
+    if (current_vars.size() != next_vars.size()) {
+        throw DDArgumentException("TransitionRelation: current and next variables differ in number");
+    }
+    manager_ = parts.front().manager();
+    for (const BDD& p : parts) {
+        if (!p.manager() || p.manager() != manager_) {
+            throw DDIncompatibleException("BDD managers do not match");
+        }
+    }
+    TraceScope trace(manager_, "TransitionRelation::build", "bdd");
+
+    bddvar n = manager_->var_count();
+    // 1 = current, 2 = next
+    std::vector<int> kind(n + 1, 0);
+    for (std::size_t i = 0; i < current_vars.size(); ++i) {
+        bddvar x = current_vars[i], y = next_vars[i];
+        if (x == 0 || x > n || y == 0 || y > n) {
+            throw DDArgumentException("Invalid variable number");
+        }
+        if (kind[x] != 0 || kind[y] != 0 || x == y) {
+            throw DDArgumentException("TransitionRelation: state variables overlap");
+        }
+        kind[x] = 1;
+        kind[y] = 2;
+    }
+    to_current_.resize(n + 1);
+    to_next_.resize(n + 1);
+    for (bddvar v = 0; v <= n; ++v) to_current_[v] = to_next_[v] = v;
+    for (std::size_t i = 0; i < current_vars.size(); ++i) {
+        to_current_[next_vars[i]] = current_vars[i];
+        to_next_[current_vars[i]] = next_vars[i];
+    }
+
+    // The image quantifies everything but the next-state variables, the
+    // preimage everything but the current-state variables.
+    std::vector<bool> image_q(n + 1, false), preimage_q(n + 1, false);
+    for (bddvar v = 1; v <= n; ++v) {
+        image_q[v] = (kind[v] != 2);
+        preimage_q[v] = (kind[v] != 1);
+    }
+
+    // Order the parts for the image and merge neighbours into clusters
+    std::vector<std::vector<bddvar> > supports;
+    supports.reserve(parts.size());
+    for (const BDD& p : parts) supports.push_back(p.support());
+    std::vector<std::size_t> order = lifetime_order(supports, image_q);
+    BDD cluster = parts[order[0]];
+    for (std::size_t i = 1; i < order.size(); ++i) {
+        const BDD& p = parts[order[i]];
+        if (cluster_limit > 0) {
+            BDD merged = cluster & p;
+            if (merged.size() <= cluster_limit) {
+                cluster = merged;
+                continue;
+            }
+        }
+        clusters_.push_back(cluster);
+        cluster = p;
+    }
+    clusters_.push_back(cluster);
+
+    supports.clear();
+    for (const BDD& c : clusters_) supports.push_back(c.support());
+    image_schedule_.order = lifetime_order(supports, image_q);
+    schedule_quantification(supports, image_schedule_.order, image_q,
+                            image_schedule_.quantify);
+    preimage_schedule_.order = lifetime_order(supports, preimage_q);
+    schedule_quantification(supports, preimage_schedule_.order, preimage_q,
+                            preimage_schedule_.quantify);
+}
+
+BDD TransitionRelation::apply_schedule(const Schedule& schedule, const BDD& states) const {
+    BDD result = states;
+    for (std::size_t i = 0; i < schedule.order.size() && !result.is_zero(); ++i) {
+        result = result.and_exist(clusters_[schedule.order[i]], schedule.quantify[i]);
+    }
+    return result;
+}
+
+BDD TransitionRelation::image(const BDD& states) const {
+    if (states.manager() != manager_) {
+        throw DDIncompatibleException("BDD managers do not match");
+    }
+    TraceScope trace(manager_, "TransitionRelation::image", "bdd");
+    return apply_schedule(image_schedule_, states).permute(to_current_);
+}
+
+BDD TransitionRelation::preimage(const BDD& states) const {
+    if (states.manager() != manager_) {
+        throw DDIncompatibleException("BDD managers do not match");
+    }
+    TraceScope trace(manager_, "TransitionRelation::preimage", "bdd");
+    return apply_schedule(preimage_schedule_, states.permute(to_next_));
+}
+
+BDD TransitionRelation::fixpoint(const BDD& init, std::size_t max_steps, bool forward) const {
+    if (init.manager() != manager_) {
+        throw DDIncompatibleException("BDD managers do not match");
+    }
+    BDD reached = init;
+    BDD frontier = init;
+    for (std::size_t step = 0; !frontier.is_zero() && (max_steps == 0 || step < max_steps); ++step) {
+        // Any set between the frontier and frontier | reached has the same
+        // new successors; let constrain pick one with the rest as don't-care.
+        BDD simplified = frontier.constrain(frontier | ~reached);
+        if (simplified.size() < frontier.size()) frontier = simplified;
+        BDD next = forward ? image(frontier) : preimage(frontier);
+        frontier = next - reached;
+        reached |= frontier;
+    }
+    return reached;
+}
+
+BDD TransitionRelation::reachable(const BDD& init, std::size_t max_steps) const {
+    TraceScope trace(manager_, "TransitionRelation::reachable", "bdd");
+    return fixpoint(init, max_steps, true);
+}
+
+BDD TransitionRelation::backward_reachable(const BDD& target, std::size_t max_steps) const {
+    TraceScope trace(manager_, "TransitionRelation::backward_reachable", "bdd");
+    return fixpoint(target, max_steps, false);
+}
+
+} // namespace sbdd2
@@ -0,0 +1,424 @@
+// SAPPOROBDD 2.0 - Lazy variable-shift view of a ZDD
+// MIT License
+
+#include "sbdd2/shifted_zdd.hpp"
+#include "sbdd2/exception.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace sbdd2 {
+
+namespace {
+
+// Smallest variable number in f, 0 if f has none
+bddvar min_support_var(const ZDD& f) {
+    std::vector<bddvar> vars = f.support();
+    return vars.empty() ? 0 : vars.front();
+}
+
+} // namespace
+
+ShiftedZDD::ShiftedZDD(const ZDD& base, int offset, bddvar floor)
+    : base_(base), offset_(offset), floor_(floor), min_var_(0) {
+    if (static_cast<std::int64_t>(floor) + offset < 0) {
+        throw DDArgumentException("ShiftedZDD: shift would move a variable below 1");
+    }
+    if (floor_ != 0) min_var_ = min_support_var(base_);
+}
+
+bool ShiftedZDD::is_relabeling() const {
+    return floor_ == 0 || min_var_ == 0 || min_var_ > floor_;
+}
+
+// Shifts compose by rewriting (offset, floor); no node is touched
+ShiftedZDD ShiftedZDD::operator<<(int s) const {
+    if (s <= 0) return *this;
+    ShiftedZDD result(*this);
+    result.offset_ += s;
+    return result;
+}
+
+ShiftedZDD ShiftedZDD::operator>>(int s) const {
+    if (s <= 0) return *this;
+    ShiftedZDD result(*this);
+    // Base variables v with v + offset <= s drop out
+    std::int64_t bound = static_cast<std::int64_t>(s) - offset_;
+    if (bound > static_cast<std::int64_t>(result.floor_)) {
+        // min_var_ is kept only while something may be projected
+        if (result.floor_ == 0) result.min_var_ = min_support_var(base_);
+        result.floor_ = static_cast<bddvar>(bound);
+    }
+    result.offset_ -= s;
+    return result;
+}
+
+ShiftedZDD& ShiftedZDD::operator<<=(int s) {
+    *this = *this << s;
+    return *this;
+}
+
+ShiftedZDD& ShiftedZDD::operator>>=(int s) {
+    *this = *this >> s;
+    return *this;
+}
+
+ZDD ShiftedZDD::materialize() const {
+    if (offset_ == 0 && floor_ == 0) return base_;
+    return zdd_shift(base_, offset_, floor_);
+}
+
+bool ShiftedZDD::is_one() const {
+    if (base_.is_one()) return true;
+    if (is_relabeling()) return false;
+    return materialize().is_one();
+}
+
+bddvar ShiftedZDD::top() const {
+    if (!is_relabeling()) return materialize().top();
+    bddvar t = base_.top();
+    if (t == 0) return 0;
+    return static_cast<bddvar>(static_cast<std::int64_t>(t) + offset_);
+}
+
+double ShiftedZDD::card() const {
+    if (is_relabeling()) return base_.card();
+    return materialize().card();
+}
+
+#if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
+std::string ShiftedZDD::exact_count() const {
+    if (is_relabeling()) return base_.exact_count();
+    return materialize().exact_count();
+}
+#endif
+
+std::vector<std::vector<bddvar>> ShiftedZDD::enumerate() const {
+    if (!is_relabeling()) return materialize().enumerate();
+    std::vector<std::vector<bddvar>> sets = base_.enumerate();
+    for (auto& set : sets) {
+        for (auto& v : set) {
+            v = static_cast<bddvar>(static_cast<std::int64_t>(v) + offset_);
+        }
+    }
+    return sets;
+}
+
+std::vector<bddvar> ShiftedZDD::one_set() const {
+    if (!is_relabeling()) return materialize().one_set();
+    std::vector<bddvar> set = base_.one_set();
+    for (auto& v : set) {
+        v = static_cast<bddvar>(static_cast<std::int64_t>(v) + offset_);
+    }
+    return set;
+}
+
+std::uint64_t ShiftedZDD::lit() const {
+    if (is_relabeling()) return base_.lit();
+    return materialize().lit();
+}
+
+std::uint64_t ShiftedZDD::len() const {
+    if (is_relabeling()) return base_.len();
+    return materialize().len();
+}
+
+// Set operations commute with an injective renaming, so two relabeling
+// views are combined in the frame of the smaller offset m. The walk reads
+// both bases in step, placing base variable v of a view at v + (offset - m);
+// only subtrees of the higher view that pass into the result unchanged are
+// shifted, and no shifted copy of a whole operand is built.
+namespace {
+
+struct NodePairHash {
+    std::size_t operator()(const std::pair<std::uint64_t, std::uint64_t>& p) const {
+        return std::hash<std::uint64_t>()(p.first * 0x9e3779b97f4a7c15ULL ^ p.second);
+    }
+};
+
+enum class ShiftCombine : std::uint8_t {
+    NODE,     // node(var, res[0], res[1])
+    PASS,     // res[0]
+    NODE_HI,  // node(var, res[0], hi)
+    JOIN      // node(var, res[0], res[1] + res[2] + res[3])
+};
+
+struct ShiftApplyFrame {
+    Arc f, g;
+    Arc sf[4], sg[4];
+    ZDD res[4];
+    ZDD hi;
+    bddvar var;
+    ShiftCombine combine;
+    std::uint8_t nsub;
+    std::uint8_t next;
+};
+
+class ShiftApply {
+public:
+    ShiftApply(DDManager* mgr, CacheOp op, int df, int dg)
+        : mgr_(mgr), op_(op), df_(df), dg_(dg) {}
+
+    ZDD run(Arc f, Arc g) {
+        ZDD result;
+        if (shortcut(f, g, result)) return result;
+
+        std::vector<ShiftApplyFrame> stack;
+        stack.emplace_back();
+        expand(f, g, stack.back());
+
+        for (;;) {
+            ShiftApplyFrame& frame = stack.back();
+            if (frame.next < frame.nsub) {
+                int i = frame.next++;
+                Arc sf = frame.sf[i];
+                Arc sg = frame.sg[i];
+                if (shortcut(sf, sg, result)) {
+                    frame.res[i] = result;
+                } else {
+                    ShiftApplyFrame child;
+                    expand(sf, sg, child);
+                    stack.push_back(child);
+                }
+                continue;
+            }
+
+            result = finish(frame);
+            stack.pop_back();
+            if (stack.empty()) return result;
+            ShiftApplyFrame& parent = stack.back();
+            parent.res[parent.next - 1] = result;
+        }
+    }
+
+private:
+    // Subtree a of the operand with delta d, moved into the result frame
+    ZDD lift(Arc a, int d) const {
+        ZDD z(mgr_, a);
+        return d == 0 ? z : zdd_shift(z, d, 0);
+    }
+
+    // Variable and level of a in the result frame (level 0 for terminals)
+    bddvar frame_var(Arc a, int d) const {
+        if (a.is_constant()) return 0;
+        return static_cast<bddvar>(
+            static_cast<std::int64_t>(mgr_->node_at(a.index()).var()) + d);
+    }
+
+    bddvar frame_lev(bddvar v) const {
+        return v == 0 ? 0 : mgr_->lev_of_var(v);
+    }
+
+    bool shortcut(Arc f, Arc g, ZDD& result) {
+        ZDD empty = ZDD::empty(*mgr_);
+        switch (op_) {
+        case CacheOp::UNION:
+            if (f == ARC_TERMINAL_0) { result = lift(g, dg_); return true; }
+            if (g == ARC_TERMINAL_0) { result = lift(f, df_); return true; }
+            break;
+        case CacheOp::INTERSECT:
+            if (f == ARC_TERMINAL_0 || g == ARC_TERMINAL_0) { result = empty; return true; }
+            break;
+        case CacheOp::DIFF:
+            if (f == ARC_TERMINAL_0) { result = empty; return true; }
+            if (g == ARC_TERMINAL_0) { result = lift(f, df_); return true; }
+            break;
+        default:
+            if (f == ARC_TERMINAL_0 || g == ARC_TERMINAL_0) { result = empty; return true; }
+            if (f == ARC_TERMINAL_1) { result = lift(g, dg_); return true; }
+            if (g == ARC_TERMINAL_1) { result = lift(f, df_); return true; }
+            break;
+        }
+        // Both are {{}} here, which no shift changes
+        if (f.is_constant() && g.is_constant()) {
+            result = (op_ == CacheOp::DIFF) ? empty : ZDD::single(*mgr_);
+            return true;
+        }
+
+        auto it = memo_.find(std::make_pair(f.data, g.data));
+        if (it != memo_.end()) {
+            result = it->second;
+            return true;
+        }
+        return false;
+    }
+
+    void expand(Arc f, Arc g, ShiftApplyFrame& frame) {
+        frame.f = f;
+        frame.g = g;
+        frame.next = 0;
+
+        bddvar f_var = frame_var(f, df_);
+        bddvar g_var = frame_var(g, dg_);
+        bddvar f_lev = frame_lev(f_var);
+        bddvar g_lev = frame_lev(g_var);
+
+        if (f_lev > g_lev) {
+            // g has no f_var
+            const DDNode& node = mgr_->node_at(f.index());
+            frame.var = f_var;
+            frame.sf[0] = node.arc0(); frame.sg[0] = g;
+            frame.sf[1] = node.arc1(); frame.sg[1] = g;
+            if (op_ == CacheOp::INTERSECT) {
+                frame.combine = ShiftCombine::PASS;
+                frame.nsub = 1;
+            } else if (op_ == CacheOp::PRODUCT) {
+                frame.combine = ShiftCombine::NODE;
+                frame.nsub = 2;
+            } else {
+                frame.combine = ShiftCombine::NODE_HI;
+                frame.hi = lift(node.arc1(), df_);
+                frame.nsub = 1;
+            }
+        } else if (f_lev < g_lev) {
+            // f has no g_var
+            const DDNode& node = mgr_->node_at(g.index());
+            frame.var = g_var;
+            frame.sf[0] = f; frame.sg[0] = node.arc0();
+            frame.sf[1] = f; frame.sg[1] = node.arc1();
+            if (op_ == CacheOp::INTERSECT || op_ == CacheOp::DIFF) {
+                frame.combine = ShiftCombine::PASS;
+                frame.nsub = 1;
+            } else if (op_ == CacheOp::PRODUCT) {
+                frame.combine = ShiftCombine::NODE;
+                frame.nsub = 2;
+            } else {
+                frame.combine = ShiftCombine::NODE_HI;
+                frame.hi = lift(node.arc1(), dg_);
+                frame.nsub = 1;
+            }
+        } else {
+            const DDNode& f_node = mgr_->node_at(f.index());
+            const DDNode& g_node = mgr_->node_at(g.index());
+            Arc f0 = f_node.arc0(), f1 = f_node.arc1();
+            Arc g0 = g_node.arc0(), g1 = g_node.arc1();
+            frame.var = f_var;
+            frame.sf[0] = f0; frame.sg[0] = g0;
+            if (op_ == CacheOp::PRODUCT) {
+                // (f0 + v*f1) * (g0 + v*g1) = f0*g0 + v*(f0*g1 + f1*g0 + f1*g1)
+                frame.combine = ShiftCombine::JOIN;
+                frame.nsub = 4;
+                frame.sf[1] = f0; frame.sg[1] = g1;
+                frame.sf[2] = f1; frame.sg[2] = g0;
+                frame.sf[3] = f1; frame.sg[3] = g1;
+            } else {
+                frame.combine = ShiftCombine::NODE;
+                frame.nsub = 2;
+                frame.sf[1] = f1; frame.sg[1] = g1;
+            }
+        }
+    }
+
+    ZDD finish(ShiftApplyFrame& frame) {
+        ZDD result;
+        switch (frame.combine) {
+        case ShiftCombine::NODE:
+            result = node(frame.var, frame.res[0], frame.res[1]);
+            break;
+        case ShiftCombine::PASS:
+            result = frame.res[0];
+            break;
+        case ShiftCombine::NODE_HI:
+            result = node(frame.var, frame.res[0], frame.hi);
+            break;
+        case ShiftCombine::JOIN:
+            result = node(frame.var, frame.res[0], frame.res[1] + frame.res[2] + frame.res[3]);
+            break;
+        }
+        memo_[std::make_pair(frame.f.data, frame.g.data)] = result;
+        return result;
+    }
+
+    ZDD node(bddvar var, const ZDD& lo, const ZDD& hi) const {
+        return ZDD(mgr_, mgr_->get_or_create_node_zdd(var, lo.arc(), hi.arc(), true));
+    }
+
+    DDManager* mgr_;
+    CacheOp op_;
+    int df_, dg_;
+    std::unordered_map<std::pair<std::uint64_t, std::uint64_t>, ZDD, NodePairHash> memo_;
+};
+
+ZDD apply_op(CacheOp op, const ZDD& a, const ZDD& b) {
+    switch (op) {
+    case CacheOp::UNION: return a + b;
+    case CacheOp::DIFF: return a - b;
+    case CacheOp::INTERSECT: return a & b;
+    default: return a * b;
+    }
+}
+
+} // namespace
+
+ShiftedZDD ShiftedZDD::combine(const ShiftedZDD& other, CacheOp op) const {
+    if (manager() != other.manager()) {
+        throw DDIncompatibleException("ZDD managers do not match");
+    }
+    if (!is_relabeling() || !other.is_relabeling()) {
+        return ShiftedZDD(apply_op(op, materialize(), other.materialize()));
+    }
+
+    int m = std::min(offset_, other.offset_);
+    // Every variable of the result lies above -m, so nothing is projected
+    bddvar floor = (m < 0) ? static_cast<bddvar>(-static_cast<std::int64_t>(m)) : 0;
+    if (offset_ == other.offset_) {
+        return ShiftedZDD(apply_op(op, base_, other.base_), m, floor);
+    }
+    ShiftApply apply(manager(), op, offset_ - m, other.offset_ - m);
+    return ShiftedZDD(apply.run(base_.arc(), other.base_.arc()), m, floor);
+}
+
+ShiftedZDD ShiftedZDD::operator+(const ShiftedZDD& other) const {
+    return combine(other, CacheOp::UNION);
+}
+
+ShiftedZDD ShiftedZDD::operator-(const ShiftedZDD& other) const {
+    return combine(other, CacheOp::DIFF);
+}
+
+ShiftedZDD ShiftedZDD::operator&(const ShiftedZDD& other) const {
+    return combine(other, CacheOp::INTERSECT);
+}
+
+ShiftedZDD ShiftedZDD::operator*(const ShiftedZDD& other) const {
+    return combine(other, CacheOp::PRODUCT);
+}
+
+// Relabelings that keep the variable order map a canonical ZDD to a
+// canonical ZDD of the same shape, so two relabeling views are equal iff
+// their bases match node by node with var(x) + offset == var(y) + other offset
+bool ShiftedZDD::operator==(const ShiftedZDD& other) const {
+    if (manager() != other.manager()) return false;
+    if (!is_relabeling() || !other.is_relabeling()) {
+        return materialize() == other.materialize();
+    }
+    if (offset_ == other.offset_) return base_ == other.base_;
+
+    DDManager* mgr = manager();
+    std::unordered_set<std::pair<std::uint64_t, std::uint64_t>, NodePairHash> visited;
+    std::vector<std::pair<Arc, Arc>> stack;
+    stack.emplace_back(base_.arc(), other.base_.arc());
+    while (!stack.empty()) {
+        Arc x = stack.back().first;
+        Arc y = stack.back().second;
+        stack.pop_back();
+        if (x.is_constant() || y.is_constant()) {
+            if (x != y) return false;
+            continue;
+        }
+        if (!visited.insert(std::make_pair(x.data, y.data)).second) continue;
+
+        const DDNode& xn = mgr->node_at(x.index());
+        const DDNode& yn = mgr->node_at(y.index());
+        if (static_cast<std::int64_t>(xn.var()) + offset_ !=
+            static_cast<std::int64_t>(yn.var()) + other.offset_) {
+            return false;
+        }
+        stack.emplace_back(xn.arc0(), yn.arc0());
+        stack.emplace_back(xn.arc1(), yn.arc1());
+    }
+    return true;
+}
+
+} // namespace sbdd2
@@ -0,0 +1,94 @@
+// SAPPOROBDD 2.0 - Operation timeline recorder
+// MIT License
+
+#include "sbdd2/trace.hpp"
+#include <cstdio>
+#include <fstream>
+#include <ostream>
+
+namespace sbdd2 {
+
+TraceRecorder::TraceRecorder(std::size_t max_events)
+    : max_events_(max_events)
+    , dropped_(0)
+    , origin_(Clock::now())
+{
+}
+
+// Small, stable thread numbers read better in the viewer than hashed ids
+unsigned TraceRecorder::thread_number(std::thread::id id) {
+    for (std::size_t i = 0; i < threads_.size(); ++i) {
+        if (threads_[i] == id) return static_cast<unsigned>(i + 1);
+    }
+    threads_.push_back(id);
+    return static_cast<unsigned>(threads_.size());
+}
+
+void TraceRecorder::record(const char* name, const char* category,
+                           Clock::time_point start, Clock::time_point end,
+                           std::size_t nodes_before, std::size_t nodes_after) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (events_.size() >= max_events_) {
+        ++dropped_;
+        return;
+    }
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.start = start;
+    event.end = end;
+    event.nodes_before = nodes_before;
+    event.nodes_after = nodes_after;
+    event.thread = thread_number(std::this_thread::get_id());
+    events_.push_back(event);
+}
+
+std::vector<TraceRecorder::Event> TraceRecorder::events() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_;
+}
+
+std::size_t TraceRecorder::event_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_.size();
+}
+
+std::size_t TraceRecorder::dropped_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+void TraceRecorder::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.clear();
+    threads_.clear();
+    dropped_ = 0;
+    origin_ = Clock::now();
+}
+
+void TraceRecorder::write_chrome_trace(std::ostream& os) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    os << "{\"traceEvents\":[";
+    char buf[512];
+    for (std::size_t i = 0; i < events_.size(); ++i) {
+        const Event& e = events_[i];
+        double ts = std::chrono::duration<double, std::micro>(e.start - origin_).count();
+        double dur = std::chrono::duration<double, std::micro>(e.end - e.start).count();
+        std::snprintf(buf, sizeof(buf),
+            "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+            "\"pid\":1,\"tid\":%u,\"args\":{\"nodes_before\":%zu,\"nodes_after\":%zu}}",
+            i == 0 ? "" : ",", e.name, e.category, ts, dur, e.thread,
+            e.nodes_before, e.nodes_after);
+        os << buf;
+    }
+    os << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" << dropped_ << "}}\n";
+}
+
+bool TraceRecorder::write_chrome_trace(const std::string& filename) const {
+    std::ofstream ofs(filename);
+    if (!ofs) return false;
+    write_chrome_trace(ofs);
+    return ofs.good();
+}
+
+} // namespace sbdd2
@@ -0,0 +1,263 @@
+// SAPPOROBDD 2.0 - Cross-manager DD transfer
+// MIT License
+
+#include "sbdd2/transfer.hpp"
+#include "sbdd2/trace.hpp"
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <unordered_map>
+
+namespace sbdd2 {
+
+namespace {
+
+// Levels with fewer nodes than this are copied on the calling thread
+constexpr std::size_t PARALLEL_LEVEL_MIN = 1024;
+
+constexpr std::size_t NO_CHILD = static_cast<std::size_t>(-1);
+
+struct SourceNode {
+    bddindex index;
+    bddvar var;
+    bddvar level;
+    Arc arc[2];
+    std::size_t child[2];  // dense id of each child, NO_CHILD for terminals
+};
+
+// Collect the nodes reachable from roots, sorted by source level (children
+// first), and number them densely.
+std::vector<SourceNode> collect_nodes(const DDManager& src, const std::vector<Arc>& roots,
+                                      std::unordered_map<bddindex, std::size_t>& dense) {
+    std::vector<SourceNode> nodes;
+    std::vector<bddindex> stack;
+    for (Arc r : roots) {
+        if (!r.is_constant()) stack.push_back(r.index());
+    }
+    while (!stack.empty()) {
+        bddindex idx = stack.back();
+        stack.pop_back();
+        if (!dense.emplace(idx, 0).second) continue;
+        const DDNode& node = src.node_at(idx);
+        SourceNode sn;
+        sn.index = idx;
+        sn.var = node.var();
+        sn.level = src.lev_of_var(node.var());
+        sn.arc[0] = node.arc0();
+        sn.arc[1] = node.arc1();
+        nodes.push_back(sn);
+        for (int i = 0; i < 2; ++i) {
+            if (!sn.arc[i].is_constant()) stack.push_back(sn.arc[i].index());
+        }
+    }
+
+    std::sort(nodes.begin(), nodes.end(), [](const SourceNode& a, const SourceNode& b) {
+        return a.level != b.level ? a.level < b.level : a.index < b.index;
+    });
+    for (std::size_t i = 0; i < nodes.size(); ++i) dense[nodes[i].index] = i;
+    for (SourceNode& sn : nodes) {
+        for (int i = 0; i < 2; ++i) {
+            sn.child[i] = sn.arc[i].is_constant() ? NO_CHILD : dense[sn.arc[i].index()];
+        }
+    }
+    return nodes;
+}
+
+// True if every edge still points to a lower level under dst's order
+bool order_preserved(const std::vector<SourceNode>& nodes, const DDManager& dst) {
+    for (const SourceNode& sn : nodes) {
+        bddvar lev = dst.lev_of_var(sn.var);
+        for (int i = 0; i < 2; ++i) {
+            if (sn.child[i] != NO_CHILD && dst.lev_of_var(nodes[sn.child[i]].var) >= lev) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+Arc map_arc(Arc a, std::size_t child, const std::vector<Arc>& mapped) {
+    if (child == NO_CHILD) return a;
+    return a.is_negated() ? mapped[child].negated() : mapped[child];
+}
+
+// Structural copy, one level at a time. Nodes of a level depend only on lower
+// levels, so a level can be split across threads.
+template<bool IsZDD>
+std::vector<Arc> copy_nodes(const std::vector<SourceNode>& nodes, DDManager& dst, bool parallel) {
+    std::vector<Arc> mapped(nodes.size());
+    auto copy_range = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const SourceNode& sn = nodes[i];
+            Arc a0 = map_arc(sn.arc[0], sn.child[0], mapped);
+            Arc a1 = map_arc(sn.arc[1], sn.child[1], mapped);
+            mapped[i] = IsZDD ? dst.get_or_create_node_zdd(sn.var, a0, a1, true)
+                              : dst.get_or_create_node_bdd(sn.var, a0, a1, true);
+        }
+    };
+
+    unsigned cores = parallel ? std::max(1u, std::thread::hardware_concurrency()) : 1;
+    std::size_t begin = 0;
+    while (begin < nodes.size()) {
+        std::size_t end = begin;
+        while (end < nodes.size() && nodes[end].level == nodes[begin].level) ++end;
+
+        std::size_t count = end - begin;
+        if (cores > 1 && count >= PARALLEL_LEVEL_MIN) {
+            std::size_t chunk = (count + cores - 1) / cores;
+            std::vector<std::future<void>> tasks;
+            for (std::size_t b = begin + chunk; b < end; b += chunk) {
+                tasks.push_back(std::async(std::launch::async, copy_range,
+                                           b, std::min(b + chunk, end)));
+            }
+            copy_range(begin, begin + chunk);
+            for (auto& t : tasks) t.get();
+        } else {
+            copy_range(begin, end);
+        }
+        begin = end;
+    }
+    return mapped;
+}
+
+// Apply the negation bit of a source arc. Only BDD arcs carry one; ZDD
+// nodes are created without negated arcs, so the bit is not read for ZDD.
+BDD signed_value(const BDD& f, Arc a) {
+    return a.is_negated() ? ~f : f;
+}
+
+ZDD signed_value(const ZDD& f, Arc) {
+    return f;
+}
+
+// Semantic rebuild for a different variable order: each node becomes
+// ite(x_v, hi, lo) on dst.
+std::vector<BDD> rebuild_nodes(const std::vector<SourceNode>& nodes, DDManager& dst,
+                               const BDD*) {
+    std::vector<BDD> mapped(nodes.size());
+    auto value = [&](Arc a, std::size_t child) -> BDD {
+        if (child == NO_CHILD) {
+            return (a.terminal_value() != a.is_negated()) ? dst.bdd_one() : dst.bdd_zero();
+        }
+        return signed_value(mapped[child], a);
+    };
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const SourceNode& sn = nodes[i];
+        BDD lo = value(sn.arc[0], sn.child[0]);
+        BDD hi = value(sn.arc[1], sn.child[1]);
+        mapped[i] = dst.var_bdd(sn.var).ite(hi, lo);
+    }
+    return mapped;
+}
+
+// Same for ZDD: lo + change(hi, v)
+std::vector<ZDD> rebuild_nodes(const std::vector<SourceNode>& nodes, DDManager& dst,
+                               const ZDD*) {
+    std::vector<ZDD> mapped(nodes.size());
+    ZDD base = ZDD::single(dst);
+    auto value = [&](Arc a, std::size_t child) -> ZDD {
+        if (child == NO_CHILD) {
+            return a.terminal_value() ? base : ZDD::empty(dst);
+        }
+        return mapped[child];
+    };
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const SourceNode& sn = nodes[i];
+        ZDD lo = value(sn.arc[0], sn.child[0]);
+        ZDD hi = value(sn.arc[1], sn.child[1]);
+        mapped[i] = lo + hi.change(sn.var);
+    }
+    return mapped;
+}
+
+// If dst was created by (possibly repeated) fork() of src, dst reads the
+// nodes of src below the returned index directly (src may have grown since
+// the fork). 0 otherwise.
+std::size_t shared_index_limit(const DDManager& dst, const DDManager* src) {
+    for (const DDManager* m = &dst; m->base_manager(); m = m->base_manager()) {
+        if (m->base_manager() == src) return m->base_index_limit();
+    }
+    return 0;
+}
+
+template<typename DD, bool IsZDD>
+std::vector<DD> transfer_impl(const std::vector<DD>& fs, DDManager& dst, bool parallel) {
+    DDManager* src = nullptr;
+    for (const DD& f : fs) {
+        if (!f.manager()) continue;
+        if (src && src != f.manager()) {
+            throw DDIncompatibleException("transfer: source DDs belong to different managers");
+        }
+        src = f.manager();
+    }
+    std::vector<DD> result(fs.size());
+    if (!src) return result;
+    std::size_t limit = (src == &dst) ? BDDINDEX_MAX : shared_index_limit(dst, src);
+    bool shared = limit > 0;
+    for (const DD& f : fs) {
+        if (f.manager() && !f.arc().is_constant() && f.arc().index() >= limit) shared = false;
+    }
+    if (shared) {
+        // A fork reads its base's nodes directly, so arcs carry over unchanged
+        for (std::size_t i = 0; i < fs.size(); ++i) {
+            if (fs[i].manager()) result[i] = DD(&dst, fs[i].arc());
+        }
+        return result;
+    }
+
+    TraceScope trace(&dst, "transfer", "io");
+
+    std::vector<Arc> roots;
+    roots.reserve(fs.size());
+    for (const DD& f : fs) roots.push_back(f.manager() ? f.arc() : ARC_TERMINAL_0);
+
+    std::unordered_map<bddindex, std::size_t> dense;
+    std::vector<SourceNode> nodes = collect_nodes(*src, roots, dense);
+
+    bddvar max_var = 0;
+    for (const SourceNode& sn : nodes) max_var = std::max(max_var, sn.var);
+    while (dst.var_count() < max_var) dst.new_var();
+
+    if (order_preserved(nodes, dst)) {
+        std::vector<Arc> mapped = copy_nodes<IsZDD>(nodes, dst, parallel);
+        for (std::size_t i = 0; i < fs.size(); ++i) {
+            if (!fs[i].manager()) continue;
+            Arc r = roots[i];
+            result[i] = DD(&dst, r.is_constant() ? r : map_arc(r, dense[r.index()], mapped));
+        }
+        return result;
+    }
+
+    std::vector<DD> mapped = rebuild_nodes(nodes, dst, static_cast<const DD*>(nullptr));
+    for (std::size_t i = 0; i < fs.size(); ++i) {
+        if (!fs[i].manager()) continue;
+        Arc r = roots[i];
+        if (r.is_constant()) {
+            result[i] = DD(&dst, r);
+        } else {
+            const DD& m = mapped[dense[r.index()]];
+            result[i] = signed_value(m, r);
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+BDD transfer(const BDD& f, DDManager& dst, bool parallel) {
+    return transfer(std::vector<BDD>(1, f), dst, parallel)[0];
+}
+
+ZDD transfer(const ZDD& f, DDManager& dst, bool parallel) {
+    return transfer(std::vector<ZDD>(1, f), dst, parallel)[0];
+}
+
+std::vector<BDD> transfer(const std::vector<BDD>& fs, DDManager& dst, bool parallel) {
+    return transfer_impl<BDD, false>(fs, dst, parallel);
+}
+
+std::vector<ZDD> transfer(const std::vector<ZDD>& fs, DDManager& dst, bool parallel) {
+    return transfer_impl<ZDD, true>(fs, dst, parallel);
+}
+
+} // namespace sbdd2
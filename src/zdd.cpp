@@ -3,12 +3,21 @@
 
 #include "sbdd2/zdd.hpp"
 #include "sbdd2/bdd.hpp"
+#include "sbdd2/profile.hpp"
+#include "sbdd2/trace.hpp"
 #include <iostream>
 #include <sstream>
 #include <stack>
 #include <unordered_set>
 #include <unordered_map>
 #include <functional>
+#include <algorithm>
+#include <random>
+#include <future>
+#include <thread>
+#include <array>
+#include <atomic>
+#include <memory>
 
 #if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
 #include "sbdd2/exact_int.hpp"
@@ -51,67 +60,182 @@ ZDD ZDD::high() const {
     return ZDD(manager_, node.arc1());
 }
 
-// Family operations
-ZDD ZDD::onset(bddvar v) const {
-    if (!manager_ || arc_.is_constant()) {
-        return ZDD::empty(*manager_);
+// Cofactor kernels (onset, offset, change) by a set of variables. The set is
+// passed as the arc of a single-set ZDD (a chain of 1-edges), so the
+// single-variable and multi-variable forms share one cache entry format:
+// (op, f, set arc).
+enum class ZDDCofactor { ONSET, OFFSET, CHANGE };
+
+static CacheOp zdd_cofactor_op(ZDDCofactor kind) {
+    switch (kind) {
+    case ZDDCofactor::ONSET: return CacheOp::ONSET;
+    case ZDDCofactor::OFFSET: return CacheOp::OFFSET;
+    case ZDDCofactor::CHANGE: break;
+    }
+    return CacheOp::CHANGE;
+}
+
+// Explicit-stack frame of the single-operand ZDD kernels
+struct ZDDUnaryFrame {
+    Arc f;
+    Arc sub[2];
+    bddvar var;
+    int stage;
+};
+
+// Explicit-stack frame of zdd_cofactor: the result is
+// node(var, cofactor(sub_f[0], sub_s[0]), cofactor(sub_f[1], sub_s[1]))
+struct ZDDCofactorFrame {
+    Arc f, s;
+    Arc sub_f[2];
+    Arc sub_s[2];
+    bddvar var;
+    int stage;
+};
+
+// Terminal, cached and tail cases of zdd_cofactor. Advances (f, s) past
+// variables of s that resolve without a new node; returns true if the result
+// is determined, false if (f, s) needs a frame.
+static bool zdd_cofactor_shortcut(DDManager* mgr, ZDDCofactor kind, Arc& f, Arc& s,
+                                  Arc& result) {
+    CacheOp op = zdd_cofactor_op(kind);
+    while (true) {
+        if (s == ARC_TERMINAL_1 || f == ARC_TERMINAL_0) {
+            result = f;
+            return true;
+        }
+        if (mgr->cache_lookup(op, f, s, result)) return true;
+
+        const DDNode& s_node = mgr->node_at(s.index());
+        bddvar s_lev = mgr->lev_of_var(s_node.var());
+        bddvar f_lev = 0;
+        const DDNode* f_node = nullptr;
+        if (!f.is_constant()) {
+            f_node = &mgr->node_at(f.index());
+            f_lev = mgr->lev_of_var(f_node->var());
+        }
+
+        // SAPPOROBDD convention: larger level = closer to root
+        if (f_lev > s_lev) return false;
+        if (f_lev < s_lev) {
+            // No set of f contains the top variable of s
+            if (kind == ZDDCofactor::ONSET) {
+                result = ARC_TERMINAL_0;
+                return true;
+            }
+            if (kind == ZDDCofactor::CHANGE) return false;
+            s = s_node.arc1();
+            continue;
+        }
+        if (kind == ZDDCofactor::CHANGE) return false;
+        f = kind == ZDDCofactor::ONSET ? f_node->arc1() : f_node->arc0();
+        s = s_node.arc1();
     }
+}
 
-    bddvar top = manager_->node_at(arc_.index()).var();
-    bddvar top_lev = manager_->lev_of_var(top);
-    bddvar v_lev = manager_->lev_of_var(v);
+static void zdd_cofactor_push(DDManager* mgr, std::vector<ZDDCofactorFrame>& stack,
+                              Arc f, Arc s) {
+    ZDDCofactorFrame frame;
+    frame.f = f;
+    frame.s = s;
+    frame.stage = 0;
 
-    // SAPPOROBDD convention: larger level = closer to root
-    // If top's level < v's level, v should have appeared earlier (closer to root)
-    // but it didn't, so v is not in this subtree
-    if (top_lev < v_lev) {
-        return ZDD::empty(*manager_);
-    }
-    if (top == v) {
-        return high();
+    const DDNode& s_node = mgr->node_at(s.index());
+    bddvar f_lev = f.is_constant() ? 0 : mgr->lev_of_var(mgr->node_at(f.index()).var());
+    bddvar s_lev = mgr->lev_of_var(s_node.var());
+    if (f_lev > s_lev) {
+        const DDNode& f_node = mgr->node_at(f.index());
+        frame.var = f_node.var();
+        frame.sub_f[0] = f_node.arc0();
+        frame.sub_f[1] = f_node.arc1();
+        frame.sub_s[0] = frame.sub_s[1] = s;
+    } else {
+        // CHANGE at the top variable of s: toggle it in every set
+        frame.var = s_node.var();
+        if (f_lev < s_lev) {
+            frame.sub_f[0] = ARC_TERMINAL_0;
+            frame.sub_f[1] = f;
+        } else {
+            const DDNode& f_node = mgr->node_at(f.index());
+            frame.sub_f[0] = f_node.arc1();
+            frame.sub_f[1] = f_node.arc0();
+        }
+        frame.sub_s[0] = frame.sub_s[1] = s_node.arc1();
     }
+    stack.push_back(frame);
+}
 
-    // Recursive case
-    const DDNode& node = manager_->node_at(arc_.index());
-    ZDD lo(manager_, node.arc0());
-    ZDD hi(manager_, node.arc1());
-
-    ZDD lo_onset = lo.onset(v);
-    ZDD hi_onset = hi.onset(v);
+// Cofactor by the variable set s (iterative, safe at any depth)
+static Arc zdd_cofactor(DDManager* mgr, ZDDCofactor kind, Arc f, Arc s) {
+    Arc result;
+    if (zdd_cofactor_shortcut(mgr, kind, f, s, result)) return result;
+
+    std::vector<ZDDCofactorFrame> stack;
+    std::vector<Arc> results;
+    zdd_cofactor_push(mgr, stack, f, s);
+
+    while (!stack.empty()) {
+        ZDDCofactorFrame& frame = stack.back();
+        if (frame.stage < 2) {
+            Arc sf = frame.sub_f[frame.stage];
+            Arc ss = frame.sub_s[frame.stage];
+            ++frame.stage;
+            if (zdd_cofactor_shortcut(mgr, kind, sf, ss, result)) {
+                results.push_back(result);
+            } else {
+                zdd_cofactor_push(mgr, stack, sf, ss);
+            }
+            continue;
+        }
 
-    // Reconstruct
-    Arc result = manager_->get_or_create_node_zdd(top, lo_onset.arc_, hi_onset.arc_, true);
-    return ZDD(manager_, result);
-}
+        Arc r1 = results.back();
+        results.pop_back();
+        Arc r0 = results.back();
+        results.pop_back();
 
-ZDD ZDD::offset(bddvar v) const {
-    if (!manager_ || arc_.is_constant()) {
-        return *this;
+        result = mgr->get_or_create_node_zdd(frame.var, r0, r1, true);
+        mgr->cache_insert(zdd_cofactor_op(kind), frame.f, frame.s, result);
+        results.push_back(result);
+        stack.pop_back();
     }
+    return results.back();
+}
 
-    bddvar top = manager_->node_at(arc_.index()).var();
-    bddvar top_lev = manager_->lev_of_var(top);
-    bddvar v_lev = manager_->lev_of_var(v);
-
-    // SAPPOROBDD convention: larger level = closer to root
-    // If top's level < v's level, v should have appeared earlier but didn't
-    // So v is not in this subtree, meaning all sets here don't contain v
-    if (top_lev < v_lev) {
-        return *this;
+// Single-set ZDD {vars} used as the variable-set operand of zdd_cofactor
+static Arc zdd_var_set(DDManager* mgr, std::vector<bddvar> vars) {
+    for (bddvar v : vars) {
+        if (v == 0 || v > mgr->var_count()) {
+            throw DDArgumentException("Invalid variable number");
+        }
     }
-    if (top == v) {
-        return low();
+    std::sort(vars.begin(), vars.end(), [mgr](bddvar a, bddvar b) {
+        return mgr->lev_of_var(a) < mgr->lev_of_var(b);
+    });
+    vars.erase(std::unique(vars.begin(), vars.end()), vars.end());
+    Arc s = ARC_TERMINAL_1;
+    for (bddvar v : vars) {
+        s = mgr->get_or_create_node_zdd(v, ARC_TERMINAL_0, s, true);
     }
+    return s;
+}
 
-    const DDNode& node = manager_->node_at(arc_.index());
-    ZDD lo(manager_, node.arc0());
-    ZDD hi(manager_, node.arc1());
+static Arc zdd_cofactor(DDManager* mgr, ZDDCofactor kind, Arc f, bddvar v) {
+    return zdd_cofactor(mgr, kind, f, zdd_var_set(mgr, std::vector<bddvar>(1, v)));
+}
 
-    ZDD lo_offset = lo.offset(v);
-    ZDD hi_offset = hi.offset(v);
+// Family operations
+ZDD ZDD::onset(bddvar v) const {
+    if (!manager_ || arc_.is_constant()) {
+        return ZDD::empty(*manager_);
+    }
+    return ZDD(manager_, zdd_cofactor(manager_, ZDDCofactor::ONSET, arc_, v));
+}
 
-    Arc result = manager_->get_or_create_node_zdd(top, lo_offset.arc_, hi_offset.arc_, true);
-    return ZDD(manager_, result);
+ZDD ZDD::offset(bddvar v) const {
+    if (!manager_ || arc_.is_constant()) {
+        return *this;
+    }
+    return ZDD(manager_, zdd_cofactor(manager_, ZDDCofactor::OFFSET, arc_, v));
 }
 
 ZDD ZDD::onset0(bddvar v) const {
@@ -133,84 +257,25 @@ ZDD ZDD::change(bddvar v) const {
         // For base (terminal 1), toggle v means add v
         return ZDD::singleton(*manager_, v);
     }
-
-    bddvar top = manager_->node_at(arc_.index()).var();
-    bddvar top_lev = manager_->lev_of_var(top);
-    bddvar v_lev = manager_->lev_of_var(v);
-    const DDNode& node = manager_->node_at(arc_.index());
-
-    // SAPPOROBDD convention: larger level = closer to root
-    // If v has larger level than top, v should be the new root
-    // Since v was skipped, all sets don't contain v; toggling adds v to all sets
-    if (top_lev < v_lev) {
-        Arc result = manager_->get_or_create_node_zdd(v, ARC_TERMINAL_0, arc_, true);
-        return ZDD(manager_, result);
-    }
-
-    if (top == v) {
-        // Swap low and high
-        Arc result = manager_->get_or_create_node_zdd(v, node.arc1(), node.arc0(), true);
-        return ZDD(manager_, result);
-    }
-
-    // Recursive
-    ZDD lo(manager_, node.arc0());
-    ZDD hi(manager_, node.arc1());
-
-    ZDD lo_change = lo.change(v);
-    ZDD hi_change = hi.change(v);
-
-    Arc result = manager_->get_or_create_node_zdd(top, lo_change.arc_, hi_change.arc_, true);
-    return ZDD(manager_, result);
+    return ZDD(manager_, zdd_cofactor(manager_, ZDDCofactor::CHANGE, arc_, v));
 }
 
-// Internal union function
-static Arc zdd_union(DDManager* mgr, Arc f, Arc g) {
-    // Terminal cases
-    if (f == ARC_TERMINAL_0) return g;
-    if (g == ARC_TERMINAL_0) return f;
-    if (f == g) return f;
-
-    // Order for cache
-    if (f.data > g.data) std::swap(f, g);
-
-    // Check cache
-    Arc result;
-    if (mgr->cache_lookup(CacheOp::UNION, f, g, result)) {
-        return result;
-    }
-
-    bddvar f_var = f.is_constant() ? 0 : mgr->node_at(f.index()).var();
-    bddvar g_var = g.is_constant() ? 0 : mgr->node_at(g.index()).var();
-    // Use level comparison to find top variable
-    bddvar top_var = mgr->var_of_top_lev(f_var, g_var);
-
-    Arc f0, f1, g0, g1;
-
-    if (f.is_constant() || mgr->var_is_below(f_var, top_var)) {
-        f0 = f;
-        f1 = ARC_TERMINAL_0;
-    } else {
-        const DDNode& node = mgr->node_at(f.index());
-        f0 = node.arc0();
-        f1 = node.arc1();
-    }
-
-    if (g.is_constant() || mgr->var_is_below(g_var, top_var)) {
-        g0 = g;
-        g1 = ARC_TERMINAL_0;
-    } else {
-        const DDNode& node = mgr->node_at(g.index());
-        g0 = node.arc0();
-        g1 = node.arc1();
-    }
+ZDD ZDD::onset(const std::vector<bddvar>& vars) const {
+    if (!manager_) return ZDD();
+    Arc s = zdd_var_set(manager_, vars);
+    return ZDD(manager_, zdd_cofactor(manager_, ZDDCofactor::ONSET, arc_, s));
+}
 
-    Arc r0 = zdd_union(mgr, f0, g0);
-    Arc r1 = zdd_union(mgr, f1, g1);
+ZDD ZDD::offset(const std::vector<bddvar>& vars) const {
+    if (!manager_) return ZDD();
+    Arc s = zdd_var_set(manager_, vars);
+    return ZDD(manager_, zdd_cofactor(manager_, ZDDCofactor::OFFSET, arc_, s));
+}
 
-    result = mgr->get_or_create_node_zdd(top_var, r0, r1, true);
-    mgr->cache_insert(CacheOp::UNION, f, g, result);
-    return result;
+ZDD ZDD::change(const std::vector<bddvar>& vars) const {
+    if (!manager_) return ZDD();
+    Arc s = zdd_var_set(manager_, vars);
+    return ZDD(manager_, zdd_cofactor(manager_, ZDDCofactor::CHANGE, arc_, s));
 }
 
 // Helper: check if ZDD contains the empty set by following 0-branches
@@ -222,104 +287,451 @@ static Arc zdd_contains_empty_set(DDManager* mgr, Arc f) {
     return f;  // ARC_TERMINAL_1 if {} ∈ F, ARC_TERMINAL_0 otherwise
 }
 
-// Internal intersection function
+// Binary set family kernels (union, intersect, diff, join, quotient) share
+// one explicit-stack driver keyed by their CacheOp. Each frame holds up to
+// four pending subproblems; a subproblem that is terminal or cached is
+// resolved before a frame is pushed for it.
+
+// How a frame combines the results of its subproblems
+enum class ZDDCombine : std::uint8_t {
+    NODE,       // node(var, res[0], res[1])
+    PASS,       // res[0]
+    NODE_HI,    // node(var, res[0], hi)
+    JOIN,       // node(var, res[0], res[1] + res[2] + res[3])
+    QUOTIENT    // res[0], then res[0] & (f.offset(var) / g.offset(var))
+};
+
+struct ZDDFrame {
+    Arc f, g;
+    Arc sf[4], sg[4];
+    Arc res[4];
+    Arc hi;
+    bddvar var;
+    ZDDCombine combine;
+    std::uint8_t nsub;
+    std::uint8_t next;
+    std::uint8_t phase;
+};
+
+static Arc zdd_binary(DDManager* mgr, CacheOp op, Arc f, Arc g);
+static Arc zdd_union3(DDManager* mgr, Arc a, Arc b, Arc c);
+
+static Arc zdd_union(DDManager* mgr, Arc f, Arc g) {
+    return zdd_binary(mgr, CacheOp::UNION, f, g);
+}
+
 static Arc zdd_intersect(DDManager* mgr, Arc f, Arc g) {
-    if (f == ARC_TERMINAL_0) return ARC_TERMINAL_0;
-    if (g == ARC_TERMINAL_0) return ARC_TERMINAL_0;
-    if (f == g) return f;
+    return zdd_binary(mgr, CacheOp::INTERSECT, f, g);
+}
 
-    // Handle terminal 1 (base set {{}})
-    // {{}} ∩ G = {{}} if {} ∈ G, else empty
-    if (f == ARC_TERMINAL_1) return zdd_contains_empty_set(mgr, g);
-    if (g == ARC_TERMINAL_1) return zdd_contains_empty_set(mgr, f);
+static Arc zdd_diff(DDManager* mgr, Arc f, Arc g) {
+    return zdd_binary(mgr, CacheOp::DIFF, f, g);
+}
 
-    if (f.data > g.data) std::swap(f, g);
+// Join (cross product)
+static Arc zdd_join(DDManager* mgr, Arc f, Arc g) {
+    return zdd_binary(mgr, CacheOp::PRODUCT, f, g);
+}
 
-    Arc result;
-    if (mgr->cache_lookup(CacheOp::INTERSECT, f, g, result)) {
-        return result;
+// Quotient (division)
+// Algorithm based on SAPPOROBDD++: F / G = {S | S ∪ T ∈ F for all T ∈ G}
+static Arc zdd_quotient(DDManager* mgr, Arc f, Arc g) {
+    return zdd_binary(mgr, CacheOp::QUOTIENT, f, g);
+}
+
+// Terminal and cached cases (returns true if result is determined).
+// Normalizes the operand order of commutative operations in place.
+static bool zdd_binary_shortcut(DDManager* mgr, CacheOp op, Arc& f, Arc& g, Arc& result) {
+    switch (op) {
+    case CacheOp::UNION:
+        if (f == ARC_TERMINAL_0) { result = g; return true; }
+        if (g == ARC_TERMINAL_0) { result = f; return true; }
+        if (f == g) { result = f; return true; }
+        // Order for cache
+        if (f.data > g.data) std::swap(f, g);
+        break;
+    case CacheOp::INTERSECT:
+        if (f == ARC_TERMINAL_0 || g == ARC_TERMINAL_0) { result = ARC_TERMINAL_0; return true; }
+        if (f == g) { result = f; return true; }
+        // {{}} ∩ G = {{}} if {} ∈ G, else empty
+        if (f == ARC_TERMINAL_1) { result = zdd_contains_empty_set(mgr, g); return true; }
+        if (g == ARC_TERMINAL_1) { result = zdd_contains_empty_set(mgr, f); return true; }
+        if (f.data > g.data) std::swap(f, g);
+        break;
+    case CacheOp::DIFF:
+        if (f == ARC_TERMINAL_0) { result = ARC_TERMINAL_0; return true; }
+        if (g == ARC_TERMINAL_0) { result = f; return true; }
+        if (f == g) { result = ARC_TERMINAL_0; return true; }
+        break;
+    case CacheOp::PRODUCT:
+        if (f == ARC_TERMINAL_0 || g == ARC_TERMINAL_0) { result = ARC_TERMINAL_0; return true; }
+        if (f == ARC_TERMINAL_1) { result = g; return true; }
+        if (g == ARC_TERMINAL_1) { result = f; return true; }
+        break;
+    case CacheOp::QUOTIENT:
+        // g = 0 (empty family) is error
+        if (g == ARC_TERMINAL_0) {
+            throw DDArgumentException("Division by empty set");
+        }
+        if (f == ARC_TERMINAL_0) { result = ARC_TERMINAL_0; return true; }
+        // g = 1 (base, {{}}) => f / {{}} = f
+        if (g == ARC_TERMINAL_1) { result = f; return true; }
+        // f == g => f / f = {{}}
+        if (f == g) { result = ARC_TERMINAL_1; return true; }
+        break;
+    default:
+        break;
+    }
+
+    SBDD2_PROFILE_CALL(mgr, op);
+    if (mgr->cache_lookup(op, f, g, result)) {
+        SBDD2_PROFILE_HIT(mgr, op);
+        return true;
+    }
+
+    if (op == CacheOp::QUOTIENT) {
+        // {{}} / G = 0 when G contains any non-empty set.
+        // SAPPOROBDD convention: larger level = closer to root.
+        // If f's level is smaller than g's top level, f has no set
+        // containing g's top variable.
+        if (f == ARC_TERMINAL_1 ||
+            mgr->lev_of_var(mgr->node_at(f.index()).var()) <
+            mgr->lev_of_var(mgr->node_at(g.index()).var())) {
+            result = ARC_TERMINAL_0;
+            mgr->cache_insert(op, f, g, result);
+            return true;
+        }
     }
+    return false;
+}
 
-    bddvar f_var = mgr->node_at(f.index()).var();
-    bddvar g_var = mgr->node_at(g.index()).var();
-    bddvar f_lev = mgr->lev_of_var(f_var);
-    bddvar g_lev = mgr->lev_of_var(g_var);
+// Set up the frame for a non-terminal, uncached subproblem
+static void zdd_binary_expand(DDManager* mgr, CacheOp op, Arc f, Arc g, ZDDFrame& frame) {
+    frame.f = f;
+    frame.g = g;
+    frame.next = 0;
+    frame.phase = 0;
 
-    if (f_lev > g_lev) {
-        // f has higher level (closer to root), g doesn't have it
-        const DDNode& node = mgr->node_at(f.index());
-        result = zdd_intersect(mgr, node.arc0(), g);
-    } else if (f_lev < g_lev) {
-        // g has higher level (closer to root), f doesn't have it
-        const DDNode& node = mgr->node_at(g.index());
-        result = zdd_intersect(mgr, f, node.arc0());
-    } else {
+    bddvar f_var = f.is_constant() ? 0 : mgr->node_at(f.index()).var();
+    bddvar g_var = g.is_constant() ? 0 : mgr->node_at(g.index()).var();
+
+    switch (op) {
+    case CacheOp::UNION:
+    case CacheOp::PRODUCT: {
+        // Use level comparison to find top variable
+        bddvar top_var = mgr->var_of_top_lev(f_var, g_var);
+        Arc f0, f1, g0, g1;
+        if (f.is_constant() || f_var != top_var) {
+            f0 = f;
+            f1 = ARC_TERMINAL_0;
+        } else {
+            const DDNode& node = mgr->node_at(f.index());
+            f0 = node.arc0();
+            f1 = node.arc1();
+        }
+        if (g.is_constant() || g_var != top_var) {
+            g0 = g;
+            g1 = ARC_TERMINAL_0;
+        } else {
+            const DDNode& node = mgr->node_at(g.index());
+            g0 = node.arc0();
+            g1 = node.arc1();
+        }
+        frame.var = top_var;
+        if (op == CacheOp::UNION) {
+            frame.combine = ZDDCombine::NODE;
+            frame.nsub = 2;
+            frame.sf[0] = f0; frame.sg[0] = g0;
+            frame.sf[1] = f1; frame.sg[1] = g1;
+        } else {
+            // (f0 + v*f1) * (g0 + v*g1) = f0*g0 + v*(f0*g1 + f1*g0 + f1*g1)
+            frame.combine = ZDDCombine::JOIN;
+            frame.nsub = 4;
+            frame.sf[0] = f0; frame.sg[0] = g0;
+            frame.sf[1] = f0; frame.sg[1] = g1;
+            frame.sf[2] = f1; frame.sg[2] = g0;
+            frame.sf[3] = f1; frame.sg[3] = g1;
+        }
+        break;
+    }
+    case CacheOp::INTERSECT: {
+        // Both operands are non-terminal here
+        bddvar f_lev = mgr->lev_of_var(f_var);
+        bddvar g_lev = mgr->lev_of_var(g_var);
         const DDNode& f_node = mgr->node_at(f.index());
         const DDNode& g_node = mgr->node_at(g.index());
-
-        Arc r0 = zdd_intersect(mgr, f_node.arc0(), g_node.arc0());
-        Arc r1 = zdd_intersect(mgr, f_node.arc1(), g_node.arc1());
-
-        result = mgr->get_or_create_node_zdd(f_var, r0, r1, true);
+        frame.var = f_var;
+        if (f_lev > g_lev) {
+            // f has higher level (closer to root), g doesn't have it
+            frame.combine = ZDDCombine::PASS;
+            frame.nsub = 1;
+            frame.sf[0] = f_node.arc0(); frame.sg[0] = g;
+        } else if (f_lev < g_lev) {
+            // g has higher level (closer to root), f doesn't have it
+            frame.combine = ZDDCombine::PASS;
+            frame.nsub = 1;
+            frame.sf[0] = f; frame.sg[0] = g_node.arc0();
+        } else {
+            frame.combine = ZDDCombine::NODE;
+            frame.nsub = 2;
+            frame.sf[0] = f_node.arc0(); frame.sg[0] = g_node.arc0();
+            frame.sf[1] = f_node.arc1(); frame.sg[1] = g_node.arc1();
+        }
+        break;
+    }
+    case CacheOp::DIFF: {
+        // f is terminal 1 (base) or non-terminal; g is terminal 1 or non-terminal
+        bddvar f_lev = f.is_constant() ? BDDVAR_MAX : mgr->lev_of_var(f_var);
+        bddvar g_lev = g.is_constant() ? BDDVAR_MAX : mgr->lev_of_var(g_var);
+        frame.var = f_var;
+        frame.nsub = 1;
+        if (f.is_constant() || (!g.is_constant() && f_lev < g_lev)) {
+            // g has higher level (closer to root)
+            frame.combine = ZDDCombine::PASS;
+            frame.sf[0] = f; frame.sg[0] = mgr->node_at(g.index()).arc0();
+        } else if (g.is_constant() || f_lev > g_lev) {
+            // f has higher level (closer to root)
+            const DDNode& f_node = mgr->node_at(f.index());
+            frame.combine = ZDDCombine::NODE_HI;
+            frame.hi = f_node.arc1();
+            frame.sf[0] = f_node.arc0(); frame.sg[0] = g;
+        } else {
+            const DDNode& f_node = mgr->node_at(f.index());
+            const DDNode& g_node = mgr->node_at(g.index());
+            frame.combine = ZDDCombine::NODE;
+            frame.nsub = 2;
+            frame.sf[0] = f_node.arc0(); frame.sg[0] = g_node.arc0();
+            frame.sf[1] = f_node.arc1(); frame.sg[1] = g_node.arc1();
+        }
+        break;
+    }
+    case CacheOp::QUOTIENT:
+        // q = f.onset(g_var) / g.onset(g_var)
+        // onset: sets containing g_var, with g_var REMOVED
+        // (SAPPOROBDD++ OnSet0 returns hi-branch directly, which removes the variable)
+        frame.var = g_var;
+        frame.combine = ZDDCombine::QUOTIENT;
+        frame.nsub = 1;
+        frame.sf[0] = zdd_cofactor(mgr, ZDDCofactor::ONSET, f, g_var);
+        frame.sg[0] = zdd_cofactor(mgr, ZDDCofactor::ONSET, g, g_var);
+        break;
+    default:
+        break;
+    }
+}
+
+// Combine subproblem results. Returns false if the frame queued another
+// phase of subproblems instead of producing its result.
+static bool zdd_binary_finish(DDManager* mgr, CacheOp op, ZDDFrame& frame, Arc& result) {
+    switch (frame.combine) {
+    case ZDDCombine::NODE:
+        result = mgr->get_or_create_node_zdd(frame.var, frame.res[0], frame.res[1], true);
+        break;
+    case ZDDCombine::PASS:
+        result = frame.res[0];
+        break;
+    case ZDDCombine::NODE_HI:
+        result = mgr->get_or_create_node_zdd(frame.var, frame.res[0], frame.hi, true);
+        break;
+    case ZDDCombine::JOIN: {
+        Arc r1 = zdd_union3(mgr, frame.res[1], frame.res[2], frame.res[3]);
+        result = mgr->get_or_create_node_zdd(frame.var, frame.res[0], r1, true);
+        break;
+    }
+    case ZDDCombine::QUOTIENT:
+        if (frame.phase == 0) {
+            result = frame.res[0];
+            if (result != ARC_TERMINAL_0) {
+                // g.offset(g_var): sets in g NOT containing g_var
+                Arc g_offset = zdd_cofactor(mgr, ZDDCofactor::OFFSET, frame.g, frame.var);
+                if (g_offset != ARC_TERMINAL_0) {
+                    frame.hi = result;
+                    frame.sf[0] = zdd_cofactor(mgr, ZDDCofactor::OFFSET, frame.f, frame.var);
+                    frame.sg[0] = g_offset;
+                    frame.nsub = 1;
+                    frame.next = 0;
+                    frame.phase = 1;
+                    return false;
+                }
+            }
+        } else {
+            result = zdd_intersect(mgr, frame.hi, frame.res[0]);
+        }
+        break;
     }
-
-    mgr->cache_insert(CacheOp::INTERSECT, f, g, result);
-    return result;
+    mgr->cache_insert(op, frame.f, frame.g, result);
+    return true;
 }
 
-// Internal difference function
-static Arc zdd_diff(DDManager* mgr, Arc f, Arc g) {
-    if (f == ARC_TERMINAL_0) return ARC_TERMINAL_0;
-    if (g == ARC_TERMINAL_0) return f;
-    if (f == g) return ARC_TERMINAL_0;
-
+// Explicit-stack driver (safe at any depth)
+static Arc zdd_binary(DDManager* mgr, CacheOp op, Arc f, Arc g) {
+    SBDD2_PROFILE_SCOPE(mgr, op);
     Arc result;
-    if (mgr->cache_lookup(CacheOp::DIFF, f, g, result)) {
-        return result;
+    if (zdd_binary_shortcut(mgr, op, f, g, result)) return result;
+
+    std::vector<ZDDFrame> stack;
+    stack.emplace_back();
+    zdd_binary_expand(mgr, op, f, g, stack.back());
+
+    for (;;) {
+        ZDDFrame& frame = stack.back();
+        if (frame.next < frame.nsub) {
+            int i = frame.next++;
+            Arc sf = frame.sf[i];
+            Arc sg = frame.sg[i];
+            if (zdd_binary_shortcut(mgr, op, sf, sg, result)) {
+                frame.res[i] = result;
+            } else {
+                ZDDFrame child;
+                zdd_binary_expand(mgr, op, sf, sg, child);
+                stack.push_back(child);
+            }
+            continue;
+        }
+
+        if (!zdd_binary_finish(mgr, op, frame, result)) continue;
+        stack.pop_back();
+        if (stack.empty()) return result;
+        ZDDFrame& parent = stack.back();
+        parent.res[parent.next - 1] = result;
+    }
+}
+
+// Three-way union a + b + c in one pass, so the join does not build the
+// intermediate family of a two-step union. Memoized under UNION3 with the
+// operands sorted.
+struct ZDDUnion3Frame {
+    Arc op[3];
+    Arc sub[2][3];
+    Arc res[2];
+    bddvar var;
+    int stage;
+};
+
+// Terminal and cached cases (returns true if result is determined).
+// Drops empty and duplicate operands and sorts the rest in place.
+static bool zdd_union3_shortcut(DDManager* mgr, Arc (&op)[3], Arc& result) {
+    int n = 0;
+    for (int i = 0; i < 3; ++i) {
+        if (op[i] == ARC_TERMINAL_0) continue;
+        bool dup = false;
+        for (int j = 0; j < n; ++j) {
+            if (op[j] == op[i]) dup = true;
+        }
+        if (!dup) op[n++] = op[i];
     }
+    if (n == 0) { result = ARC_TERMINAL_0; return true; }
+    if (n == 1) { result = op[0]; return true; }
+    if (n == 2) { result = zdd_union(mgr, op[0], op[1]); return true; }
 
-    bddvar f_var = f.is_constant() ? 0 : mgr->node_at(f.index()).var();
-    bddvar g_var = g.is_constant() ? 0 : mgr->node_at(g.index()).var();
-    bddvar f_lev = f.is_constant() ? BDDVAR_MAX : mgr->lev_of_var(f_var);
-    bddvar g_lev = g.is_constant() ? BDDVAR_MAX : mgr->lev_of_var(g_var);
+    if (op[0].data > op[1].data) std::swap(op[0], op[1]);
+    if (op[1].data > op[2].data) std::swap(op[1], op[2]);
+    if (op[0].data > op[1].data) std::swap(op[0], op[1]);
+    return mgr->cache_lookup3(CacheOp::UNION3, op[0], op[1], op[2], result);
+}
 
-    if (f.is_constant()) {
-        // f is terminal 1 (base)
-        if (g.is_constant()) {
-            result = ARC_TERMINAL_0;  // base - base = empty
-        } else {
-            const DDNode& g_node = mgr->node_at(g.index());
-            result = zdd_diff(mgr, f, g_node.arc0());
+static void zdd_union3_expand(DDManager* mgr, const Arc (&op)[3], ZDDUnion3Frame& frame) {
+    bddvar top_var = 0;
+    for (int i = 0; i < 3; ++i) {
+        frame.op[i] = op[i];
+        if (!op[i].is_constant()) {
+            top_var = mgr->var_of_top_lev(top_var, mgr->node_at(op[i].index()).var());
         }
-    } else if (g.is_constant()) {
-        // g is terminal, f is not
-        if (g == ARC_TERMINAL_1) {
-            const DDNode& f_node = mgr->node_at(f.index());
-            Arc r0 = zdd_diff(mgr, f_node.arc0(), g);
-            result = mgr->get_or_create_node_zdd(f_var, r0, f_node.arc1(), true);
+    }
+    for (int i = 0; i < 3; ++i) {
+        if (op[i].is_constant() || mgr->node_at(op[i].index()).var() != top_var) {
+            frame.sub[0][i] = op[i];
+            frame.sub[1][i] = ARC_TERMINAL_0;
         } else {
-            result = f;  // f - empty = f
+            const DDNode& node = mgr->node_at(op[i].index());
+            frame.sub[0][i] = node.arc0();
+            frame.sub[1][i] = node.arc1();
         }
-    } else if (f_lev > g_lev) {
-        // f has higher level (closer to root)
-        const DDNode& f_node = mgr->node_at(f.index());
-        Arc r0 = zdd_diff(mgr, f_node.arc0(), g);
-        result = mgr->get_or_create_node_zdd(f_var, r0, f_node.arc1(), true);
-    } else if (f_lev < g_lev) {
-        // g has higher level (closer to root)
-        const DDNode& g_node = mgr->node_at(g.index());
-        result = zdd_diff(mgr, f, g_node.arc0());
-    } else {
-        const DDNode& f_node = mgr->node_at(f.index());
-        const DDNode& g_node = mgr->node_at(g.index());
+    }
+    frame.var = top_var;
+    frame.stage = 0;
+}
 
-        Arc r0 = zdd_diff(mgr, f_node.arc0(), g_node.arc0());
-        Arc r1 = zdd_diff(mgr, f_node.arc1(), g_node.arc1());
+static Arc zdd_union3(DDManager* mgr, Arc a, Arc b, Arc c) {
+    Arc op[3] = {a, b, c};
+    Arc result;
+    if (zdd_union3_shortcut(mgr, op, result)) return result;
+
+    std::vector<ZDDUnion3Frame> stack;
+    stack.emplace_back();
+    zdd_union3_expand(mgr, op, stack.back());
+
+    for (;;) {
+        ZDDUnion3Frame& frame = stack.back();
+        if (frame.stage < 2) {
+            int i = frame.stage++;
+            Arc sub[3] = {frame.sub[i][0], frame.sub[i][1], frame.sub[i][2]};
+            if (zdd_union3_shortcut(mgr, sub, result)) {
+                frame.res[i] = result;
+            } else {
+                ZDDUnion3Frame child;
+                zdd_union3_expand(mgr, sub, child);
+                stack.push_back(child);
+            }
+            continue;
+        }
 
-        result = mgr->get_or_create_node_zdd(f_var, r0, r1, true);
+        result = mgr->get_or_create_node_zdd(frame.var, frame.res[0], frame.res[1], true);
+        mgr->cache_insert3(CacheOp::UNION3, frame.op[0], frame.op[1], frame.op[2], result);
+        stack.pop_back();
+        if (stack.empty()) return result;
+        ZDDUnion3Frame& parent = stack.back();
+        parent.res[parent.stage - 1] = result;
+    }
+}
+
+// True if the DAGs rooted at f and g have at least limit nodes together
+// (stops counting at limit, so the check is O(limit))
+static bool zdd_size_at_least(DDManager* mgr, Arc f, Arc g, std::size_t limit) {
+    std::unordered_set<bddindex> visited;
+    std::vector<Arc> stack;
+    stack.push_back(f);
+    stack.push_back(g);
+    while (!stack.empty()) {
+        Arc a = stack.back();
+        stack.pop_back();
+        if (a.is_constant() || !visited.insert(a.index()).second) continue;
+        if (visited.size() >= limit) return true;
+        const DDNode& node = mgr->node_at(a.index());
+        stack.push_back(node.arc0());
+        stack.push_back(node.arc1());
     }
+    return false;
+}
+
+// Marks the manager's table as shared by tasks while in scope
+struct ZDDParallelSection {
+    explicit ZDDParallelSection(DDManager* mgr) : mgr(mgr) { mgr->begin_parallel(); }
+    ~ZDDParallelSection() { mgr->end_parallel(); }
+    DDManager* mgr;
+};
 
-    mgr->cache_insert(CacheOp::DIFF, f, g, result);
+// Join with the four sub-joins of the top `depth` levels run as tasks.
+// Below that, and for subproblems that are terminal or cached, the
+// sequential driver is used; all tasks share the manager's tables.
+static Arc zdd_join_parallel(DDManager* mgr, Arc f, Arc g, int depth) {
+    Arc result;
+    if (zdd_binary_shortcut(mgr, CacheOp::PRODUCT, f, g, result)) return result;
+    if (depth <= 0) return zdd_join(mgr, f, g);
+
+    ZDDFrame frame;
+    zdd_binary_expand(mgr, CacheOp::PRODUCT, f, g, frame);
+
+    std::future<Arc> tasks[3];
+    for (int i = 1; i < 4; ++i) {
+        tasks[i - 1] = std::async(std::launch::async, zdd_join_parallel,
+                                  mgr, frame.sf[i], frame.sg[i], depth - 1);
+    }
+    frame.res[0] = zdd_join_parallel(mgr, frame.sf[0], frame.sg[0], depth - 1);
+    for (int i = 1; i < 4; ++i) {
+        frame.res[i] = tasks[i - 1].get();
+    }
+    zdd_binary_finish(mgr, CacheOp::PRODUCT, frame, result);
     return result;
 }
 
@@ -328,6 +740,7 @@ ZDD ZDD::operator+(const ZDD& other) const {
     if (!manager_ || !other.manager_ || manager_ != other.manager_) {
         throw DDIncompatibleException("ZDD managers do not match");
     }
+    TraceScope trace(manager_, "ZDD::union", "zdd");
     Arc result = zdd_union(manager_, arc_, other.arc_);
     return ZDD(manager_, result);
 }
@@ -336,6 +749,7 @@ ZDD ZDD::operator-(const ZDD& other) const {
     if (!manager_ || !other.manager_ || manager_ != other.manager_) {
         throw DDIncompatibleException("ZDD managers do not match");
     }
+    TraceScope trace(manager_, "ZDD::diff", "zdd");
     Arc result = zdd_diff(manager_, arc_, other.arc_);
     return ZDD(manager_, result);
 }
@@ -344,84 +758,16 @@ ZDD ZDD::operator&(const ZDD& other) const {
     if (!manager_ || !other.manager_ || manager_ != other.manager_) {
         throw DDIncompatibleException("ZDD managers do not match");
     }
+    TraceScope trace(manager_, "ZDD::intersect", "zdd");
     Arc result = zdd_intersect(manager_, arc_, other.arc_);
     return ZDD(manager_, result);
 }
 
-// Quotient (division)
-// Algorithm based on SAPPOROBDD++: F / G = {S | S ∪ T ∈ F for all T ∈ G}
-static Arc zdd_quotient(DDManager* mgr, Arc f, Arc g) {
-    // g = 0 (empty family) is error
-    if (g == ARC_TERMINAL_0) {
-        throw DDArgumentException("Division by empty set");
-    }
-    // f = 0 => 0 / g = 0
-    if (f == ARC_TERMINAL_0) return ARC_TERMINAL_0;
-    // g = 1 (base, {{}}) => f / {{}} = f
-    if (g == ARC_TERMINAL_1) return f;
-    // f == g => f / f = {{}}
-    if (f == g) return ARC_TERMINAL_1;
-
-    Arc result;
-    if (mgr->cache_lookup(CacheOp::QUOTIENT, f, g, result)) {
-        return result;
-    }
-
-    // Get g's top variable (divisor's top)
-    bddvar g_var = mgr->node_at(g.index()).var();
-    bddvar g_lev = mgr->lev_of_var(g_var);
-
-    // Check f's level
-    if (f == ARC_TERMINAL_1) {
-        // f = {{}} (base), g has non-empty sets
-        // {{}} / G = 0 when G contains any non-empty set
-        result = ARC_TERMINAL_0;
-        mgr->cache_insert(CacheOp::QUOTIENT, f, g, result);
-        return result;
-    }
-
-    bddvar f_var = mgr->node_at(f.index()).var();
-    bddvar f_lev = mgr->lev_of_var(f_var);
-
-    // SAPPOROBDD convention: larger level = closer to root
-    // If f's level is smaller (farther from root) than g's level,
-    // f doesn't contain sets with g's top variable at the right position
-    if (f_lev < g_lev) {
-        result = ARC_TERMINAL_0;
-        mgr->cache_insert(CacheOp::QUOTIENT, f, g, result);
-        return result;
-    }
-
-    // Use ZDD wrapper for onset/offset operations
-    ZDD f_zdd(mgr, f);
-    ZDD g_zdd(mgr, g);
-
-    // q = f.onset(g_var) / g.onset(g_var)
-    // onset: sets containing g_var, with g_var REMOVED
-    // (SAPPOROBDD++ OnSet0 returns hi-branch directly, which removes the variable)
-    ZDD f_onset = f_zdd.onset(g_var);
-    ZDD g_onset = g_zdd.onset(g_var);
-
-    result = zdd_quotient(mgr, f_onset.arc(), g_onset.arc());
-
-    if (result != ARC_TERMINAL_0) {
-        // g.offset(g_var): sets in g NOT containing g_var
-        ZDD g_offset = g_zdd.offset(g_var);
-        if (g_offset.arc() != ARC_TERMINAL_0) {
-            ZDD f_offset = f_zdd.offset(g_var);
-            Arc q2 = zdd_quotient(mgr, f_offset.arc(), g_offset.arc());
-            result = zdd_intersect(mgr, result, q2);
-        }
-    }
-
-    mgr->cache_insert(CacheOp::QUOTIENT, f, g, result);
-    return result;
-}
-
 ZDD ZDD::operator/(const ZDD& other) const {
     if (!manager_ || !other.manager_ || manager_ != other.manager_) {
         throw DDIncompatibleException("ZDD managers do not match");
     }
+    TraceScope trace(manager_, "ZDD::quotient", "zdd");
     Arc result = zdd_quotient(manager_, arc_, other.arc_);
     return ZDD(manager_, result);
 }
@@ -431,6 +777,7 @@ ZDD ZDD::operator%(const ZDD& other) const {
     if (!manager_ || !other.manager_ || manager_ != other.manager_) {
         throw DDIncompatibleException("ZDD managers do not match");
     }
+    TraceScope trace(manager_, "ZDD::remainder", "zdd");
     ZDD q = *this / other;
     ZDD qg = q.join(other);
     return *this - qg;
@@ -462,62 +809,23 @@ ZDD& ZDD::operator%=(const ZDD& other) {
     return *this;
 }
 
-// Join (cross product)
-static Arc zdd_join(DDManager* mgr, Arc f, Arc g) {
-    if (f == ARC_TERMINAL_0 || g == ARC_TERMINAL_0) return ARC_TERMINAL_0;
-    if (f == ARC_TERMINAL_1) return g;
-    if (g == ARC_TERMINAL_1) return f;
-
-    Arc result;
-    if (mgr->cache_lookup(CacheOp::PRODUCT, f, g, result)) {
-        return result;
-    }
-
-    bddvar f_var = mgr->node_at(f.index()).var();
-    bddvar g_var = mgr->node_at(g.index()).var();
-    bddvar f_lev = mgr->lev_of_var(f_var);
-    bddvar g_lev = mgr->lev_of_var(g_var);
-    // Larger level = closer to root (SAPPOROBDD convention)
-    bddvar top_var = (f_lev >= g_lev) ? f_var : g_var;
-
-    Arc f0, f1, g0, g1;
-
-    if (f_var == top_var) {
-        const DDNode& node = mgr->node_at(f.index());
-        f0 = node.arc0();
-        f1 = node.arc1();
-    } else {
-        f0 = f;
-        f1 = ARC_TERMINAL_0;
-    }
-
-    if (g_var == top_var) {
-        const DDNode& node = mgr->node_at(g.index());
-        g0 = node.arc0();
-        g1 = node.arc1();
-    } else {
-        g0 = g;
-        g1 = ARC_TERMINAL_0;
-    }
-
-    // (f0 + v*f1) * (g0 + v*g1) = f0*g0 + v*(f0*g1 + f1*g0 + f1*g1)
-    Arc r00 = zdd_join(mgr, f0, g0);
-    Arc r01 = zdd_join(mgr, f0, g1);
-    Arc r10 = zdd_join(mgr, f1, g0);
-    Arc r11 = zdd_join(mgr, f1, g1);
-
-    Arc r1 = zdd_union(mgr, zdd_union(mgr, r01, r10), r11);
-    result = mgr->get_or_create_node_zdd(top_var, r00, r1, true);
-
-    mgr->cache_insert(CacheOp::PRODUCT, f, g, result);
-    return result;
-}
-
 ZDD ZDD::join(const ZDD& other) const {
     if (!manager_ || !other.manager_ || manager_ != other.manager_) {
         throw DDIncompatibleException("ZDD managers do not match");
     }
-    Arc result = zdd_join(manager_, arc_, other.arc_);
+    TraceScope trace(manager_, "ZDD::join", "zdd");
+    std::size_t cutoff = manager_->parallel_cutoff();
+    Arc result;
+    if (cutoff > 0 && zdd_size_at_least(manager_, arc_, other.arc_, cutoff)) {
+        // Split the top levels until there are at least as many tasks as cores
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        int depth = 1;
+        while ((1u << (2 * depth)) < cores && depth < 3) ++depth;
+        ZDDParallelSection section(manager_);
+        result = zdd_join_parallel(manager_, arc_, other.arc_, depth);
+    } else {
+        result = zdd_join(manager_, arc_, other.arc_);
+    }
     return ZDD(manager_, result);
 }
 
@@ -530,29 +838,50 @@ ZDD& ZDD::operator*=(const ZDD& other) {
     return *this;
 }
 
-// Counting
-double ZDD::card() const {
-    if (!manager_) return 0.0;
-    if (arc_ == ARC_TERMINAL_0) return 0.0;
-    if (arc_ == ARC_TERMINAL_1) return 1.0;
-
-    std::unordered_map<bddindex, double> memo;
+// Bottom-up evaluation helper: folds the DAG rooted at root with
+// combine(value_of_lo, value_of_hi), where terminals map to t0 / t1.
+// Post-order traversal with an explicit stack, memoized per node index.
+template <typename T, typename Combine>
+static T zdd_fold(DDManager* mgr, Arc root, const T& t0, const T& t1, Combine combine) {
+    if (root == ARC_TERMINAL_0) return t0;
+    if (root == ARC_TERMINAL_1) return t1;
 
-    std::function<double(Arc)> count_rec = [&](Arc a) -> double {
-        if (a == ARC_TERMINAL_0) return 0.0;
-        if (a == ARC_TERMINAL_1) return 1.0;
+    std::unordered_map<bddindex, T> memo;
+    auto value = [&](Arc a) -> const T& {
+        if (a == ARC_TERMINAL_0) return t0;
+        if (a == ARC_TERMINAL_1) return t1;
+        return memo.find(a.index())->second;
+    };
 
+    std::vector<std::pair<Arc, bool>> stack;
+    stack.emplace_back(root, false);
+    while (!stack.empty()) {
+        Arc a = stack.back().first;
+        bool expanded = stack.back().second;
+        stack.pop_back();
         bddindex idx = a.index();
-        auto it = memo.find(idx);
-        if (it != memo.end()) return it->second;
-
-        const DDNode& node = manager_->node_at(idx);
-        double result = count_rec(node.arc0()) + count_rec(node.arc1());
-        memo[idx] = result;
-        return result;
-    };
+        if (memo.count(idx)) continue;
+
+        const DDNode& node = mgr->node_at(idx);
+        Arc a0 = node.arc0();
+        Arc a1 = node.arc1();
+        if (!expanded) {
+            stack.emplace_back(a, true);
+            if (!a1.is_constant() && !memo.count(a1.index())) stack.emplace_back(a1, false);
+            if (!a0.is_constant() && !memo.count(a0.index())) stack.emplace_back(a0, false);
+            continue;
+        }
+        T result = combine(value(a0), value(a1));
+        memo.emplace(idx, std::move(result));
+    }
+    return memo.find(root.index())->second;
+}
 
-    return count_rec(arc_);
+// Counting
+double ZDD::card() const {
+    if (!manager_) return 0.0;
+    return zdd_fold<double>(manager_, arc_, 0.0, 1.0,
+        [](double c0, double c1) { return c0 + c1; });
 }
 
 double ZDD::count() const {
@@ -562,26 +891,204 @@ double ZDD::count() const {
 #if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
 std::string ZDD::exact_count() const {
     if (!manager_) return "0";
-    if (arc_ == ARC_TERMINAL_0) return "0";
-    if (arc_ == ARC_TERMINAL_1) return "1";
+    exact_int_t result = zdd_fold<exact_int_t>(manager_, arc_, exact_int_t(0), exact_int_t(1),
+        [](const exact_int_t& c0, const exact_int_t& c1) -> exact_int_t { return c0 + c1; });
+    return exact_int_to_str(result);
+}
+#endif
 
-    std::unordered_map<bddindex, exact_int_t> memo;
+// Nodes of a ZDD sorted by level, lowest first, for the per-level passes of
+// size_histogram and element_frequencies. The nodes of one level depend only
+// on lower levels, so a level can be split across threads. The root is the
+// last node.
+static const std::size_t LEVEL_CHILD_0 = static_cast<std::size_t>(-1);
+static const std::size_t LEVEL_CHILD_1 = static_cast<std::size_t>(-2);
+static const std::size_t LEVEL_PARALLEL_MIN = 1024;
+
+struct ZDDLevelNodes {
+    std::vector<bddvar> var;
+    std::vector<std::array<std::size_t, 2> > child;   // position or LEVEL_CHILD_0/1
+    std::vector<std::size_t> level_begin;              // one past the end at the back
+};
+
+static ZDDLevelNodes zdd_level_nodes(DDManager* mgr, Arc root) {
+    std::vector<std::pair<bddvar, bddindex> > keyed;
+    std::unordered_map<bddindex, std::size_t> pos;
+    std::vector<Arc> stack(1, root);
+    while (!stack.empty()) {
+        Arc a = stack.back();
+        stack.pop_back();
+        if (a.is_constant() || pos.count(a.index())) continue;
+        pos.emplace(a.index(), 0);
+        const DDNode& node = mgr->node_at(a.index());
+        keyed.push_back(std::make_pair(mgr->lev_of_var(node.var()), a.index()));
+        stack.push_back(node.arc0());
+        stack.push_back(node.arc1());
+    }
+    std::sort(keyed.begin(), keyed.end());
+    for (std::size_t i = 0; i < keyed.size(); ++i) pos[keyed[i].second] = i;
+
+    ZDDLevelNodes order;
+    order.var.reserve(keyed.size());
+    order.child.reserve(keyed.size());
+    for (std::size_t i = 0; i < keyed.size(); ++i) {
+        if (i == 0 || keyed[i].first != keyed[i - 1].first) order.level_begin.push_back(i);
+        const DDNode& node = mgr->node_at(keyed[i].second);
+        order.var.push_back(node.var());
+        std::array<std::size_t, 2> c;
+        for (int b = 0; b < 2; ++b) {
+            Arc a = b ? node.arc1() : node.arc0();
+            if (a.is_constant()) {
+                c[b] = a.terminal_value() ? LEVEL_CHILD_1 : LEVEL_CHILD_0;
+            } else {
+                c[b] = pos[a.index()];
+            }
+        }
+        order.child.push_back(c);
+    }
+    order.level_begin.push_back(keyed.size());
+    return order;
+}
 
-    std::function<exact_int_t(Arc)> count_rec = [&](Arc a) -> exact_int_t {
-        if (a == ARC_TERMINAL_0) return exact_int_t(0);
-        if (a == ARC_TERMINAL_1) return exact_int_t(1);
+// Calls fn(i) for every node i of the level group g
+template <typename Fn>
+static void zdd_for_level(const ZDDLevelNodes& order, std::size_t g, bool parallel, Fn fn) {
+    std::size_t begin = order.level_begin[g];
+    std::size_t end = order.level_begin[g + 1];
+    auto run = [&fn](std::size_t b, std::size_t e) {
+        for (std::size_t i = b; i < e; ++i) fn(i);
+    };
+    unsigned cores = parallel ? std::max(1u, std::thread::hardware_concurrency()) : 1;
+    if (cores > 1 && end - begin >= LEVEL_PARALLEL_MIN) {
+        std::size_t chunk = (end - begin + cores - 1) / cores;
+        std::vector<std::future<void> > tasks;
+        for (std::size_t b = begin + chunk; b < end; b += chunk) {
+            tasks.push_back(std::async(std::launch::async, run, b, std::min(b + chunk, end)));
+        }
+        run(begin, begin + chunk);
+        for (auto& t : tasks) t.get();
+    } else {
+        run(begin, end);
+    }
+}
 
-        bddindex idx = a.index();
-        auto it = memo.find(idx);
-        if (it != memo.end()) return it->second;
+// hist(node) = hist(lo) + hist(hi) shifted by one. A child's histogram is
+// freed once its last parent has read it.
+template <typename T>
+static std::vector<T> zdd_size_histogram(DDManager* mgr, Arc root, bool parallel) {
+    if (root == ARC_TERMINAL_0) return std::vector<T>();
+    if (root == ARC_TERMINAL_1) return std::vector<T>(1, T(1));
 
-        const DDNode& node = manager_->node_at(idx);
-        exact_int_t result = count_rec(node.arc0()) + count_rec(node.arc1());
-        memo[idx] = result;
-        return result;
+    ZDDLevelNodes order = zdd_level_nodes(mgr, root);
+    std::size_t n = order.var.size();
+    std::unique_ptr<std::atomic<std::size_t>[]> readers(new std::atomic<std::size_t>[n]);
+    for (std::size_t i = 0; i < n; ++i) readers[i].store(0, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (int b = 0; b < 2; ++b) {
+            if (order.child[i][b] < n) readers[order.child[i][b]].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<std::vector<T> > hist(n);
+    const std::vector<T> none;
+    const std::vector<T> unit(1, T(1));
+    auto value = [&](std::size_t c) -> const std::vector<T>& {
+        if (c == LEVEL_CHILD_0) return none;
+        if (c == LEVEL_CHILD_1) return unit;
+        return hist[c];
+    };
+    auto release = [&](std::size_t c) {
+        if (c < n && readers[c].fetch_sub(1) == 1) std::vector<T>().swap(hist[c]);
+    };
+
+    for (std::size_t g = 0; g + 1 < order.level_begin.size(); ++g) {
+        zdd_for_level(order, g, parallel, [&](std::size_t i) {
+            const std::vector<T>& h0 = value(order.child[i][0]);
+            const std::vector<T>& h1 = value(order.child[i][1]);
+            std::vector<T> h(std::max(h0.size(), h1.size() + 1), T(0));
+            for (std::size_t k = 0; k < h0.size(); ++k) h[k] += h0[k];
+            for (std::size_t k = 0; k < h1.size(); ++k) h[k + 1] += h1[k];
+            hist[i] = std::move(h);
+            release(order.child[i][0]);
+            release(order.child[i][1]);
+        });
+    }
+    return std::move(hist[n - 1]);
+}
+
+// freq(v) = sum over nodes u of v of paths(root -> u) * |family below hi(u)|
+template <typename T>
+static std::vector<T> zdd_element_frequencies(DDManager* mgr, Arc root, bool parallel) {
+    std::vector<T> result(mgr->var_count() + 1, T(0));
+    if (root.is_constant()) return result;
+
+    ZDDLevelNodes order = zdd_level_nodes(mgr, root);
+    std::size_t n = order.var.size();
+    std::size_t groups = order.level_begin.size() - 1;
+    std::vector<std::vector<std::size_t> > parents(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (int b = 0; b < 2; ++b) {
+            if (order.child[i][b] < n) parents[order.child[i][b]].push_back(i);
+        }
+    }
+
+    std::vector<T> card(n, T(0));
+    auto value = [&](std::size_t c) -> T {
+        if (c == LEVEL_CHILD_0) return T(0);
+        if (c == LEVEL_CHILD_1) return T(1);
+        return card[c];
     };
+    for (std::size_t g = 0; g < groups; ++g) {
+        zdd_for_level(order, g, parallel, [&](std::size_t i) {
+            card[i] = value(order.child[i][0]) + value(order.child[i][1]);
+        });
+    }
+
+    std::vector<T> paths(n, T(0));
+    std::vector<T> contrib(n, T(0));
+    for (std::size_t g = groups; g-- > 0;) {
+        zdd_for_level(order, g, parallel, [&](std::size_t i) {
+            T p = (i == n - 1) ? T(1) : T(0);
+            for (std::size_t parent : parents[i]) p += paths[parent];
+            contrib[i] = p * value(order.child[i][1]);
+            paths[i] = std::move(p);
+        });
+    }
+    for (std::size_t i = 0; i < n; ++i) result[order.var[i]] += contrib[i];
+    return result;
+}
+
+std::vector<double> ZDD::size_histogram(bool parallel) const {
+    if (!manager_) return std::vector<double>();
+    TraceScope trace(manager_, "ZDD::size_histogram", "zdd");
+    return zdd_size_histogram<double>(manager_, arc_, parallel);
+}
+
+std::vector<double> ZDD::element_frequencies(bool parallel) const {
+    if (!manager_) return std::vector<double>();
+    TraceScope trace(manager_, "ZDD::element_frequencies", "zdd");
+    return zdd_element_frequencies<double>(manager_, arc_, parallel);
+}
 
-    return exact_int_to_str(count_rec(arc_));
+#if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
+std::vector<std::string> ZDD::exact_size_histogram(bool parallel) const {
+    std::vector<std::string> result;
+    if (!manager_) return result;
+    TraceScope trace(manager_, "ZDD::exact_size_histogram", "zdd");
+    for (const exact_int_t& c : zdd_size_histogram<exact_int_t>(manager_, arc_, parallel)) {
+        result.push_back(exact_int_to_str(c));
+    }
+    return result;
+}
+
+std::vector<std::string> ZDD::exact_element_frequencies(bool parallel) const {
+    std::vector<std::string> result;
+    if (!manager_) return result;
+    TraceScope trace(manager_, "ZDD::exact_element_frequencies", "zdd");
+    for (const exact_int_t& c : zdd_element_frequencies<exact_int_t>(manager_, arc_, parallel)) {
+        result.push_back(exact_int_to_str(c));
+    }
+    return result;
 }
 #endif
 
@@ -591,28 +1098,38 @@ std::vector<std::vector<bddvar>> ZDD::enumerate() const {
     if (!manager_) return result;
     if (arc_ == ARC_TERMINAL_0) return result;
 
+    // Depth-first walk with an explicit stack: low branch (v not in set)
+    // first, then high branch (v in set). An entry with var != 0 appends
+    // var to current on entry; var == BDDVAR_MAX marks the matching pop.
+    struct Entry {
+        Arc arc;
+        bddvar var;
+    };
     std::vector<bddvar> current;
+    std::vector<Entry> stack;
+    stack.push_back({arc_, 0});
+
+    while (!stack.empty()) {
+        Entry e = stack.back();
+        stack.pop_back();
+        if (e.var == BDDVAR_MAX) {
+            current.pop_back();
+            continue;
+        }
+        if (e.var != 0) current.push_back(e.var);
 
-    std::function<void(Arc)> enum_rec = [&](Arc a) {
-        if (a == ARC_TERMINAL_0) return;
+        Arc a = e.arc;
         if (a == ARC_TERMINAL_1) {
             result.push_back(current);
-            return;
+        } else if (a != ARC_TERMINAL_0) {
+            const DDNode& node = manager_->node_at(a.index());
+            // Pushed in reverse order of visit
+            stack.push_back({ARC_TERMINAL_0, BDDVAR_MAX});
+            stack.push_back({node.arc1(), node.var()});
+            stack.push_back({node.arc0(), 0});
+            continue;
         }
-
-        const DDNode& node = manager_->node_at(a.index());
-        bddvar v = node.var();
-
-        // Low branch (v not in set)
-        enum_rec(node.arc0());
-
-        // High branch (v in set)
-        current.push_back(v);
-        enum_rec(node.arc1());
-        current.pop_back();
-    };
-
-    enum_rec(arc_);
+    }
     return result;
 }
 
@@ -639,6 +1156,138 @@ std::vector<bddvar> ZDD::one_set() const {
     return result;
 }
 
+// BDD <-> ZDD conversion over the universe of levels 1..lev. A level that
+// the source skips means "element absent" for a ZDD and "don't care" for a
+// BDD, so the result gets a node there. Results are cached under
+// (op, f, lev); lev is stored as the raw data of the second key arc.
+enum class DDConvert { ZDD_TO_BDD, BDD_TO_ZDD };
+
+struct ConvertFrame {
+    Arc f;
+    bddvar lev;
+    Arc sub[2];
+    bddvar var;
+    int nsub;   // 1 if f skips lev: the one result fills both branches
+    int stage;
+};
+
+static CacheOp convert_op(DDConvert kind) {
+    return kind == DDConvert::ZDD_TO_BDD ? CacheOp::ZDD_TO_BDD : CacheOp::BDD_TO_ZDD;
+}
+
+static bddvar convert_top_lev(DDManager* mgr, Arc f) {
+    return f.is_constant() ? 0 : mgr->lev_of_var(mgr->node_at(f.index()).var());
+}
+
+static bool convert_shortcut(DDManager* mgr, DDConvert kind, Arc f, bddvar lev, Arc& result) {
+    if (f.is_constant()) {
+        // ZDD terminals and plain BDD terminals share their arcs
+        bool value = kind == DDConvert::BDD_TO_ZDD ? f.terminal_value() != f.is_negated()
+                                                   : f.terminal_value();
+        if (!value) {
+            result = ARC_TERMINAL_0;
+            return true;
+        }
+        if (lev == 0) {
+            result = ARC_TERMINAL_1;
+            return true;
+        }
+    }
+    Arc lev_key(static_cast<std::uint64_t>(lev));
+    return mgr->cache_lookup(convert_op(kind), f, lev_key, result);
+}
+
+static void convert_push(DDManager* mgr, std::vector<ConvertFrame>& stack, Arc f, bddvar lev) {
+    ConvertFrame frame;
+    frame.f = f;
+    frame.lev = lev;
+    frame.var = mgr->var_of_lev(lev);
+    frame.stage = 0;
+    if (convert_top_lev(mgr, f) == lev) {
+        const DDNode& node = mgr->node_at(f.index());
+        frame.sub[0] = node.arc0();
+        frame.sub[1] = node.arc1();
+        if (f.is_negated()) {
+            frame.sub[0] = frame.sub[0].negated();
+            frame.sub[1] = frame.sub[1].negated();
+        }
+        frame.nsub = 2;
+    } else {
+        frame.sub[0] = f;
+        frame.nsub = 1;
+    }
+    stack.push_back(frame);
+}
+
+static Arc dd_convert(DDManager* mgr, DDConvert kind, Arc f, bddvar lev) {
+    Arc result;
+    if (convert_shortcut(mgr, kind, f, lev, result)) return result;
+
+    std::vector<ConvertFrame> stack;
+    std::vector<Arc> results;
+    convert_push(mgr, stack, f, lev);
+
+    while (!stack.empty()) {
+        ConvertFrame& frame = stack.back();
+        if (frame.stage < frame.nsub) {
+            Arc sf = frame.sub[frame.stage];
+            bddvar sub_lev = frame.lev - 1;
+            ++frame.stage;
+            if (convert_shortcut(mgr, kind, sf, sub_lev, result)) {
+                results.push_back(result);
+            } else {
+                convert_push(mgr, stack, sf, sub_lev);
+            }
+            continue;
+        }
+
+        Arc r1 = results.back();
+        results.pop_back();
+        Arc r0 = r1;
+        if (frame.nsub == 2) {
+            r0 = results.back();
+            results.pop_back();
+        } else if (kind == DDConvert::ZDD_TO_BDD) {
+            r1 = ARC_TERMINAL_0;  // element absent from every set
+        }
+
+        result = kind == DDConvert::ZDD_TO_BDD
+                     ? mgr->get_or_create_node_bdd(frame.var, r0, r1, true)
+                     : mgr->get_or_create_node_zdd(frame.var, r0, r1, true);
+        Arc lev_key(static_cast<std::uint64_t>(frame.lev));
+        mgr->cache_insert(convert_op(kind), frame.f, lev_key, result);
+        results.push_back(result);
+        stack.pop_back();
+    }
+    return results.back();
+}
+
+static bddvar convert_universe(DDManager* mgr, Arc f, bddvar universe) {
+    if (universe == 0) universe = mgr->top_lev();
+    if (universe > mgr->top_lev()) {
+        throw DDArgumentException("universe exceeds the number of variables");
+    }
+    if (convert_top_lev(mgr, f) > universe) {
+        throw DDArgumentException("DD depends on a variable outside the universe");
+    }
+    return universe;
+}
+
+BDD ZDD::to_bdd(bddvar universe) const {
+    if (!manager_) return BDD();
+    TraceScope trace(manager_, "ZDD::to_bdd", "zdd");
+    bddvar lev = convert_universe(manager_, arc_, universe);
+    return BDD(manager_, dd_convert(manager_, DDConvert::ZDD_TO_BDD, arc_, lev));
+}
+
+ZDD ZDD::from_bdd(const BDD& f, bddvar universe) {
+    DDManager* mgr = f.manager();
+    if (!mgr) return ZDD();
+    TraceScope trace(mgr, "ZDD::from_bdd", "zdd");
+    bddvar lev = convert_universe(mgr, f.arc(), universe);
+    return ZDD(mgr, dd_convert(mgr, DDConvert::BDD_TO_ZDD, f.arc(), lev));
+}
+
 // Debug output
 std::string ZDD::to_string() const {
     if (!manager_) return "invalid";
@@ -866,119 +1515,371 @@ ZDD ZDD::always() const {
     return ZDD(manager_, result);
 }
 
-// ============== Count/Size operations ==============
+// ============== Maximal / minimal families ==============
+// Knuth, TAOCP Vol. 4A, 7.1.4 (Exercises 236-237)
+
+// The four kernels call each other with nested arguments, so they share
+// one explicit-stack driver. A frame makes up to three calls in order; a
+// call may take the result of the previous one as its f. The result is
+// node(var, lo, hi) with lo/hi a call result or a fixed arc, or the result
+// of the last call if var is 0.
+//
+//   nonsup(f, g), f above g: node(v, nonsup(f0, g), nonsup(f1, g))
+//   nonsup(f, g), same top:  node(v, nonsup(f0, g0), nonsup(nonsup(f1, g0), g1))
+//   nonsub(f, g), g above f: nonsub(nonsub(f, g0), g1)
+//   nonsub(f, g), f above g: node(v, nonsub(f0, g), f1)
+//   nonsub(f, g), same top:  node(v, nonsub(nonsub(f0, g0), g1), nonsub(f1, g1))
+//   max(f) = node(v, nonsub(max(f0), f1), max(f1))
+//   min(f) = node(v, min(f0), nonsup(min(f1), f0))
+// (nonsup(f, g) with g above f is nonsup(f, g0), resolved in the shortcut.)
+enum class ZDDMinMaxOp : std::uint8_t { NONSUP, NONSUB, MAXIMAL, MINIMAL };
+
+struct ZDDMinMaxCall {
+    ZDDMinMaxOp op;
+    Arc f, g;
+    bool f_prev;  // f is the result of the previous call
+};
+
+struct ZDDMinMaxFrame {
+    ZDDMinMaxOp op;
+    Arc f, g;
+    ZDDMinMaxCall call[3];
+    Arc res[3];
+    int ncall;
+    int lo, hi;     // index into res, or -1 for lo_arc / hi_arc
+    Arc lo_arc, hi_arc;
+    bddvar var;
+    int stage;
+};
+
+static CacheOp zdd_minmax_cache_op(ZDDMinMaxOp op) {
+    switch (op) {
+    case ZDDMinMaxOp::NONSUP: return CacheOp::NONSUP;
+    case ZDDMinMaxOp::NONSUB: return CacheOp::NONSUB;
+    case ZDDMinMaxOp::MAXIMAL: return CacheOp::MAXIMAL;
+    case ZDDMinMaxOp::MINIMAL: break;
+    }
+    return CacheOp::MINIMAL;
+}
+
+static bddvar zdd_top_lev(DDManager* mgr, Arc f) {
+    return mgr->lev_of_var(mgr->node_at(f.index()).var());
+}
+
+// Terminal and cached cases (returns true if the result is determined).
+// g is ARC_TERMINAL_0 for maximal / minimal.
+static bool zdd_minmax_shortcut(DDManager* mgr, ZDDMinMaxOp op, Arc f, Arc& g, Arc& result) {
+    switch (op) {
+    case ZDDMinMaxOp::NONSUP:
+        for (;;) {
+            if (f == ARC_TERMINAL_0) { result = ARC_TERMINAL_0; return true; }
+            if (g == ARC_TERMINAL_0) { result = f; return true; }
+            if (f == g) { result = ARC_TERMINAL_0; return true; }
+            // {} is a subset of every set
+            if (g == ARC_TERMINAL_1) { result = ARC_TERMINAL_0; return true; }
+            if (f == ARC_TERMINAL_1) {
+                result = zdd_contains_empty_set(mgr, g) == ARC_TERMINAL_1 ? ARC_TERMINAL_0 : f;
+                return true;
+            }
+            if (mgr->cache_lookup(CacheOp::NONSUP, f, g, result)) return true;
+            // No set of f contains g's top variable
+            if (zdd_top_lev(mgr, f) >= zdd_top_lev(mgr, g)) return false;
+            g = mgr->node_at(g.index()).arc0();
+        }
+    case ZDDMinMaxOp::NONSUB:
+        if (f == ARC_TERMINAL_0) { result = ARC_TERMINAL_0; return true; }
+        if (g == ARC_TERMINAL_0) { result = f; return true; }
+        if (f == g) { result = ARC_TERMINAL_0; return true; }
+        // {} is a subset of every set, and g is not empty
+        if (f == ARC_TERMINAL_1) { result = ARC_TERMINAL_0; return true; }
+        // Only {} is a subset of {}
+        if (g == ARC_TERMINAL_1) { result = zdd_diff(mgr, f, ARC_TERMINAL_1); return true; }
+        break;
+    case ZDDMinMaxOp::MAXIMAL:
+    case ZDDMinMaxOp::MINIMAL:
+        if (f.is_constant()) { result = f; return true; }
+        break;
+    }
+    return mgr->cache_lookup(zdd_minmax_cache_op(op), f, g, result);
+}
+
+static void zdd_minmax_push(DDManager* mgr, std::vector<ZDDMinMaxFrame>& stack,
+                            ZDDMinMaxOp op, Arc f, Arc g) {
+    ZDDMinMaxFrame frame;
+    frame.op = op;
+    frame.f = f;
+    frame.g = g;
+    frame.stage = 0;
+    frame.lo = 0;
+    frame.hi = 1;
+
+    auto call = [&frame](int i, ZDDMinMaxOp cop, Arc cf, Arc cg, bool f_prev) {
+        frame.call[i].op = cop;
+        frame.call[i].f = cf;
+        frame.call[i].g = cg;
+        frame.call[i].f_prev = f_prev;
+    };
 
-// Total literal count (sum of all set sizes)
-std::uint64_t ZDD::lit() const {
-    if (!manager_) return 0;
-    if (arc_ == ARC_TERMINAL_0) return 0;
-    if (arc_ == ARC_TERMINAL_1) return 0;  // Empty set has 0 elements
+    const DDNode& f_node = mgr->node_at(f.index());
+    Arc f0 = f_node.arc0();
+    Arc f1 = f_node.arc1();
+    frame.var = f_node.var();
 
-    std::unordered_map<bddindex, std::pair<double, double> > memo;  // (count, lit_sum)
+    switch (op) {
+    case ZDDMinMaxOp::NONSUP:
+    case ZDDMinMaxOp::NONSUB: {
+        bddvar f_lev = zdd_top_lev(mgr, f);
+        bddvar g_lev = zdd_top_lev(mgr, g);
+        const DDNode& g_node = mgr->node_at(g.index());
+        Arc g0 = g_node.arc0();
+        Arc g1 = g_node.arc1();
+        if (op == ZDDMinMaxOp::NONSUP) {
+            // The shortcut has skipped the levels of g above f
+            if (f_lev > g_lev) {
+                call(0, op, f0, g, false);
+                call(1, op, f1, g, false);
+                frame.ncall = 2;
+            } else {
+                call(0, op, f0, g0, false);
+                call(1, op, f1, g0, false);
+                call(2, op, Arc(), g1, true);
+                frame.ncall = 3;
+                frame.hi = 2;
+            }
+        } else if (f_lev < g_lev) {
+            // f = f0 (no set of f has g's top variable)
+            call(0, op, f, g0, false);
+            call(1, op, Arc(), g1, true);
+            frame.ncall = 2;
+            frame.var = 0;
+        } else if (f_lev > g_lev) {
+            // Sets of f with v have no superset in g
+            call(0, op, f0, g, false);
+            frame.ncall = 1;
+            frame.hi = -1;
+            frame.hi_arc = f1;
+        } else {
+            call(0, op, f0, g0, false);
+            call(1, op, Arc(), g1, true);
+            call(2, op, f1, g1, false);
+            frame.ncall = 3;
+            frame.lo = 1;
+            frame.hi = 2;
+        }
+        break;
+    }
+    case ZDDMinMaxOp::MAXIMAL:
+        call(0, op, f1, ARC_TERMINAL_0, false);
+        call(1, op, f0, ARC_TERMINAL_0, false);
+        call(2, ZDDMinMaxOp::NONSUB, Arc(), f1, true);
+        frame.ncall = 3;
+        frame.lo = 2;
+        frame.hi = 0;
+        break;
+    case ZDDMinMaxOp::MINIMAL:
+        call(0, op, f0, ARC_TERMINAL_0, false);
+        call(1, op, f1, ARC_TERMINAL_0, false);
+        call(2, ZDDMinMaxOp::NONSUP, Arc(), f0, true);
+        frame.ncall = 3;
+        frame.lo = 0;
+        frame.hi = 2;
+        break;
+    }
+    stack.push_back(frame);
+}
+
+// Explicit-stack driver (safe at any depth)
+static Arc zdd_minmax(DDManager* mgr, ZDDMinMaxOp op, Arc f, Arc g) {
+    Arc result;
+    if (zdd_minmax_shortcut(mgr, op, f, g, result)) return result;
+
+    std::vector<ZDDMinMaxFrame> stack;
+    zdd_minmax_push(mgr, stack, op, f, g);
+
+    for (;;) {
+        ZDDMinMaxFrame& frame = stack.back();
+        if (frame.stage < frame.ncall) {
+            const ZDDMinMaxCall& c = frame.call[frame.stage];
+            Arc cf = c.f_prev ? frame.res[frame.stage - 1] : c.f;
+            Arc cg = c.g;
+            ZDDMinMaxOp cop = c.op;
+            if (zdd_minmax_shortcut(mgr, cop, cf, cg, result)) {
+                frame.res[frame.stage++] = result;
+            } else {
+                zdd_minmax_push(mgr, stack, cop, cf, cg);
+            }
+            continue;
+        }
 
-    std::function<std::pair<double, double>(Arc)> count_rec = [&](Arc a) -> std::pair<double, double> {
-        if (a == ARC_TERMINAL_0) return std::make_pair(0.0, 0.0);
-        if (a == ARC_TERMINAL_1) return std::make_pair(1.0, 0.0);
+        if (frame.var == 0) {
+            result = frame.res[frame.ncall - 1];
+        } else {
+            Arc lo = frame.lo < 0 ? frame.lo_arc : frame.res[frame.lo];
+            Arc hi = frame.hi < 0 ? frame.hi_arc : frame.res[frame.hi];
+            result = mgr->get_or_create_node_zdd(frame.var, lo, hi, true);
+        }
+        mgr->cache_insert(zdd_minmax_cache_op(frame.op), frame.f, frame.g, result);
+        stack.pop_back();
+        if (stack.empty()) return result;
+        ZDDMinMaxFrame& parent = stack.back();
+        parent.res[parent.stage++] = result;
+    }
+}
 
-        bddindex idx = a.index();
-        std::unordered_map<bddindex, std::pair<double, double> >::iterator it = memo.find(idx);
-        if (it != memo.end()) return it->second;
+// Nonsupersets: sets in f that contain no set of g
+static Arc zdd_nonsup_impl(DDManager* mgr, Arc f, Arc g) {
+    return zdd_minmax(mgr, ZDDMinMaxOp::NONSUP, f, g);
+}
 
-        const DDNode& node = manager_->node_at(idx);
-        std::pair<double, double> res0 = count_rec(node.arc0());
-        std::pair<double, double> res1 = count_rec(node.arc1());
-        double cnt0 = res0.first, lit0 = res0.second;
-        double cnt1 = res1.first, lit1 = res1.second;
+// Nonsubsets: sets in f that are contained in no set of g
+static Arc zdd_nonsub_impl(DDManager* mgr, Arc f, Arc g) {
+    return zdd_minmax(mgr, ZDDMinMaxOp::NONSUB, f, g);
+}
 
-        // High branch adds 1 element per set
-        double total_cnt = cnt0 + cnt1;
-        double total_lit = lit0 + lit1 + cnt1;
+// Maximal sets
+static Arc zdd_maximal_impl(DDManager* mgr, Arc f) {
+    return zdd_minmax(mgr, ZDDMinMaxOp::MAXIMAL, f, ARC_TERMINAL_0);
+}
 
-        memo[idx] = std::make_pair(total_cnt, total_lit);
-        return std::make_pair(total_cnt, total_lit);
-    };
+// Minimal sets
+static Arc zdd_minimal_impl(DDManager* mgr, Arc f) {
+    return zdd_minmax(mgr, ZDDMinMaxOp::MINIMAL, f, ARC_TERMINAL_0);
+}
 
-    std::pair<double, double> result = count_rec(arc_);
-    return static_cast<std::uint64_t>(result.second);
+ZDD ZDD::maximal() const {
+    if (!manager_) return *this;
+    Arc result = zdd_maximal_impl(manager_, arc_);
+    return ZDD(manager_, result);
 }
 
-// Maximum set size (longest path)
-std::uint64_t ZDD::len() const {
-    if (!manager_) return 0;
-    if (arc_ == ARC_TERMINAL_0) return 0;
-    if (arc_ == ARC_TERMINAL_1) return 0;
+ZDD ZDD::minimal() const {
+    if (!manager_) return *this;
+    Arc result = zdd_minimal_impl(manager_, arc_);
+    return ZDD(manager_, result);
+}
 
-    std::unordered_map<bddindex, std::uint64_t> memo;
+ZDD ZDD::nonsup(const ZDD& g) const {
+    if (!manager_ || !g.manager_ || manager_ != g.manager_) {
+        throw DDIncompatibleException("ZDD managers do not match");
+    }
+    Arc result = zdd_nonsup_impl(manager_, arc_, g.arc_);
+    return ZDD(manager_, result);
+}
 
-    std::function<std::uint64_t(Arc)> len_rec = [&](Arc a) -> std::uint64_t {
-        if (a == ARC_TERMINAL_0) return 0;
-        if (a == ARC_TERMINAL_1) return 0;
+ZDD ZDD::nonsub(const ZDD& g) const {
+    if (!manager_ || !g.manager_ || manager_ != g.manager_) {
+        throw DDIncompatibleException("ZDD managers do not match");
+    }
+    Arc result = zdd_nonsub_impl(manager_, arc_, g.arc_);
+    return ZDD(manager_, result);
+}
 
-        bddindex idx = a.index();
-        auto it = memo.find(idx);
-        if (it != memo.end()) return it->second;
+// ============== Count/Size operations ==============
 
-        const DDNode& node = manager_->node_at(idx);
-        std::uint64_t len0 = len_rec(node.arc0());
-        std::uint64_t len1 = len_rec(node.arc1());
+// Total literal count (sum of all set sizes)
+std::uint64_t ZDD::lit() const {
+    if (!manager_) return 0;
 
-        // High branch adds 1 to length, but only if it leads to non-empty
-        std::uint64_t max_len = std::max(len0, len1 + 1);
-        memo[idx] = max_len;
-        return max_len;
-    };
+    // (count, lit_sum); the high branch adds 1 element per set
+    typedef std::pair<double, double> CountLit;
+    CountLit result = zdd_fold<CountLit>(manager_, arc_,
+        CountLit(0.0, 0.0), CountLit(1.0, 0.0),
+        [](const CountLit& r0, const CountLit& r1) {
+            return CountLit(r0.first + r1.first, r0.second + r1.second + r1.first);
+        });
+    return static_cast<std::uint64_t>(result.second);
+}
 
-    return len_rec(arc_);
+// Maximum set size (longest path)
+std::uint64_t ZDD::len() const {
+    if (!manager_) return 0;
+
+    // High branch adds 1 to length (it never leads to the empty family)
+    return zdd_fold<std::uint64_t>(manager_, arc_, 0, 0,
+        [](std::uint64_t len0, std::uint64_t len1) { return std::max(len0, len1 + 1); });
 }
 
 // ============== Shift operations ==============
 
-// Left shift: increase all variable numbers by s
-static Arc zdd_lshift_impl(DDManager* mgr, Arc f, int s) {
+// Projected shift: variables v <= floor are removed (the two branches are
+// unioned), every other variable v is renamed to v + offset. Both shift
+// operators and ShiftedZDD::materialize() run on this one kernel, memoized
+// under SHIFT with the (offset, floor) pair encoded in the g and h keys.
+static Arc zdd_shift_impl(DDManager* mgr, Arc f, int offset, bddvar floor) {
     if (f.is_constant()) return f;
-    if (s <= 0) return f;
-
-    const DDNode& node = mgr->node_at(f.index());
-    bddvar new_var = node.var() + static_cast<bddvar>(s);
-
-    Arc r0 = zdd_lshift_impl(mgr, node.arc0(), s);
-    Arc r1 = zdd_lshift_impl(mgr, node.arc1(), s);
+    if (offset == 0 && floor == 0) return f;
 
-    return mgr->get_or_create_node_zdd(new_var, r0, r1, true);
-}
+    Arc off_key(static_cast<std::uint64_t>(static_cast<std::int64_t>(offset)));
+    Arc floor_key(static_cast<std::uint64_t>(floor));
+    Arc result;
+    if (mgr->cache_lookup3(CacheOp::SHIFT, f, off_key, floor_key, result)) {
+        return result;
+    }
 
-ZDD ZDD::operator<<(int s) const {
-    if (!manager_ || s <= 0) return *this;
-    Arc result = zdd_lshift_impl(manager_, arc_, s);
-    return ZDD(manager_, result);
-}
+    auto resolve = [&](Arc a, Arc& r) -> bool {
+        if (a.is_constant()) {
+            r = a;
+            return true;
+        }
+        return mgr->cache_lookup3(CacheOp::SHIFT, a, off_key, floor_key, r);
+    };
+    auto push = [mgr](std::vector<ZDDUnaryFrame>& stack, Arc a) {
+        const DDNode& node = mgr->node_at(a.index());
+        ZDDUnaryFrame frame;
+        frame.f = a;
+        frame.sub[0] = node.arc0();
+        frame.sub[1] = node.arc1();
+        frame.var = node.var();
+        frame.stage = 0;
+        stack.push_back(frame);
+    };
 
-// Right shift: decrease all variable numbers by s
-static Arc zdd_rshift_impl(DDManager* mgr, Arc f, int s) {
-    if (f.is_constant()) return f;
-    if (s <= 0) return f;
+    std::vector<ZDDUnaryFrame> stack;
+    std::vector<Arc> results;
+    push(stack, f);
+
+    while (!stack.empty()) {
+        ZDDUnaryFrame& frame = stack.back();
+        if (frame.stage < 2) {
+            Arc sf = frame.sub[frame.stage];
+            ++frame.stage;
+            if (resolve(sf, result)) {
+                results.push_back(result);
+            } else {
+                push(stack, sf);
+            }
+            continue;
+        }
 
-    const DDNode& node = mgr->node_at(f.index());
-    bddvar var = node.var();
+        Arc r1 = results.back();
+        results.pop_back();
+        Arc r0 = results.back();
+        results.pop_back();
 
-    if (var <= static_cast<bddvar>(s)) {
-        // Variable would become 0 or negative, skip this level
-        Arc r0 = zdd_rshift_impl(mgr, node.arc0(), s);
-        Arc r1 = zdd_rshift_impl(mgr, node.arc1(), s);
-        return zdd_union(mgr, r0, r1);
+        if (frame.var <= floor) {
+            result = zdd_union(mgr, r0, r1);
+        } else {
+            bddvar new_var = static_cast<bddvar>(
+                static_cast<std::int64_t>(frame.var) + offset);
+            result = mgr->get_or_create_node_zdd(new_var, r0, r1, true);
+        }
+        mgr->cache_insert3(CacheOp::SHIFT, frame.f, off_key, floor_key, result);
+        results.push_back(result);
+        stack.pop_back();
     }
+    return results.back();
+}
 
-    bddvar new_var = var - static_cast<bddvar>(s);
-    Arc r0 = zdd_rshift_impl(mgr, node.arc0(), s);
-    Arc r1 = zdd_rshift_impl(mgr, node.arc1(), s);
-
-    return mgr->get_or_create_node_zdd(new_var, r0, r1, true);
+// Left shift: increase all variable numbers by s
+ZDD ZDD::operator<<(int s) const {
+    if (!manager_ || s <= 0) return *this;
+    return ZDD(manager_, zdd_shift_impl(manager_, arc_, s, 0));
 }
 
+// Right shift: decrease all variable numbers by s, projecting out v <= s
 ZDD ZDD::operator>>(int s) const {
     if (!manager_ || s <= 0) return *this;
-    Arc result = zdd_rshift_impl(manager_, arc_, s);
-    return ZDD(manager_, result);
+    return ZDD(manager_, zdd_shift_impl(manager_, arc_, -s, static_cast<bddvar>(s)));
 }
 
 ZDD& ZDD::operator<<=(int s) {
@@ -993,6 +1894,141 @@ ZDD& ZDD::operator>>=(int s) {
 
 // ============== Symmetry and Implication ==============
 
+// Virtual cofactor of F used by the symmetry check: the sets S of the
+// subfamily at arc with S ∩ {a, b} fixed, a and b removed. Side 0 is
+// F_{a,~b} (a in, b out), side 1 is F_{~a,b}. flags bit 0 / bit 1 mark a / b
+// as already resolved on the path; bit 2 is the side. An empty view has
+// arc == ARC_TERMINAL_0.
+struct ZDDSymView {
+    Arc arc;
+    std::uint8_t flags;
+
+    std::uint64_t key() const { return (arc.data << 3) | flags; }
+};
+
+struct ZDDSymViewPairHash {
+    std::size_t operator()(const std::pair<std::uint64_t, std::uint64_t>& p) const {
+        return std::hash<std::uint64_t>()(p.first * 0x9e3779b97f4a7c15ULL ^ p.second);
+    }
+};
+
+// Resolve a and b at the top of the view so that it is empty, the base
+// {{}}, or positioned at a node of another variable
+static ZDDSymView zdd_sym_normalize(DDManager* mgr, ZDDSymView view, bddvar a, bddvar b,
+                                    bddvar a_lev, bddvar b_lev) {
+    bool a_in = (view.flags & 4) == 0;
+    bool b_in = !a_in;
+    for (;;) {
+        if (view.arc == ARC_TERMINAL_0) return view;
+
+        bddvar lev = 0;
+        bddvar v = 0;
+        if (!view.arc.is_constant()) {
+            v = mgr->node_at(view.arc.index()).var();
+            lev = mgr->lev_of_var(v);
+        }
+        // Variable skipped on this path: it is not in any set below
+        if (!(view.flags & 1) && lev < a_lev) {
+            if (a_in) view.arc = ARC_TERMINAL_0;
+            view.flags |= 1;
+            continue;
+        }
+        if (!(view.flags & 2) && lev < b_lev) {
+            if (b_in) view.arc = ARC_TERMINAL_0;
+            view.flags |= 2;
+            continue;
+        }
+        if (view.arc.is_constant()) return view;
+
+        const DDNode& node = mgr->node_at(view.arc.index());
+        if (v == a) {
+            view.arc = a_in ? node.arc1() : node.arc0();
+            view.flags |= 1;
+        } else if (v == b) {
+            view.arc = b_in ? node.arc1() : node.arc0();
+            view.flags |= 2;
+        } else {
+            return view;
+        }
+    }
+}
+
+// Does the view contain at least one set?
+static bool zdd_sym_nonempty(DDManager* mgr, ZDDSymView view, bddvar a, bddvar b,
+                             bddvar a_lev, bddvar b_lev) {
+    std::unordered_set<std::uint64_t> visited;
+    std::vector<ZDDSymView> stack;
+    stack.push_back(view);
+    while (!stack.empty()) {
+        ZDDSymView x = zdd_sym_normalize(mgr, stack.back(), a, b, a_lev, b_lev);
+        stack.pop_back();
+        if (x.arc == ARC_TERMINAL_0) continue;
+        if (x.arc == ARC_TERMINAL_1) return true;
+        if (!visited.insert(x.key()).second) continue;
+
+        const DDNode& node = mgr->node_at(x.arc.index());
+        stack.push_back({node.arc1(), x.flags});
+        stack.push_back({node.arc0(), x.flags});
+    }
+    return false;
+}
+
+// F_{a,~b} == F_{~a,b}, compared variable by variable on the fly without
+// creating nodes. The comparison starts from each arc in starts (the root,
+// or every node that can be entered from above both a and b).
+static bool zdd_sym_cofactors_equal(DDManager* mgr, const std::vector<Arc>& starts,
+                                    bddvar a, bddvar b) {
+    bddvar a_lev = mgr->lev_of_var(a);
+    bddvar b_lev = mgr->lev_of_var(b);
+    const ZDDSymView empty_view = {ARC_TERMINAL_0, 0};
+
+    std::unordered_set<std::pair<std::uint64_t, std::uint64_t>, ZDDSymViewPairHash> visited;
+    std::vector<std::pair<ZDDSymView, ZDDSymView>> stack;
+    for (Arc f : starts) {
+        stack.push_back(std::make_pair(ZDDSymView{f, 0}, ZDDSymView{f, 4}));
+    }
+
+    while (!stack.empty()) {
+        ZDDSymView x = zdd_sym_normalize(mgr, stack.back().first, a, b, a_lev, b_lev);
+        ZDDSymView y = zdd_sym_normalize(mgr, stack.back().second, a, b, a_lev, b_lev);
+        stack.pop_back();
+
+        bool x_empty = x.arc == ARC_TERMINAL_0;
+        bool y_empty = y.arc == ARC_TERMINAL_0;
+        if (x_empty || y_empty) {
+            if (x_empty && y_empty) continue;
+            if (zdd_sym_nonempty(mgr, x_empty ? y : x, a, b, a_lev, b_lev)) return false;
+            continue;
+        }
+        // Below both a and b the views are plain ZDDs, which are canonical
+        if ((x.flags & 3) == 3 && (y.flags & 3) == 3) {
+            if (x.arc != y.arc) return false;
+            continue;
+        }
+        if (!visited.insert(std::make_pair(x.key(), y.key())).second) continue;
+
+        bddvar x_lev = x.arc.is_constant() ? 0 : mgr->lev_of_var(mgr->node_at(x.arc.index()).var());
+        bddvar y_lev = y.arc.is_constant() ? 0 : mgr->lev_of_var(mgr->node_at(y.arc.index()).var());
+        bddvar top_lev = std::max(x_lev, y_lev);
+
+        // Split both views on the top variable
+        ZDDSymView x0 = x, x1 = empty_view, y0 = y, y1 = empty_view;
+        if (x_lev == top_lev) {
+            const DDNode& node = mgr->node_at(x.arc.index());
+            x0 = {node.arc0(), x.flags};
+            x1 = {node.arc1(), x.flags};
+        }
+        if (y_lev == top_lev) {
+            const DDNode& node = mgr->node_at(y.arc.index());
+            y0 = {node.arc0(), y.flags};
+            y1 = {node.arc1(), y.flags};
+        }
+        stack.push_back(std::make_pair(x1, y1));
+        stack.push_back(std::make_pair(x0, y0));
+    }
+    return true;
+}
+
 // Check if v1 and v2 are symmetric
 int ZDD::sym_chk(bddvar v1, bddvar v2) const {
     if (!manager_) return -1;
@@ -1000,68 +2036,294 @@ int ZDD::sym_chk(bddvar v1, bddvar v2) const {
 
     // Symmetric if the sets with v1 (v1 removed) that don't have v2
     // equal the sets with v2 (v2 removed) that don't have v1
-    ZDD f10 = onset(v1).offset(v2);  // had v1 but not v2 (v1 removed)
-    ZDD f01 = offset(v1).onset(v2);  // had v2 but not v1 (v2 removed)
+    return zdd_sym_cofactors_equal(manager_, std::vector<Arc>(1, arc_), v1, v2) ? 1 : 0;
+}
+
+// Collect the nodes reachable from f, each once (visited bitmap over the
+// node table)
+static std::vector<bddindex> zdd_collect_nodes(DDManager* mgr, Arc f) {
+    std::vector<bddindex> nodes;
+    if (f.is_constant()) return nodes;
+
+    std::vector<bool> visited(mgr->node_index_limit(), false);
+    std::vector<Arc> stack;
+    stack.push_back(f);
+    while (!stack.empty()) {
+        Arc a = stack.back();
+        stack.pop_back();
+        if (a.is_constant()) continue;
+
+        bddindex idx = a.index();
+        if (visited[idx]) continue;
+        visited[idx] = true;
+        nodes.push_back(idx);
+
+        const DDNode& node = mgr->node_at(idx);
+        stack.push_back(node.arc1());
+        stack.push_back(node.arc0());
+    }
+    return nodes;
+}
 
-    return (f10 == f01) ? 1 : 0;
+// Variables appearing in f, ordered by level (bottom first)
+static std::vector<bddvar> zdd_support_vars(DDManager* mgr, Arc f) {
+    std::vector<bool> seen(mgr->var_count() + 1, false);
+    std::vector<bddvar> vars;
+    for (bddindex idx : zdd_collect_nodes(mgr, f)) {
+        bddvar v = mgr->node_at(idx).var();
+        if (!seen[v]) {
+            seen[v] = true;
+            vars.push_back(v);
+        }
+    }
+    std::sort(vars.begin(), vars.end(), [mgr](bddvar a, bddvar b) {
+        return mgr->lev_of_var(a) < mgr->lev_of_var(b);
+    });
+    return vars;
 }
 
-// Get support (all variables appearing in ZDD)
+// Get support (all variables appearing in ZDD) as the family of singletons
 static ZDD zdd_support(DDManager* mgr, Arc f) {
-    if (f.is_constant()) {
-        return ZDD::empty(*mgr);
+    // Build {{v1}, {v2}, ...} bottom-up as a chain of 0-edges
+    Arc result = ARC_TERMINAL_0;
+    for (bddvar v : zdd_support_vars(mgr, f)) {
+        result = mgr->get_or_create_node_zdd(v, result, ARC_TERMINAL_1, true);
+    }
+    return ZDD(mgr, result);
+}
+
+// Modulus of the symmetry signatures (largest 32-bit prime, so that
+// products fit in 64 bits)
+static const std::uint64_t SYM_MOD = 4294967291ULL;
+
+static inline std::uint64_t sym_add(std::uint64_t x, std::uint64_t y) {
+    std::uint64_t r = x + y;
+    return r >= SYM_MOD ? r - SYM_MOD : r;
+}
+
+static inline std::uint64_t sym_mul(std::uint64_t x, std::uint64_t y) {
+    return x * y % SYM_MOD;
+}
+
+// Flat layout of a ZDD for signature passes: nodes in topological order
+// (root first), children as positions, terminals as SYM_T0 / SYM_T1.
+struct ZDDSymLayout {
+    std::vector<bddvar> var;
+    std::vector<std::int64_t> lo, hi;
+    std::vector<bddindex> index;
+    std::vector<bddvar> lev;
+    std::vector<bddvar> parent_lev;  // highest level of a parent (BDDVAR_MAX for the root)
+};
+static const std::int64_t SYM_T0 = -1;
+static const std::int64_t SYM_T1 = -2;
+
+static ZDDSymLayout zdd_sym_layout(DDManager* mgr, Arc f) {
+    std::vector<std::pair<bddvar, bddindex>> order;
+    for (bddindex idx : zdd_collect_nodes(mgr, f)) {
+        order.emplace_back(mgr->lev_of_var(mgr->node_at(idx).var()), idx);
+    }
+    // Larger level (closer to root) first
+    std::sort(order.begin(), order.end(),
+              [](const std::pair<bddvar, bddindex>& a, const std::pair<bddvar, bddindex>& b) {
+                  return a.first > b.first;
+              });
+    std::unordered_map<bddindex, std::int64_t> pos;
+    pos.reserve(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        pos.emplace(order[i].second, static_cast<std::int64_t>(i));
+    }
+    auto child = [&](Arc a) -> std::int64_t {
+        if (a.is_constant()) return a == ARC_TERMINAL_1 ? SYM_T1 : SYM_T0;
+        return pos[a.index()];
+    };
+
+    ZDDSymLayout layout;
+    layout.var.reserve(order.size());
+    layout.lo.reserve(order.size());
+    layout.hi.reserve(order.size());
+    layout.index.reserve(order.size());
+    layout.lev.reserve(order.size());
+    layout.parent_lev.assign(order.size(), 0);
+    for (const auto& entry : order) {
+        const DDNode& node = mgr->node_at(entry.second);
+        layout.var.push_back(node.var());
+        layout.lo.push_back(child(node.arc0()));
+        layout.hi.push_back(child(node.arc1()));
+        layout.index.push_back(entry.second);
+        layout.lev.push_back(entry.first);
+    }
+    if (!order.empty()) layout.parent_lev[0] = BDDVAR_MAX;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        for (std::int64_t c : {layout.lo[i], layout.hi[i]}) {
+            if (c >= 0 && layout.parent_lev[c] < layout.lev[i]) {
+                layout.parent_lev[c] = layout.lev[i];
+            }
+        }
     }
+    return layout;
+}
+
+// With P(F) = sum over S in F of prod_{v in S} w[v] (mod SYM_MOD):
+//   down[i] = P of the subfamily below node i,
+//   up[i]   = sum over root-to-i paths of the product of 1-edge weights,
+//   partial[v] = dP/dw[v] = sum over nodes i labelled v of up[i] * down(hi(i)),
+// since every set containing v leaves exactly one node labelled v
+// through its 1-edge.
+static void zdd_sym_partials(const ZDDSymLayout& layout, const std::vector<std::uint64_t>& w,
+                             std::vector<std::uint64_t>& down, std::vector<std::uint64_t>& up,
+                             std::vector<std::uint64_t>& partial) {
+    std::size_t n = layout.var.size();
+    down.assign(n, 0);
+    up.assign(n, 0);
+    auto down_of = [&](std::int64_t c) -> std::uint64_t {
+        return c == SYM_T1 ? 1 : (c == SYM_T0 ? 0 : down[c]);
+    };
 
-    std::unordered_set<bddvar> vars;
-    std::function<void(Arc)> collect = [&](Arc a) {
-        if (a.is_constant()) return;
-        const DDNode& node = mgr->node_at(a.index());
-        vars.insert(node.var());
-        collect(node.arc0());
-        collect(node.arc1());
+    for (std::size_t i = n; i-- > 0; ) {
+        down[i] = sym_add(down_of(layout.lo[i]), sym_mul(w[layout.var[i]], down_of(layout.hi[i])));
+    }
+    if (n > 0) up[0] = 1;
+    for (std::size_t i = 0; i < n; ++i) {
+        bddvar v = layout.var[i];
+        partial[v] = sym_add(partial[v], sym_mul(up[i], down_of(layout.hi[i])));
+        if (layout.lo[i] >= 0) {
+            up[layout.lo[i]] = sym_add(up[layout.lo[i]], up[i]);
+        }
+        if (layout.hi[i] >= 0) {
+            up[layout.hi[i]] = sym_add(up[layout.hi[i]], sym_mul(up[i], w[v]));
+        }
+    }
+}
+
+// Forward-mode derivative of zdd_sym_partials with respect to w[a]:
+// accumulates the mixed partials d2P/dw[a]dw[v] into mixed[v].
+static void zdd_sym_mixed(const ZDDSymLayout& layout, const std::vector<std::uint64_t>& w,
+                          const std::vector<std::uint64_t>& down, const std::vector<std::uint64_t>& up,
+                          bddvar a, std::vector<std::uint64_t>& ddown, std::vector<std::uint64_t>& dup,
+                          std::vector<std::uint64_t>& mixed) {
+    std::size_t n = layout.var.size();
+    ddown.assign(n, 0);
+    dup.assign(n, 0);
+    auto down_of = [&](std::int64_t c) -> std::uint64_t {
+        return c == SYM_T1 ? 1 : (c == SYM_T0 ? 0 : down[c]);
+    };
+    auto ddown_of = [&](std::int64_t c) -> std::uint64_t {
+        return c < 0 ? 0 : ddown[c];
     };
-    collect(f);
 
-    ZDD result = ZDD::empty(*mgr);
-    for (bddvar v : vars) {
-        result = result + ZDD::singleton(*mgr, v);
+    for (std::size_t i = n; i-- > 0; ) {
+        bddvar v = layout.var[i];
+        std::uint64_t d = sym_add(ddown_of(layout.lo[i]), sym_mul(w[v], ddown_of(layout.hi[i])));
+        if (v == a) d = sym_add(d, down_of(layout.hi[i]));
+        ddown[i] = d;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        bddvar v = layout.var[i];
+        std::uint64_t hi_down = down_of(layout.hi[i]);
+        mixed[v] = sym_add(mixed[v], sym_add(sym_mul(dup[i], hi_down),
+                                             sym_mul(up[i], ddown_of(layout.hi[i]))));
+        if (layout.lo[i] >= 0) {
+            dup[layout.lo[i]] = sym_add(dup[layout.lo[i]], dup[i]);
+        }
+        if (layout.hi[i] >= 0) {
+            std::uint64_t d = sym_mul(dup[i], w[v]);
+            if (v == a) d = sym_add(d, up[i]);
+            dup[layout.hi[i]] = sym_add(dup[layout.hi[i]], d);
+        }
     }
-    return result;
 }
 
 // Get symmetric groups
+//
+// Variables a, b are symmetric iff F_{a,~b} == F_{~a,b}. Writing
+// P = P(F) as a multilinear polynomial in the weights,
+//   P(F_{a,~b}) - P(F_{~a,b}) = dP/dw[a] - dP/dw[b] + (w[a] - w[b]) d2P/dw[a]dw[b],
+// which is identically 0 for symmetric a, b. Candidates are first bucketed
+// by dP/dw[v] with all weights equal (symmetric variables always agree).
+// Within a bucket, one forward-mode pass per representative a evaluates the
+// identity for every remaining b at random weights; hits are confirmed
+// exactly by zdd_sym_cofactors_equal().
 ZDD ZDD::sym_grp() const {
     if (!manager_) return *this;
 
-    ZDD support = zdd_support(manager_, arc_);
-    std::vector<bddvar> vars = support.one_set();
-
+    std::vector<bddvar> vars = zdd_support_vars(manager_, arc_);
     ZDD result = ZDD::empty(*manager_);
-    std::unordered_set<bddvar> processed;
+    if (vars.size() < 2) return result;
 
-    for (bddvar v1 : vars) {
-        if (processed.count(v1)) continue;
+    ZDDSymLayout layout = zdd_sym_layout(manager_, arc_);
+    std::size_t nvars = manager_->var_count() + 1;
+    std::mt19937_64 rng(0x5bdd2u);
+    std::uniform_int_distribution<std::uint64_t> dist(1, SYM_MOD - 1);
+    std::vector<std::uint64_t> down, up, ddown, dup;
 
-        ZDD group = ZDD::singleton(*manager_, v1);
-        for (bddvar v2 : vars) {
-            if (v1 != v2 && !processed.count(v2)) {
-                if (sym_chk(v1, v2) == 1) {
-                    group = group + ZDD::singleton(*manager_, v2);
-                    processed.insert(v2);
-                }
+    // Bucket by the equal-weight signature
+    std::vector<std::uint64_t> w(nvars, dist(rng));
+    std::vector<std::uint64_t> sig(nvars, 0);
+    zdd_sym_partials(layout, w, down, up, sig);
+
+    std::unordered_map<std::uint64_t, std::vector<bddvar>> buckets;
+    std::vector<std::uint64_t> bucket_order;
+    for (bddvar v : vars) {
+        std::vector<bddvar>& bucket = buckets[sig[v]];
+        if (bucket.empty()) bucket_order.push_back(sig[v]);
+        bucket.push_back(v);
+    }
+
+    // First derivatives at random weights
+    for (std::size_t v = 0; v < nvars; ++v) {
+        w[v] = dist(rng);
+    }
+    std::vector<std::uint64_t> partial(nvars, 0);
+    std::vector<std::uint64_t> mixed(nvars, 0);
+    zdd_sym_partials(layout, w, down, up, partial);
+
+    // Nodes entered from above level L (the part of F above L does not
+    // involve the checked pair, so the comparison can start there)
+    std::unordered_map<bddvar, std::vector<Arc>> frontiers;
+    auto frontier_of = [&](bddvar lev) -> const std::vector<Arc>& {
+        auto it = frontiers.find(lev);
+        if (it != frontiers.end()) return it->second;
+        std::vector<Arc>& starts = frontiers[lev];
+        for (std::size_t i = 0; i < layout.var.size(); ++i) {
+            if (layout.lev[i] <= lev && lev < layout.parent_lev[i]) {
+                starts.push_back(Arc::node(layout.index[i]));
             }
         }
-        processed.insert(v1);
+        return starts;
+    };
 
-        // Only add non-singleton groups, or all if needed
-        if (group.card() > 1) {
-            // Convert group to a set representation
-            std::vector<bddvar> group_vars = group.one_set();
-            ZDD group_set = ZDD::single(*manager_);
-            for (bddvar gv : group_vars) {
-                group_set = group_set.change(gv);
+    for (std::uint64_t key : bucket_order) {
+        std::vector<bddvar> remaining = buckets[key];
+        while (remaining.size() >= 2) {
+            bddvar a = remaining[0];
+            zdd_sym_mixed(layout, w, down, up, a, ddown, dup, mixed);
+
+            std::vector<bddvar> group(1, a);
+            std::vector<bddvar> rest;
+            for (std::size_t i = 1; i < remaining.size(); ++i) {
+                bddvar b = remaining[i];
+                std::uint64_t lhs = sym_add(partial[a], sym_mul(sym_add(w[a], SYM_MOD - w[b]), mixed[b]));
+                if (lhs == partial[b] &&
+                    zdd_sym_cofactors_equal(manager_, frontier_of(std::max(manager_->lev_of_var(a), manager_->lev_of_var(b))), a, b)) {
+                    group.push_back(b);
+                } else {
+                    rest.push_back(b);
+                }
             }
-            result = result + group_set;
+            // Mixed partials are only accumulated for support variables
+            for (bddvar v : vars) {
+                mixed[v] = 0;
+            }
+
+            // Only add non-singleton groups
+            if (group.size() > 1) {
+                ZDD group_set = ZDD::single(*manager_);
+                for (bddvar gv : group) {
+                    group_set = group_set.change(gv);
+                }
+                result = result + group_set;
+            }
+            remaining.swap(rest);
         }
     }
 
@@ -1425,4 +2687,12 @@ ZDD zdd_meet(const ZDD& f, const ZDD& g) {
     return ZDD(f.manager(), result);
 }
 
+ZDD zdd_shift(const ZDD& f, int offset, bddvar floor) {
+    if (static_cast<std::int64_t>(floor) + offset < 0) {
+        throw DDArgumentException("zdd_shift: shift would move a variable below 1");
+    }
+    if (!f.manager()) return f;
+    return ZDD(f.manager(), zdd_shift_impl(f.manager(), f.arc(), offset, floor));
+}
+
 } // namespace sbdd2
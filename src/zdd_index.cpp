@@ -39,6 +39,16 @@ static int get_level(DDManager* mgr, Arc arc) {
     return static_cast<int>(mgr->lev_of_var(node.var()));
 }
 
+// Bytes held by an index (level lists and the two hash maps)
+template<typename IndexData>
+static std::size_t index_bytes(const IndexData& data) {
+    std::size_t bytes = data.level_nodes.capacity() * sizeof(std::vector<Arc>);
+    for (const auto& level : data.level_nodes) {
+        bytes += level.capacity() * sizeof(Arc);
+    }
+    return bytes + hash_table_bytes(data.node_to_idx) + hash_table_bytes(data.count_cache);
+}
+
 void ZDD::build_index() const {
     if (!manager_ || !index_once_flag_) {
         return;
@@ -157,6 +167,7 @@ void ZDD::build_index_impl() const {
             index_cache_->count_cache[node] = count0 + count1;
         }
     }
+    index_cache_->memory.update(manager_, AuxMemory::ZDD_INDEX, index_bytes(*index_cache_));
 }
 
 #if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
@@ -269,6 +280,8 @@ void ZDD::build_exact_index_impl() const {
             exact_index_cache_->count_cache[node] = count0 + count1;
         }
     }
+    exact_index_cache_->memory.update(manager_, AuxMemory::ZDD_INDEX,
+                                      index_bytes(*exact_index_cache_));
 }
 #endif
 
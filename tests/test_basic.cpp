@@ -3,6 +3,8 @@
 
 #include <gtest/gtest.h>
 #include "sbdd2/sbdd2.hpp"
+#include <sstream>
+#include <thread>
 
 using namespace sbdd2;
 
@@ -95,6 +97,295 @@ TEST(DDManagerTest, Construction) {
     EXPECT_EQ(mgr.node_count(), 0u);
 }
 
+TEST(DDManagerTest, Stats) {
+    DDManager mgr;
+    mgr.new_var();
+    mgr.new_var();
+    mgr.reset_stats();
+
+    BDD x1 = mgr.var_bdd(1);
+    BDD x2 = mgr.var_bdd(2);
+    BDD f = x1 & x2;
+    std::size_t misses = mgr.cache_miss_count();
+    EXPECT_GT(misses, 0u);
+    BDD g = x1 & x2;
+    EXPECT_EQ(f, g);
+    EXPECT_GT(mgr.cache_hit_count(), 0u);
+    EXPECT_EQ(mgr.peak_node_count(), mgr.node_count());
+
+    mgr.reset_stats();
+    EXPECT_EQ(mgr.cache_hit_count(), 0u);
+    EXPECT_EQ(mgr.cache_miss_count(), 0u);
+    EXPECT_EQ(mgr.peak_node_count(), mgr.node_count());
+}
+
+TEST(DDManagerTest, ProfileReport) {
+    DDManager mgr;
+    for (int i = 0; i < 4; ++i) mgr.new_var();
+
+    BDD f = (mgr.var_bdd(1) & mgr.var_bdd(2)) | (mgr.var_bdd(3) & mgr.var_bdd(4));
+    BDD g = f & mgr.var_bdd(1);
+    ZDD z = ZDD::singleton(mgr, 1) + ZDD::singleton(mgr, 2);
+    (void)g;
+
+    std::vector<OpProfile> report = mgr.profile_report();
+    if (!DDManager::profiling_enabled()) {
+        EXPECT_TRUE(report.empty());
+        return;
+    }
+    bool seen_and = false;
+    bool seen_union = false;
+    for (const OpProfile& p : report) {
+        EXPECT_LE(p.cache_hits, p.calls);
+        if (p.op == CacheOp::AND) {
+            seen_and = true;
+            EXPECT_GT(p.nodes_created, 0u);
+        }
+        if (p.op == CacheOp::UNION) seen_union = true;
+    }
+    EXPECT_TRUE(seen_and);
+    EXPECT_TRUE(seen_union);
+    EXPECT_STREQ(cache_op_name(CacheOp::UNION), "UNION");
+
+    mgr.reset_profile();
+    EXPECT_TRUE(mgr.profile_report().empty());
+
+    // Nodes are counted at insertion, so one AND reports exactly the nodes it
+    // added, and nodes made outside any operation are not attributed
+    mgr.new_var();
+    BDD x5 = mgr.var_bdd(5);
+    std::size_t before = mgr.node_count();
+    BDD h = f & x5;
+    std::size_t added = mgr.node_count() - before;
+    ZDD s = ZDD::singleton(mgr, 5);
+    (void)s;
+    std::uint64_t and_nodes = 0;
+    for (const OpProfile& p : mgr.profile_report()) {
+        if (p.op == CacheOp::AND) and_nodes = p.nodes_created;
+    }
+    EXPECT_GT(added, 0u);
+    EXPECT_EQ(and_nodes, added);
+    (void)h;
+}
+
+TEST(DDManagerTest, MemoryUsage) {
+    DDManager mgr(1024, 256);
+    for (int i = 0; i < 6; ++i) mgr.new_var();
+
+    MemoryUsage base = mgr.memory_usage();
+    // Node slots plus one hash-index bucket per slot
+    EXPECT_EQ(base.node_table, 1024 * (sizeof(DDNode) + sizeof(bddindex)));
+    EXPECT_EQ(base.cache, 256 * sizeof(CacheEntry));
+    EXPECT_EQ(base.zdd_index, 0u);
+    EXPECT_EQ(base.bddct_cache, 0u);
+
+    ZDD f = get_power_set_with_card(mgr, 6, 3);
+    f.build_index();
+    EXPECT_GT(mgr.memory_usage().zdd_index, 0u);
+    f.clear_index();
+    EXPECT_EQ(mgr.memory_usage().zdd_index, 0u);
+
+    {
+        BDDCT ct(mgr);
+        ct.alloc(6, 1);
+        ct.zdd_cost_le(f, 2);
+        EXPECT_GT(mgr.memory_usage().bddct_cache, 0u);
+    }
+    MemoryUsage after = mgr.memory_usage();
+    EXPECT_EQ(after.bddct_cache, 0u);
+    EXPECT_GE(mgr.peak_memory_usage(), after.total() + 1);
+}
+
+TEST(DDManagerTest, TraceRecorder) {
+    DDManager mgr;
+    for (int i = 0; i < 3; ++i) mgr.new_var();
+    BDD x1 = mgr.var_bdd(1);
+    BDD x2 = mgr.var_bdd(2);
+
+    TraceRecorder recorder;
+    mgr.set_trace_recorder(&recorder);
+    BDD f = x1 & x2;
+    ZDD z = ZDD::singleton(mgr, 1) + ZDD::singleton(mgr, 3);
+    mgr.gc();
+    mgr.set_trace_recorder(nullptr);
+    BDD g = x1 | x2;
+    (void)g;
+
+    std::vector<TraceRecorder::Event> events = recorder.events();
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_STREQ(events[0].name, "BDD::and");
+    EXPECT_STREQ(events[1].name, "ZDD::union");
+    EXPECT_STREQ(events[2].name, "gc");
+    EXPECT_GT(events[0].nodes_after, events[0].nodes_before);
+    EXPECT_EQ(events[0].thread, 1u);
+
+    std::ostringstream oss;
+    recorder.write_chrome_trace(oss);
+    std::string json = oss.str();
+    EXPECT_EQ(json.find("{\"traceEvents\":["), 0u);
+    EXPECT_NE(json.find("\"name\":\"BDD::and\",\"cat\":\"bdd\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"nodes_after\":"), std::string::npos);
+
+    recorder.clear();
+    EXPECT_EQ(recorder.event_count(), 0u);
+}
+
+TEST(DDManagerTest, DefaultManagerThreads) {
+    std::vector<DDManager*> seen(8, nullptr);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < seen.size(); ++i) {
+        threads.emplace_back([&seen, i] { seen[i] = &default_manager(); });
+    }
+    for (std::thread& t : threads) t.join();
+    for (DDManager* m : seen) EXPECT_EQ(m, &default_manager());
+}
+
+TEST(DDManagerTest, ScopedManager) {
+    DDManager& global = default_manager();
+    EXPECT_EQ(bound_manager(), nullptr);
+
+    DDManager mgr(1024, 256);
+    {
+        ScopedManager outer(mgr);
+        EXPECT_EQ(&default_manager(), &mgr);
+        {
+            ScopedManager inner(1024, 256);
+            EXPECT_EQ(&default_manager(), &inner.manager());
+            EXPECT_NE(&inner.manager(), &mgr);
+        }
+        EXPECT_EQ(&default_manager(), &mgr);
+
+        // Bindings are per thread
+        DDManager* other = nullptr;
+        std::thread t([&other] { other = &default_manager(); });
+        t.join();
+        EXPECT_EQ(other, &global);
+    }
+    EXPECT_EQ(&default_manager(), &global);
+
+    // Each worker builds in its own manager
+    std::vector<double> counts(4, 0);
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < counts.size(); ++i) {
+        workers.emplace_back([&counts, i] {
+            ScopedManager scope(1 << 12, 1 << 10);
+            DDManager& m = default_manager();
+            for (int v = 0; v < 5; ++v) m.new_var();
+            ZDD f = get_power_set_with_card(m, 5, 2);
+            counts[i] = f.card();
+        });
+    }
+    for (std::thread& t : workers) t.join();
+    for (double c : counts) EXPECT_EQ(c, 10.0);
+}
+
+TEST(DDManagerTest, Fork) {
+    DDManager base(1 << 12, 1 << 10);
+    for (int i = 0; i < 8; ++i) base.new_var();
+    ZDD family = get_power_set_with_card(base, 8, 4);
+    ZDD pair = ZDD::singleton(base, 1) * ZDD::singleton(base, 2);
+    std::size_t base_nodes = base.node_count();
+
+    std::vector<double> cards(4, 0);
+    std::vector<std::size_t> child_nodes(cards.size(), 0);
+    {
+        std::vector<std::unique_ptr<DDManager>> children;
+        for (std::size_t i = 0; i < cards.size(); ++i) {
+            children.push_back(base.fork(1 << 10, 1 << 8));
+        }
+        EXPECT_EQ(base.fork_count(), cards.size());
+        EXPECT_EQ(children[0]->base_manager(), &base);
+
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < cards.size(); ++i) {
+            DDManager* child = children[i].get();
+            workers.emplace_back([&, child, i] {
+                ZDD f = transfer(family, *child);
+                EXPECT_EQ(f.arc(), family.arc());  // shared, not copied
+                bddvar v = static_cast<bddvar>(i + 1);
+                ZDD g = f.onset(v) + ZDD::singleton(*child, v);
+                child->gc();
+                cards[i] = g.card();
+                child_nodes[i] = child->node_count();
+            });
+        }
+        for (std::thread& t : workers) t.join();
+
+        // Nodes already in the base are found there instead of being recreated
+        ZDD again = transfer(pair, *children[0]);
+        ZDD built = ZDD::singleton(*children[0], 1) * ZDD::singleton(*children[0], 2);
+        EXPECT_EQ(built.arc(), again.arc());
+
+        // The base is not swept while forks refer to it
+        EXPECT_FALSE(base.gc());
+        EXPECT_EQ(base.node_count(), base_nodes);
+    }
+    EXPECT_EQ(base.fork_count(), 0u);
+    EXPECT_EQ(base.node_count(), base_nodes);
+    for (std::size_t i = 0; i < cards.size(); ++i) {
+        EXPECT_EQ(cards[i], 35.0 + 1.0);  // C(7,3) sets contain v, plus {v}
+        EXPECT_GT(child_nodes[i], 0u);
+    }
+    EXPECT_EQ(family.card(), 70.0);
+}
+
+// The base keeps growing while a fork is alive; nodes it creates past the
+// fork's view are copied into the fork instead of being shared
+TEST(DDManagerTest, ForkedBaseGrows) {
+    DDManager base(1 << 4, 1 << 4);
+    for (int i = 0; i < 10; ++i) base.new_var();
+    ZDD pair = ZDD::singleton(base, 1) * ZDD::singleton(base, 2);
+    std::size_t size = base.table_size();
+
+    ZDD big;
+    {
+        std::unique_ptr<DDManager> child = base.fork(1 << 4, 1 << 4);
+        EXPECT_EQ(child->base_index_limit(), size);
+        big = get_power_set_with_card(base, 10, 5);
+        EXPECT_GT(base.table_size(), size);
+        EXPECT_EQ(big.card(), 252.0);
+
+        EXPECT_EQ(transfer(pair, *child).arc(), pair.arc());
+        ZDD copied = transfer(big, *child);
+        EXPECT_EQ(copied.manager(), child.get());
+        EXPECT_EQ(copied.card(), 252.0);
+        EXPECT_EQ(copied, get_power_set_with_card(*child, 10, 5));
+        EXPECT_EQ(copied.onset(1).card(), 126.0);
+        EXPECT_EQ(transfer(copied, base), big);
+        EXPECT_FALSE(base.gc());
+    }
+    EXPECT_TRUE(base.gc());
+    EXPECT_EQ(big.card(), 252.0);
+}
+
+// Node creation past the GC threshold used to call gc() with the table
+// lock held and deadlock; it now grows the table and leaves GC to gc()
+TEST(DDManagerTest, NodeCreationPastGCThreshold) {
+    DDManager mgr(1 << 4, 1 << 4);
+    for (int i = 0; i < 12; ++i) mgr.new_var();
+    std::size_t size = mgr.table_size();
+
+    ZDD kept = get_power_set_with_card(mgr, 12, 6);
+    EXPECT_GT(mgr.table_size(), size);
+    EXPECT_GT(mgr.node_count(), size);
+    EXPECT_EQ(kept.card(), 924.0);
+
+    std::uint64_t epoch = mgr.gc_epoch();
+    EXPECT_TRUE(mgr.gc());
+    EXPECT_EQ(mgr.gc_epoch(), epoch + 1);
+    EXPECT_EQ(kept.card(), 924.0);
+    ZDD more = get_power_set_with_card(mgr, 12, 3);
+    EXPECT_EQ(more.card(), 220.0);
+
+    // GC is refused, not silently skipped, while a fork reads the table
+    {
+        std::unique_ptr<DDManager> child = mgr.fork(1 << 4, 1 << 4);
+        EXPECT_FALSE(mgr.gc());
+        EXPECT_EQ(mgr.gc_epoch(), epoch + 1);
+    }
+    EXPECT_TRUE(mgr.gc());
+}
+
 TEST(DDManagerTest, NewVar) {
     DDManager mgr;
 
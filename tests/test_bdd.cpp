@@ -37,6 +37,45 @@ TEST_F(BDDTest, Negation) {
     EXPECT_EQ(x1, ~~x1);
 }
 
+TEST_F(BDDTest, CanonicalForm) {
+    BDD x1 = mgr.var_bdd(1);
+    BDD x2 = mgr.var_bdd(2);
+    BDD x5 = mgr.var_bdd(5);
+
+    // One representation per function, however the negations are placed
+    EXPECT_EQ(x1 & ~x5, ~(~x1 | x5));
+    EXPECT_EQ(~x1 & x2, ~(x1 | ~x2));
+    EXPECT_EQ(x1 ^ x2, ~(x1 ^ ~x2));
+    EXPECT_EQ(~x1.ite(x2, ~x5), x1.ite(~x2, x5));
+
+    // Terminal and negated arcs given directly are normalized the same way
+    Arc t0 = ARC_TERMINAL_0, t1 = ARC_TERMINAL_1;
+    EXPECT_EQ(mgr.get_or_create_node_bdd(1, t0, t1), x1.arc());
+    EXPECT_EQ(mgr.get_or_create_node_bdd(1, t1, t0), (~x1).arc());
+    EXPECT_EQ(mgr.get_or_create_node_bdd(1, t1.negated(), t0.negated()), x1.arc());
+    EXPECT_EQ(mgr.get_or_create_node_bdd(2, x1.arc(), t0), (x1 & ~x2).arc());
+    EXPECT_EQ(mgr.get_or_create_node_bdd(2, (~x1).arc(), x1.arc().negated()), (~x1).arc());
+
+    // Top-down construction agrees with apply
+    bddindex p = mgr.create_placeholder_bdd(5);
+    EXPECT_EQ(mgr.finalize_node_bdd(p, x1.arc(), t0), (x1 & ~x5).arc());
+
+    // No stored node has a negated or terminal-0 1-arc, or a negated terminal
+    BDD f = (x1 & ~x5) | (~x1 & x2) | (x2 ^ x5);
+    std::vector<Arc> stack(1, f.arc());
+    while (!stack.empty()) {
+        Arc a = stack.back();
+        stack.pop_back();
+        if (a.is_constant()) continue;
+        const DDNode& node = mgr.node_at(a.index());
+        EXPECT_FALSE(node.arc1().is_negated());
+        EXPECT_NE(node.arc1(), t0);
+        EXPECT_FALSE(node.arc0().is_constant() && node.arc0().is_negated());
+        stack.push_back(node.arc0());
+        stack.push_back(node.arc1());
+    }
+}
+
 TEST_F(BDDTest, AndOperation) {
     BDD x1 = mgr.var_bdd(1);
     BDD x2 = mgr.var_bdd(2);
@@ -140,6 +179,60 @@ TEST_F(BDDTest, Cofactors) {
     EXPECT_EQ(f.at1(2), x1);
 }
 
+TEST_F(BDDTest, CubeCofactor) {
+    BDD x1 = mgr.var_bdd(1);
+    BDD x2 = mgr.var_bdd(2);
+    BDD x3 = mgr.var_bdd(3);
+    BDD x4 = mgr.var_bdd(4);
+    BDD f = (x1 & x2) | (~x3 & x4) | (x2 ^ x3);
+
+    BDD cube = x1 & ~x3;
+    EXPECT_EQ(f.cofactor(cube), f.restrict(1, true).restrict(3, false));
+    EXPECT_EQ(f.cofactor(mgr.bdd_one()), f);
+
+    // A repeated call is answered from the cache
+    std::size_t hits = mgr.cache_hit_count();
+    f.cofactor(cube);
+    EXPECT_GT(mgr.cache_hit_count(), hits);
+
+    EXPECT_THROW(f.cofactor(x1 | x2), DDArgumentException);
+    EXPECT_THROW(f.cofactor(mgr.bdd_zero()), DDArgumentException);
+}
+
+TEST_F(BDDTest, Approximation) {
+    for (int i = 0; i < 11; ++i) mgr.new_var();
+    // x1 x2 + x3 x4 + ... with mixed polarities: many nodes, complement edges
+    BDD f = mgr.bdd_zero();
+    for (bddvar v = 1; v + 1 <= 16; v += 2) {
+        BDD a = mgr.var_bdd(v);
+        BDD b = (v % 4 == 1) ? ~mgr.var_bdd(v + 1) : mgr.var_bdd(v + 1);
+        f = (v % 3 == 0) ? f ^ (a & b) : f | (a & b);
+    }
+    std::size_t n = f.size();
+    ASSERT_GT(n, 8u);
+
+    EXPECT_EQ(f.under_approx(n), f);
+    EXPECT_EQ(f.subset_heavy_branch(n + 1), f);
+
+    for (std::size_t t : {n - 1, n / 2, static_cast<std::size_t>(3), static_cast<std::size_t>(0)}) {
+        BDD subsets[] = {f.under_approx(t), f.subset_heavy_branch(t), f.subset_short_paths(t)};
+        for (const BDD& u : subsets) {
+            EXPECT_LE(u.size(), t);
+            EXPECT_TRUE((u & ~f).is_zero());
+        }
+        BDD supersets[] = {f.over_approx(t), f.superset_heavy_branch(t),
+                           f.superset_short_paths(t)};
+        for (const BDD& o : supersets) {
+            EXPECT_LE(o.size(), t);
+            EXPECT_TRUE((f & ~o).is_zero());
+        }
+    }
+
+    // A small cut keeps most of the assignments
+    EXPECT_GT(f.under_approx(n - 1).card(), 0.5 * f.card());
+    EXPECT_GT(f.subset_heavy_branch(n - 1).card(), 0.0);
+}
+
 TEST_F(BDDTest, Quantification) {
     BDD x1 = mgr.var_bdd(1);
     BDD x2 = mgr.var_bdd(2);
@@ -152,6 +245,81 @@ TEST_F(BDDTest, Quantification) {
     EXPECT_TRUE(f.forall(1).is_zero());
 }
 
+TEST_F(BDDTest, AndExist) {
+    BDD x1 = mgr.var_bdd(1);
+    BDD x2 = mgr.var_bdd(2);
+    BDD x3 = mgr.var_bdd(3);
+    BDD x4 = mgr.var_bdd(4);
+    BDD x5 = mgr.var_bdd(5);
+    BDD f = (x1 & ~x2) | (x3 ^ x5);
+    BDD g = (x2 | x4) & ~(x1 & x3);
+
+    std::vector<std::vector<bddvar> > var_sets = {{}, {1}, {2, 4}, {5, 1, 3}, {1, 2, 3, 4, 5}};
+    for (const auto& vars : var_sets) {
+        EXPECT_EQ(f.and_exist(g, vars), (f & g).exist(vars));
+        EXPECT_EQ(g.and_exist(f, vars), (f & g).exist(vars));
+        EXPECT_EQ(f.and_exist(f, vars), f.exist(vars));
+        EXPECT_EQ(f.and_exist(mgr.bdd_one(), vars), f.exist(vars));
+    }
+    EXPECT_TRUE(f.and_exist(~f, {1}).is_zero());
+    EXPECT_THROW(f.and_exist(g, {0}), DDArgumentException);
+}
+
+// Arcs to nodes 0 and 1 sort below the terminal arcs; the constant operand
+// must still be the one treated as constant
+TEST(BDDAndExistTest, LowNodeIndices) {
+    DDManager mgr(1);
+    for (int i = 0; i < 3; ++i) mgr.new_var();
+    BDD x1 = mgr.var_bdd(1);
+    ASSERT_EQ(x1.arc().index(), 0u);
+    BDD x2 = mgr.var_bdd(2);
+    BDD one = mgr.bdd_one();
+
+    for (const BDD& f : {x1, ~x1, x2, ~x2, x1 & x2}) {
+        EXPECT_EQ(f.and_exist(one, {1}), f.exist({1}));
+        EXPECT_EQ(one.and_exist(f, {1}), f.exist({1}));
+        EXPECT_EQ(f.and_exist(one, {3}), f);
+        EXPECT_EQ(f.and_exist(x2, {1}), (f & x2).exist({1}));
+    }
+}
+
+TEST_F(BDDTest, Constrain) {
+    BDD x1 = mgr.var_bdd(1);
+    BDD x2 = mgr.var_bdd(2);
+    BDD x3 = mgr.var_bdd(3);
+    BDD x4 = mgr.var_bdd(4);
+    BDD f = (x1 & x2) | (~x3 & x4) | (x2 ^ x4);
+
+    BDD cares[] = {x1, ~x3 & x2, x1 | x4, (x1 ^ x3) & x2, f, ~f, mgr.bdd_one()};
+    for (const BDD& c : cares) {
+        BDD r = f.constrain(c);
+        EXPECT_EQ(r & c, f & c);
+    }
+    // On a cube, constrain coincides with the cofactor
+    EXPECT_EQ(f.constrain(x1 & ~x3), f.cofactor(x1 & ~x3));
+    EXPECT_TRUE(f.constrain(mgr.bdd_zero()).is_zero());
+    EXPECT_TRUE(f.constrain(f).is_one());
+}
+
+TEST_F(BDDTest, Permute) {
+    BDD x1 = mgr.var_bdd(1);
+    BDD x2 = mgr.var_bdd(2);
+    BDD x3 = mgr.var_bdd(3);
+    BDD x4 = mgr.var_bdd(4);
+    BDD x5 = mgr.var_bdd(5);
+    BDD f = (x1 & ~x2) | (x3 ^ x4);
+
+    // Swap x1 <-> x5 and x2 <-> x3
+    std::vector<bddvar> perm = {0, 5, 3, 2, 4, 1};
+    BDD expected = (x5 & ~x3) | (x2 ^ x4);
+    EXPECT_EQ(f.permute(perm), expected);
+    EXPECT_EQ(f.permute(perm).permute(perm), f);
+    EXPECT_EQ((~f).permute(perm), ~expected);
+    // Variables past the end of perm are kept
+    EXPECT_EQ(f.permute({0, 1, 3, 2}), (x1 & ~x3) | (x2 ^ x4));
+    EXPECT_THROW(f.permute({0, 6}), DDArgumentException);
+}
+
 TEST_F(BDDTest, Size) {
     BDD x1 = mgr.var_bdd(1);
     BDD x2 = mgr.var_bdd(2);
@@ -216,6 +384,35 @@ TEST_F(BDDTest, LowHigh) {
 }
 
 #if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
+TEST_F(BDDTest, PBConstraint) {
+    std::vector<bddvar> vars = {1, 2, 3, 4, 5};
+    std::vector<long long> weights = {3, -2, 4, 1, -5};
+    for (long long bound = -8; bound <= 9; ++bound) {
+        for (PBRelation rel : {PBRelation::LE, PBRelation::GE, PBRelation::EQ}) {
+            BDD f = pb_bdd(mgr, vars, weights, rel, bound);
+            EXPECT_EQ(ZDD::from_bdd(f), pb_zdd(mgr, vars, weights, rel, bound));
+        }
+    }
+
+    // Variables outside the constraint are don't-cares
+    std::vector<bddvar> sub = {2, 4};
+    BDD f = pb_bdd(mgr, sub, std::vector<long long>{2, 3}, PBRelation::LE, 3);
+    EXPECT_EQ(f, ~(mgr.var_bdd(2) & mgr.var_bdd(4)));
+
+    // Cardinality: x1 + ... + x5 <= 2 and == 2
+    for (int k = -1; k <= 6; ++k) {
+        BDD at_most = at_most_k_bdd(mgr, vars, k);
+        BDD exactly = exactly_k_bdd(mgr, vars, k);
+        EXPECT_EQ(at_most, pb_bdd(mgr, vars, std::vector<long long>(5, 1), PBRelation::LE, k));
+        EXPECT_EQ(ZDD::from_bdd(exactly), get_power_set_with_card(mgr, vars, k));
+        if (k >= 0) {
+            EXPECT_EQ(at_most & ~at_most_k_bdd(mgr, vars, k - 1), exactly);
+        }
+    }
+    EXPECT_TRUE(at_most_k_bdd(mgr, vars, 5).is_one());
+    EXPECT_TRUE(exactly_k_bdd(mgr, vars, 6).is_zero());
+}
+
 TEST(BDDExactCountTest, MatchesCard) {
     DDManager mgr;
 
@@ -271,3 +468,38 @@ TEST(BDDExactCountTest, LargeCount) {
     EXPECT_EQ(x1.exact_count(), exact_str);
 }
 #endif
+
+// Deep BDDs (long variable chains) must not overflow the call stack
+TEST(BDDDeepTest, LongChains) {
+    const bddvar n = 100000;
+    DDManager mgr(1 << 21);
+    for (bddvar i = 0; i < n; ++i) {
+        mgr.new_var();
+    }
+
+    BDD all = BDD::one(mgr);
+    BDD any = BDD::zero(mgr);
+    for (bddvar v = 1; v <= n; ++v) {
+        all = all & mgr.var_bdd(v);
+        any = any | mgr.var_bdd(v);
+    }
+
+    EXPECT_EQ(all & any, all);
+    EXPECT_EQ(all | any, any);
+    EXPECT_EQ((all ^ any) & all, BDD::zero(mgr));
+    EXPECT_EQ(all.ite(any, BDD::zero(mgr)), all);
+
+    // x1 = 1 leaves the conjunction of x2..xn
+    BDD rest = all.restrict(1, true);
+    EXPECT_EQ(rest & mgr.var_bdd(1), all);
+    EXPECT_EQ(all.restrict(1, false), BDD::zero(mgr));
+
+    // Substituting x2 := x1 just drops x2 from the conjunction
+    EXPECT_EQ(all.compose(2, mgr.var_bdd(1)), all.restrict(2, true));
+
+    EXPECT_DOUBLE_EQ(all.card(), 1.0);
+    EXPECT_DOUBLE_EQ(rest.count(n), 2.0);
+
+    mgr.gc();
+    EXPECT_EQ(all & any, all);
+}
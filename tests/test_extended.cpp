@@ -3,6 +3,7 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <random>
 #include <sstream>
 #include "sbdd2/sbdd2.hpp"
 
@@ -168,6 +169,140 @@ TEST_F(QDDTest, ToZDD) {
     EXPECT_EQ(zdd, ZDD::singleton(mgr, 1));
 }
 
+// ============== ChainZDD Tests ==============
+
+class ChainZDDTest : public ::testing::Test {
+protected:
+    DDManager mgr;
+
+    void SetUp() override {
+        for (int i = 0; i < 12; ++i) {
+            mgr.new_var();
+        }
+    }
+
+    // Single set {lo, lo+1, ..., hi}
+    ZDD run(bddvar lo, bddvar hi) {
+        ZDD s = ZDD::single(mgr);
+        for (bddvar v = lo; v <= hi; ++v) s = s.join(ZDD::singleton(mgr, v));
+        return s;
+    }
+};
+
+TEST_F(ChainZDDTest, CompressesRuns) {
+    ZDD f = run(1, 10) + run(3, 12) + run(5, 6);
+    ChainZDD c(f);
+
+    EXPECT_LT(c.size(), f.size());
+    EXPECT_EQ(c.card(), f.card());
+    EXPECT_EQ(c.to_zdd(), f);
+    EXPECT_EQ(c.support(), f.support());
+    EXPECT_EQ(ChainZDD(c.to_zdd()), c);
+
+    EXPECT_EQ(ChainZDD(ZDD::empty(mgr)), ChainZDD::empty(mgr));
+    EXPECT_EQ(ChainZDD(ZDD::single(mgr)), ChainZDD::single(mgr));
+}
+
+TEST_F(ChainZDDTest, SetOperations) {
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<bddvar> pick(1, 12);
+    for (int trial = 0; trial < 20; ++trial) {
+        ZDD f = ZDD::empty(mgr);
+        ZDD g = ZDD::empty(mgr);
+        for (int i = 0; i < 4; ++i) {
+            bddvar a = pick(rng), b = pick(rng);
+            f += run(std::min(a, b), std::max(a, b));
+            a = pick(rng);
+            b = pick(rng);
+            g += run(std::min(a, b), std::max(a, b));
+        }
+        if (trial % 3 == 0) f += ZDD::single(mgr);
+        ChainZDD cf(f), cg(g);
+
+        EXPECT_EQ((cf + cg).to_zdd(), f + g);
+        EXPECT_EQ((cf & cg).to_zdd(), f & g);
+        EXPECT_EQ((cf - cg).to_zdd(), f - g);
+        EXPECT_EQ((cg - cf).to_zdd(), g - f);
+        // Results stay canonical
+        EXPECT_EQ(cf + cg, ChainZDD(f + g));
+        EXPECT_EQ(cf - cg, ChainZDD(f - g));
+        EXPECT_EQ((cf + cg).card(), (f + g).card());
+    }
+
+    DDManager other;
+    other.new_var();
+    EXPECT_THROW(ChainZDD(run(1, 3)) + ChainZDD::single(other), DDIncompatibleException);
+}
+
+TEST_F(ChainZDDTest, ChainHeadsAreNotZDDNodes) {
+    ChainZDD c(run(2, 9));
+    const DDNode& head = mgr.node_at(c.arc().index());
+    ASSERT_TRUE(head.is_chain_head());
+    EXPECT_FALSE(mgr.node_at(run(2, 9).arc().index()).is_chain_head());
+
+    // Generic utilities either understand the chain or refuse it
+    const DDBase& base = c;
+    EXPECT_EQ(base.support(), run(2, 9).support());
+    EXPECT_EQ(c.size(), 2u);
+    EXPECT_TRUE(c.ref().child0().is_terminal_zero());
+    EXPECT_THROW(c.ref().child1(), DDArgumentException);
+
+    ZDD as_zdd(&mgr, c.arc());
+    std::stringstream ss;
+    EXPECT_FALSE(validate_zdd(as_zdd));
+    EXPECT_FALSE(export_zdd(as_zdd, ss));
+    EXPECT_THROW(to_dot(as_zdd), DDArgumentException);
+    EXPECT_THROW(mgr.get_or_create_node_zdd(3, ARC_TERMINAL_0, head.arc1()),
+                 DDArgumentException);
+
+    // A ZDD file cannot smuggle a negated arc into the table
+    ss.str("");
+    ASSERT_TRUE(export_zdd(run(2, 9), ss));
+    std::string bytes = ss.str();
+    bytes[bytes.size() - 8] |= 1;
+    std::istringstream tampered(bytes);
+    EXPECT_FALSE(import_zdd(mgr, tampered).is_valid());
+
+    // GC follows the tagged arc to the tail
+    c += ChainZDD(run(5, 6));
+    mgr.gc();
+    EXPECT_EQ(c.to_zdd(), run(2, 9) + run(5, 6));
+}
+
+// Long runs and long paths of single levels must not overflow the call stack
+TEST(ChainZDDDeepTest, LongChains) {
+    const bddvar n = 300000;
+    DDManager mgr(1 << 21);
+    for (bddvar i = 0; i < n; ++i) {
+        mgr.new_var();
+    }
+
+    // {{1, ..., n}, {1}}: the run becomes one chain node
+    ZDD all = ZDD::single(mgr);
+    for (bddvar v = 1; v <= n; ++v) {
+        all = all.change(v);
+    }
+    ZDD f = all + ZDD::singleton(mgr, 1);
+    ChainZDD cf(f);
+    EXPECT_DOUBLE_EQ(cf.card(), 2.0);
+    EXPECT_EQ(cf.to_zdd(), f);
+
+    // Sets of every other variable have no runs to compress
+    ZDD odd = ZDD::single(mgr);
+    ZDD even = ZDD::single(mgr);
+    for (bddvar v = 1; v <= n; ++v) {
+        if (v % 2) odd = odd.change(v); else even = even.change(v);
+    }
+    ChainZDD co(odd), ce(even);
+    ChainZDD u = co + ce;
+    EXPECT_DOUBLE_EQ(u.card(), 2.0);
+    EXPECT_EQ(u.to_zdd(), odd + even);
+    EXPECT_EQ(u & co, co);
+    EXPECT_EQ(u - co, ce);
+    EXPECT_EQ((u + cf).to_zdd(), odd + even + f);
+    EXPECT_EQ((cf - u).to_zdd(), f);
+}
+
 // ============== SeqBDD Tests ==============
 
 class SeqBDDTest : public ::testing::Test {
@@ -273,6 +408,116 @@ TEST_F(BDDCTTest, MaxCost) {
     EXPECT_EQ(max, 7);  // {3} has maximum cost
 }
 
+TEST_F(BDDCTTest, CostLeMatchesBruteForce) {
+    BDDCT ct(mgr);
+    ct.alloc(5, 1);
+    const bddcost costs[] = {0, 4, 1, 3, 2, 5};
+    for (int v = 1; v <= 5; ++v) ct.set_cost(v, costs[v]);
+
+    // All subsets of {1..5}
+    ZDD all = ZDD::single(mgr);
+    for (bddvar v = 1; v <= 5; ++v) all = all + all.change(v);
+
+    for (bddcost bound = -1; bound <= 16; ++bound) {
+        bddcost aw, rb;
+        ZDD le = ct.zdd_cost_le(all, bound, aw, rb);
+
+        double expected = 0;
+        bddcost kept_max = -BDDCOST_NULL, dropped_min = BDDCOST_NULL;
+        for (const auto& s : all.enumerate()) {
+            bddcost sum = 0;
+            for (bddvar v : s) sum += costs[v];
+            if (sum <= bound) {
+                ++expected;
+                kept_max = std::max(kept_max, sum);
+            } else {
+                dropped_min = std::min(dropped_min, sum);
+            }
+        }
+        EXPECT_EQ(le.card(), expected);
+        EXPECT_EQ(aw, kept_max);
+        EXPECT_EQ(rb, dropped_min);
+        EXPECT_EQ(ct.zdd_cost_le0(all, bound), le);
+        if (le.card() > 0) {
+            EXPECT_LE(ct.max_cost(le), bound);
+        }
+    }
+    EXPECT_EQ(ct.min_cost(all), 0);
+    EXPECT_EQ(ct.max_cost(all), 15);
+
+    // Changing a cost invalidates the cached results
+    ct.set_cost(5, 0);
+    EXPECT_EQ(ct.max_cost(all), 10);
+    EXPECT_EQ(ct.zdd_cost_le(all, 0).card(), 2.0);
+}
+
+TEST_F(BDDCTTest, BoundSweepReusesIntervals) {
+    DDManager big(1 << 16);
+    for (int i = 0; i < 16; ++i) big.new_var();
+    BDDCT ct(big);
+    ct.alloc(16, 1);
+    for (int v = 1; v <= 16; ++v) ct.set_cost(v, v);
+
+    ZDD all = ZDD::single(big);
+    for (bddvar v = 1; v <= 16; ++v) all = all + all.change(v);
+
+    // Reference counts, computed with a fresh table per bound
+    std::vector<double> expected;
+    for (bddcost bound = 0; bound <= 136; ++bound) {
+        BDDCT fresh(big);
+        fresh.alloc(16, 1);
+        for (int v = 1; v <= 16; ++v) fresh.set_cost(v, v);
+        expected.push_back(fresh.zdd_cost_le(all, bound).card());
+    }
+
+    for (bddcost bound = 0; bound <= 136; ++bound) {
+        EXPECT_EQ(ct.zdd_cost_le(all, bound).card(), expected[bound]);
+    }
+    // A second sweep is answered from the interval cache at the root
+    for (bddcost bound = 136; bound >= 0; --bound) {
+        bddcost aw, rb;
+        ZDD le = ct.zdd_cost_le(all, bound, aw, rb);
+        EXPECT_EQ(le.card(), expected[bound]);
+        EXPECT_LE(aw, bound);
+        EXPECT_GT(rb, bound);
+    }
+
+    // Cached arcs are dropped after a GC
+    big.gc();
+    EXPECT_EQ(ct.zdd_cost_le(all, 10).card(), expected[10]);
+}
+
+TEST_F(BDDCTTest, DeepChainAndSaturatedCosts) {
+    // {{1}, {2}, ..., {n}} is a chain of n nodes along the 0-arcs
+    const int n = 200000;
+    DDManager deep(1 << 18);
+    for (int i = 0; i < n; ++i) deep.new_var();
+    Arc chain = ARC_TERMINAL_0;
+    for (int v = 1; v <= n; ++v) {
+        chain = deep.get_or_create_node_zdd(v, chain, ARC_TERMINAL_1);
+    }
+    ZDD f(&deep, chain);
+    BDDCT ct(deep);
+    ct.alloc(n, 1);
+    ct.set_cost(1, 5);
+    // Room for every node, so min/max costs are not recomputed per node
+    for (int i = 0; i < 10; ++i) ct.cache0_enlarge();
+    EXPECT_EQ(ct.min_cost(f), 1);
+    EXPECT_EQ(ct.max_cost(f), 5);
+    // Only {1} is dropped, which is decided at the bottom of the chain
+    EXPECT_EQ(ct.zdd_cost_le(f, 1).card(), n - 1);
+
+    // Sums past BDDCOST_NULL saturate instead of wrapping
+    BDDCT big(mgr);
+    big.alloc(2, 1);
+    big.set_cost(1, BDDCOST_NULL - 10);
+    big.set_cost(2, BDDCOST_NULL - 10);
+    ZDD both = ZDD::singleton(mgr, 1).change(2);
+    EXPECT_EQ(big.max_cost(both), BDDCOST_NULL - 1);
+    EXPECT_EQ(big.min_cost(both), BDDCOST_NULL - 1);
+    EXPECT_EQ(big.zdd_cost_le(both, BDDCOST_NULL - 10).card(), 0.0);
+}
+
 // ============== IO Tests ==============
 
 class IOTest : public ::testing::Test {
@@ -347,6 +592,92 @@ TEST_F(IOTest, ExportImportZDD) {
     EXPECT_TRUE(imported.is_valid());
 }
 
+TEST(IORoundTripTest, LargeDiagrams) {
+    const int n = 24;
+    DDManager mgr;
+    DDManager mgr2;
+    for (int i = 0; i < n; ++i) {
+        mgr.new_var();
+        mgr2.new_var();
+    }
+
+    std::mt19937 rng(7);
+    BDD f = mgr.bdd_zero();
+    ZDD z = mgr.zdd_empty();
+    for (int k = 0; k < 200; ++k) {
+        BDD cube = mgr.bdd_one();
+        std::vector<bddvar> set;
+        for (bddvar v = 1; v <= static_cast<bddvar>(n); ++v) {
+            switch (rng() % 3) {
+            case 0: cube = cube & mgr.var_bdd(v); set.push_back(v); break;
+            case 1: cube = cube & ~mgr.var_bdd(v); break;
+            default: break;
+            }
+        }
+        f = f | cube;
+        z = z + mgr.zdd_base().change(set);
+    }
+
+    ExportOptions opts;
+    opts.format = DDFileFormat::BINARY;
+
+    std::stringstream bdd_out;
+    ASSERT_TRUE(export_bdd(f, bdd_out, opts));
+    BDD f2 = import_bdd(mgr2, bdd_out);
+    ASSERT_TRUE(f2.is_valid());
+    EXPECT_EQ(f2.exact_count(), f.exact_count());
+    std::stringstream bdd_back;
+    ASSERT_TRUE(export_bdd(f2, bdd_back, opts));
+    EXPECT_EQ(import_bdd(mgr, bdd_back), f);
+
+    std::stringstream zdd_out;
+    ASSERT_TRUE(export_zdd(z, zdd_out, opts));
+    ZDD z2 = import_zdd(mgr2, zdd_out);
+    ASSERT_TRUE(z2.is_valid());
+    EXPECT_EQ(z2.exact_count(), z.exact_count());
+    std::stringstream zdd_back;
+    ASSERT_TRUE(export_zdd(z2, zdd_back, opts));
+    EXPECT_EQ(import_zdd(mgr, zdd_back), z);
+}
+
+// Export writes children before parents, whatever their table indices:
+// a parent placed in a slot freed by GC sits below its child, and import
+// resolves arcs in file order
+TEST(IORoundTripTest, ParentInReusedSlot) {
+    DDManager mgr;
+    DDManager mgr2;
+    for (int i = 0; i < 4; ++i) {
+        mgr.new_var();
+        mgr2.new_var();
+    }
+    BDD x3 = mgr.var_bdd(3);
+    BDD x4 = mgr.var_bdd(4);
+    Arc dead = (x3 & x4).arc();
+    BDD x1 = mgr.var_bdd(1);
+    BDD x2 = mgr.var_bdd(2);
+    // Drop the reference the node got at creation, so GC frees its slot
+    mgr.dec_ref(dead);
+    ASSERT_TRUE(mgr.gc());
+
+    BDD f = x2 & x1;
+    ASSERT_EQ(f.arc().index(), dead.index());
+    ASSERT_LT(f.arc().index(), x1.arc().index());
+
+    ExportOptions opts;
+    opts.format = DDFileFormat::BINARY;
+    std::stringstream bdd_out;
+    ASSERT_TRUE(export_bdd(f, bdd_out, opts));
+    std::string bytes = bdd_out.str();
+    BDD g = import_bdd(mgr2, bdd_out);
+    EXPECT_EQ(g, mgr2.var_bdd(2) & mgr2.var_bdd(1));
+
+    // Swapping the two 20-byte node records after the 16-byte header puts
+    // the parent first; import rejects the forward reference
+    std::swap_ranges(bytes.begin() + 16, bytes.begin() + 36, bytes.begin() + 36);
+    std::stringstream broken(bytes);
+    EXPECT_FALSE(import_bdd(mgr2, broken).is_valid());
+}
+
 TEST_F(IOTest, Validation) {
     BDD x1 = mgr.var_bdd(1);
     ZDD s1 = ZDD::singleton(mgr, 1);
@@ -359,3 +690,245 @@ TEST_F(IOTest, Validation) {
     EXPECT_FALSE(validate_bdd(invalid));
     EXPECT_FALSE(validate_zdd(invalid_z));
 }
+
+// ============== Transfer Tests ==============
+
+TEST(TransferTest, SameOrder) {
+    DDManager src;
+    for (int i = 0; i < 6; ++i) src.new_var();
+    ZDD f = get_power_set_with_card(src, 6, 3);
+    BDD g = (src.var_bdd(1) & ~src.var_bdd(3)) | src.var_bdd(6);
+
+    DDManager dst;
+    ZDD f2 = transfer(f, dst);
+    BDD g2 = transfer(g, dst);
+    EXPECT_EQ(f2.manager(), &dst);
+    EXPECT_EQ(dst.var_count(), 6u);
+    EXPECT_EQ(f2.card(), f.card());
+    EXPECT_EQ(f2.size(), f.size());
+    EXPECT_EQ(f2, get_power_set_with_card(dst, 6, 3));
+    EXPECT_EQ(g2, (dst.var_bdd(1) & ~dst.var_bdd(3)) | dst.var_bdd(6));
+
+    // Terminals and invalid DDs pass through
+    EXPECT_TRUE(transfer(ZDD::single(src), dst).is_one());
+    EXPECT_FALSE(transfer(ZDD(), dst).is_valid());
+}
+
+TEST(TransferTest, DifferentOrder) {
+    DDManager src;
+    for (int i = 0; i < 5; ++i) src.new_var();
+    DDManager dst;
+    for (int i = 0; i < 5; ++i) dst.new_var_of_lev(1);  // reversed order
+    EXPECT_EQ(dst.lev_of_var(1), 5u);
+
+    ZDD f = ZDD::singleton(src, 1) * ZDD::singleton(src, 4) + ZDD::singleton(src, 2)
+          + ZDD::single(src);
+    BDD g = (src.var_bdd(1) ^ src.var_bdd(2)) & ~src.var_bdd(5);
+
+    ZDD f2 = transfer(f, dst);
+    BDD g2 = transfer(g, dst);
+    EXPECT_EQ(f2.card(), f.card());
+    EXPECT_EQ(f2, ZDD::singleton(dst, 1) * ZDD::singleton(dst, 4) + ZDD::singleton(dst, 2)
+                  + ZDD::single(dst));
+    EXPECT_EQ(g2, (dst.var_bdd(1) ^ dst.var_bdd(2)) & ~dst.var_bdd(5));
+
+    // Round trip restores the canonical original
+    EXPECT_EQ(transfer(f2, src), f);
+    EXPECT_EQ(transfer(g2, src), g);
+}
+
+TEST(TransferTest, BatchSharingAndParallel) {
+    const int n = 12;
+    DDManager src;
+    for (int i = 0; i < n; ++i) src.new_var();
+
+    // 2048 distinct sets sharing the top variable: wide enough to split a level
+    std::vector<ZDD> fs;
+    for (int mask = 0; mask < (1 << (n - 1)); ++mask) {
+        ZDD s = ZDD::singleton(src, n);
+        for (int v = 1; v < n; ++v) {
+            if (mask & (1 << (v - 1))) s = s * ZDD::singleton(src, v);
+        }
+        fs.push_back(s);
+    }
+    fs.push_back(fs[0] + fs[1]);
+    fs.push_back(ZDD());
+
+    DDManager seq_dst;
+    DDManager par_dst;
+    std::vector<ZDD> seq = transfer(fs, seq_dst);
+    std::vector<ZDD> par = transfer(fs, par_dst, true);
+    ASSERT_EQ(seq.size(), fs.size());
+    ASSERT_EQ(par.size(), fs.size());
+    for (std::size_t i = 0; i + 1 < fs.size(); ++i) {
+        EXPECT_EQ(seq[i].card(), 1.0 + (i + 2 == fs.size() ? 1.0 : 0.0));
+        EXPECT_EQ(transfer(seq[i], src), fs[i]);
+        EXPECT_EQ(transfer(par[i], src), fs[i]);
+    }
+    EXPECT_FALSE(seq.back().is_valid());
+    EXPECT_EQ(seq_dst.node_count(), par_dst.node_count());
+
+    DDManager other;
+    other.new_var();
+    std::vector<ZDD> mixed = {ZDD::singleton(src, 1), ZDD::singleton(other, 1)};
+    EXPECT_THROW(transfer(mixed, seq_dst), DDIncompatibleException);
+}
+
+// Three-bit counter x (current) -> y (next) with enable input e:
+// y = e ? x + 1 : x, one part per bit.
+class ReachabilityTest : public ::testing::Test {
+protected:
+    DDManager mgr;
+    std::vector<bddvar> cur, next;
+    std::vector<BDD> parts;
+    bddvar e;
+
+    void SetUp() override {
+        for (int i = 0; i < 3; ++i) {
+            cur.push_back(mgr.new_var());
+            next.push_back(mgr.new_var());
+        }
+        e = mgr.new_var();
+        BDD carry = mgr.var_bdd(e);
+        for (int i = 0; i < 3; ++i) {
+            BDD x = mgr.var_bdd(cur[i]);
+            BDD y = mgr.var_bdd(next[i]);
+            parts.push_back(~(y ^ (x ^ carry)));
+            carry = carry & x;
+        }
+    }
+
+    BDD state(int value) {
+        BDD s = mgr.bdd_one();
+        for (int i = 0; i < 3; ++i) {
+            BDD x = mgr.var_bdd(cur[i]);
+            s &= ((value >> i) & 1) ? x : ~x;
+        }
+        return s;
+    }
+
+    // Image through the monolithic relation
+    BDD monolithic_image(const BDD& s) {
+        BDD t = mgr.bdd_one();
+        for (const BDD& p : parts) t &= p;
+        std::vector<bddvar> q = cur;
+        q.push_back(e);
+        std::vector<bddvar> perm(mgr.var_count() + 1);
+        for (bddvar v = 0; v <= mgr.var_count(); ++v) perm[v] = v;
+        for (int i = 0; i < 3; ++i) perm[next[i]] = cur[i];
+        return (s & t).exist(q).permute(perm);
+    }
+};
+
+TEST_F(ReachabilityTest, ImageMatchesMonolithic) {
+    for (std::size_t limit : {static_cast<std::size_t>(0), static_cast<std::size_t>(1000)}) {
+        TransitionRelation tr(parts, cur, next, limit);
+        EXPECT_EQ(tr.cluster_count(), limit == 0 ? 3u : 1u);
+        BDD sets[] = {state(0), state(3) | state(6), state(7), mgr.bdd_one(), mgr.bdd_zero()};
+        for (const BDD& s : sets) {
+            EXPECT_EQ(tr.image(s), monolithic_image(s));
+        }
+        EXPECT_EQ(tr.image(state(7)), state(7) | state(0));
+        EXPECT_EQ(tr.preimage(state(0)), state(0) | state(7));
+        EXPECT_EQ(tr.preimage(state(5)), state(5) | state(4));
+    }
+}
+
+TEST_F(ReachabilityTest, Fixpoint) {
+    TransitionRelation tr(parts, cur, next, 0);
+    BDD all = mgr.bdd_one().exist(next).exist(std::vector<bddvar>{e});
+    EXPECT_EQ(tr.reachable(state(2)), all);
+    EXPECT_EQ(tr.reachable(state(2), 2), state(2) | state(3) | state(4));
+    EXPECT_EQ(tr.backward_reachable(state(2), 1), state(2) | state(1));
+    EXPECT_EQ(tr.backward_reachable(state(2)), all);
+
+    // Without the enable input the counter is stuck
+    std::vector<BDD> frozen = parts;
+    frozen.push_back(~mgr.var_bdd(e));
+    TransitionRelation stuck(frozen, cur, next);
+    EXPECT_EQ(stuck.reachable(state(5)), state(5));
+
+    EXPECT_THROW(TransitionRelation(std::vector<BDD>(), cur, next), DDArgumentException);
+    EXPECT_THROW(TransitionRelation(parts, cur, std::vector<bddvar>{next[0]}), DDArgumentException);
+    EXPECT_THROW(TransitionRelation(parts, cur, cur), DDArgumentException);
+}
+
+// x_i and y_i paired: (x1 & y1) | ... | (x6 & y6). Numbering all x before
+// all y gives an exponential BDD, pairing them gives a linear one.
+TEST(OrderingTest, HeuristicsPairVariables) {
+    const bddvar half = 6, n = 2 * half;
+    ordering::Hypergraph edges;
+    for (bddvar i = 1; i <= half; ++i) edges.push_back({i, i + half});
+    // A chain through the pairs so that the graph is connected
+    for (bddvar i = 1; i < half; ++i) edges.push_back({i + half, i + 1});
+
+    auto bdd_size = [&](const std::vector<bddvar>& order) {
+        DDManager mgr;
+        if (order.empty()) {
+            for (bddvar v = 1; v <= n; ++v) mgr.new_var();
+        } else {
+            ordering::apply(mgr, order);
+        }
+        BDD f = mgr.bdd_zero();
+        for (bddvar i = 1; i <= half; ++i) f |= mgr.var_bdd(i) & mgr.var_bdd(i + half);
+        return f.size();
+    };
+    std::size_t file_order = bdd_size(std::vector<bddvar>());
+
+    std::vector<bddvar> identity;
+    for (bddvar v = 1; v <= n; ++v) identity.push_back(v);
+    std::vector<std::vector<bddvar> > orders = {
+        ordering::dfs(n, edges), ordering::bfs(n, edges),
+        ordering::force(n, edges), ordering::force(n, edges, ordering::dfs(n, edges)),
+        ordering::mince(n, edges)};
+    for (const auto& order : orders) {
+        std::vector<bddvar> sorted = order;
+        std::sort(sorted.begin(), sorted.end());
+        EXPECT_EQ(sorted, identity);
+        EXPECT_LE(ordering::total_span(order, edges), ordering::total_span(identity, edges));
+        EXPECT_LT(bdd_size(order), file_order);
+    }
+    EXPECT_EQ(bdd_size(ordering::dfs(n, edges)), 2 * half);
+}
+
+TEST(OrderingTest, ApplyAndClauses) {
+    ordering::Hypergraph edges = ordering::from_clauses({{1, -3}, {-2, 3, -3}, {4}});
+    ASSERT_EQ(edges.size(), 3u);
+    EXPECT_EQ(edges[1], (std::vector<bddvar>{2, 3}));
+    EXPECT_EQ(ordering::dfs(5, edges), (std::vector<bddvar>{1, 3, 2, 4, 5}));
+    EXPECT_EQ(ordering::bfs(5, edges), (std::vector<bddvar>{1, 3, 2, 4, 5}));
+
+    DDManager mgr;
+    mgr.new_var();
+    std::vector<bddvar> order = {3, 1, 4, 2};
+    ordering::apply(mgr, order);
+    ASSERT_EQ(mgr.var_count(), 5u);
+    EXPECT_EQ(mgr.lev_of_var(1), 1u);
+    EXPECT_EQ(mgr.lev_of_var(1 + 3), 5u);
+    EXPECT_EQ(mgr.lev_of_var(1 + 1), 4u);
+    EXPECT_EQ(mgr.lev_of_var(1 + 4), 3u);
+    EXPECT_EQ(mgr.lev_of_var(1 + 2), 2u);
+
+    std::vector<bddvar> big(1000);
+    for (bddvar i = 0; i < big.size(); ++i) big[i] = i + 1;
+    std::shuffle(big.begin(), big.end(), std::mt19937(3));
+    DDManager mgr2;
+    ordering::apply(mgr2, big);
+    for (bddvar i = 0; i < big.size(); ++i) {
+        EXPECT_EQ(mgr2.lev_of_var(big[i]), big.size() - i);
+        EXPECT_EQ(mgr2.var_of_lev(big.size() - i), big[i]);
+    }
+
+    // Bulk creation must place the new variables above the existing ones
+    EXPECT_THROW(mgr.new_vars_of_levs({5, 6}), DDArgumentException);
+    EXPECT_THROW(mgr.new_vars_of_levs({7, 7}), DDArgumentException);
+    EXPECT_EQ(mgr.var_count(), 5u);
+    EXPECT_EQ(mgr.new_vars_of_levs({7, 6}), 6u);
+    EXPECT_EQ(mgr.lev_of_var(6), 7u);
+    EXPECT_EQ(mgr.var_of_lev(6), 7u);
+
+    EXPECT_THROW(ordering::apply(mgr, {1, 1}), DDArgumentException);
+    EXPECT_THROW(ordering::dfs(2, {{1, 3}}), DDArgumentException);
+    EXPECT_THROW(ordering::force(3, edges, {1, 2}), DDArgumentException);
+    EXPECT_THROW(ordering::from_clauses({{1, 0}}), DDArgumentException);
+}
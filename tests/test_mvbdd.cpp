@@ -399,3 +399,83 @@ TEST_F(MVBDDTest, CompoundAssignment) {
     EXPECT_TRUE(o.evaluate({2}));
     EXPECT_FALSE(o.evaluate({3}));
 }
+
+// --- Saturation Tests ---
+
+// Token ring: 4 places holding 0..3 tokens, one event per place moving a
+// token to the next place (the last one wraps around to the first).
+TEST_F(MVBDDTest, SaturationMatchesBFS) {
+    const int n = 4;
+    MVBDD base = MVBDD::one(mgr, k);
+    for (int i = 0; i < n; ++i) base.new_var();
+
+    std::vector<MVEvent> events(n);
+    for (int i = 0; i < n; ++i) {
+        bddvar from = static_cast<bddvar>(i + 1);
+        bddvar to = static_cast<bddvar>((i + 1) % n + 1);
+        for (int v = 1; v < k; ++v) events[i].add(from, v, v - 1);
+        for (int v = 0; v + 1 < k; ++v) events[i].add(to, v, v + 1);
+    }
+    MVBDDSaturation sat(base, events);
+
+    MVBDD init = MVBDD::single(base, 1, 3);
+    for (bddvar mv = 2; mv <= n; ++mv) init &= MVBDD::single(base, mv, 0);
+
+    // One step moves the tokens from place 1 to place 2
+    MVBDD step = sat.image(init);
+    EXPECT_TRUE(step.evaluate({2, 1, 0, 0}));
+    EXPECT_FALSE(step.evaluate({3, 0, 0, 0}));
+    EXPECT_FALSE(step.evaluate({2, 0, 0, 1}));
+
+    MVBDD bfs = init;
+    MVBDD frontier = init;
+    while (!frontier.is_zero()) {
+        MVBDD next = sat.image(frontier);
+        frontier = next & ~bfs;
+        bfs |= frontier;
+    }
+    MVBDD reached = sat.reachable(init);
+    EXPECT_EQ(reached, bfs);
+    // A second call is answered from the caches
+    EXPECT_EQ(sat.reachable(init), reached);
+
+    // Exactly the states holding 3 tokens in total
+    int count = 0;
+    for (int code = 0; code < 256; ++code) {
+        std::vector<int> s = {code & 3, (code >> 2) & 3, (code >> 4) & 3, (code >> 6) & 3};
+        bool expected = (s[0] + s[1] + s[2] + s[3] == 3);
+        EXPECT_EQ(reached.evaluate(s), expected);
+        if (expected) ++count;
+    }
+    EXPECT_EQ(count, 20);
+}
+
+TEST_F(MVBDDTest, SaturationEvents) {
+    MVBDD base = MVBDD::one(mgr, k);
+    base.new_var();
+    base.new_var();
+
+    // x1: 0 -> 1 -> 2 -> 3 on its own; x2 may jump to 3 only while x1 == 2
+    MVEvent count_up;
+    count_up.add(1, 0, 1).add(1, 1, 2).add(1, 2, 3);
+    MVEvent jump;
+    jump.add(1, 2, 2).add(2, 0, 3);
+    MVBDDSaturation sat(base, {count_up, jump});
+
+    MVBDD init = MVBDD::single(base, 1, 0) & MVBDD::single(base, 2, 0);
+    MVBDD expected = MVBDD::single(base, 2, 0) |
+                     ((MVBDD::single(base, 1, 2) | MVBDD::single(base, 1, 3)) &
+                      MVBDD::single(base, 2, 3));
+    EXPECT_EQ(sat.reachable(init), expected);
+    EXPECT_TRUE(sat.reachable(MVBDD::zero(mgr, k)).is_zero());
+
+    sat.clear_cache();
+    EXPECT_EQ(sat.reachable(init), expected);
+
+    MVEvent bad_var;
+    bad_var.add(3, 0, 1);
+    EXPECT_THROW(MVBDDSaturation(base, {bad_var}), DDArgumentException);
+    MVEvent bad_value;
+    bad_value.add(1, 0, k);
+    EXPECT_THROW(MVBDDSaturation(base, {bad_value}), DDArgumentException);
+}
@@ -4,6 +4,9 @@
 #include <gtest/gtest.h>
 #include "sbdd2/sbdd2.hpp"
 #include <algorithm>
+#include <iterator>
+#include <random>
+#include <set>
 
 using namespace sbdd2;
 
@@ -120,6 +123,29 @@ TEST_F(ZDDTest, Change) {
     EXPECT_EQ(c.change(1), base);
 }
 
+TEST_F(ZDDTest, MultiVarCofactors) {
+    ZDD s1 = ZDD::singleton(mgr, 1);
+    ZDD s2 = ZDD::singleton(mgr, 2);
+    ZDD s3 = ZDD::singleton(mgr, 3);
+    ZDD f = s1.join(s2) + s2.join(s3) + s1.join(s3).join(ZDD::singleton(mgr, 4)) + s3;
+
+    std::vector<bddvar> vars = {3, 1};
+    EXPECT_EQ(f.onset(vars), f.onset(1).onset(3));
+    EXPECT_EQ(f.offset(vars), f.offset(1).offset(3));
+    EXPECT_EQ(f.change(vars), f.change(1).change(3));
+
+    // Duplicates and the empty list
+    EXPECT_EQ(f.onset(std::vector<bddvar>{2, 2}), f.onset(2));
+    EXPECT_EQ(f.change(std::vector<bddvar>()), f);
+
+    // A repeated call is answered from the cache
+    std::size_t hits = mgr.cache_hit_count();
+    f.change(vars);
+    EXPECT_GT(mgr.cache_hit_count(), hits);
+
+    EXPECT_THROW(f.onset(std::vector<bddvar>{1, 99}), DDArgumentException);
+}
+
 TEST_F(ZDDTest, Product) {
     ZDD s1 = ZDD::singleton(mgr, 1);
     ZDD s2 = ZDD::singleton(mgr, 2);
@@ -406,6 +432,40 @@ TEST_F(ZDDTest, IsMember) {
     EXPECT_FALSE(is_member(combined, test2));
 }
 
+TEST_F(ZDDTest, BDDConversion) {
+    ZDD s1 = ZDD::singleton(mgr, 1);
+    ZDD s2 = ZDD::singleton(mgr, 2);
+    ZDD s3 = ZDD::singleton(mgr, 3);
+    ZDD f = s1.join(s3) + s2 + ZDD::single(mgr);  // {{1,3}, {2}, {}}
+
+    // Characteristic function: true exactly on the members of f
+    BDD b = f.to_bdd();
+    for (int mask = 0; mask < 32; ++mask) {
+        BDD cube = mgr.bdd_one();
+        std::vector<bddvar> set;
+        for (bddvar v = 1; v <= 5; ++v) {
+            bool in = (mask >> (v - 1)) & 1;
+            cube = cube & (in ? mgr.var_bdd(v) : ~mgr.var_bdd(v));
+            if (in) set.push_back(v);
+        }
+        EXPECT_EQ(b.cofactor(cube).is_one(), is_member(f, set)) << mask;
+    }
+    EXPECT_EQ(ZDD::from_bdd(b), f);
+    EXPECT_EQ(b.to_zdd(), f);
+
+    // Skipped BDD levels are don't-cares within the universe
+    BDD x1 = mgr.var_bdd(1);
+    EXPECT_EQ(ZDD::from_bdd(x1).card(), 16.0);
+    EXPECT_EQ(ZDD::from_bdd(x1, 2).card(), 2.0);
+    EXPECT_EQ(ZDD::from_bdd(mgr.bdd_one()).card(), 32.0);
+    EXPECT_TRUE(ZDD::from_bdd(mgr.bdd_zero()).is_zero());
+    EXPECT_EQ(f.to_bdd(3).to_zdd(3), f);
+
+    EXPECT_THROW(f.to_bdd(2), DDArgumentException);
+    EXPECT_THROW(ZDD::from_bdd(mgr.var_bdd(4), 3), DDArgumentException);
+    EXPECT_THROW(f.to_bdd(6), DDArgumentException);
+}
+
 TEST_F(ZDDTest, WeightFilter) {
     ZDD ps = get_power_set(mgr, 3);  // Power set of {1,2,3}
     std::vector<long long> weights = {1, 2, 3};  // var 1 has weight 1, etc.
@@ -421,6 +481,233 @@ TEST_F(ZDDTest, WeightFilter) {
     EXPECT_EQ(eq3.card(), 2.0);
 }
 
+TEST_F(ZDDTest, PBConstraint) {
+    std::vector<bddvar> vars = {2, 5, 1, 4};
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> dist(-3, 5);
+    for (int trial = 0; trial < 20; ++trial) {
+        std::vector<long long> weights;
+        for (std::size_t i = 0; i < vars.size(); ++i) weights.push_back(dist(rng));
+        for (long long bound = -7; bound <= 12; ++bound) {
+            ZDD le = ZDD::empty(mgr), ge = ZDD::empty(mgr), eq = ZDD::empty(mgr);
+            for (int mask = 0; mask < 16; ++mask) {
+                ZDD set = ZDD::single(mgr);
+                long long sum = 0;
+                for (int i = 0; i < 4; ++i) {
+                    if (mask & (1 << i)) {
+                        set = set.change(vars[i]);
+                        sum += weights[i];
+                    }
+                }
+                if (sum <= bound) le = le + set;
+                if (sum >= bound) ge = ge + set;
+                if (sum == bound) eq = eq + set;
+            }
+            EXPECT_EQ(pb_zdd(mgr, vars, weights, PBRelation::LE, bound), le);
+            EXPECT_EQ(pb_zdd(mgr, vars, weights, PBRelation::GE, bound), ge);
+            EXPECT_EQ(pb_zdd(mgr, vars, weights, PBRelation::EQ, bound), eq);
+        }
+    }
+
+    // Same family as filtering the power set
+    std::vector<bddvar> all = {1, 2, 3, 4, 5};
+    std::vector<long long> weights = {1, 2, 3, 4, 5};
+    ZDD ps = get_power_set(mgr, 5);
+    EXPECT_EQ(pb_zdd(mgr, all, weights, PBRelation::LE, 7), weight_le(ps, 7, weights));
+    EXPECT_EQ(pb_zdd(mgr, all, weights, PBRelation::GE, 7), weight_ge(ps, 7, weights));
+
+    EXPECT_THROW(pb_zdd(mgr, all, std::vector<long long>(2, 1), PBRelation::LE, 1),
+                 DDArgumentException);
+    EXPECT_THROW(pb_zdd(mgr, std::vector<bddvar>{1, 1}, std::vector<long long>(2, 1),
+                        PBRelation::LE, 1), DDArgumentException);
+}
+
+TEST_F(ZDDTest, CardinalityConstraint) {
+    std::vector<bddvar> vars = {1, 3, 4, 5};
+    ZDD ps = get_power_set(mgr, vars);
+    for (int k = -1; k <= 5; ++k) {
+        ZDD at_most = ZDD::empty(mgr), exactly = ZDD::empty(mgr);
+        for (const auto& set : ps.enumerate()) {
+            ZDD s = ZDD::single(mgr);
+            for (bddvar v : set) s = s.change(v);
+            if (static_cast<int>(set.size()) <= k) at_most = at_most + s;
+            if (static_cast<int>(set.size()) == k) exactly = exactly + s;
+        }
+        EXPECT_EQ(at_most_k_zdd(mgr, vars, k), at_most);
+        EXPECT_EQ(exactly_k_zdd(mgr, vars, k), exactly);
+        EXPECT_EQ(get_power_set_with_card(mgr, vars, k), exactly);
+    }
+    // n - k + 1 nodes per level at most
+    EXPECT_EQ(exactly_k_zdd(mgr, vars, 2).size(), 6u);
+}
+
+TEST_F(ZDDTest, SizeHistogram) {
+    EXPECT_TRUE(ZDD::empty(mgr).size_histogram().empty());
+    EXPECT_EQ(ZDD::single(mgr).size_histogram(), std::vector<double>(1, 1.0));
+
+    std::mt19937 rng(11);
+    ZDD f = get_random_zdd_with_card(mgr, 5, 20, rng);
+    std::vector<double> hist = f.size_histogram();
+    double total = 0;
+    for (int k = 0; k <= 6; ++k) {
+        double expected = (f & get_power_set_with_card(mgr, 5, k)).card();
+        EXPECT_EQ(k < static_cast<int>(hist.size()) ? hist[k] : 0.0, expected);
+        total += expected;
+    }
+    EXPECT_EQ(total, f.card());
+    ASSERT_FALSE(hist.empty());
+    EXPECT_GT(hist.back(), 0.0);
+
+#if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
+    std::vector<std::string> exact = f.exact_size_histogram();
+    ASSERT_EQ(exact.size(), hist.size());
+    for (std::size_t k = 0; k < hist.size(); ++k) {
+        EXPECT_EQ(exact[k], std::to_string(static_cast<long long>(hist[k])));
+    }
+#endif
+}
+
+TEST_F(ZDDTest, ElementFrequencies) {
+    EXPECT_EQ(ZDD::empty(mgr).element_frequencies(), std::vector<double>(6, 0.0));
+
+    std::mt19937 rng(12);
+    ZDD f = get_random_zdd_with_card(mgr, 5, 20, rng);
+    std::vector<double> freq = f.element_frequencies();
+    ASSERT_EQ(freq.size(), 6u);
+    EXPECT_EQ(freq[0], 0.0);
+    for (bddvar v = 1; v <= 5; ++v) {
+        EXPECT_EQ(freq[v], f.onset(v).card());
+    }
+#if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
+    std::vector<std::string> exact = f.exact_element_frequencies();
+    for (bddvar v = 1; v <= 5; ++v) {
+        EXPECT_EQ(exact[v], std::to_string(static_cast<long long>(freq[v])));
+    }
+#endif
+}
+
+TEST(ZDDStatisticsTest, ParallelMatchesSequential) {
+    DDManager mgr;
+    for (int i = 0; i < 32; ++i) mgr.new_var();
+    // Wide enough that some levels are split across threads
+    std::mt19937 rng(5);
+    std::vector<bddvar> vars;
+    std::vector<long long> weights;
+    long long sum = 0;
+    for (bddvar v = 1; v <= 32; ++v) {
+        vars.push_back(v);
+        weights.push_back(1 + static_cast<long long>(rng() % 1000));
+        sum += weights.back();
+    }
+    ZDD f = pb_zdd(mgr, vars, weights, PBRelation::LE, sum / 2);
+    EXPECT_EQ(f.size_histogram(true), f.size_histogram());
+    EXPECT_EQ(f.element_frequencies(true), f.element_frequencies());
+#if defined(SBDD2_HAS_GMP) || defined(SBDD2_HAS_BIGINT)
+    EXPECT_EQ(f.exact_size_histogram(true), f.exact_size_histogram());
+    EXPECT_EQ(f.exact_element_frequencies(true), f.exact_element_frequencies());
+#endif
+
+    // Frequencies sum to the total size of all sets
+    std::vector<double> hist = f.size_histogram();
+    double total_size = 0, freq_sum = 0;
+    for (std::size_t k = 0; k < hist.size(); ++k) total_size += k * hist[k];
+    for (double c : f.element_frequencies()) freq_sum += c;
+    EXPECT_EQ(freq_sum, total_size);
+}
+
+// Itemsets with support >= min_support by brute force over subsets of
+// the n variables; closed ones have no single-item extension of equal support
+static void mine_by_brute_force(DDManager& mgr, int n, const std::vector<Transaction>& db,
+                                std::size_t min_support, ZDD& frequent, ZDD& closed) {
+    auto support = [&](unsigned mask) {
+        std::size_t s = 0;
+        for (const Transaction& t : db) {
+            unsigned tm = 0;
+            for (bddvar v : t) tm |= 1u << (v - 1);
+            if ((tm & mask) == mask) ++s;
+        }
+        return s;
+    };
+    frequent = ZDD::empty(mgr);
+    closed = ZDD::empty(mgr);
+    for (unsigned mask = 0; mask < (1u << n); ++mask) {
+        std::size_t s = support(mask);
+        if (s < min_support) continue;
+        ZDD set = ZDD::single(mgr);
+        bool is_closed = true;
+        for (int i = 0; i < n; ++i) {
+            if (mask & (1u << i)) {
+                set = set.change(i + 1);
+            } else if (support(mask | (1u << i)) == s) {
+                is_closed = false;
+            }
+        }
+        frequent = frequent + set;
+        if (is_closed) closed = closed + set;
+    }
+}
+
+TEST(ItemsetMiningTest, SmallDatabase) {
+    DDManager mgr;
+    for (int i = 0; i < 4; ++i) mgr.new_var();
+    std::vector<Transaction> db = {{1, 2, 3}, {1, 2}, {2, 4}, {2, 1}};
+
+    ZDD freq = mine_frequent(mgr, db, 2);
+    // {}, {1}, {2}, {1,2}
+    EXPECT_EQ(freq.card(), 4.0);
+    ZDD closed = mine_closed(mgr, db, 2);
+    // {2} (support 4) and {1,2} (support 3)
+    EXPECT_EQ(closed, ZDD::singleton(mgr, 2) + (ZDD::singleton(mgr, 1) * ZDD::singleton(mgr, 2)));
+
+    EXPECT_TRUE(mine_frequent(mgr, db, 5).is_zero());
+    EXPECT_THROW(mine_frequent(mgr, db, 0), DDArgumentException);
+    EXPECT_THROW(mine_closed(mgr, std::vector<Transaction>{{5}}, 1), DDArgumentException);
+}
+
+TEST(ItemsetMiningTest, MatchesBruteForce) {
+    const int n = 8;
+    DDManager mgr;
+    for (int i = 0; i < n; ++i) mgr.new_var();
+    mgr.new_var_of_lev(3);  // Items need not follow the variable numbering
+    std::mt19937 rng(21);
+    for (int trial = 0; trial < 10; ++trial) {
+        std::vector<Transaction> db;
+        for (int t = 0; t < 30; ++t) {
+            Transaction tr;
+            for (bddvar v = 1; v <= n; ++v) {
+                if (rng() % 3 != 0) tr.push_back(v);
+            }
+            db.push_back(tr);
+        }
+        for (std::size_t min_support : {1u, 3u, 8u}) {
+            ZDD frequent, closed;
+            mine_by_brute_force(mgr, n, db, min_support, frequent, closed);
+            EXPECT_EQ(mine_frequent(mgr, db, min_support), frequent);
+            EXPECT_EQ(mine_closed(mgr, db, min_support), closed);
+            EXPECT_EQ(mine_frequent(mgr, db, min_support, true), frequent);
+            EXPECT_EQ(mine_closed(mgr, db, min_support, true), closed);
+        }
+    }
+}
+
+TEST(ItemsetMiningTest, LongTransactions) {
+    // 2^60 frequent itemsets from a few long transactions
+    DDManager mgr;
+    for (int i = 0; i < 64; ++i) mgr.new_var();
+    Transaction all;
+    for (bddvar v = 1; v <= 60; ++v) all.push_back(v);
+    std::vector<Transaction> db(3, all);
+    db.push_back(Transaction{61, 62});
+    db.push_back(Transaction{61, 62, 1});
+
+    ZDD freq = mine_frequent(mgr, db, 3);
+    EXPECT_EQ(freq.card(), 1152921504606846976.0);
+    EXPECT_LE(freq.size(), 60u);
+    ZDD closed = mine_closed(mgr, db, 2);
+    // {}, {1}, {1..60}, {61,62}
+    EXPECT_EQ(closed.card(), 4.0);
+}
+
 // Test ZDD operations with variable level management
 TEST(ZDDLevelTest, OperationsWithDifferentLevels) {
     DDManager mgr;
@@ -1175,3 +1462,417 @@ TEST_F(ZDDIndexTest, WeightIteratorSmall) {
     EXPECT_EQ(max_results[0].size(), 1u);
     EXPECT_EQ(max_results[0].count(2), 1u);
 }
+
+// Deep ZDDs (long variable chains) must not overflow the call stack
+TEST(ZDDDeepTest, LongChains) {
+    const bddvar n = 100000;
+    DDManager mgr(1 << 21);
+    for (bddvar i = 0; i < n; ++i) {
+        mgr.new_var();
+    }
+
+    // a = {{1, ..., n}}, b = {{2, ..., n}}
+    ZDD a = ZDD::single(mgr);
+    for (bddvar v = 1; v <= n; ++v) {
+        a = a.change(v);
+    }
+    ZDD b = a.change(1);
+
+    ZDD u = a + b;
+    EXPECT_DOUBLE_EQ(u.card(), 2.0);
+    EXPECT_EQ(u & a, a);
+    EXPECT_EQ(u - a, b);
+    EXPECT_EQ(a * b, a);
+    EXPECT_EQ(u / b, ZDD::single(mgr) + ZDD::singleton(mgr, 1));
+    EXPECT_EQ(u.onset(n).offset(1), b.onset(n));
+
+    EXPECT_EQ(u.len(), static_cast<std::uint64_t>(n));
+    EXPECT_EQ(u.lit(), static_cast<std::uint64_t>(2 * n - 1));
+
+    std::vector<std::vector<bddvar>> sets = u.enumerate();
+    ASSERT_EQ(sets.size(), 2u);
+    EXPECT_EQ(sets[0].size() + sets[1].size(), static_cast<std::size_t>(2 * n - 1));
+
+    mgr.gc();
+    EXPECT_EQ(u - b, a);
+}
+
+TEST(ZDDDeepTest, MaximalMinimal) {
+    const bddvar n = 300000;
+    DDManager mgr(1 << 21);
+    for (bddvar i = 0; i < n; ++i) {
+        mgr.new_var();
+    }
+
+    // a = {{1, ..., n}}, b = {{2, ..., n}}, odd = {{1, 3, 5, ...}}
+    ZDD a = ZDD::single(mgr);
+    ZDD odd = ZDD::single(mgr);
+    for (bddvar v = 1; v <= n; ++v) {
+        a = a.change(v);
+        if (v % 2) odd = odd.change(v);
+    }
+    ZDD b = a.change(1);
+    ZDD u = a + b + odd;
+
+    EXPECT_EQ(u.maximal(), a);
+    EXPECT_EQ(u.minimal(), b + odd);
+    EXPECT_EQ(u.nonsup(b), odd);
+    EXPECT_EQ(u.nonsub(b), a + odd);
+}
+
+TEST_F(ZDDTest, SymChkAndSymGrp) {
+    ZDD s1 = ZDD::singleton(mgr, 1);
+    ZDD s2 = ZDD::singleton(mgr, 2);
+    ZDD s3 = ZDD::singleton(mgr, 3);
+    ZDD s4 = ZDD::singleton(mgr, 4);
+    ZDD s5 = ZDD::singleton(mgr, 5);
+
+    // (all 2-subsets of {1,2,3}) x {{4}, {5}}
+    ZDD f = (s1.join(s2) + s1.join(s3) + s2.join(s3)).join(s4 + s5);
+
+    EXPECT_EQ(f.sym_chk(1, 3), 1);
+    EXPECT_EQ(f.sym_chk(4, 5), 1);
+    EXPECT_EQ(f.sym_chk(3, 4), 0);
+
+    ZDD expected = s1.join(s2).join(s3) + s4.join(s5);
+    EXPECT_EQ(f.sym_grp(), expected);
+
+    // No symmetric pair: no groups
+    ZDD g = s1 + s1.join(s2);
+    EXPECT_TRUE(g.sym_grp().is_zero());
+}
+
+TEST(ZDDSymGrpTest, ManyVariables) {
+    // Choose one variable from each pair {2i-1, 2i}: every pair is a
+    // symmetric group, but all variables look alike by set sizes alone
+    const bddvar pairs = 1000;
+    DDManager mgr;
+    for (bddvar i = 0; i < 2 * pairs; ++i) {
+        mgr.new_var();
+    }
+
+    ZDD f = ZDD::single(mgr);
+    for (bddvar i = 1; i <= pairs; ++i) {
+        f = f.join(ZDD::singleton(mgr, 2 * i - 1) + ZDD::singleton(mgr, 2 * i));
+    }
+
+    ZDD groups = f.sym_grp();
+    EXPECT_DOUBLE_EQ(groups.card(), static_cast<double>(pairs));
+    EXPECT_EQ(groups.len(), 2u);
+    EXPECT_EQ(f.sym_chk(1, 2), 1);
+    EXPECT_EQ(f.sym_chk(1, 3), 0);
+}
+
+TEST_F(ZDDTest, MaximalMinimal) {
+    ZDD s1 = ZDD::singleton(mgr, 1);
+    ZDD s2 = ZDD::singleton(mgr, 2);
+    ZDD s3 = ZDD::singleton(mgr, 3);
+    ZDD base = ZDD::single(mgr);
+
+    // {{}, {1}, {1,2}, {3}, {2,3}}
+    ZDD f = base + s1 + s1.join(s2) + s3 + s2.join(s3);
+
+    EXPECT_EQ(f.maximal(), s1.join(s2) + s2.join(s3));
+    EXPECT_EQ(f.minimal(), base);
+    EXPECT_EQ((f - base).minimal(), s1 + s3);
+
+    // Sets of f with no subset in {{2}}: {}, {1}, {3}
+    EXPECT_EQ(f.nonsup(s2), base + s1 + s3);
+    // Sets of f with no superset in {{1,2}}: {3}, {2,3}
+    EXPECT_EQ(f.nonsub(s1.join(s2)), s3 + s2.join(s3));
+
+    EXPECT_EQ(f.nonsup(ZDD::empty(mgr)), f);
+    EXPECT_EQ(f.nonsub(ZDD::empty(mgr)), f);
+    EXPECT_TRUE(f.nonsup(base).is_zero());
+}
+
+TEST(ZDDMaximalMinimalTest, RandomFamilies) {
+    typedef std::set<std::set<bddvar>> Family;
+    const int n = 6;
+    std::mt19937 rng(7);
+
+    auto random_family = [&](DDManager& mgr, Family& fam) {
+        ZDD z = ZDD::empty(mgr);
+        int m = rng() % 12;
+        for (int k = 0; k < m; ++k) {
+            unsigned mask = rng() % (1u << n);
+            std::set<bddvar> s;
+            ZDD t = ZDD::single(mgr);
+            for (int v = 1; v <= n; ++v) {
+                if (mask >> (v - 1) & 1) {
+                    s.insert(v);
+                    t = t.change(v);
+                }
+            }
+            fam.insert(s);
+            z = z + t;
+        }
+        return z;
+    };
+    auto to_family = [](const ZDD& z) {
+        Family fam;
+        for (const auto& s : z.enumerate()) {
+            fam.insert(std::set<bddvar>(s.begin(), s.end()));
+        }
+        return fam;
+    };
+    auto subset = [](const std::set<bddvar>& a, const std::set<bddvar>& b) {
+        return std::includes(b.begin(), b.end(), a.begin(), a.end());
+    };
+
+    for (int iter = 0; iter < 50; ++iter) {
+        DDManager mgr;
+        for (int i = 0; i < n; ++i) mgr.new_var();
+        Family ff, gf;
+        ZDD f = random_family(mgr, ff);
+        ZDD g = random_family(mgr, gf);
+
+        Family max_f, min_f, nonsup_fg, nonsub_fg;
+        for (const auto& s : ff) {
+            bool is_max = true, is_min = true, no_sub = true, no_sup = true;
+            for (const auto& t : ff) {
+                if (t != s && subset(s, t)) is_max = false;
+                if (t != s && subset(t, s)) is_min = false;
+            }
+            for (const auto& t : gf) {
+                if (subset(t, s)) no_sub = false;
+                if (subset(s, t)) no_sup = false;
+            }
+            if (is_max) max_f.insert(s);
+            if (is_min) min_f.insert(s);
+            if (no_sub) nonsup_fg.insert(s);
+            if (no_sup) nonsub_fg.insert(s);
+        }
+
+        EXPECT_EQ(to_family(f.maximal()), max_f);
+        EXPECT_EQ(to_family(f.minimal()), min_f);
+        EXPECT_EQ(to_family(f.nonsup(g)), nonsup_fg);
+        EXPECT_EQ(to_family(f.nonsub(g)), nonsub_fg);
+    }
+}
+
+TEST(ShiftedZDDTest, ViewMatchesEagerShifts) {
+    typedef std::set<std::set<bddvar>> Family;
+    const int n = 8;
+    std::mt19937 rng(11);
+    DDManager mgr;
+    for (int i = 0; i < 3 * n; ++i) mgr.new_var();
+
+    auto to_family = [](const std::vector<std::vector<bddvar>>& sets) {
+        Family fam;
+        for (const auto& s : sets) {
+            fam.insert(std::set<bddvar>(s.begin(), s.end()));
+        }
+        return fam;
+    };
+
+    for (int iter = 0; iter < 40; ++iter) {
+        ZDD f = ZDD::empty(mgr);
+        int m = 1 + rng() % 10;
+        for (int k = 0; k < m; ++k) {
+            ZDD t = ZDD::single(mgr);
+            for (int v = n + 1; v <= 2 * n; ++v) {
+                if (rng() % 2) t = t.change(v);
+            }
+            f = f + t;
+        }
+
+        // Apply the same random shift sequence eagerly and lazily
+        ZDD eager = f;
+        ShiftedZDD lazy(f);
+        for (int step = 0; step < 4; ++step) {
+            int s = rng() % 5;
+            if (rng() % 2) {
+                eager = eager << s;
+                lazy = lazy << s;
+            } else {
+                eager = eager >> s;
+                lazy = lazy >> s;
+            }
+        }
+
+        EXPECT_EQ(lazy.materialize(), eager);
+        EXPECT_EQ(to_family(lazy.enumerate()), to_family(eager.enumerate()));
+        EXPECT_EQ(lazy.card(), eager.card());
+        EXPECT_EQ(lazy.lit(), eager.lit());
+        EXPECT_EQ(lazy.len(), eager.len());
+        EXPECT_EQ(lazy.top(), eager.top());
+        EXPECT_EQ(lazy.is_one(), eager.is_one());
+    }
+}
+
+TEST(ShiftedZDDTest, ShiftsDoNotCreateNodes) {
+    DDManager mgr;
+    for (int i = 0; i < 40; ++i) mgr.new_var();
+    ZDD f = ZDD::single(mgr);
+    for (int v = 1; v <= 10; ++v) {
+        f = f + f.change(v);
+    }
+
+    std::size_t before = mgr.node_count();
+    ShiftedZDD view(f);
+    for (int i = 0; i < 1000; ++i) {
+        view = (view << 3) >> 2;
+    }
+    view = view >> 1000;
+    EXPECT_EQ(mgr.node_count(), before);
+    EXPECT_TRUE(view.is_relabeling());
+    EXPECT_EQ(view.offset(), 0);
+    EXPECT_EQ(view.card(), 1024.0);
+    EXPECT_EQ(view.materialize(), f);
+}
+
+TEST(ShiftedZDDTest, AlignedSetOperations) {
+    DDManager mgr;
+    for (int i = 0; i < 30; ++i) mgr.new_var();
+    ZDD f = ZDD::single(mgr);
+    for (int v = 1; v <= 5; ++v) {
+        f = f + f.change(v);
+    }
+
+    ShiftedZDD a = ShiftedZDD(f) << 5;
+    ShiftedZDD b = ShiftedZDD(f) << 10;
+    ShiftedZDD joined = a * b;
+    EXPECT_EQ(joined.offset(), 5);
+    EXPECT_EQ(joined.materialize(), (f << 5) * (f << 10));
+    EXPECT_EQ(joined.card(), 1024.0);
+
+    ShiftedZDD same = a + (ShiftedZDD(f << 2) << 3);
+    EXPECT_EQ(same.materialize(), f << 5);
+    EXPECT_EQ((a - a).card(), 0.0);
+    EXPECT_EQ((a & (ShiftedZDD(f) << 7)).materialize(), (f << 5) & (f << 7));
+    EXPECT_TRUE(a == ShiftedZDD(f << 5));
+    EXPECT_TRUE(a != b);
+
+    // Views at different offsets are compared and combined by walking both
+    // bases in step; nothing shifted exists before the snapshot
+    ZDD g = ZDD::single(mgr);
+    for (int v = 12; v <= 16; ++v) {
+        g = g + g.change(v);
+    }
+    std::size_t before = mgr.node_count();
+    ShiftedZDD down = ShiftedZDD(g) >> 11;
+    ShiftedZDD up = ShiftedZDD(f) << 9;
+    EXPECT_TRUE(down.is_relabeling());
+    EXPECT_TRUE(down == ShiftedZDD(f));
+    EXPECT_TRUE((down << 9) == up);
+    EXPECT_TRUE(down != (ShiftedZDD(f) << 8));
+    EXPECT_EQ(mgr.node_count(), before);
+
+    // f over 1..5 joined with f over 7..11 in the frame of the lower view:
+    // the result reuses f and adds one node per variable 7..11
+    ShiftedZDD lower = ShiftedZDD(f) << 2;
+    ShiftedZDD upper = ShiftedZDD(f) << 8;
+    ShiftedZDD prod = lower * upper;
+    EXPECT_EQ(prod.offset(), 2);
+    EXPECT_EQ(mgr.node_count(), before + 5);
+    EXPECT_EQ(prod.materialize(), (f << 2) * (f << 8));
+    EXPECT_EQ((lower + upper).materialize(), (f << 2) + (f << 8));
+    EXPECT_EQ((upper - lower).materialize(), (f << 8) - (f << 2));
+    EXPECT_EQ((lower - upper).materialize(), (f << 2) - (f << 8));
+    ShiftedZDD overlap = ShiftedZDD(f) << 4;
+    EXPECT_EQ((lower & overlap).materialize(), (f << 2) & (f << 4));
+    EXPECT_EQ((overlap + lower).materialize(), (f << 4) + (f << 2));
+    EXPECT_EQ((overlap - lower).materialize(), (f << 4) - (f << 2));
+    EXPECT_EQ((lower * overlap).materialize(), (f << 2) * (f << 4));
+    EXPECT_EQ((down * up).materialize(), f * (f << 9));
+}
+
+TEST(ZDDJoinTest, ParallelMatchesSequential) {
+    const int n = 24;
+    std::mt19937 rng(5);
+    DDManager mgr(1 << 21);
+    for (int i = 0; i < n; ++i) mgr.new_var();
+
+    auto random_family = [&](int m) {
+        ZDD z = ZDD::empty(mgr);
+        for (int k = 0; k < m; ++k) {
+            ZDD t = ZDD::single(mgr);
+            for (int v = 1; v <= n; ++v) {
+                if (rng() % 4 == 0) t = t.change(v);
+            }
+            z = z + t;
+        }
+        return z;
+    };
+
+    for (int iter = 0; iter < 3; ++iter) {
+        ZDD f = random_family(40);
+        ZDD g = random_family(40);
+
+        mgr.set_parallel_cutoff(0);
+        ZDD seq = f * g;
+        mgr.cache_clear();
+        mgr.set_parallel_cutoff(1);
+        ZDD par = f * g;
+        EXPECT_EQ(par, seq);
+
+        // The fused three-way union agrees with pairwise unions
+        ZDD expected = ZDD::empty(mgr);
+        for (const auto& s : f.enumerate()) {
+            ZDD fs = ZDD::single(mgr);
+            for (bddvar v : s) fs = fs.change(v);
+            for (const auto& t : g.enumerate()) {
+                ZDD st = fs;
+                for (bddvar v : t) {
+                    if (std::find(s.begin(), s.end(), v) == s.end()) st = st.change(v);
+                }
+                expected = expected + st;
+            }
+        }
+        EXPECT_EQ(seq, expected);
+    }
+    mgr.set_parallel_cutoff(0);
+}
+
+TEST(ZDDJoinTest, ParallelGrowsTable) {
+    // The table starts tiny, so the tasks grow it while they run
+    const int n = 24;
+    std::mt19937 rng(7);
+    DDManager mgr(1 << 6);
+    for (int i = 0; i < n; ++i) mgr.new_var();
+
+    auto random_family = [&](int m) {
+        ZDD z = ZDD::empty(mgr);
+        for (int k = 0; k < m; ++k) {
+            ZDD t = ZDD::single(mgr);
+            for (int v = 1; v <= n; ++v) {
+                if (rng() % 4 == 0) t = t.change(v);
+            }
+            z = z + t;
+        }
+        return z;
+    };
+
+    ZDD f = random_family(60);
+    ZDD g = random_family(60);
+    auto sorted_sets = [](const ZDD& z) {
+        std::set<std::vector<bddvar> > sets;
+        for (auto s : z.enumerate()) {
+            std::sort(s.begin(), s.end());
+            sets.insert(s);
+        }
+        return sets;
+    };
+    std::set<std::vector<bddvar> > fs = sorted_sets(f);
+    std::set<std::vector<bddvar> > gs = sorted_sets(g);
+
+    std::size_t before = mgr.table_size();
+    mgr.set_parallel_cutoff(1);
+    ZDD par = f * g;
+    mgr.set_parallel_cutoff(0);
+    EXPECT_GT(mgr.table_size(), before);
+
+    std::set<std::vector<bddvar> > expected;
+    for (const auto& s : fs) {
+        for (const auto& t : gs) {
+            std::vector<bddvar> u;
+            std::set_union(s.begin(), s.end(), t.begin(), t.end(), std::back_inserter(u));
+            expected.insert(u);
+        }
+    }
+    EXPECT_EQ(sorted_sets(par), expected);
+
+    // Arcs taken before the table grew still name the same families
+    EXPECT_EQ(sorted_sets(f), fs);
+}